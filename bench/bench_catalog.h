@@ -0,0 +1,73 @@
+#ifndef BENCH_CATALOG_H
+#define BENCH_CATALOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+
+// Random fertilizer blend requests for the fertilizer benchmarks. Products
+// carry one to four nutrients at realistic grades; a third of them have an
+// availability limit. Every nutrient has a straight product without a limit,
+// so the targets are always reachable.
+
+#define BENCH_CATALOG_NUTRIENTS 12
+
+static const char *const bench_nutrient_names[BENCH_CATALOG_NUTRIENTS] = {
+    "N", "P2O5", "K2O", "S", "Ca", "Mg", "Zn", "B", "Cu", "Mn", "Fe", "Mo"
+};
+
+// Targets in kg/ha: macronutrients first, then micronutrients
+static const double bench_nutrient_min[BENCH_CATALOG_NUTRIENTS] = {
+    120, 60, 80, 20, 10, 10, 1, 0.5, 0.3, 0.8, 0.8, 0.02
+};
+
+static inline double bench_uniform(uint32_t *state, double low, double high) {
+    return low + (high - low) * (bench_rand(state) / 4294967296.0);
+}
+
+// Writes a request with product_count products to a malloc()ed string
+static inline char *bench_make_catalog(int product_count, double area, uint32_t seed) {
+    size_t cap = 256 + (size_t)product_count * 320;
+    char *json = malloc(cap);
+    if (!json) {
+        return NULL;
+    }
+    uint32_t state = seed ? seed : 1;
+    size_t len = (size_t)snprintf(json, cap, "{\"area\":%.2f,\"nutrients\":{", area);
+    for (int k = 0; k < BENCH_CATALOG_NUTRIENTS; k++) {
+        double min = bench_nutrient_min[k] * bench_uniform(&state, 0.8, 1.2);
+        len += (size_t)snprintf(json + len, cap - len, "%s\"%s\":{\"min\":%.4g,\"max\":%.4g}", k ? "," : "",
+                                bench_nutrient_names[k], min, min * 1.5);
+    }
+    len += (size_t)snprintf(json + len, cap - len, "},\"products\":[");
+    for (int i = 0; i < product_count; i++) {
+        // The first products are straight ones covering every nutrient
+        int straight = i < BENCH_CATALOG_NUTRIENTS;
+        int parts = straight ? 1 : 1 + (int)(bench_rand(&state) % 4);
+        double left = bench_uniform(&state, 0.3, 0.65);
+        len += (size_t)snprintf(json + len, cap - len, "%s{\"name\":\"P%d\",\"price\":%.4f,\"composition\":{",
+                                i ? "," : "", i, bench_uniform(&state, 0.2, 1.5));
+        int used = -1;
+        for (int p = 0; p < parts; p++) {
+            int k = straight ? i : (int)(bench_rand(&state) % BENCH_CATALOG_NUTRIENTS);
+            if (k == used) {
+                continue;
+            }
+            // Micronutrients come in small fractions
+            double fraction = k < 6 ? left / parts : left / parts * 0.05;
+            len += (size_t)snprintf(json + len, cap - len, "%s\"%s\":%.4f", p ? "," : "", bench_nutrient_names[k],
+                                    fraction);
+            used = k;
+        }
+        len += (size_t)snprintf(json + len, cap - len, "}");
+        if (!straight && bench_rand(&state) % 3 == 0) {
+            len += (size_t)snprintf(json + len, cap - len, ",\"available\":%.1f",
+                                    bench_uniform(&state, 10.0, 400.0) * area);
+        }
+        len += (size_t)snprintf(json + len, cap - len, "}");
+    }
+    snprintf(json + len, cap - len, "]}");
+    return json;
+}
+
+#endif
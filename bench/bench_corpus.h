@@ -0,0 +1,140 @@
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Shared helpers for the benchmark programs. The puzzle corpus is derived
+// from a seed grid through validity-preserving symmetries (digit relabeling,
+// row/column swaps inside bands and stacks, band/stack swaps, transposition)
+// so every generated puzzle is solvable and has the same difficulty profile.
+
+static const int bench_seed_puzzle[9][9] = {
+    {5, 3, 0, 0, 7, 0, 0, 0, 0},
+    {6, 0, 0, 1, 9, 5, 0, 0, 0},
+    {0, 9, 8, 0, 0, 0, 0, 6, 0},
+    {8, 0, 0, 0, 6, 0, 0, 0, 3},
+    {4, 0, 0, 8, 0, 3, 0, 0, 1},
+    {7, 0, 0, 0, 2, 0, 0, 0, 6},
+    {0, 6, 0, 0, 0, 0, 2, 8, 0},
+    {0, 0, 0, 4, 1, 9, 0, 0, 5},
+    {0, 0, 0, 0, 8, 0, 0, 7, 9}
+};
+
+static inline uint32_t bench_rand(uint32_t *state) {
+    // xorshift32, good enough to shuffle a corpus deterministically
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline void bench_shuffle(int *values, int count, uint32_t *state) {
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int)(bench_rand(state) % (uint32_t)(i + 1));
+        int tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+    }
+}
+
+static inline void bench_permutation(int perm[9], uint32_t *state) {
+    // Permutation of the 9 lines that keeps bands (or stacks) together
+    int bands[3] = {0, 1, 2};
+    bench_shuffle(bands, 3, state);
+    for (int b = 0; b < 3; b++) {
+        int inner[3] = {0, 1, 2};
+        bench_shuffle(inner, 3, state);
+        for (int r = 0; r < 3; r++) {
+            perm[3 * b + r] = 3 * bands[b] + inner[r];
+        }
+    }
+}
+
+// Hard instances (heavy search for every engine), in 81-character form
+static const char *const bench_hard_puzzles[] = {
+    "800000000003600000070090000050007000000045700000100030001000068008500010090000400",
+    "850002400720000009004000000000107002305000900040000000000080070017000000000036040",
+    "005300000800000020070010500400005300010070006003200080060500009004000030000009700",
+    "400000805030000000000700000020000060000080400000010000000603070500200000104000000",
+    "000000039000001005003050800008090006070002000100400000009080050020000600400700000",
+    "100007090030020008009600500005300900010080002600004000300000010040000007007000300"
+};
+#define BENCH_HARD_PUZZLE_COUNT (int)(sizeof(bench_hard_puzzles) / sizeof(bench_hard_puzzles[0]))
+
+static inline void bench_parse_grid(const char *text, int grid[9][9]) {
+    for (int cell = 0; cell < 81; cell++) {
+        char ch = text[cell];
+        grid[cell / 9][cell % 9] = (ch >= '1' && ch <= '9') ? ch - '0' : 0;
+    }
+}
+
+// Fills corpus with count symmetric variants of the seed grids, cycling
+// through them in order
+static inline void bench_make_corpus_from(const int (*seeds)[9][9], int seed_count,
+                                          int (*corpus)[9][9], int count, uint32_t seed) {
+    uint32_t state = seed ? seed : 0x9e3779b9u;
+
+    for (int n = 0; n < count; n++) {
+        int digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        int rows[9];
+        int cols[9];
+        bench_shuffle(digits + 1, 9, &state);
+        bench_permutation(rows, &state);
+        bench_permutation(cols, &state);
+        int transpose = (int)(bench_rand(&state) & 1u);
+
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                int value = seeds[n % seed_count][rows[i]][cols[j]];
+                if (transpose) {
+                    corpus[n][j][i] = digits[value];
+                } else {
+                    corpus[n][i][j] = digits[value];
+                }
+            }
+        }
+    }
+}
+
+static inline void bench_make_corpus(int (*corpus)[9][9], int count, uint32_t seed) {
+    bench_make_corpus_from(&bench_seed_puzzle, 1, corpus, count, seed);
+}
+
+static inline void bench_make_hard_corpus(int (*corpus)[9][9], int count, uint32_t seed) {
+    int seeds[BENCH_HARD_PUZZLE_COUNT][9][9];
+    for (int p = 0; p < BENCH_HARD_PUZZLE_COUNT; p++) {
+        bench_parse_grid(bench_hard_puzzles[p], seeds[p]);
+    }
+    bench_make_corpus_from((const int (*)[9][9])seeds, BENCH_HARD_PUZZLE_COUNT, corpus, count, seed);
+}
+
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline int bench_compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile p (0 to 1) of count sorted values
+static inline double bench_percentile(const double *sorted, int count, double p) {
+    return sorted[(int)(p * (count - 1) + 0.5)];
+}
+
+// Sorts count latencies (seconds) in place and prints their p50, p99 and max
+static inline void bench_print_latency(const char *label, double *latency, int count) {
+    qsort(latency, (size_t)count, sizeof(*latency), bench_compare_doubles);
+    printf("%-12s p50 %10.1f us  p99 %10.1f us  max %10.1f us\n", label, bench_percentile(latency, count, 0.50) * 1e6,
+           bench_percentile(latency, count, 0.99) * 1e6, latency[count - 1] * 1e6);
+}
+
+#endif
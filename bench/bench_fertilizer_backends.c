@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_catalog.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+
+// Solve latency of the SCIP and LP-only backends on the same parsed random
+// catalogs. "cold" builds a new context per request, so SCIP pays for
+// SCIPcreate() and the default plugins and the LP for creating SoPlex;
+// "reused" keeps one context, as solve_fertilizer_mixing() does per thread.
+// Parsing is excluded.
+//
+// Usage: bench_fertilizer_backends [products] [requests]
+
+#define CATALOGS 64
+
+// Fills latency[] with per-request seconds and *total_cost with the summed
+// cost of all blends, so the backends can be checked against each other
+static int run(fertilizer_backend_t backend, bool cold, const fertilizer_problem_t *problems, int requests,
+               double *latency, double *total_cost) {
+    fertilizer_ctx_t ctx;
+    fertilizer_ctx_init(&ctx);
+    ctx.backend = backend;
+    *total_cost = 0.0;
+    for (int r = 0; r < requests; r++) {
+        const fertilizer_problem_t *problem = &problems[r % CATALOGS];
+        fertilizer_solution_t solution;
+        if (fertilizer_solution_init(&solution, problem) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        double start = bench_now();
+        SCIP_RETCODE retcode = fertilizer_solve(&ctx, problem, &solution);
+        if (cold) {
+            fertilizer_ctx_free(&ctx);
+        }
+        latency[r] = bench_now() - start;
+        bool ok = retcode == SCIP_OKAY && solution.status == FERTILIZER_OPTIMAL;
+        *total_cost += solution.cost;
+        fertilizer_solution_free(&solution);
+        if (!ok) {
+            fprintf(stderr, "Request %d not solved\n", r);
+            fertilizer_ctx_free(&ctx);
+            return EXIT_FAILURE;
+        }
+    }
+    fertilizer_ctx_free(&ctx);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    int products = argc > 1 ? atoi(argv[1]) : 200;
+    int requests = argc > 2 ? atoi(argv[2]) : 1000;
+    if (products <= BENCH_CATALOG_NUTRIENTS || requests <= 0) {
+        fprintf(stderr, "Need more than %d products and at least one request\n", BENCH_CATALOG_NUTRIENTS);
+        return EXIT_FAILURE;
+    }
+
+    static fertilizer_problem_t problems[CATALOGS];
+    for (int c = 0; c < CATALOGS; c++) {
+        char *json = bench_make_catalog(products, 10.0 + c, 4242u + (uint32_t)c);
+        char *error_msg = NULL;
+        if (!json || fertilizer_parse(json, &problems[c], &error_msg) != EXIT_SUCCESS) {
+            fprintf(stderr, "Catalog %d: %s\n", c, error_msg ? error_msg : "out of memory");
+            return EXIT_FAILURE;
+        }
+        free(json);
+    }
+    double *latency = malloc((size_t)requests * sizeof(*latency));
+    if (!latency) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    const struct {
+        const char *label;
+        fertilizer_backend_t backend;
+        bool cold;
+    } cases[] = {
+        {"scip cold", FERTILIZER_BACKEND_SCIP, true},
+        {"scip reused", FERTILIZER_BACKEND_SCIP, false},
+        {"lp cold", FERTILIZER_BACKEND_LP, true},
+        {"lp reused", FERTILIZER_BACKEND_LP, false}
+    };
+    printf("%d products, %d nutrients, %d requests\n", products, BENCH_CATALOG_NUTRIENTS, requests);
+    int status = EXIT_SUCCESS;
+    double expected = 0.0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]) && status == EXIT_SUCCESS; c++) {
+        double total_cost = 0.0;
+        status = run(cases[c].backend, cases[c].cold, problems, requests, latency, &total_cost);
+        if (status != EXIT_SUCCESS) {
+            break;
+        }
+        if (c == 0) {
+            expected = total_cost;
+        } else if (fabs(total_cost - expected) > 1e-6 * fabs(expected)) {
+            fprintf(stderr, "%s: total cost %.6f, expected %.6f\n", cases[c].label, total_cost, expected);
+            status = EXIT_FAILURE;
+        }
+        bench_print_latency(cases[c].label, latency, requests);
+    }
+
+    free(latency);
+    for (int c = 0; c < CATALOGS; c++) {
+        fertilizer_problem_free(&problems[c]);
+    }
+    return status;
+}
@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_catalog.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+
+// Quote latency with and without the optimal-basis cache. Requests cycle
+// through a few random catalogs, each quote moving every price
+// independently by up to +-jitter around the catalog's list price, and go
+// once to the plain LP backend and once to the LP backend with a basis
+// cache. Both must agree on the cost. Parsing is excluded.
+//
+// Usage: bench_fertilizer_cache [products] [requests] [jitter]
+
+#define CATALOGS 8
+
+int main(int argc, char **argv) {
+    int products = argc > 1 ? atoi(argv[1]) : 200;
+    int requests = argc > 2 ? atoi(argv[2]) : 2000;
+    double jitter = argc > 3 ? atof(argv[3]) : 0.02;
+    if (products <= BENCH_CATALOG_NUTRIENTS || requests <= 0 || jitter < 0.0 || jitter >= 1.0) {
+        fprintf(stderr, "Need more than %d products, at least one request and 0 <= jitter < 1\n",
+                BENCH_CATALOG_NUTRIENTS);
+        return EXIT_FAILURE;
+    }
+
+    static fertilizer_problem_t problems[CATALOGS];
+    static double *list_prices[CATALOGS];
+    for (int c = 0; c < CATALOGS; c++) {
+        char *json = bench_make_catalog(products, 10.0 + c, 777u + (uint32_t)c);
+        char *error_msg = NULL;
+        if (!json || fertilizer_parse(json, &problems[c], &error_msg) != EXIT_SUCCESS) {
+            fprintf(stderr, "Catalog %d: %s\n", c, error_msg ? error_msg : "out of memory");
+            return EXIT_FAILURE;
+        }
+        free(json);
+        list_prices[c] = malloc((size_t)products * sizeof(double));
+        if (!list_prices[c]) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        for (int i = 0; i < products; i++) {
+            list_prices[c][i] = problems[c].products[i].price;
+        }
+    }
+    double *plain = malloc((size_t)requests * sizeof(*plain));
+    double *cached = malloc((size_t)requests * sizeof(*cached));
+    fertilizer_basis_cache_t cache;
+    if (!plain || !cached || fertilizer_basis_cache_init(&cache, CATALOGS) != EXIT_SUCCESS) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    fertilizer_ctx_t plain_ctx;
+    fertilizer_ctx_t cached_ctx;
+    fertilizer_ctx_init(&plain_ctx);
+    fertilizer_ctx_init(&cached_ctx);
+    plain_ctx.backend = FERTILIZER_BACKEND_LP;
+    cached_ctx.backend = FERTILIZER_BACKEND_LP;
+    cached_ctx.cache = &cache;
+
+    int status = EXIT_SUCCESS;
+    uint32_t state = 99;
+    for (int r = 0; r < requests && status == EXIT_SUCCESS; r++) {
+        int c = r % CATALOGS;
+        fertilizer_problem_t *problem = &problems[c];
+        for (int i = 0; i < products; i++) {
+            problem->products[i].price = list_prices[c][i] * bench_uniform(&state, 1.0 - jitter, 1.0 + jitter);
+        }
+        fertilizer_solution_t expected;
+        fertilizer_solution_t answer;
+        if (fertilizer_solution_init(&expected, problem) != EXIT_SUCCESS ||
+            fertilizer_solution_init(&answer, problem) != EXIT_SUCCESS) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+        double start = bench_now();
+        SCIP_RETCODE retcode = fertilizer_solve(&plain_ctx, problem, &expected);
+        plain[r] = bench_now() - start;
+
+        start = bench_now();
+        SCIP_RETCODE cached_retcode = fertilizer_solve(&cached_ctx, problem, &answer);
+        cached[r] = bench_now() - start;
+
+        if (retcode != SCIP_OKAY || cached_retcode != SCIP_OKAY || expected.status != FERTILIZER_OPTIMAL ||
+            answer.status != FERTILIZER_OPTIMAL) {
+            fprintf(stderr, "Request %d not solved\n", r);
+            status = EXIT_FAILURE;
+        } else if (fabs(answer.cost - expected.cost) > 1e-5 * fabs(expected.cost)) {
+            fprintf(stderr, "Request %d: cost %.6f%s, expected %.6f\n", r, answer.cost,
+                    cached_ctx.from_cache ? " (cached)" : "", expected.cost);
+            status = EXIT_FAILURE;
+        }
+        fertilizer_solution_free(&expected);
+        fertilizer_solution_free(&answer);
+    }
+
+    if (status == EXIT_SUCCESS) {
+        fertilizer_basis_cache_stats_t stats;
+        fertilizer_basis_cache_get_stats(&cache, &stats);
+        printf("%d products, %d catalogs, %d requests, prices +-%.1f%%\n", products, CATALOGS, requests,
+               jitter * 100.0);
+        bench_print_latency("lp", plain, requests);
+        bench_print_latency("cached", cached, requests);
+        printf("hit rate %.1f%% (%zu hits, %zu misses, %zu warm-started, %zu bases stored)\n", stats.hit_rate * 100.0,
+               stats.hits, stats.misses, stats.warm_starts, stats.insertions);
+    }
+
+    fertilizer_ctx_free(&plain_ctx);
+    fertilizer_ctx_free(&cached_ctx);
+    fertilizer_basis_cache_free(&cache);
+    free(plain);
+    free(cached);
+    for (int c = 0; c < CATALOGS; c++) {
+        free(list_prices[c]);
+        fertilizer_problem_free(&problems[c]);
+    }
+    return status;
+}
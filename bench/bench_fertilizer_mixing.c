@@ -0,0 +1,74 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_catalog.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+
+// End-to-end latency of solve_fertilizer_mixing() (parse, LP solve, JSON
+// answer) on random catalogs, reported as percentiles. The first request
+// pays for creating the thread's LP and is reported apart.
+//
+// Usage: bench_fertilizer_mixing [products] [requests]
+
+#define CATALOGS 64
+
+int main(int argc, char **argv) {
+    int products = argc > 1 ? atoi(argv[1]) : 200;
+    int requests = argc > 2 ? atoi(argv[2]) : 2000;
+    if (products <= BENCH_CATALOG_NUTRIENTS || requests <= 0) {
+        fprintf(stderr, "Need more than %d products and at least one request\n", BENCH_CATALOG_NUTRIENTS);
+        return EXIT_FAILURE;
+    }
+
+    char *catalogs[CATALOGS];
+    for (int c = 0; c < CATALOGS; c++) {
+        catalogs[c] = bench_make_catalog(products, 10.0 + c, 4242u + (uint32_t)c);
+        if (!catalogs[c]) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+    double *latency = malloc((size_t)requests * sizeof(*latency));
+    if (!latency) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    double first = 0.0;
+    for (int r = -1; r < requests && status == EXIT_SUCCESS; r++) {
+        char *solution = NULL;
+        char *error_msg = NULL;
+        double start = bench_now();
+        int retcode = solve_fertilizer_mixing(catalogs[(r + CATALOGS) % CATALOGS], &solution, &error_msg);
+        double elapsed = bench_now() - start;
+        if (retcode != EXIT_SUCCESS) {
+            fprintf(stderr, "Request %d failed: %s\n", r, error_msg ? error_msg : "unknown error");
+            status = EXIT_FAILURE;
+        } else if (r < 0) {
+            first = elapsed;
+        } else {
+            latency[r] = elapsed;
+        }
+        free(solution);
+        free(error_msg);
+    }
+
+    if (status == EXIT_SUCCESS) {
+        qsort(latency, (size_t)requests, sizeof(*latency), bench_compare_doubles);
+        printf("%d products, %d nutrients, %d requests\n", products, BENCH_CATALOG_NUTRIENTS, requests);
+        printf("first request %8.3f ms\n", first * 1e3);
+        printf("p50           %8.3f ms\n", bench_percentile(latency, requests, 0.50) * 1e3);
+        printf("p99           %8.3f ms\n", bench_percentile(latency, requests, 0.99) * 1e3);
+        printf("max           %8.3f ms\n", latency[requests - 1] * 1e3);
+    }
+
+    fertilizer_thread_cleanup();
+    free(latency);
+    for (int c = 0; c < CATALOGS; c++) {
+        free(catalogs[c]);
+    }
+    return status;
+}
@@ -0,0 +1,124 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_catalog.h"
+#include "problems/fertilizer_mixing/fertilizer_session.h"
+
+// Re-quote latency on one random catalog whose prices drift: every request
+// moves a few prices by up to 5% and every fourth also a nutrient minimum
+// by up to 10%. "full" re-solves each request from scratch on the reused
+// LP-only context, "warm" feeds the same changes to a fertilizer session.
+// Both must arrive at the same costs. Building the updates is excluded.
+//
+// Usage: bench_fertilizer_session [products] [requests]
+
+#define PRICE_MOVES 3
+
+// Random walk of prices and targets, relative to the current problem
+static void make_update(const fertilizer_problem_t *problem, int request, uint32_t *state, int *products,
+                        double *prices, fertilizer_update_t *update) {
+    memset(update, 0, sizeof(*update));
+    update->price_products = products;
+    update->prices = prices;
+    for (int n = 0; n < PRICE_MOVES; n++) {
+        int i = (int)(bench_rand(state) % (uint32_t)problem->product_count);
+        products[n] = i;
+        prices[n] = problem->products[i].price * bench_uniform(state, 0.95, 1.05);
+    }
+    update->price_count = PRICE_MOVES;
+    if (request % 4 == 3) {
+        int k = (int)(bench_rand(state) % (uint32_t)problem->nutrient_count);
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+        double min = nutrient->min * bench_uniform(state, 0.9, 1.1);
+        update->target_count = 1;
+        update->target_nutrients[0] = k;
+        update->target_min[0] = min < nutrient->max ? min : nutrient->max;
+        update->target_max[0] = nutrient->max;
+    }
+}
+
+int main(int argc, char **argv) {
+    int products = argc > 1 ? atoi(argv[1]) : 200;
+    int requests = argc > 2 ? atoi(argv[2]) : 1000;
+    if (products <= BENCH_CATALOG_NUTRIENTS || requests <= 0) {
+        fprintf(stderr, "Need more than %d products and at least one request\n", BENCH_CATALOG_NUTRIENTS);
+        return EXIT_FAILURE;
+    }
+
+    // One copy for the full solves, one handed to the session
+    char *json = bench_make_catalog(products, 25.0, 2024u);
+    fertilizer_problem_t problem;
+    fertilizer_problem_t session_problem;
+    char *error_msg = NULL;
+    if (!json || fertilizer_parse(json, &problem, &error_msg) != EXIT_SUCCESS ||
+        fertilizer_parse(json, &session_problem, &error_msg) != EXIT_SUCCESS) {
+        fprintf(stderr, "Catalog: %s\n", error_msg ? error_msg : "out of memory");
+        return EXIT_FAILURE;
+    }
+    free(json);
+
+    double *full = malloc((size_t)requests * sizeof(*full));
+    double *warm = malloc((size_t)requests * sizeof(*warm));
+    fertilizer_solution_t solution;
+    if (!full || !warm || fertilizer_solution_init(&solution, &problem) != EXIT_SUCCESS) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    fertilizer_ctx_t ctx;
+    fertilizer_ctx_init(&ctx);
+    ctx.backend = FERTILIZER_BACKEND_LP;
+    fertilizer_session_t session;
+    fertilizer_session_init(&session);
+
+    int status = EXIT_SUCCESS;
+    if (fertilizer_session_load(&session, &session_problem) != SCIP_OKAY ||
+        session.solution.status != FERTILIZER_OPTIMAL) {
+        fprintf(stderr, "Catalog not solved\n");
+        status = EXIT_FAILURE;
+    }
+    uint32_t state = 7;
+    int update_products[PRICE_MOVES];
+    double update_prices[PRICE_MOVES];
+    for (int r = 0; r < requests && status == EXIT_SUCCESS; r++) {
+        fertilizer_update_t update;
+        make_update(&problem, r, &state, update_products, update_prices, &update);
+
+        double start = bench_now();
+        fertilizer_problem_apply(&problem, &update);
+        SCIP_RETCODE retcode = fertilizer_solve(&ctx, &problem, &solution);
+        full[r] = bench_now() - start;
+
+        start = bench_now();
+        SCIP_RETCODE session_retcode = fertilizer_session_update(&session, &update);
+        warm[r] = bench_now() - start;
+
+        if (retcode != SCIP_OKAY || session_retcode != SCIP_OKAY || solution.status != FERTILIZER_OPTIMAL ||
+            session.solution.status != FERTILIZER_OPTIMAL) {
+            fprintf(stderr, "Request %d not solved\n", r);
+            status = EXIT_FAILURE;
+        } else if (fabs(solution.cost - session.solution.cost) > 1e-6 * fabs(solution.cost)) {
+            fprintf(stderr, "Request %d: warm cost %.6f, full cost %.6f\n", r, session.solution.cost,
+                    solution.cost);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    if (status == EXIT_SUCCESS) {
+        printf("%d products, %d nutrients, %d requests\n", products, BENCH_CATALOG_NUTRIENTS, requests);
+        bench_print_latency("full", full, requests);
+        bench_print_latency("warm", warm, requests);
+        printf("warm re-solves %zu of %zu, %.1f simplex iterations each\n", session.stats.warm,
+               session.stats.updates,
+               session.stats.warm ? (double)session.stats.iterations / (double)session.stats.warm : 0.0);
+    }
+
+    fertilizer_session_free(&session);
+    fertilizer_ctx_free(&ctx);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+    free(full);
+    free(warm);
+    return status;
+}
@@ -0,0 +1,60 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_batch.h"
+
+// Batch throughput on a hard corpus for growing worker pools.
+//
+// Usage: bench_sudoku_batch [puzzle_count]
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 20000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    char *puzzles = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    char *solutions = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    if (!corpus || !puzzles || !solutions) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 777u);
+    for (int n = 0; n < count; n++) {
+        for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+            puzzles[(size_t)n * SUDOKU_PUZZLE_LEN + (size_t)cell] = (char)('0' + corpus[n][cell / 9][cell % 9]);
+        }
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int status = EXIT_SUCCESS;
+    for (int threads = 1; status == EXIT_SUCCESS; threads *= 2) {
+        if (threads > cpus) {
+            threads = (int)cpus;
+        }
+
+        sudoku_batch_config_t config;
+        sudoku_batch_default_config(&config);
+        config.threads = threads;
+        sudoku_batch_stats_t stats;
+
+        status = solve_sudoku_batch(puzzles, (size_t)count, solutions, NULL, &config, &stats);
+        if (status == EXIT_SUCCESS) {
+            printf("%3d threads %8d puzzles %10.3f s %12.0f puzzles/s (%zu solved, %zu failed)\n",
+                   stats.threads, count, stats.elapsed, stats.puzzles_per_second, stats.solved, stats.failed);
+        }
+        if (threads >= cpus) {
+            break;
+        }
+    }
+
+    free(corpus);
+    free(puzzles);
+    free(solutions);
+    return status;
+}
@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_binary.h"
+#include "problems/sudoku/sudoku_parser.h"
+
+// Binary record format against the line format: pack/unpack throughput in
+// memory, then file size and write/read time for the same records as text
+// lines, packed binary and compressed binary. Reads include turning the
+// records back into SUDOKU_PUZZLE_LEN-byte text, as the solvers take it.
+//
+// Usage: bench_sudoku_binary [puzzle_count]
+
+static double file_megabytes(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (double)st.st_size / (1024.0 * 1024.0) : 0.0;
+}
+
+static int text_write(const char *path, const char *records, size_t count) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return EXIT_FAILURE;
+    }
+    char line[SUDOKU_PUZZLE_LEN + 1];
+    line[SUDOKU_PUZZLE_LEN] = '\n';
+    for (size_t n = 0; n < count; n++) {
+        memcpy(line, records + n * SUDOKU_PUZZLE_LEN, SUDOKU_PUZZLE_LEN);
+        fwrite(line, 1, sizeof(line), file);
+    }
+    return fclose(file) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static size_t text_read(const char *path, char *records, size_t count) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    char line[SUDOKU_PUZZLE_LEN + 1];
+    size_t n = 0;
+    while (n < count && fread(line, 1, sizeof(line), file) == sizeof(line)) {
+        memcpy(records + n * SUDOKU_PUZZLE_LEN, line, SUDOKU_PUZZLE_LEN);
+        n++;
+    }
+    fclose(file);
+    return n;
+}
+
+static int binary_write(const char *path, const char *records, size_t count, bool compress) {
+    sudoku_binary_writer_t writer;
+    if (sudoku_binary_writer_open(&writer, path, 3, compress) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    sudoku_binary_write(&writer, records, count);
+    return sudoku_binary_writer_close(&writer);
+}
+
+static size_t binary_read(const char *path, char *records, size_t count) {
+    sudoku_binary_reader_t reader;
+    if (sudoku_binary_reader_open(&reader, path, NULL) != EXIT_SUCCESS) {
+        return 0;
+    }
+    size_t n = sudoku_binary_read(&reader, records, count);
+    return sudoku_binary_reader_close(&reader) == EXIT_SUCCESS ? n : 0;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    enum { CORPUS = 4096 };
+    static int corpus[CORPUS][9][9];
+    bench_make_hard_corpus(corpus, CORPUS, 2024u);
+    char *records = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    char *copy = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    uint8_t *packed = malloc((size_t)count * SUDOKU_PACKED_LEN);
+    if (!records || !copy || !packed) {
+        fprintf(stderr, "Out of memory\n");
+        free(records);
+        free(copy);
+        free(packed);
+        return EXIT_FAILURE;
+    }
+    for (int n = 0; n < count; n++) {
+        sudoku_format_line((const int (*)[9])corpus[n % CORPUS], records + (size_t)n * SUDOKU_PUZZLE_LEN);
+    }
+
+    double start = bench_now();
+    for (int n = 0; n < count; n++) {
+        sudoku_pack_cells(records + (size_t)n * SUDOKU_PUZZLE_LEN, SUDOKU_PUZZLE_LEN,
+                          packed + (size_t)n * SUDOKU_PACKED_LEN);
+    }
+    double pack = bench_now() - start;
+    memset(copy, 0, (size_t)count * SUDOKU_PUZZLE_LEN);  // Fault the pages in outside the timing
+    start = bench_now();
+    for (int n = 0; n < count; n++) {
+        sudoku_unpack_cells(packed + (size_t)n * SUDOKU_PACKED_LEN, SUDOKU_PUZZLE_LEN,
+                            copy + (size_t)n * SUDOKU_PUZZLE_LEN);
+    }
+    double unpack = bench_now() - start;
+    int status = memcmp(records, copy, (size_t)count * SUDOKU_PUZZLE_LEN) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    printf("pack   %8.1f M records/s\nunpack %8.1f M records/s\n",
+           pack > 0 ? count / pack * 1e-6 : 0.0, unpack > 0 ? count / unpack * 1e-6 : 0.0);
+
+    const struct {
+        const char *label;
+        const char *suffix;
+        bool binary;
+        bool compress;
+    } formats[] = {
+        {"text", "txt", false, false},
+        {"binary", "sdkb", true, false},
+        {"zlib", "sdkz", true, true}
+    };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]) && status == EXIT_SUCCESS; f++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/bench_sudoku_binary_%ld.%s", (long)getpid(), formats[f].suffix);
+
+        start = bench_now();
+        status = formats[f].binary ? binary_write(path, records, (size_t)count, formats[f].compress)
+                                   : text_write(path, records, (size_t)count);
+        double write = bench_now() - start;
+
+        memset(copy, 0, (size_t)count * SUDOKU_PUZZLE_LEN);
+        start = bench_now();
+        size_t read = formats[f].binary ? binary_read(path, copy, (size_t)count)
+                                        : text_read(path, copy, (size_t)count);
+        double elapsed = bench_now() - start;
+        if (status != EXIT_SUCCESS || read != (size_t)count
+            || memcmp(records, copy, (size_t)count * SUDOKU_PUZZLE_LEN) != 0) {
+            fprintf(stderr, "%s: round trip failed\n", formats[f].label);
+            status = EXIT_FAILURE;
+        } else {
+            double megabytes = file_megabytes(path);
+            printf("%-6s %8d records %9.2f MB %6.1f bytes/record write %7.3f s read %7.3f s\n",
+                   formats[f].label, count, megabytes, megabytes * 1024.0 * 1024.0 / count, write, elapsed);
+        }
+        remove(path);
+    }
+
+    free(records);
+    free(copy);
+    free(packed);
+    return status;
+}
@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_cache.h"
+#include "problems/sudoku/sudoku_canonical.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Solution cache on a hard corpus in which every puzzle is a symmetric
+// variant of a handful of seeds: solving each puzzle against looking it up
+// by canonical form first and solving only on a miss. This is the path
+// solve_sudoku() takes, without its console output.
+//
+// Usage: bench_sudoku_cache [puzzle_count]
+
+static int solve_one(sudoku_ctx_t *ctx, const int puzzle[9][9]) {
+    sudoku_grid_from_rows(&ctx->puzzle, puzzle);
+    return solve_puzzle(ctx) == SCIP_OKAY && ctx->has_solution ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 2000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    sudoku_cache_t cache;
+    if (!corpus || sudoku_cache_init(&cache, SUDOKU_CACHE_DEFAULT_CAPACITY) != EXIT_SUCCESS) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 1313u);
+
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    int status = EXIT_SUCCESS;
+
+    double start = bench_now();
+    for (int n = 0; n < count && status == EXIT_SUCCESS; n++) {
+        status = solve_one(&ctx, (const int (*)[9])corpus[n]);
+    }
+    double solve_time = bench_now() - start;
+
+    start = bench_now();
+    for (int n = 0; n < count; n++) {
+        int canonical[9][9];
+        sudoku_canonicalize((const int (*)[9])corpus[n], canonical, NULL);
+    }
+    double canonical_time = bench_now() - start;
+
+    start = bench_now();
+    for (int n = 0; n < count && status == EXIT_SUCCESS; n++) {
+        int canonical[9][9];
+        sudoku_transform_t transform;
+        char key[SUDOKU_PUZZLE_LEN];
+        char cached[SUDOKU_PUZZLE_LEN];
+        sudoku_canonicalize((const int (*)[9])corpus[n], canonical, &transform);
+        sudoku_format_line((const int (*)[9])canonical, key);
+        if (sudoku_cache_lookup(&cache, key, cached)) {
+            for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+                canonical[cell / 9][cell % 9] = cached[cell] - '0';
+            }
+            sudoku_transform_invert(&transform, (const int (*)[9])canonical, sudoku_grid_rows(&ctx.puzzle));
+            continue;
+        }
+        status = solve_one(&ctx, (const int (*)[9])corpus[n]);
+        sudoku_transform_apply(&transform, (const int (*)[9])sudoku_grid_rows(&ctx.puzzle), canonical);
+        sudoku_format_line((const int (*)[9])canonical, cached);
+        sudoku_cache_insert(&cache, key, cached);
+    }
+    double cached_time = bench_now() - start;
+
+    if (status == EXIT_SUCCESS) {
+        sudoku_cache_stats_t stats;
+        sudoku_cache_get_stats(&cache, &stats);
+        printf("%-12s %8d puzzles %10.3f s %12.0f puzzles/s\n", "solve", count, solve_time, count / solve_time);
+        printf("%-12s %8d puzzles %10.3f s %12.0f puzzles/s\n", "canonical", count, canonical_time,
+               count / canonical_time);
+        printf("%-12s %8d puzzles %10.3f s %12.0f puzzles/s (%zu hits, %zu misses)\n", "cached", count,
+               cached_time, count / cached_time, stats.hits, stats.misses);
+    } else {
+        fprintf(stderr, "Solve failed\n");
+    }
+
+    sudoku_ctx_free(&ctx);
+    sudoku_cache_free(&cache);
+    free(corpus);
+    return status;
+}
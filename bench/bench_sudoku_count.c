@@ -0,0 +1,60 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_propagation.h"
+
+// Uniqueness check (solution count capped at 2) on the hard corpus, serial
+// against the search tree split over worker threads. Proving uniqueness
+// needs the full tree, so this is where the parallel split pays off.
+//
+// Usage: bench_sudoku_count [puzzle_count] [threads]
+
+static int run(const char *label, int threads, int (*corpus)[9][9], int count) {
+    long nodes = 0;
+    int unique = 0;
+    double start = bench_now();
+    for (int n = 0; n < count; n++) {
+        int grid[9][9];
+        int solutions = 0;
+        sudoku_native_stats_t stats;
+        memcpy(grid, corpus[n], sizeof(grid));
+        if (sudoku_native_count_parallel(grid, 2, threads, NULL, &stats, &solutions) != SUDOKU_NATIVE_SOLVED) {
+            fprintf(stderr, "%s: failed on puzzle %d\n", label, n);
+            return EXIT_FAILURE;
+        }
+        nodes += stats.nodes;
+        unique += solutions == 1;
+    }
+    double elapsed = bench_now() - start;
+
+    printf("%-9s %8d puzzles %10.3f s %10.1f us/puzzle %10.1f nodes/puzzle %6d unique\n",
+           label, count, elapsed, elapsed * 1e6 / count, (double)nodes / count, unique);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 500;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    if (!corpus) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 4242u);
+
+    int status = run("serial", 1, corpus, count);
+    if (status == EXIT_SUCCESS) {
+        status = run("parallel", threads, corpus, count);
+    }
+
+    free(corpus);
+    return status;
+}
@@ -0,0 +1,75 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Throughput of the Sudoku engines (propagation, DLX, SCIP) on a corpus of
+// hard puzzles. The native engines run without a budget so every engine
+// solves every puzzle on its own.
+//
+// Usage: bench_sudoku_engines [puzzle_count]
+
+typedef struct {
+    const char *label;
+    sudoku_engine_t engine;
+} engine_case_t;
+
+static const engine_case_t engines[] = {
+    {"native", SUDOKU_ENGINE_NATIVE},
+    {"dlx", SUDOKU_ENGINE_DLX},
+    {"scip", SUDOKU_ENGINE_SCIP}
+};
+
+static int run(const engine_case_t *engine, int (*corpus)[9][9], int count) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = engine->engine;
+    ctx.options.native_node_limit = 0;
+    ctx.options.native_time_limit = 0.0;
+
+    long nodes = 0;
+    int status = EXIT_SUCCESS;
+    double start = bench_now();
+    for (int n = 0; n < count; n++) {
+        sudoku_grid_from_rows(&ctx.puzzle, (const int (*)[9])corpus[n]);
+        if (solve_puzzle(&ctx) != SCIP_OKAY) {
+            fprintf(stderr, "%s: failed on puzzle %d\n", engine->label, n);
+            status = EXIT_FAILURE;
+            break;
+        }
+        nodes += ctx.native_stats.nodes;
+    }
+    double elapsed = bench_now() - start;
+    sudoku_ctx_free(&ctx);
+
+    if (status == EXIT_SUCCESS) {
+        printf("%-8s %8d puzzles %10.3f s %12.0f puzzles/s %10.1f nodes/puzzle\n",
+               engine->label, count, elapsed, count / elapsed, (double)nodes / count);
+    }
+    return status;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 2000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    if (!corpus) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 4242u);
+
+    int status = EXIT_SUCCESS;
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]) && status == EXIT_SUCCESS; e++) {
+        status = run(&engines[e], corpus, count);
+    }
+
+    free(corpus);
+    return status;
+}
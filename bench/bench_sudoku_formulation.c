@@ -0,0 +1,77 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// SCIP search effort of the linear, set-partitioning and all-different
+// Sudoku models on a hard corpus: branch-and-bound nodes, LP iterations
+// and wall time.
+//
+// Usage: bench_sudoku_formulation [puzzle_count]
+
+typedef struct {
+    const char *label;
+    sudoku_formulation_t formulation;
+} formulation_case_t;
+
+static const formulation_case_t formulations[] = {
+    {"linear", SUDOKU_FORMULATION_LINEAR},
+    {"setppc", SUDOKU_FORMULATION_SETPPC},
+    {"alldiff", SUDOKU_FORMULATION_ALLDIFF}
+};
+
+static int run(const formulation_case_t *formulation, int (*corpus)[9][9], int count) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    ctx.options.formulation = formulation->formulation;
+
+    SCIP_Longint nodes = 0;
+    SCIP_Longint lp_iterations = 0;
+    int status = EXIT_SUCCESS;
+    double start = bench_now();
+    for (int n = 0; n < count; n++) {
+        sudoku_grid_from_rows(&ctx.puzzle, (const int (*)[9])corpus[n]);
+        if (solve_puzzle(&ctx) != SCIP_OKAY || !ctx.has_solution) {
+            fprintf(stderr, "%s: failed on puzzle %d\n", formulation->label, n);
+            status = EXIT_FAILURE;
+            break;
+        }
+        nodes += SCIPgetNTotalNodes(ctx.scip);
+        lp_iterations += SCIPgetNLPIterations(ctx.scip);
+    }
+    double elapsed = bench_now() - start;
+    sudoku_ctx_free(&ctx);
+
+    if (status == EXIT_SUCCESS) {
+        printf("%-8s %8d puzzles %10.3f s %10.1f us/puzzle %8.2f nodes/puzzle %10.1f LP iter/puzzle\n",
+               formulation->label, count, elapsed, elapsed * 1e6 / count,
+               (double)nodes / count, (double)lp_iterations / count);
+    }
+    return status;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    if (!corpus) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 2024u);
+
+    int status = EXIT_SUCCESS;
+    for (size_t f = 0; f < sizeof(formulations) / sizeof(formulations[0]) && status == EXIT_SUCCESS; f++) {
+        status = run(&formulations[f], corpus, count);
+    }
+
+    free(corpus);
+    return status;
+}
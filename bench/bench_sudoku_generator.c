@@ -0,0 +1,58 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "problems/sudoku/sudoku_generator.h"
+#include "problems/sudoku/sudoku_parser.h"
+
+// Generator throughput per difficulty tier across all worker threads.
+//
+// Usage: bench_sudoku_generator [puzzle_count] [threads]
+
+typedef struct {
+    const char *label;
+    int clues;
+    sudoku_difficulty_t difficulty;
+} generator_case_t;
+
+static const generator_case_t cases[] = {
+    {"any/30", 30, SUDOKU_DIFFICULTY_ANY},
+    {"easy/35", 35, SUDOKU_DIFFICULTY_EASY},
+    {"medium/28", 28, SUDOKU_DIFFICULTY_MEDIUM},
+    {"hard/26", 26, SUDOKU_DIFFICULTY_HARD}
+};
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 5000;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    char *puzzles = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    if (!puzzles) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]) && status == EXIT_SUCCESS; c++) {
+        sudoku_generator_config_t config;
+        sudoku_generator_default_config(&config);
+        config.clues = cases[c].clues;
+        config.difficulty = cases[c].difficulty;
+        config.threads = threads;
+
+        sudoku_generator_stats_t stats;
+        status = sudoku_generate_batch((size_t)count, puzzles, NULL, NULL, &config, &stats);
+        if (status == EXIT_SUCCESS) {
+            printf("%-10s %8zu puzzles %6zu failed %2d threads %10.3f s %12.0f puzzles/s %8.2f grids/puzzle\n",
+                   cases[c].label, stats.generated, stats.failed, stats.threads, stats.elapsed,
+                   stats.puzzles_per_second, (double)stats.attempts / count);
+        }
+    }
+
+    free(puzzles);
+    return status;
+}
@@ -0,0 +1,78 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_hint.h"
+
+// Latency of sudoku_next_hint() as an app would see it: every puzzle of an
+// easy and a hard corpus is played out hint by hint, applying each one to
+// the grid and the candidate marks, until no technique applies. Reports
+// median, p99 and max per call and how often each technique fired.
+//
+// Usage: bench_sudoku_hint [puzzle_count]
+
+#define MAX_CALLS_PER_PUZZLE 512
+
+static void run(const char *label, int (*corpus)[9][9], int count, double *latencies) {
+    size_t techniques[SUDOKU_HINT_X_WING + 1] = {0};
+    size_t calls = 0;
+    size_t stuck = 0;
+    sudoku_hint_t hint;
+
+    for (int n = 0; n < count; n++) {
+        uint16_t marks[81] = {0};
+        for (int step = 0; step < MAX_CALLS_PER_PUZZLE; step++) {
+            double start = bench_now();
+            sudoku_hint_technique_t technique = sudoku_next_hint((const int (*)[9])corpus[n], marks, &hint);
+            latencies[calls++] = bench_now() - start;
+            techniques[technique]++;
+            if (technique == SUDOKU_HINT_NONE || technique == SUDOKU_HINT_CONTRADICTION) {
+                break;
+            }
+            sudoku_hint_apply(&hint, corpus[n], marks);
+        }
+        for (int cell = 0; cell < 81; cell++) {
+            if (corpus[n][cell / 9][cell % 9] == 0) {
+                stuck++;  // Needs more than the techniques above
+                break;
+            }
+        }
+    }
+
+    qsort(latencies, calls, sizeof(*latencies), bench_compare_doubles);
+    printf("%-6s %8zu calls %8.2f us median %8.2f us p99 %8.2f us max, %zu of %d puzzles left unfinished\n",
+           label, calls, bench_percentile(latencies, (int)calls, 0.50) * 1e6,
+           bench_percentile(latencies, (int)calls, 0.99) * 1e6, latencies[calls - 1] * 1e6, stuck, count);
+    for (int t = SUDOKU_HINT_CONTRADICTION; t <= SUDOKU_HINT_X_WING; t++) {
+        if (techniques[t] > 0) {
+            printf("  %-14s %8zu\n", sudoku_hint_technique_name((sudoku_hint_technique_t)t), techniques[t]);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    double *latencies = malloc((size_t)count * MAX_CALLS_PER_PUZZLE * sizeof(*latencies));
+    if (!corpus || !latencies) {
+        fprintf(stderr, "Out of memory\n");
+        free(corpus);
+        free(latencies);
+        return EXIT_FAILURE;
+    }
+
+    bench_make_corpus(corpus, count, 1234u);
+    run("easy", corpus, count, latencies);
+    bench_make_hard_corpus(corpus, count, 4242u);
+    run("hard", corpus, count, latencies);
+
+    free(corpus);
+    free(latencies);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Compares rebuilding the SCIP model for every puzzle against reusing the
+// persistent model template (prepare_model() + fix_variables()) and against
+// building a reduced per-puzzle model without givens (build_reduced_model()).
+//
+// Usage: bench_sudoku_model [puzzle_count]
+
+static SCIP_RETCODE solve_rebuild(sudoku_ctx_t *ctx, const int grid[9][9]) {
+    sudoku_grid_from_rows(&ctx->puzzle, grid);
+    SCIP_CALL(init_model(ctx));
+    SCIP_CALL(add_variables(ctx));
+    SCIP_CALL(create_constraints(ctx));
+    SCIP_CALL(fix_variables(ctx));
+    SCIP_CALL(solve(ctx));
+    SCIP_CALL(free_model(ctx));
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE solve_template(sudoku_ctx_t *ctx, const int grid[9][9]) {
+    sudoku_grid_from_rows(&ctx->puzzle, grid);
+    SCIP_CALL(prepare_model(ctx));
+    SCIP_CALL(fix_variables(ctx));
+    SCIP_CALL(solve(ctx));
+    return SCIP_OKAY;
+}
+
+static long reduced_vars = 0;
+static long reduced_conss = 0;
+
+static SCIP_RETCODE solve_reduced(sudoku_ctx_t *ctx, const int grid[9][9]) {
+    sudoku_grid_from_rows(&ctx->puzzle, grid);
+    SCIP_CALL(build_reduced_model(ctx));
+    reduced_vars += ctx->model_vars;
+    reduced_conss += ctx->model_conss;
+    SCIP_CALL(solve(ctx));
+    SCIP_CALL(free_model(ctx));
+    return SCIP_OKAY;
+}
+
+static int run(const char *label, SCIP_RETCODE (*solver)(sudoku_ctx_t *, const int[9][9]),
+               sudoku_ctx_t *ctx, int (*corpus)[9][9], int count, double *elapsed) {
+    double start = bench_now();
+    for (int n = 0; n < count; n++) {
+        if (solver(ctx, (const int (*)[9])corpus[n]) != SCIP_OKAY) {
+            fprintf(stderr, "%s: failed on puzzle %d\n", label, n);
+            return EXIT_FAILURE;
+        }
+    }
+    *elapsed = bench_now() - start;
+
+    printf("%-10s %8d puzzles %10.3f s %10.1f us/puzzle\n",
+           label, count, *elapsed, *elapsed * 1e6 / count);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 2000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    if (!corpus) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    bench_make_corpus(corpus, count, 12345u);
+
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+
+    double rebuild_time = 0.0;
+    double template_time = 0.0;
+    double reduced_time = 0.0;
+    int status = run("rebuild", solve_rebuild, &ctx, corpus, count, &rebuild_time);
+    if (status == EXIT_SUCCESS) {
+        status = run("template", solve_template, &ctx, corpus, count, &template_time);
+    }
+    if (status == EXIT_SUCCESS) {
+        // The reduced model replaces the template, so it runs last
+        status = run("reduced", solve_reduced, &ctx, corpus, count, &reduced_time);
+    }
+    sudoku_ctx_free(&ctx);
+
+    if (status == EXIT_SUCCESS && template_time > 0.0 && reduced_time > 0.0) {
+        printf("speedup    %.2fx (template), %.2fx (reduced)\n",
+               rebuild_time / template_time, rebuild_time / reduced_time);
+        printf("reduced model: %.1f vars, %.1f constraints per puzzle (full: 729 vars, 324 constraints)\n",
+               (double)reduced_vars / count, (double)reduced_conss / count);
+    }
+
+    free(corpus);
+    return status;
+}
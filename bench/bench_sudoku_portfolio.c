@@ -0,0 +1,95 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_portfolio.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Per-puzzle latency of the native engine, SCIP and the portfolio race on
+// a hard corpus (median, p99, max), followed by the race winners per
+// puzzle class. The native engine runs without a budget.
+//
+// Usage: bench_sudoku_portfolio [puzzle_count]
+
+typedef struct {
+    const char *label;
+    sudoku_engine_t engine;
+} engine_case_t;
+
+static const engine_case_t engines[] = {
+    {"native", SUDOKU_ENGINE_NATIVE},
+    {"scip", SUDOKU_ENGINE_SCIP},
+    {"portfolio", SUDOKU_ENGINE_PORTFOLIO}
+};
+
+static int run(const engine_case_t *engine, int (*corpus)[9][9], int count, double *latencies) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = engine->engine;
+    ctx.options.native_node_limit = 0;
+    ctx.options.native_time_limit = 0.0;
+
+    int status = EXIT_SUCCESS;
+    for (int n = 0; n < count; n++) {
+        sudoku_grid_from_rows(&ctx.puzzle, (const int (*)[9])corpus[n]);
+        double start = bench_now();
+        if (solve_puzzle(&ctx) != SCIP_OKAY) {
+            fprintf(stderr, "%s: failed on puzzle %d\n", engine->label, n);
+            status = EXIT_FAILURE;
+            break;
+        }
+        latencies[n] = bench_now() - start;
+    }
+    sudoku_ctx_free(&ctx);
+
+    if (status == EXIT_SUCCESS) {
+        bench_print_latency(engine->label, latencies, count);
+    }
+    return status;
+}
+
+static void print_winners(void) {
+    sudoku_portfolio_stats_t stats;
+    sudoku_portfolio_get_stats(&stats);
+    for (int c = 0; c < SUDOKU_CLASS_COUNT; c++) {
+        const sudoku_portfolio_class_stats_t *cls = &stats.classes[c];
+        if (cls->races == 0) {
+            continue;
+        }
+        printf("  %-8s %8zu races %8zu native %8zu scip %10.1f us mean %10.1f us max\n",
+               sudoku_puzzle_class_name((sudoku_puzzle_class_t)c), cls->races, cls->native_wins, cls->scip_wins,
+               cls->seconds * 1e6 / (double)cls->races, cls->max_seconds * 1e6);
+    }
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 500;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    double *latencies = malloc((size_t)count * sizeof(*latencies));
+    if (!corpus || !latencies) {
+        fprintf(stderr, "Out of memory\n");
+        free(corpus);
+        free(latencies);
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 4242u);
+
+    sudoku_portfolio_reset_stats();
+    int status = EXIT_SUCCESS;
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]) && status == EXIT_SUCCESS; e++) {
+        status = run(&engines[e], corpus, count, latencies);
+    }
+    if (status == EXIT_SUCCESS) {
+        print_winners();
+    }
+
+    free(corpus);
+    free(latencies);
+    return status;
+}
@@ -0,0 +1,79 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Solve time of the Sudoku SCIP model as the box order n grows (4x4 up to
+// 36x36), built per puzzle without givens (options.reduced_model). Puzzles are random relabelings of a patterned solved
+// grid with a fixed fraction of cells blanked, so every instance is
+// feasible and the difficulty per order is comparable.
+//
+// Usage: bench_sudoku_scaling [puzzles_per_order] [max_order] [blank_percent]
+
+static void make_puzzle(sudoku_grid_t *grid, int blank_percent, uint32_t *state) {
+    int size = grid->size;
+    int order = grid->order;
+    int digits[SUDOKU_MAX_SIZE];
+    for (int d = 0; d < size; d++) {
+        digits[d] = d + 1;
+    }
+    bench_shuffle(digits, size, state);
+
+    for (int cell = 0; cell < size * size; cell++) {
+        int row = cell / size;
+        int col = cell % size;
+        int value = ((row % order) * order + row / order + col) % size;
+        bool blank = (int)(bench_rand(state) % 100u) < blank_percent;
+        grid->cells[cell] = blank ? 0 : digits[value];
+    }
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 20;
+    int max_order = argc > 2 ? atoi(argv[2]) : 5;
+    int blank_percent = argc > 3 ? atoi(argv[3]) : 60;
+    if (count <= 0 || max_order < SUDOKU_MIN_ORDER || max_order > SUDOKU_MAX_ORDER ||
+        blank_percent < 0 || blank_percent > 100) {
+        fprintf(stderr, "Invalid arguments\n");
+        return EXIT_FAILURE;
+    }
+
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    ctx.options.reduced_model = true;
+
+    printf("%-7s %-7s %10s %10s %14s\n", "order", "grid", "vars", "conss", "ms/puzzle");
+    uint32_t state = 12345u;
+    for (int order = SUDOKU_MIN_ORDER; order <= max_order; order++) {
+        long vars = 0;
+        long conss = 0;
+        double elapsed = 0.0;
+
+        for (int n = 0; n < count; n++) {
+            sudoku_grid_init(&ctx.puzzle, order);
+            make_puzzle(&ctx.puzzle, blank_percent, &state);
+
+            double start = bench_now();
+            SCIP_RETCODE retcode = solve_puzzle(&ctx);
+            elapsed += bench_now() - start;
+
+            if (retcode != SCIP_OKAY || !ctx.has_solution) {
+                fprintf(stderr, "order %d: failed on puzzle %d\n", order, n);
+                sudoku_ctx_free(&ctx);
+                return EXIT_FAILURE;
+            }
+            vars += ctx.model_vars;
+            conss += ctx.model_conss;
+        }
+
+        char grid[16];
+        snprintf(grid, sizeof(grid), "%dx%d", order * order, order * order);
+        printf("%-7d %-7s %10.1f %10.1f %14.3f\n", order, grid, (double)vars / count, (double)conss / count,
+               elapsed * 1e3 / count);
+    }
+    sudoku_ctx_free(&ctx);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_session.h"
+
+// Per-edit latency of an interactive session against solving every edited
+// grid from scratch, for the native engine and SCIP. Each puzzle of a hard
+// corpus gets a scripted run of edits: mostly correct entries, some wrong
+// digits and some erasures, like a player would make.
+//
+// Usage: bench_sudoku_session [puzzle_count] [edits_per_puzzle]
+
+typedef struct {
+    int row;
+    int col;
+    int digit;
+} edit_t;
+
+typedef struct {
+    const char *label;
+    sudoku_engine_t engine;
+} engine_case_t;
+
+static const engine_case_t engines[] = {
+    {"native", SUDOKU_ENGINE_NATIVE},
+    {"scip", SUDOKU_ENGINE_SCIP}
+};
+
+static void make_script(const int puzzle[9][9], const int solution[9][9], edit_t *script, int edits, uint32_t *rng) {
+    for (int e = 0; e < edits; e++) {
+        int cell;
+        do {
+            cell = (int)(bench_rand(rng) % 81);
+        } while (puzzle[cell / 9][cell % 9] != 0);
+        uint32_t kind = bench_rand(rng) % 4;
+        script[e].row = cell / 9;
+        script[e].col = cell % 9;
+        script[e].digit = kind < 2 ? solution[cell / 9][cell % 9] : kind == 2 ? (int)(bench_rand(rng) % 9) + 1 : 0;
+    }
+}
+
+static int run(const engine_case_t *engine, int (*corpus)[9][9], int count, const edit_t *scripts, int edits) {
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.engine = engine->engine;
+    options.native_node_limit = 0;
+    options.native_time_limit = 0.0;
+
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options = options;
+    sudoku_session_t session;
+    sudoku_session_init(&session, &options);
+
+    double scratch = 0.0;
+    double incremental = 0.0;
+    int status = EXIT_SUCCESS;
+    for (int n = 0; n < count && status == EXIT_SUCCESS; n++) {
+        int grid[9][9];
+        memcpy(grid, corpus[n], sizeof(grid));
+        if (sudoku_session_load(&session, (const int (*)[9])grid) != SUDOKU_SESSION_SOLVED) {
+            fprintf(stderr, "%s: failed to load puzzle %d\n", engine->label, n);
+            status = EXIT_FAILURE;
+            break;
+        }
+        for (int e = 0; e < edits; e++) {
+            const edit_t *edit = &scripts[n * edits + e];
+            grid[edit->row][edit->col] = edit->digit;
+
+            double start = bench_now();
+            sudoku_grid_from_rows(&ctx.puzzle, (const int (*)[9])grid);
+            SCIP_RETCODE retcode = solve_puzzle(&ctx);
+            scratch += bench_now() - start;
+
+            start = bench_now();
+            sudoku_session_status_t result = sudoku_session_set_cell(&session, edit->row, edit->col, edit->digit);
+            incremental += bench_now() - start;
+
+            if (retcode != SCIP_OKAY || result == SUDOKU_SESSION_ERROR
+                || ctx.has_solution != (result == SUDOKU_SESSION_SOLVED)) {
+                fprintf(stderr, "%s: results differ on puzzle %d, edit %d\n", engine->label, n, e);
+                status = EXIT_FAILURE;
+                break;
+            }
+        }
+    }
+
+    if (status == EXIT_SUCCESS) {
+        double total = (double)count * edits;
+        printf("%-7s %8.0f edits %10.1f us/edit from scratch %10.1f us/edit in session (%.1fx), "
+               "%zu revalidated, %zu re-solved\n",
+               engine->label, total, scratch * 1e6 / total, incremental * 1e6 / total,
+               incremental > 0 ? scratch / incremental : 0.0, session.stats.revalidated, session.stats.resolved);
+    }
+    sudoku_session_free(&session);
+    sudoku_ctx_free(&ctx);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100;
+    int edits = argc > 2 ? atoi(argv[2]) : 40;
+    if (count <= 0 || edits <= 0) {
+        fprintf(stderr, "Invalid puzzle or edit count\n");
+        return EXIT_FAILURE;
+    }
+
+    int (*corpus)[9][9] = malloc((size_t)count * sizeof(*corpus));
+    edit_t *scripts = malloc((size_t)count * (size_t)edits * sizeof(*scripts));
+    if (!corpus || !scripts) {
+        fprintf(stderr, "Out of memory\n");
+        free(corpus);
+        free(scripts);
+        return EXIT_FAILURE;
+    }
+    bench_make_hard_corpus(corpus, count, 4242u);
+
+    // Scripts are based on each puzzle's solution, found once up front
+    uint32_t rng = 99u;
+    for (int n = 0; n < count; n++) {
+        int solution[9][9];
+        memcpy(solution, corpus[n], sizeof(solution));
+        sudoku_native_solve(solution, NULL, NULL);
+        make_script((const int (*)[9])corpus[n], (const int (*)[9])solution, &scripts[n * edits], edits, &rng);
+    }
+
+    int status = EXIT_SUCCESS;
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]) && status == EXIT_SUCCESS; e++) {
+        status = run(&engines[e], corpus, count, scripts, edits);
+    }
+
+    free(corpus);
+    free(scripts);
+    return status;
+}
@@ -0,0 +1,74 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_stream.h"
+
+// Streaming file throughput on a hard corpus for growing worker pools.
+//
+// Usage: bench_sudoku_stream [puzzle_count]
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    if (count <= 0) {
+        fprintf(stderr, "Invalid puzzle count\n");
+        return EXIT_FAILURE;
+    }
+
+    char input_path[64];
+    char output_path[64];
+    snprintf(input_path, sizeof(input_path), "/tmp/bench_sudoku_stream_%ld.txt", (long)getpid());
+    snprintf(output_path, sizeof(output_path), "/tmp/bench_sudoku_stream_%ld.out", (long)getpid());
+
+    // Cycle a small hard corpus instead of holding every puzzle in memory
+    enum { CORPUS = 1024 };
+    static int corpus[CORPUS][9][9];
+    bench_make_hard_corpus(corpus, CORPUS, 777u);
+    FILE *input = fopen(input_path, "wb");
+    if (!input) {
+        perror(input_path);
+        return EXIT_FAILURE;
+    }
+    for (int n = 0; n < count; n++) {
+        char line[SUDOKU_PUZZLE_LEN + 1];
+        for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+            line[cell] = (char)('0' + corpus[n % CORPUS][cell / 9][cell % 9]);
+        }
+        line[SUDOKU_PUZZLE_LEN] = '\n';
+        fwrite(line, 1, sizeof(line), input);
+    }
+    if (fclose(input) != 0) {
+        perror(input_path);
+        return EXIT_FAILURE;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int status = EXIT_SUCCESS;
+    for (int threads = 1; status == EXIT_SUCCESS; threads *= 2) {
+        if (threads > cpus) {
+            threads = (int)cpus;
+        }
+
+        sudoku_batch_config_t config;
+        sudoku_batch_default_config(&config);
+        config.threads = threads;
+        sudoku_batch_stats_t stats;
+
+        status = solve_sudoku_file(input_path, output_path, &config, &stats);
+        if (status == EXIT_SUCCESS) {
+            double megabytes = (double)count * (SUDOKU_PUZZLE_LEN + 1) / (1024.0 * 1024.0);
+            printf("%3d threads %8d puzzles %10.3f s %12.0f puzzles/s %8.1f MB/s (%zu solved, %zu failed)\n",
+                   stats.threads, count, stats.elapsed, stats.puzzles_per_second,
+                   stats.elapsed > 0.0 ? megabytes / stats.elapsed : 0.0, stats.solved, stats.failed);
+        }
+        if (threads >= cpus) {
+            break;
+        }
+    }
+
+    remove(input_path);
+    remove(output_path);
+    return status;
+}
@@ -0,0 +1,102 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_corpus.h"
+#include "problems/sudoku/sudoku_parser.h"
+#include "problems/sudoku/sudoku_propagation.h"
+#include "problems/sudoku/sudoku_verify.h"
+
+// Verification throughput: sudoku_verify_batch() (SIMD when the build
+// targets AVX2) against sudoku_verify_record() per grid, with and without
+// the givens check. The grids are solutions of a hard corpus, with every
+// 64th one corrupted so both outcomes occur.
+//
+// Usage: bench_sudoku_verify [grid_count] [passes]
+
+typedef size_t (*verify_fn_t)(const char *solutions, const char *puzzles, size_t count);
+
+static size_t verify_scalar(const char *solutions, const char *puzzles, size_t count) {
+    size_t valid = 0;
+    for (size_t n = 0; n < count; n++) {
+        valid += sudoku_verify_record(solutions + n * SUDOKU_PUZZLE_LEN,
+                                      puzzles ? puzzles + n * SUDOKU_PUZZLE_LEN : NULL);
+    }
+    return valid;
+}
+
+static size_t verify_batch(const char *solutions, const char *puzzles, size_t count) {
+    return sudoku_verify_batch(solutions, puzzles, count, NULL);
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    int passes = argc > 2 ? atoi(argv[2]) : 10;
+    if (count <= 0 || passes <= 0) {
+        fprintf(stderr, "Invalid grid or pass count\n");
+        return EXIT_FAILURE;
+    }
+
+    enum { CORPUS = 1024 };
+    static int corpus[CORPUS][9][9];
+    static char puzzle_lines[CORPUS][SUDOKU_PUZZLE_LEN];
+    static char solution_lines[CORPUS][SUDOKU_PUZZLE_LEN];
+    bench_make_hard_corpus(corpus, CORPUS, 31337u);
+    for (int n = 0; n < CORPUS; n++) {
+        sudoku_format_line((const int (*)[9])corpus[n], puzzle_lines[n]);
+        sudoku_native_solve(corpus[n], NULL, NULL);
+        sudoku_format_line((const int (*)[9])corpus[n], solution_lines[n]);
+    }
+
+    char *solutions = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    char *puzzles = malloc((size_t)count * SUDOKU_PUZZLE_LEN);
+    if (!solutions || !puzzles) {
+        fprintf(stderr, "Out of memory\n");
+        free(solutions);
+        free(puzzles);
+        return EXIT_FAILURE;
+    }
+    for (int n = 0; n < count; n++) {
+        char *grid = solutions + (size_t)n * SUDOKU_PUZZLE_LEN;
+        memcpy(grid, solution_lines[n % CORPUS], SUDOKU_PUZZLE_LEN);
+        memcpy(puzzles + (size_t)n * SUDOKU_PUZZLE_LEN, puzzle_lines[n % CORPUS], SUDOKU_PUZZLE_LEN);
+        if (n % 64 == 63) {
+            grid[n % SUDOKU_PUZZLE_LEN] = grid[n % SUDOKU_PUZZLE_LEN] == '9' ? '1' : (char)(grid[n % SUDOKU_PUZZLE_LEN] + 1);
+        }
+    }
+
+    const struct {
+        const char *label;
+        verify_fn_t verify;
+        bool givens;
+    } cases[] = {
+        {"scalar", verify_scalar, false},
+        {"batch", verify_batch, false},
+        {"scalar+givens", verify_scalar, true},
+        {"batch+givens", verify_batch, true}
+    };
+    int status = EXIT_SUCCESS;
+    size_t expected = 0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        size_t valid = 0;
+        double start = bench_now();
+        for (int p = 0; p < passes; p++) {
+            valid = cases[c].verify(solutions, cases[c].givens ? puzzles : NULL, (size_t)count);
+        }
+        double elapsed = bench_now() - start;
+        if (c == 0) {
+            expected = valid;
+        } else if (valid != expected) {
+            fprintf(stderr, "%s: %zu valid grids, expected %zu\n", cases[c].label, valid, expected);
+            status = EXIT_FAILURE;
+        }
+        double grids = (double)count * passes;
+        printf("%-14s %10.0f grids %8.3f s %8.1f M grids/s (%zu valid per pass)\n", cases[c].label, grids,
+               elapsed, elapsed > 0.0 ? grids / elapsed * 1e-6 : 0.0, valid);
+    }
+
+    free(solutions);
+    free(puzzles);
+    return status;
+}
@@ -7,11 +7,44 @@ typedef enum {
     TYPE_INVALID
 } problem_manager_type_t;
 
+typedef enum {
+    ENGINE_DEFAULT,
+    ENGINE_SCIP,
+    ENGINE_NATIVE,
+    ENGINE_DLX,
+    ENGINE_PORTFOLIO,   // Sudoku: native engine and SCIP raced, first answer wins
+    ENGINE_LP           // Fertilizer: LP-only backend, without the SCIP fallback
+} problem_manager_engine_t;
+
+// Zero-initialized options select the defaults
+typedef struct {
+    problem_manager_engine_t engine;  // Fertilizer mixing by default uses ENGINE_LP, falling back to SCIP
+    int solution_cap;                 // Sudoku only: > 0 counts solutions up to the cap (2 checks uniqueness)
+    int threads;                      // Sudoku counting threads, <= 0 for the default of one
+
+    // Per-request bounds, <= 0 for none. Time and nodes bound the native,
+    // DLX, counting and SCIP searches (limits/time, limits/nodes); memory
+    // bounds SCIP only (limits/memory)
+    double time_limit;                // Seconds
+    long node_limit;                  // Search nodes, branch-and-bound nodes in SCIP
+    double memory_limit;              // Megabytes
+} problem_manager_options_t;
+
+// solver_result_t.status when a limit stopped the search; solution then
+// holds the best incumbent or the partial grid, and gap the relative gap
+#define PROBLEM_MANAGER_LIMIT_REACHED 2
+
 typedef struct {
     int status;
     char *message;
+    char *solution;      // Problem-specific solution text, NULL if none
+    int solution_count;  // Sudoku counting mode: solutions found, capped at solution_cap; 0 otherwise
+    double gap;          // PROBLEM_MANAGER_LIMIT_REACHED: relative gap at the stop; 0 otherwise
 } solver_result_t;
 
 solver_result_t problem_manager_dispatch_solver(problem_manager_type_t type, const char *data);
+solver_result_t problem_manager_dispatch_solver_with_options(problem_manager_type_t type, const char *data,
+                                                             const problem_manager_options_t *options);
+void problem_manager_free_result(solver_result_t *result);
 
 #endif
@@ -0,0 +1,105 @@
+#ifndef FERTILIZER_BASIS_CACHE_H
+#define FERTILIZER_BASIS_CACHE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+
+// Recent optimal LP bases per catalog, so quotes whose prices and targets
+// stay inside the region where an earlier basis is optimal are answered
+// without a solve. A catalog is the constraint matrix (products and their
+// nutrient fractions); prices, product limits, targets and area are free to
+// change between lookups.
+//
+// Bases are taken from the LP with a row for every nutrient (all_rows),
+// written as A x - s = 0 with s the nutrient activities. Each stores its
+// dense B^-1 (at most 16 x 16), so a lookup only checks the basis against
+// the new data:
+//   - Primal: x_B = -B^-1 N z_N, with nonbasic products and activities at
+//     the bounds their status names, stays within bounds
+//   - Dual: reduced costs c_j - c_B^T B^-1 a_j have the sign of their status
+// A basis passing both is optimal and gives the answer directly. Every call
+// takes the cache lock.
+
+#define FERTILIZER_BASIS_CACHE_DEFAULT_CAPACITY 64      // Catalogs
+#define FERTILIZER_BASIS_CACHE_BASES 4                  // Bases kept per catalog, most recent first
+
+// Relative tolerance of both checks, SoPlex's default feasibility tolerance
+#define FERTILIZER_BASIS_CACHE_TOLERANCE 1e-6
+
+typedef struct {
+    int *status;        // SCIP_BASESTAT of the products, then of the rows
+    int basic[FERTILIZER_MAX_NUTRIENTS];     // Basic variable of each B column: product i, or product_count + row
+    double inverse[FERTILIZER_MAX_NUTRIENTS * FERTILIZER_MAX_NUTRIENTS];   // B^-1, row-major
+} fertilizer_cached_basis_t;
+
+typedef struct {
+    uint64_t hash;
+    int product_count;
+    int nutrient_count;
+    double *content;    // Nutrient fractions, product-major (nutrient_count per product)
+    int *statuses;      // Storage behind bases[].status
+    fertilizer_cached_basis_t bases[FERTILIZER_BASIS_CACHE_BASES];
+    int basis_count;
+    uint64_t last_used;
+} fertilizer_basis_catalog_t;
+
+typedef struct {
+    size_t hits;            // Answered from a cached basis
+    size_t misses;
+    size_t warm_starts;     // Misses whose catalog had a basis to start the simplex from
+    size_t insertions;      // Bases stored
+    size_t evictions;       // Catalogs dropped for new ones
+    size_t entries;         // Catalogs cached
+    size_t capacity;
+    double hit_rate;        // hits / (hits + misses), 0 before the first lookup
+} fertilizer_basis_cache_stats_t;
+
+typedef struct {
+    fertilizer_basis_catalog_t *catalogs;
+    size_t capacity;
+    size_t count;
+    uint64_t clock;         // Lookup and insert counter for least recently used eviction
+    fertilizer_basis_cache_stats_t stats;
+    pthread_mutex_t lock;
+} fertilizer_basis_cache_t;
+
+// capacity 0 makes a cache that stores nothing but still counts misses
+int fertilizer_basis_cache_init(fertilizer_basis_cache_t *cache, size_t capacity);
+void fertilizer_basis_cache_free(fertilizer_basis_cache_t *cache);
+
+// Tries the catalog's bases, most recent first. On a hit fills solution
+// (fertilizer_solution_init()ed for problem) with the optimal blend, copies
+// that basis to col_basis (product_count entries) and row_basis
+// (nutrient_count) and returns true. On a miss copies the catalog's most
+// recent basis there instead, if it has one, and sets *warm.
+bool fertilizer_basis_cache_lookup(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                   fertilizer_solution_t *solution, int *col_basis, int *row_basis, bool *warm);
+
+// Stores an optimal basis (SCIPlpiGetBase() of the all_rows LP) as the
+// catalog's most recent one. Bases with a singular B are ignored.
+void fertilizer_basis_cache_insert(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                   const int *col_basis, const int *row_basis);
+
+// Fills basis->basic and basis->inverse from SCIP_BASESTAT statuses of the
+// all_rows LP (basis->status is left alone). False unless exactly
+// nutrient_count variables are basic and B is regular.
+bool fertilizer_basis_invert(const fertilizer_problem_t *problem, const int *col_basis, const int *row_basis,
+                             fertilizer_cached_basis_t *basis);
+
+// Bounds of variable v of A x - s = 0: product v, or the activity of row
+// v - product_count (area times the nutrient's min and max)
+void fertilizer_basis_variable_bounds(const fertilizer_problem_t *problem, int v, double *lower, double *upper);
+
+// Drops all entries and resets the counters
+void fertilizer_basis_cache_clear(fertilizer_basis_cache_t *cache);
+void fertilizer_basis_cache_get_stats(fertilizer_basis_cache_t *cache, fertilizer_basis_cache_stats_t *stats);
+
+// Process-wide cache used by solve_fertilizer_mixing(), created on first use
+// with FERTILIZER_BASIS_CACHE_DEFAULT_CAPACITY; NULL if it could not be
+// allocated
+fertilizer_basis_cache_t *fertilizer_basis_cache(void);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef FERTILIZER_LP_H
+#define FERTILIZER_LP_H
+
+#include <stdbool.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_basis_cache.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+
+// LP-only backend: the blend LP goes straight into SoPlex through SCIP's LP
+// interface, without a SCIP instance, plugins or problem transformation.
+//
+// The model is the one of fertilizer_mixing_solver.h, stored as a sparse
+// column-major matrix: column i is product i, row r is the r-th nutrient
+// with a bound.
+
+typedef struct {
+    int ncols;
+    int nrows;
+    int nnonz;
+    double *obj;                            // Price per kg
+    double *lb;
+    double *ub;                             // The build's infinity where open
+    double *lhs;                            // area * min
+    double *rhs;                            // area * max, the build's infinity where open
+    int *beg;                               // Column starts in ind/val, ncols entries
+    int *ind;                               // Row indices
+    double *val;                            // Nutrient fractions
+    int row_nutrient[FERTILIZER_MAX_NUTRIENTS];  // Nutrient index of each row
+} fertilizer_lp_matrix_t;
+
+// Open bounds are stored as infinity (SCIPlpiInfinity() of the target LP).
+// With all_rows set, nutrients without bounds get a row as well, so targets
+// can be set later by changing row sides; such a row is 0 <= activity (lhs
+// min * area = 0, rhs infinity), which nonnegative contents always meet. Returns EXIT_SUCCESS or
+// EXIT_FAILURE when out of memory.
+int fertilizer_lp_matrix_build(const fertilizer_problem_t *problem, double infinity, bool all_rows,
+                               fertilizer_lp_matrix_t *matrix);
+void fertilizer_lp_matrix_free(fertilizer_lp_matrix_t *matrix);
+
+// Creates *lpi (quiet, minimizing) unless it exists; an LPI is reused by
+// loading the next matrix into it, which replaces the previous LP
+SCIP_RETCODE fertilizer_lp_create(SCIP_LPI **lpi);
+SCIP_RETCODE fertilizer_lp_load(SCIP_LPI *lpi, const fertilizer_lp_matrix_t *matrix);
+
+// Reads the result of the last solve of lpi into solution: status and, if
+// optimal, cost, amounts and binding flags
+SCIP_RETCODE fertilizer_lp_extract(SCIP_LPI *lpi, const fertilizer_problem_t *problem,
+                                   fertilizer_solution_t *solution);
+
+// Solves problem into solution (fertilizer_solution_init()ed for it) with
+// the dual simplex, which starts from the dual feasible slack basis when
+// prices are non-negative, and with sensitivity set fills
+// solution->sensitivity from the final basis (fertilizer_sensitivity.h).
+SCIP_RETCODE fertilizer_lp_solve(SCIP_LPI **lpi, const fertilizer_problem_t *problem,
+                                 fertilizer_solution_t *solution, bool sensitivity);
+
+// Like fertilizer_lp_solve(), but answers from cache when one of the
+// catalog's bases is still optimal (*from_cache is then set and no LP is
+// touched). Otherwise the LP, built with all_rows, starts from the
+// catalog's most recent basis if there is one, and its optimal basis is
+// added to the cache.
+SCIP_RETCODE fertilizer_lp_solve_cached(SCIP_LPI **lpi, fertilizer_basis_cache_t *cache,
+                                        const fertilizer_problem_t *problem, fertilizer_solution_t *solution,
+                                        bool sensitivity, bool *from_cache);
+
+#endif
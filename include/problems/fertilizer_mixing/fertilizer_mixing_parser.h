@@ -0,0 +1,137 @@
+#ifndef FERTILIZER_MIXING_PARSER_H
+#define FERTILIZER_MIXING_PARSER_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Least-cost blend request (JSON):
+//   {
+//     "area": 12.5,                                   hectares, default 1
+//     "nutrients": {                                  targets in kg/ha
+//       "N": {"min": 120, "max": 160},
+//       "P2O5": {"min": 60},
+//       "Zn": {"max": 1.5}
+//     },
+//     "products": [                                   the catalog
+//       {"name": "Urea", "price": 0.52,               price per kg
+//        "composition": {"N": 0.46},                  mass fractions
+//        "min": 0, "available": 4000}                 kg for the whole area
+//     ]
+//   }
+// Missing bounds are open. Composition entries for nutrients without a
+// target are ignored. Parsing rejects malformed input and inconsistent
+// bounds, so solvers only see well-formed problems.
+
+#define FERTILIZER_MAX_NUTRIENTS 16
+#define FERTILIZER_MAX_PRODUCTS 4096
+#define FERTILIZER_NAME_LEN 32
+#define FERTILIZER_UNLIMITED HUGE_VAL
+
+typedef struct {
+    char name[FERTILIZER_NAME_LEN];
+    double min;                 // kg/ha, 0 if not given
+    double max;                 // kg/ha, FERTILIZER_UNLIMITED if not given
+} fertilizer_nutrient_t;
+
+typedef struct {
+    char name[FERTILIZER_NAME_LEN];
+    double price;                                   // Per kg
+    double content[FERTILIZER_MAX_NUTRIENTS];       // Mass fraction of each problem nutrient
+    double min_amount;                              // kg, 0 if not given
+    double max_amount;                              // kg, FERTILIZER_UNLIMITED if not given
+} fertilizer_product_t;
+
+typedef struct {
+    double area;
+    int nutrient_count;
+    fertilizer_nutrient_t nutrients[FERTILIZER_MAX_NUTRIENTS];
+    int product_count;
+    fertilizer_product_t *products;
+} fertilizer_problem_t;
+
+typedef enum {
+    FERTILIZER_BOUND_NONE,
+    FERTILIZER_BOUND_MIN,
+    FERTILIZER_BOUND_MAX
+} fertilizer_bound_t;
+
+typedef enum {
+    FERTILIZER_OPTIMAL,
+    FERTILIZER_INFEASIBLE,      // No blend meets the targets within the availability limits
+    FERTILIZER_UNBOUNDED,       // Negative prices without availability limits
+    FERTILIZER_NOT_SOLVED       // Solver stopped without a proof
+} fertilizer_status_t;
+
+// Sensitivity of an LP optimum, read from its final basis. Every value
+// holds as long as that basis stays optimal: prices within their ranges
+// keep the blend's composition, and within a target's range each extra
+// kg/ha costs the shadow price.
+typedef struct {
+    bool valid;                                             // Only blends solved by the LP backend have it
+    double *reduced_cost;                                   // Per product and kg: 0 for products in the blend
+    double *price_low;                                      // Per product: price range, infinite where open
+    double *price_high;
+    double shadow_price[FERTILIZER_MAX_NUTRIENTS];          // Cost per extra kg/ha of the target, 0 if not binding
+    double target_low[FERTILIZER_MAX_NUTRIENTS];            // Range of the binding target in kg/ha, NAN if none binds
+    double target_high[FERTILIZER_MAX_NUTRIENTS];
+} fertilizer_sensitivity_t;
+
+typedef struct {
+    fertilizer_status_t status;
+    double cost;
+    double *amounts;                                        // kg per product
+    fertilizer_bound_t *product_binding;                    // Amount at min (if > 0) or availability
+    double supplied[FERTILIZER_MAX_NUTRIENTS];              // kg/ha per nutrient
+    fertilizer_bound_t nutrient_binding[FERTILIZER_MAX_NUTRIENTS];
+    fertilizer_sensitivity_t sensitivity;
+} fertilizer_solution_t;
+
+// Both return EXIT_SUCCESS or EXIT_FAILURE with *error_msg (if not NULL)
+// set to a strdup()ed reason
+int fertilizer_parse(const char *data, fertilizer_problem_t *problem, char **error_msg);
+void fertilizer_problem_free(fertilizer_problem_t *problem);
+
+// Price and target changes to a parsed problem (JSON):
+//   {"prices": {"Urea": 0.55, "AN": 0.31},
+//    "nutrients": {"N": {"min": 130}, "Zn": {"max": null}}}
+// Products and nutrients are named as in the problem. A nutrient entry
+// replaces the bounds it gives and keeps the others; null opens a bound.
+typedef struct {
+    int price_count;
+    int *price_products;                                // Product indices
+    double *prices;
+    int target_count;
+    int target_nutrients[FERTILIZER_MAX_NUTRIENTS];    // Nutrient indices
+    double target_min[FERTILIZER_MAX_NUTRIENTS];       // New bounds in kg/ha
+    double target_max[FERTILIZER_MAX_NUTRIENTS];
+} fertilizer_update_t;
+
+int fertilizer_parse_update(const char *data, const fertilizer_problem_t *problem, fertilizer_update_t *update,
+                            char **error_msg);
+void fertilizer_update_free(fertilizer_update_t *update);
+
+// Applies the update to the problem's prices and targets
+void fertilizer_problem_apply(fertilizer_problem_t *problem, const fertilizer_update_t *update);
+
+int fertilizer_solution_init(fertilizer_solution_t *solution, const fertilizer_problem_t *problem);
+void fertilizer_solution_free(fertilizer_solution_t *solution);
+
+// Completes a solution whose amounts are set: rounds LP noise within feastol
+// to zero and fills supplied and the binding flags, comparing with the
+// relative tolerance of SCIPisFeasEQ() so every backend reports alike
+void fertilizer_solution_finish(const fertilizer_problem_t *problem, fertilizer_solution_t *solution, double feastol);
+
+// JSON answer for an optimal solution:
+//   {"cost": 379.13, "area": 2,
+//    "products": [{"name": "Urea", "kg": 286.96, "binding": null}, ...],
+//    "nutrients": [{"name": "N", "kg_per_ha": 100, "min": 100, "max": 150, "binding": "min"}, ...]}
+// Products with a zero amount are left out; "binding" is "min", "max" or
+// null. A valid sensitivity adds, for every product and nutrient:
+//   "sensitivity": {"products": [{"name": "NPK", "reduced_cost": 0.0076, "price_range": [0.4424, null]}, ...],
+//                   "nutrients": [{"name": "N", "shadow_price": 2.17, "target_range": [34, 150]}, ...]}
+// with null for open range ends and for the range of a target that does
+// not bind. Returns a malloc()ed string, NULL when out of memory.
+char *fertilizer_format_solution(const fertilizer_problem_t *problem, const fertilizer_solution_t *solution);
+
+#endif
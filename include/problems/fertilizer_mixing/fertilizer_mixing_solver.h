@@ -3,8 +3,60 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <scip/scip.h>
+#include "problems/fertilizer_mixing/fertilizer_lp.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+
+// Least-cost blend as an LP: one continuous variable per product (kg over
+// the whole area, bounded by min and availability, priced per kg) and one
+// row per nutrient keeping area * min <= sum(fraction * kg) <= area * max.
+// Rows without any bound are left out.
+//
+// Blends go to the LP-only backend (fertilizer_lp.h) by default, with SCIP
+// as the fallback when SoPlex fails. The SCIP instance lives in the context
+// and is reused between solves: plugins are included once, presolving,
+// heuristics, separation and propagation are off, and each solve only
+// creates and frees the problem.
+//
+// With a basis cache in the context (solve_fertilizer_mixing() uses the
+// process-wide one) the LP backend first tries the cached optimal bases of
+// the request's catalog and only solves, warm-started, when none of them
+// fits the new prices and targets.
+
+typedef enum {
+    FERTILIZER_BACKEND_AUTO,    // LP, SCIP when SoPlex fails (no sensitivity then)
+    FERTILIZER_BACKEND_LP,
+    FERTILIZER_BACKEND_SCIP
+} fertilizer_backend_t;
+
+typedef struct {
+    fertilizer_backend_t backend;
+    SCIP *scip;         // NULL until the first SCIP solve
+    SCIP_LPI *lpi;      // NULL until the first LP solve
+    fertilizer_basis_cache_t *cache;    // LP backend: optimal bases to answer from, NULL for none
+    bool from_cache;    // Whether the last solve was answered from the cache
+    bool sensitivity;   // LP backend: fill solution->sensitivity from the final basis
+} fertilizer_ctx_t;
+
+void fertilizer_ctx_init(fertilizer_ctx_t *ctx);
+SCIP_RETCODE fertilizer_ctx_free(fertilizer_ctx_t *ctx);
+
+// Solves problem into solution (fertilizer_solution_init()ed for it) with
+// the context's backend. Infeasible and unbounded problems are not errors:
+// they are reported in solution->status.
+SCIP_RETCODE fertilizer_solve(fertilizer_ctx_t *ctx, const fertilizer_problem_t *problem,
+                              fertilizer_solution_t *solution);
 
 bool validate_fertilizer_mixing_data(const char *data, char **error_msg);
-int solve_fertilizer_mixing(const char *data, char **error_msg);
 
-#endif
\ No newline at end of file
+// Parses the JSON request, solves it in a per-thread context and sets
+// *solution to the fertilizer_format_solution() text, with sensitivity
+// for blends solved by the LP backend. Infeasible and
+// unbounded requests fail with a message saying so.
+// fertilizer_thread_cleanup() releases the context before the thread exits.
+int solve_fertilizer_mixing(const char *data, char **solution, char **error_msg);
+int solve_fertilizer_mixing_with_backend(const char *data, fertilizer_backend_t backend, char **solution,
+                                         char **error_msg);
+void fertilizer_thread_cleanup(void);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef FERTILIZER_SENSITIVITY_H
+#define FERTILIZER_SENSITIVITY_H
+
+#include "problems/fertilizer_mixing/fertilizer_basis_cache.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+
+// Shadow prices, reduced costs and ranging from an optimal basis, in the
+// A x - s = 0 form of fertilizer_basis_cache.h. SCIP's LP interface has no
+// ranging call, so everything is read off the dense B^-1 of the basis:
+//   - Duals y^T = c_B^T B^-1; a nutrient's shadow price is y_r * area
+//   - Reduced costs c_i - y^T A_i
+//   - Price ranging: a nonbasic product's price may move until its reduced
+//     cost changes sign; a basic product's moves y along its row of B^-1
+//     and is limited by the first nonbasic reduced cost to change sign
+//   - Target ranging: a binding target moves the basic variables along its
+//     column of B^-1 until the first one reaches a bound (or the target
+//     reaches the nutrient's other bound)
+
+// Fills solution->sensitivity from the SCIP_BASESTAT statuses of an optimal
+// basis of the all_rows LP and the solution's amounts and supplies. Leaves
+// it invalid if the statuses do not form a regular basis.
+void fertilizer_sensitivity_compute(const fertilizer_problem_t *problem, const int *col_basis,
+                                    const int *row_basis, fertilizer_solution_t *solution);
+
+#endif
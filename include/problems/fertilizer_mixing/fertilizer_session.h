@@ -0,0 +1,49 @@
+#ifndef FERTILIZER_SESSION_H
+#define FERTILIZER_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+
+// Re-quoting session over one blend whose prices and nutrient targets move
+// between requests. The LP stays loaded in SoPlex (with a row for every
+// nutrient, so any target can be set later) together with its last optimal
+// basis. An update only changes objective coefficients and row sides and
+// re-solves from that basis:
+//   - Price changes keep the basis primal feasible: primal simplex
+//   - Target changes keep it dual feasible: dual simplex (also used when
+//     both change)
+// After an infeasible or unbounded answer the last optimal basis is loaded
+// back before the next re-solve. Setting ctx.sensitivity adds sensitivity
+// to every optimal answer.
+
+typedef struct {
+    size_t updates;
+    size_t warm;                // Re-solved from the last optimal basis
+    size_t cold;                // Solved from scratch: loads, updates before any optimum
+    long long iterations;       // Simplex iterations of the warm re-solves
+} fertilizer_session_stats_t;
+
+typedef struct {
+    fertilizer_ctx_t ctx;
+    fertilizer_problem_t problem;       // Current prices and targets, owned by the session
+    fertilizer_solution_t solution;     // Answer for the current problem
+    int *col_basis;                     // Last optimal basis, SCIP_BASESTAT per column
+    int row_basis[FERTILIZER_MAX_NUTRIENTS];   // and per row (one row per nutrient)
+    bool basis_valid;
+    bool lp_at_basis;                   // The LP still holds that basis (last answer optimal)
+    fertilizer_session_stats_t stats;
+} fertilizer_session_t;
+
+void fertilizer_session_init(fertilizer_session_t *session);
+SCIP_RETCODE fertilizer_session_free(fertilizer_session_t *session);
+
+// Takes over problem (left empty) and solves it from scratch; the answer is
+// in session->solution
+SCIP_RETCODE fertilizer_session_load(fertilizer_session_t *session, fertilizer_problem_t *problem);
+
+// Applies the price and target changes (parsed against session->problem)
+// and re-solves
+SCIP_RETCODE fertilizer_session_update(fertilizer_session_t *session, const fertilizer_update_t *update);
+
+#endif
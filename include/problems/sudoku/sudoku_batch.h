@@ -0,0 +1,48 @@
+#ifndef SUDOKU_BATCH_H
+#define SUDOKU_BATCH_H
+
+#include <stddef.h>
+#include "problems/sudoku/sudoku_solver.h"
+
+// Bulk solving over a fixed pool of worker threads. Puzzles and solutions
+// are contiguous arrays of SUDOKU_PUZZLE_LEN-byte records in the usual
+// line format: '1'-'9' for givens, '0' or '.' for empty cells, no
+// separators or terminators.
+
+typedef enum {
+    SUDOKU_BATCH_SOLVED,
+    SUDOKU_BATCH_INFEASIBLE,  // No solution, including duplicate givens
+    SUDOKU_BATCH_INVALID,     // Malformed record
+    SUDOKU_BATCH_ERROR      // Solver failure (e.g. budget exhausted)
+} sudoku_batch_status_t;
+
+typedef struct {
+    int threads;               // Worker count, <= 0 for one per online CPU
+    sudoku_options_t options;  // Engine and budgets used by every worker
+} sudoku_batch_config_t;
+
+typedef struct {
+    size_t solved;
+    size_t infeasible;
+    size_t invalid;
+    size_t failed;
+    int threads;
+    double elapsed;              // Seconds, wall clock
+    double puzzles_per_second;
+} sudoku_batch_stats_t;
+
+void sudoku_batch_default_config(sudoku_batch_config_t *config);
+
+// Solves one SUDOKU_PUZZLE_LEN-byte record with ctx; solution is only
+// written for SUDOKU_BATCH_SOLVED
+sudoku_batch_status_t sudoku_batch_solve_record(sudoku_ctx_t *ctx, const char *record, char *solution);
+
+// Solves count puzzles. solutions receives the solved grid of every
+// puzzle with status SUDOKU_BATCH_SOLVED and a copy of the input record
+// otherwise. status (one entry per puzzle), config and stats may be NULL.
+// Returns EXIT_FAILURE only if the pool could not be started.
+int solve_sudoku_batch(const char *puzzles, size_t count, char *solutions,
+                       sudoku_batch_status_t *status, const sudoku_batch_config_t *config,
+                       sudoku_batch_stats_t *stats);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SUDOKU_BINARY_H
+#define SUDOKU_BINARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <zlib.h>
+
+// Packed binary format for bulk puzzles and solutions, 4 bits per cell:
+//
+//   Header, SUDOKU_BINARY_HEADER_SIZE bytes, little-endian:
+//     0  magic "SDKB"
+//     4  version (1), order n, flags, reserved (0)
+//     8  record count (u64)
+//    16  payload bytes as stored (u64)
+//    24  CRC-32 of the uncompressed payload (u32)
+//    28  bytes per record (u32)
+//   Payload: count records of (n^4 + 1) / 2 bytes, cell 2i in the low and
+//   cell 2i+1 in the high nibble of byte i, 0 for empty cells; a single
+//   zlib stream of the records with SUDOKU_BINARY_COMPRESSED
+//
+// A 9x9 record takes 41 bytes against 82 for a text line. Records convert
+// from and to the line format of sudoku_batch.h ('1'-'9', '0' or '.'),
+// with SSE2/AVX2 when the build targets them. Orders 2 and 3 fit in 4 bits.
+
+#define SUDOKU_BINARY_MAGIC "SDKB"
+#define SUDOKU_BINARY_VERSION 1
+#define SUDOKU_BINARY_HEADER_SIZE 32
+#define SUDOKU_BINARY_COMPRESSED 0x01u
+#define SUDOKU_PACKED_LEN 41   // Bytes per packed 9x9 record
+#define SUDOKU_BINARY_CHUNK 4096  // Records packed or unpacked per step of the file APIs
+
+typedef struct {
+    int order;
+    uint32_t flags;
+    uint64_t count;
+    uint64_t payload_bytes;
+    uint32_t checksum;
+    uint32_t record_bytes;
+} sudoku_binary_header_t;
+
+// Packs cells text characters into (cells + 1) / 2 bytes. Returns false,
+// with packed undefined, on characters other than '0'-'9' and '.'.
+bool sudoku_pack_cells(const char *text, size_t cells, uint8_t *packed);
+void sudoku_unpack_cells(const uint8_t *packed, size_t cells, char *text);
+
+// Header (de)serialization; decode returns false on a bad magic, version,
+// order or record size
+void sudoku_binary_encode_header(const sudoku_binary_header_t *header, uint8_t out[SUDOKU_BINARY_HEADER_SIZE]);
+bool sudoku_binary_decode_header(const uint8_t in[SUDOKU_BINARY_HEADER_SIZE], sudoku_binary_header_t *header);
+
+// Whole buffers, e.g. request and response bodies. encode allocates *out;
+// decode allocates *records (count * n^4 text bytes) and checks the
+// checksum. Both return EXIT_SUCCESS or EXIT_FAILURE.
+int sudoku_binary_encode(const char *records, size_t count, int order, bool compress, uint8_t **out,
+                         size_t *out_len);
+int sudoku_binary_decode(const uint8_t *data, size_t len, char **records, size_t *count, int *order);
+
+// Streaming writer over a seekable file: records are appended as they
+// come and the header is completed on close
+typedef struct {
+    FILE *file;
+    sudoku_binary_header_t header;
+    uint32_t crc;
+    z_stream zstream;
+    uint8_t *packed;           // SUDOKU_BINARY_CHUNK packed records
+    uint8_t *output;           // Deflate output
+    bool failed;
+} sudoku_binary_writer_t;
+
+int sudoku_binary_writer_open(sudoku_binary_writer_t *writer, const char *path, int order, bool compress);
+// Appends count text records of n^4 characters; EXIT_FAILURE on I/O
+// errors or invalid characters
+int sudoku_binary_write(sudoku_binary_writer_t *writer, const char *records, size_t count);
+int sudoku_binary_writer_close(sudoku_binary_writer_t *writer);
+
+typedef struct {
+    FILE *file;
+    sudoku_binary_header_t header;
+    uint64_t remaining;        // Records not read yet
+    uint32_t crc;
+    z_stream zstream;
+    uint64_t payload_left;     // Stored payload bytes not read yet
+    uint8_t *input;            // Compressed input
+    uint8_t *packed;           // SUDOKU_BINARY_CHUNK packed records
+    bool failed;
+} sudoku_binary_reader_t;
+
+// Opens a file and reads its header; header may be NULL
+int sudoku_binary_reader_open(sudoku_binary_reader_t *reader, const char *path, sudoku_binary_header_t *header);
+// Reads up to max records as text. Returns the number read, 0 at the end
+// and on errors (reader->failed); the checksum is verified with the last record.
+size_t sudoku_binary_read(sudoku_binary_reader_t *reader, char *records, size_t max);
+int sudoku_binary_reader_close(sudoku_binary_reader_t *reader);
+
+// Whether the file starts with SUDOKU_BINARY_MAGIC
+bool sudoku_binary_file_detect(const char *path);
+
+// Conversions between 9x9 line files (as read by solve_sudoku_file()) and
+// the binary format. Blank lines are skipped; any other line that is not a
+// valid record fails the conversion. count may be NULL.
+int sudoku_binary_pack_file(const char *text_path, const char *binary_path, bool compress, size_t *count);
+int sudoku_binary_unpack_file(const char *binary_path, const char *text_path, size_t *count);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef SUDOKU_CACHE_H
+#define SUDOKU_CACHE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "problems/sudoku/sudoku_parser.h"
+
+// Bounded LRU map from a puzzle record to its solution record, both
+// SUDOKU_PUZZLE_LEN bytes in line format. solve_sudoku() keys the shared
+// instance by canonical form (sudoku_canonical.h), so puzzles that only
+// differ by a symmetry share one entry. Every call takes the cache lock.
+
+#define SUDOKU_CACHE_DEFAULT_CAPACITY 16384
+
+// Puzzles with fewer givens are never unique and bypass the cache
+#define SUDOKU_CACHE_MIN_GIVENS 17
+// So do puzzles with more: nearly every row order ties on their pattern of
+// givens, so canonicalizing them costs milliseconds (a complete grid over
+// 100 ms) while singles alone solve them
+#define SUDOKU_CACHE_MAX_GIVENS 77
+
+typedef struct {
+    char key[SUDOKU_PUZZLE_LEN];
+    char solution[SUDOKU_PUZZLE_LEN];
+    uint64_t hash;
+    int32_t prev;             // LRU list, most recently used first
+    int32_t next;
+    int32_t chain;            // Next entry in the same bucket
+} sudoku_cache_entry_t;
+
+typedef struct {
+    size_t hits;
+    size_t misses;
+    size_t insertions;
+    size_t evictions;
+    size_t entries;
+    size_t capacity;
+} sudoku_cache_stats_t;
+
+typedef struct {
+    sudoku_cache_entry_t *entries;
+    int32_t *buckets;
+    size_t capacity;
+    size_t bucket_mask;
+    size_t count;
+    int32_t head;
+    int32_t tail;
+    sudoku_cache_stats_t stats;
+    pthread_mutex_t lock;
+} sudoku_cache_t;
+
+// capacity 0 makes a cache that stores nothing but still counts misses
+int sudoku_cache_init(sudoku_cache_t *cache, size_t capacity);
+void sudoku_cache_free(sudoku_cache_t *cache);
+
+// Copies the cached solution of key and marks it most recently used
+bool sudoku_cache_lookup(sudoku_cache_t *cache, const char *key, char *solution);
+// Adds or refreshes key, evicting the least recently used entry when full
+void sudoku_cache_insert(sudoku_cache_t *cache, const char *key, const char *solution);
+// Drops all entries and resets the counters
+void sudoku_cache_clear(sudoku_cache_t *cache);
+void sudoku_cache_get_stats(sudoku_cache_t *cache, sudoku_cache_stats_t *stats);
+
+// Process-wide cache used by solve_sudoku(), created on first use with
+// SUDOKU_CACHE_DEFAULT_CAPACITY; NULL if it could not be allocated
+sudoku_cache_t *sudoku_solution_cache(void);
+
+#endif
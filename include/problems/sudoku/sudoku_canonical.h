@@ -0,0 +1,33 @@
+#ifndef SUDOKU_CANONICAL_H
+#define SUDOKU_CANONICAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Canonical form of a 9x9 Sudoku under the validity-preserving symmetries:
+// transposition, band and stack swaps, row swaps within a band, column
+// swaps within a stack and digit relabeling. The representative is the
+// lexicographically smallest row-major grid (empty cells lowest) with
+// digits numbered in order of first appearance, so two puzzles have the
+// same canonical grid exactly when one is a transform of the other.
+
+typedef struct {
+    bool transposed;     // Source is read transposed before permuting
+    uint8_t rows[9];     // Canonical row i is (oriented) source row rows[i]
+    uint8_t cols[9];     // Canonical column j is (oriented) source column cols[j]
+    uint8_t digits[10];  // Source digit -> canonical digit, digits[0] = 0
+} sudoku_transform_t;
+
+// Writes the canonical grid of puzzle and the transform that produces it
+// from puzzle. Cost grows with the number of tied arrangements, so very
+// sparse or highly symmetric grids are the slow case.
+void sudoku_canonicalize(const int puzzle[9][9], int canonical[9][9], sudoku_transform_t *transform);
+
+// Maps a grid of the source puzzle's frame (e.g. its solution) into the
+// canonical frame
+void sudoku_transform_apply(const sudoku_transform_t *transform, const int grid[9][9], int out[9][9]);
+
+// Maps a grid of the canonical frame back into the source puzzle's frame
+void sudoku_transform_invert(const sudoku_transform_t *transform, const int grid[9][9], int out[9][9]);
+
+#endif
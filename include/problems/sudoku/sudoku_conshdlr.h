@@ -0,0 +1,29 @@
+#ifndef SUDOKU_CONSHDLR_H
+#define SUDOKU_CONSHDLR_H
+
+#include <scip/scip.h>
+
+// SCIP constraint handler "sudoku_alldiff": the nine cells of one unit
+// (row, column or box) take one digit each and no digit twice. A
+// constraint holds the unit's binaries x[cell][digit] and propagates them
+// through 16-bit candidate masks, one per cell:
+//   - a placed digit leaves its cell and its peers in the unit
+//   - naked single: a cell with one candidate left takes it
+//   - hidden single: a digit with one cell left goes there
+//   - naked pair: two cells with the same two candidates remove both
+//     digits from the other cells
+// Every deduction is explained to conflict analysis. The LP only sees the
+// unit as rows once a solution violates it.
+
+#define SUDOKU_ALLDIFF_CONSHDLR_NAME "sudoku_alldiff"
+
+// Registers the handler with scip, after SCIPincludeDefaultPlugins()
+SCIP_RETCODE sudoku_include_alldiff_conshdlr(SCIP *scip);
+
+// vars[cell][digit] may hold NULL for pairs that are already ruled out.
+// givens, if not NULL, holds the digit (1-9) of cells that are given and
+// have no variables, 0 elsewhere; those digits count as placed.
+SCIP_RETCODE sudoku_create_alldiff_cons(SCIP *scip, SCIP_CONS **cons, const char *name, SCIP_VAR *vars[9][9],
+                                        const int givens[9]);
+
+#endif
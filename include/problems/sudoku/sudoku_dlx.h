@@ -0,0 +1,35 @@
+#ifndef SUDOKU_DLX_H
+#define SUDOKU_DLX_H
+
+#include "problems/sudoku/sudoku_propagation.h"
+
+// Dancing Links (Algorithm X) over the same exact-cover structure as the
+// SCIP model: 324 columns (cell, row, column and box constraints) and 729
+// rows (one per cell/digit pair). All links live in one preallocated
+// array; a solve copies the prebuilt template instead of allocating.
+
+#define SUDOKU_DLX_COLUMNS 324
+#define SUDOKU_DLX_ROWS 729
+#define SUDOKU_DLX_NODES (1 + SUDOKU_DLX_COLUMNS + 4 * SUDOKU_DLX_ROWS)
+
+typedef struct {
+    uint16_t left[SUDOKU_DLX_NODES];
+    uint16_t right[SUDOKU_DLX_NODES];
+    uint16_t up[SUDOKU_DLX_NODES];
+    uint16_t down[SUDOKU_DLX_NODES];
+    uint16_t column[SUDOKU_DLX_NODES];   // Column header of every node
+    uint16_t row[SUDOKU_DLX_NODES];      // Matrix row (cell * 9 + digit - 1) of every node
+    uint16_t size[SUDOKU_DLX_COLUMNS + 1];
+} sudoku_dlx_t;
+
+// Same contract as sudoku_native_solve(): the grid is only modified when
+// the puzzle is solved, limits and stats may be NULL.
+sudoku_native_status_t sudoku_dlx_solve(int grid[9][9], const sudoku_native_limits_t *limits,
+                                        sudoku_native_stats_t *stats);
+
+// Variant working on caller-provided link storage (e.g. one per worker)
+sudoku_native_status_t sudoku_dlx_solve_with(sudoku_dlx_t *dlx, int grid[9][9],
+                                             const sudoku_native_limits_t *limits,
+                                             sudoku_native_stats_t *stats);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SUDOKU_GENERATOR_H
+#define SUDOKU_GENERATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Puzzle generator on top of the native engine: a random solved grid is
+// thinned out clue by clue, keeping only removals after which the puzzle
+// still has exactly one solution (sudoku_native_count() with cap 2), and
+// the result is graded by the search effort it takes to solve. A puzzle in
+// the wrong tier has clues swapped for blank cells of the same grid until
+// its search effort reaches the target tier.
+
+typedef enum {
+    SUDOKU_DIFFICULTY_ANY,     // Target only: accept every tier
+    SUDOKU_DIFFICULTY_EASY,    // Naked and hidden singles suffice
+    SUDOKU_DIFFICULTY_MEDIUM,  // A little search (up to SUDOKU_MEDIUM_MAX_NODES)
+    SUDOKU_DIFFICULTY_HARD     // Deeper search
+} sudoku_difficulty_t;
+
+#define SUDOKU_MEDIUM_MAX_NODES 16
+#define SUDOKU_MIN_CLUES 17
+
+typedef struct {
+    int clues;                       // Target clue count, SUDOKU_MIN_CLUES-80
+    sudoku_difficulty_t difficulty;  // Target tier
+    int max_attempts;                // Solved grids tried per puzzle before giving up
+    int threads;                     // Worker count, <= 0 for one per online CPU
+    uint64_t seed;                   // Puzzle n is derived from (seed, n) only
+} sudoku_generator_config_t;
+
+typedef struct {
+    size_t generated;
+    size_t failed;                   // Target not met within max_attempts
+    size_t attempts;                 // Solved grids tried in total
+    int threads;
+    double elapsed;                  // Seconds, wall clock
+    double puzzles_per_second;
+} sudoku_generator_stats_t;
+
+void sudoku_generator_default_config(sudoku_generator_config_t *config);
+
+// Tier of a uniquely solvable puzzle
+sudoku_difficulty_t sudoku_grade(const int puzzle[9][9]);
+
+// Generates one puzzle from seed. solution, grade and attempts may be NULL.
+// Returns EXIT_FAILURE when no grid met the targets within max_attempts.
+int sudoku_generate(uint64_t seed, const sudoku_generator_config_t *config, int puzzle[9][9],
+                    int solution[9][9], sudoku_difficulty_t *grade, int *attempts);
+
+// Generates count puzzles in parallel into SUDOKU_PUZZLE_LEN-byte records
+// (same layout as sudoku_batch.h). The output depends on config->seed only,
+// not on the thread count or scheduling. solutions, grades, config and
+// stats may be NULL; failed puzzles are all-zero records with grade
+// SUDOKU_DIFFICULTY_ANY. Returns EXIT_FAILURE if no worker could be started.
+int sudoku_generate_batch(size_t count, char *puzzles, char *solutions, sudoku_difficulty_t *grades,
+                          const sudoku_generator_config_t *config, sudoku_generator_stats_t *stats);
+
+#endif
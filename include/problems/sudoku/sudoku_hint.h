@@ -0,0 +1,57 @@
+#ifndef SUDOKU_HINT_H
+#define SUDOKU_HINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Next-step hints for interactive play: from the grid and the player's
+// candidate marks, finds the simplest deduction a human would make next and
+// names the technique and the cells involved. Only bit-mask scans over the
+// grid, no search and no SCIP, so a call stays far below 100 us
+// (bench/bench_sudoku_hint.c).
+//
+// Marks use bit d-1 for digit d, one mask per cell in row-major order. A
+// mark of 0 on an empty cell means "not marked yet" and stands for every
+// digit the grid allows there. Marks are always intersected with what the
+// placed digits allow, so stale marks are harmless, while candidates the
+// player has erased stay erased.
+
+typedef enum {
+    SUDOKU_HINT_NONE,           // Complete grid, or nothing below applies
+    SUDOKU_HINT_CONTRADICTION,  // A clash, a cell without candidates or a digit without a place
+    SUDOKU_HINT_NAKED_SINGLE,   // A cell with one candidate left
+    SUDOKU_HINT_HIDDEN_SINGLE,  // A digit with one place left in a unit
+    SUDOKU_HINT_NAKED_PAIR,     // Two cells of a unit limited to the same two digits
+    SUDOKU_HINT_POINTING,       // A digit confined to one line within a box
+    SUDOKU_HINT_CLAIMING,       // A digit confined to one box within a line
+    SUDOKU_HINT_HIDDEN_PAIR,    // Two digits confined to the same two cells of a unit
+    SUDOKU_HINT_X_WING          // A digit confined to the same two columns of two rows, or vice versa
+} sudoku_hint_technique_t;
+
+#define SUDOKU_HINT_MAX_CELLS 9
+
+typedef struct {
+    sudoku_hint_technique_t technique;
+    int unit;                              // 0-8 rows, 9-17 columns, 18-26 boxes; -1 for X-wings and single cells
+    uint16_t digits;                       // Digits of the pattern
+    int cells[SUDOKU_HINT_MAX_CELLS];      // Cells forming the pattern, 0-80
+    int cell_count;
+    int placement_cell;                    // Singles: the cell to fill, -1 otherwise
+    int placement_digit;
+    uint16_t eliminations[81];             // Candidates the deduction removes, per cell
+    int elimination_count;                 // Cells with eliminations
+} sudoku_hint_t;
+
+// Finds the next deduction, trying the techniques in the order of the enum
+// (contradictions first). grid holds 0 for empty cells; marks may be NULL
+// for an unmarked grid. Returns hint->technique.
+sudoku_hint_technique_t sudoku_next_hint(const int grid[9][9], const uint16_t marks[81], sudoku_hint_t *hint);
+
+// Carries out a hint: fills the placement and removes the eliminated
+// candidates from marks (NULL to update the grid only), materializing
+// unmarked cells first
+void sudoku_hint_apply(const sudoku_hint_t *hint, int grid[9][9], uint16_t marks[81]);
+
+const char *sudoku_hint_technique_name(sudoku_hint_technique_t technique);
+
+#endif
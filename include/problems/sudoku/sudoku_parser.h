@@ -0,0 +1,87 @@
+#ifndef SUDOKU_PARSER_H
+#define SUDOKU_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Sudoku of box order n: an n^2 x n^2 grid of n x n boxes holding the
+// digits 1..n^2 (order 3 is the classic 9x9, 4 is 16x16, 5 is 25x25).
+//
+// Puzzle input formats, the order following from the number of cells (n^4):
+//   - Line format: one symbol per cell, '1'-'9' then 'A'-'Z'
+//     (case-insensitive) for 10-35, '0' or '.' for empty cells; up to order
+//     5. The 81-character 9x9 line takes the SIMD path below.
+//   - Tokens: cell values as decimal numbers separated by whitespace or
+//     commas, 0 for empty cells; any supported order
+//   - JSON: an n^2 x n^2 array of numbers (0 or null for empty cells),
+//     either at the top level or under a "grid" key; "grid" may also hold a
+//     string in one of the formats above
+// Surrounding whitespace is ignored. Parsing rejects malformed input and
+// duplicate givens in a row, column or box, so contradictory requests
+// never reach a solver.
+
+#define SUDOKU_PUZZLE_LEN 81
+#define SUDOKU_MIN_ORDER 2
+#define SUDOKU_MAX_ORDER 6     // 36x36, candidate sets fit in a uint64_t
+#define SUDOKU_MAX_SIZE (SUDOKU_MAX_ORDER * SUDOKU_MAX_ORDER)
+#define SUDOKU_MAX_CELLS (SUDOKU_MAX_SIZE * SUDOKU_MAX_SIZE)
+#define SUDOKU_MAX_SYMBOL 35   // Largest digit with a line-format symbol ('Z')
+
+typedef enum {
+    SUDOKU_PARSE_OK,
+    SUDOKU_PARSE_EMPTY,
+    SUDOKU_PARSE_BAD_LENGTH,
+    SUDOKU_PARSE_BAD_CHAR,
+    SUDOKU_PARSE_BAD_JSON,
+    SUDOKU_PARSE_DUPLICATE
+} sudoku_parse_status_t;
+
+// A puzzle or solution of any supported order. Cells are row-major with
+// stride size, so a 9x9 grid is laid out like int[9][9] (sudoku_grid_rows()).
+typedef struct {
+    int order;                       // n
+    int size;                        // n^2: row length and number of digits
+    int cells[SUDOKU_MAX_CELLS];     // size * size used, 0 = empty
+} sudoku_grid_t;
+
+// Sets the order and empties the grid; false for an unsupported order
+bool sudoku_grid_init(sudoku_grid_t *grid, int order);
+void sudoku_grid_copy(sudoku_grid_t *dst, const sudoku_grid_t *src);
+void sudoku_grid_from_rows(sudoku_grid_t *grid, const int rows[9][9]);
+
+// The cells of an order 3 grid as the int[9][9] the 9x9 engines take
+static inline int (*sudoku_grid_rows(sudoku_grid_t *grid))[9] {
+    return (int (*)[9])grid->cells;
+}
+
+static inline int sudoku_grid_box(const sudoku_grid_t *grid, int row, int col) {
+    return (row / grid->order) * grid->order + col / grid->order;
+}
+
+// Classifies one record of exactly SUDOKU_PUZZLE_LEN bytes (SIMD when the
+// build targets SSE2/AVX2), marking each block's givens for the duplicate
+// check in the same pass
+sudoku_parse_status_t sudoku_parse_line(const char *line, int grid[9][9]);
+
+// Detects the format and order of a NUL-terminated request body and
+// parses it
+sudoku_parse_status_t sudoku_parse_grid(const char *data, sudoku_grid_t *grid);
+
+// sudoku_parse_grid() for 9x9 puzzles only; other orders are BAD_LENGTH
+sudoku_parse_status_t sudoku_parse(const char *data, int grid[9][9]);
+
+// Range and duplicate check on an already decoded grid
+bool sudoku_grid_consistent(const sudoku_grid_t *grid);
+bool sudoku_givens_consistent(const int grid[9][9]);
+
+// Writes the grid as SUDOKU_PUZZLE_LEN characters, no terminator
+void sudoku_format_line(const int grid[9][9], char *line);
+
+// Writes the grid in line format when every digit has a symbol, as tokens
+// otherwise, NUL-terminated. Returns the length of the full text like
+// snprintf.
+size_t sudoku_format_grid(const sudoku_grid_t *grid, char *out, size_t len);
+
+const char *sudoku_parse_error(sudoku_parse_status_t status);
+
+#endif
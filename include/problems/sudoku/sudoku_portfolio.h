@@ -0,0 +1,49 @@
+#ifndef SUDOKU_PORTFOLIO_H
+#define SUDOKU_PORTFOLIO_H
+
+#include <scip/scip.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Support for SUDOKU_ENGINE_PORTFOLIO, which races the propagation engine
+// against SCIP on two threads (solve_puzzle() in sudoku_solver.c). The
+// first engine with an answer wins and the other one is cancelled: the
+// native search through sudoku_native_limits_t.cancel, SCIP through the
+// event handler below, which calls SCIPinterruptSolve() from SCIP's own
+// thread. Outcomes are counted per puzzle class.
+
+// Puzzle classes by number of givens; sparse puzzles are the usual hard ones
+typedef enum {
+    SUDOKU_CLASS_SPARSE,   // At most 24 givens
+    SUDOKU_CLASS_TYPICAL,  // 25 to 30 givens
+    SUDOKU_CLASS_DENSE,    // More than 30 givens
+    SUDOKU_CLASS_COUNT
+} sudoku_puzzle_class_t;
+
+typedef struct {
+    size_t races;
+    size_t native_wins;
+    size_t scip_wins;
+    double seconds;       // Total wall time of the races
+    double max_seconds;   // Slowest race
+} sudoku_portfolio_class_stats_t;
+
+typedef struct {
+    sudoku_portfolio_class_stats_t classes[SUDOKU_CLASS_COUNT];
+} sudoku_portfolio_stats_t;
+
+sudoku_puzzle_class_t sudoku_puzzle_class(const int puzzle[9][9]);
+const char *sudoku_puzzle_class_name(sudoku_puzzle_class_t puzzle_class);
+
+// Process-wide race statistics, safe to use from any thread
+void sudoku_portfolio_record(sudoku_puzzle_class_t puzzle_class, bool native_won, double seconds);
+void sudoku_portfolio_get_stats(sudoku_portfolio_stats_t *stats);
+void sudoku_portfolio_reset_stats(void);
+
+// Registers an event handler that interrupts the solve at the next node or
+// LP once *cancel is set. cancel must outlive scip; SCIPsolve() does not
+// clear it.
+SCIP_RETCODE sudoku_include_cancel_eventhdlr(SCIP *scip, atomic_bool *cancel);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SUDOKU_PROPAGATION_H
+#define SUDOKU_PROPAGATION_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Native constraint-propagation engine: 9-bit candidate masks per row,
+// column and box, naked/hidden singles, and depth-first search on the cell
+// with the fewest candidates (minimum remaining values).
+
+typedef enum {
+    SUDOKU_NATIVE_SOLVED,
+    SUDOKU_NATIVE_INFEASIBLE,
+    SUDOKU_NATIVE_LIMIT_REACHED
+} sudoku_native_status_t;
+
+typedef struct {
+    long node_limit;    // Search nodes before giving up, <= 0 for no limit
+    double time_limit;  // Seconds before giving up, <= 0 for no limit
+    const atomic_bool *cancel;  // Gives up once set by another thread, NULL for never
+} sudoku_native_limits_t;
+
+typedef struct {
+    long nodes;         // Branching decisions taken by the search
+    long placements;    // Digits placed by propagation (givens excluded)
+} sudoku_native_stats_t;
+
+// Solves grid in place (0 marks an empty cell). The grid is only modified
+// when the result is SUDOKU_NATIVE_SOLVED. limits and stats may be NULL.
+sudoku_native_status_t sudoku_native_solve(int grid[9][9], const sudoku_native_limits_t *limits,
+                                           sudoku_native_stats_t *stats);
+
+// Same, but every branch tries the digit of guide (e.g. the solution before
+// an edit) first, so a nearby solution is found with little backtracking.
+// guide may be NULL and may contradict the givens.
+sudoku_native_status_t sudoku_native_solve_guided(int grid[9][9], const int guide[9][9],
+                                                  const sudoku_native_limits_t *limits,
+                                                  sudoku_native_stats_t *stats);
+
+// Counts solutions up to cap, stopping as soon as the cap is reached (cap 2
+// answers "is the solution unique?"). *count is exact below the cap. The
+// first solution found is written to grid. Returns SOLVED when at least one
+// solution was found and the count is final, INFEASIBLE for none, and
+// LIMIT_REACHED when the budget ran out first (*count is a lower bound).
+sudoku_native_status_t sudoku_native_count(int grid[9][9], int cap, const sudoku_native_limits_t *limits,
+                                           sudoku_native_stats_t *stats, int *count);
+
+// Same count with the search tree split over threads (<= 0: one per online
+// CPU). The node limit is shared out between the workers.
+sudoku_native_status_t sudoku_native_count_parallel(int grid[9][9], int cap, int threads,
+                                                    const sudoku_native_limits_t *limits,
+                                                    sudoku_native_stats_t *stats, int *count);
+
+#endif
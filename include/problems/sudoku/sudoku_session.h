@@ -0,0 +1,51 @@
+#ifndef SUDOKU_SESSION_H
+#define SUDOKU_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "problems/sudoku/sudoku_solver.h"
+
+// Interactive session over one grid that changes a cell at a time. The
+// session keeps its solver context (and with it the SCIP model template)
+// and the last answer between edits:
+//   - Edits the last answer still covers are answered in O(1): clearing a
+//     given, entering the digit the solution already has, entering a digit
+//     that clashes with a peer, or adding a given to an infeasible grid
+//   - Every other edit re-solves with the previous solution as guide: the
+//     native search tries its digits first and SCIP gets it as a partial
+//     start solution (sudoku_ctx_t.guide)
+
+typedef enum {
+    SUDOKU_SESSION_SOLVED,      // solution holds a solution of the current grid
+    SUDOKU_SESSION_INFEASIBLE,  // The current grid has no solution
+    SUDOKU_SESSION_ERROR        // Solver failure or exhausted limits; the next edit re-solves
+} sudoku_session_status_t;
+
+typedef struct {
+    size_t edits;
+    size_t revalidated;         // Answered from the previous result
+    size_t resolved;            // Needed a guided solve
+} sudoku_session_stats_t;
+
+typedef struct {
+    sudoku_ctx_t ctx;
+    int givens[9][9];
+    int solution[9][9];
+    bool guide_valid;           // solution holds an earlier answer (the guide), even if status is not SOLVED
+    sudoku_session_status_t status;
+    sudoku_session_stats_t stats;
+} sudoku_session_t;
+
+// options may be NULL for the defaults; solution counting is turned off
+void sudoku_session_init(sudoku_session_t *session, const sudoku_options_t *options);
+SCIP_RETCODE sudoku_session_free(sudoku_session_t *session);
+
+// Replaces the grid and solves it from scratch. A digit out of range
+// leaves the session unchanged and returns ERROR.
+sudoku_session_status_t sudoku_session_load(sudoku_session_t *session, const int puzzle[9][9]);
+
+// Sets one cell (digit 0 clears it) and brings the answer up to date.
+// Out-of-range arguments leave the session unchanged and return ERROR.
+sudoku_session_status_t sudoku_session_set_cell(sudoku_session_t *session, int row, int col, int digit);
+
+#endif
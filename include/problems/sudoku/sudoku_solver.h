@@ -2,17 +2,183 @@
 #define SUDOKU_SOLVER_H
 
 #include <scip/scip.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include "problems/sudoku/sudoku_propagation.h"
+#include "problems/sudoku/sudoku_dlx.h"
+#include "problems/sudoku/sudoku_parser.h"
 
+// Budget for the native engines. With SUDOKU_ENGINE_AUTO the propagation
+// engine is tried before SCIP and the puzzle falls back to the SCIP model
+// once the budget is exhausted.
+#define SUDOKU_DEFAULT_NATIVE_NODE_LIMIT 100000
+#define SUDOKU_DEFAULT_NATIVE_TIME_LIMIT 0.05
+
+typedef enum {
+    SUDOKU_ENGINE_AUTO,    // Propagation engine, SCIP on budget exhaustion
+    SUDOKU_ENGINE_NATIVE,  // Propagation engine only
+    SUDOKU_ENGINE_DLX,     // Dancing Links only
+    SUDOKU_ENGINE_SCIP,    // SCIP model only
+    SUDOKU_ENGINE_PORTFOLIO  // Propagation engine and SCIP raced on two threads, first answer wins
+} sudoku_engine_t;
+
+// How the SCIP model expresses "exactly one" per cell and unit
+typedef enum {
+    SUDOKU_FORMULATION_LINEAR,  // Generic linear constraints, sum = 1
+    SUDOKU_FORMULATION_SETPPC,  // Set-partitioning constraints (setppc handler)
+    SUDOKU_FORMULATION_ALLDIFF  // One all-different constraint per unit (sudoku_conshdlr.h), setppc per cell
+} sudoku_formulation_t;
+
+// Build-time default, switched with make SUDOKU_SETPPC=1 or SUDOKU_ALLDIFF=1
+#ifndef SUDOKU_DEFAULT_FORMULATION
+#define SUDOKU_DEFAULT_FORMULATION SUDOKU_FORMULATION_LINEAR
+#endif
+
+typedef struct {
+    sudoku_engine_t engine;
+    sudoku_formulation_t formulation;
+    bool reduced_model;        // Per-puzzle SCIP model without givens and their peer eliminations
+    long native_node_limit;    // <= 0 for no limit; also bounds counting
+    double native_time_limit;  // Seconds, <= 0 for no limit
+    int solution_cap;          // > 0: count solutions up to the cap instead of solving (2 checks uniqueness)
+    int count_threads;         // Threads for counting, <= 0 for one per online CPU
+    bool use_cache;            // solve_sudoku*(): answer repeats up to symmetry from sudoku_solution_cache()
+
+    // Per-puzzle limits (SCIP's limits/time, limits/nodes, limits/memory),
+    // <= 0 for none. Time and nodes also cap the native budget above and
+    // bound the native, DLX and counting searches of every engine.
+    double time_limit;         // Seconds
+    long node_limit;           // Branch-and-bound nodes (search nodes natively)
+    double memory_limit;       // Megabytes
+} sudoku_options_t;
+
+// solve_sudoku*() result when a limit stopped the search (SCIP, or the
+// native engines without a SCIP fallback) before a solution was found
+#define SUDOKU_LIMIT_REACHED 2
+
+typedef struct {
+    bool limit_reached;        // A time, node or memory limit (or the native budget) stopped the search
+    double gap;                // SCIPgetGap() at the stop, SCIP's infinity without an incumbent
+    int solution_count;        // Counting mode: solutions found, capped at solution_cap
+} sudoku_solve_info_t;
+
+void sudoku_default_options(sudoku_options_t *options);
+
+// Solver state for one Sudoku of any order. The native engines, the
+// solution cache and portfolio races are 9x9 only; other orders go to the
+// SCIP model. Every entry point below works on a context only, so
+// independent contexts can be used from different threads.
+typedef struct {
+    SCIP* scip;
+    sudoku_grid_t puzzle;
+
+    // SCIP model for a grid of model_size digits, flat arrays allocated by
+    // init_model(); entries eliminated by a reduced model stay NULL
+    int model_order;
+    int model_size;
+    SCIP_VAR** vars;                       // [(row * size + col) * size + digit]
+    SCIP_CONS** row_constrs;               // [row * size + digit]
+    SCIP_CONS** col_constrs;               // [col * size + digit]
+    SCIP_CONS** subgrid_constrs;           // [box * size + digit], boxes row-major
+    SCIP_CONS** fillgrid_constrs;          // [row * size + col]
+    SCIP_CONS** alldiff_constrs;           // Rows, columns, then boxes; SUDOKU_FORMULATION_ALLDIFF only
+    SCIP_Bool infeasible;
+    SCIP_Bool fixed;
+
+    // Persistent model template: variables and constraints are built once
+    // and reused, only the fixings of the givens change between puzzles
+    SCIP_Bool model_ready;
+    sudoku_formulation_t model_formulation;
+    int model_vars;                        // Size of the current SCIP model
+    int model_conss;
+    int *applied_givens;                   // [row * size + col]
+
+    sudoku_options_t options;
+    bool has_solution;                     // Whether puzzle holds a solution after the last solve
+    bool solved_natively;                  // Whether the last puzzle skipped SCIP
+    bool from_cache;                       // Whether the last puzzle was answered by the solution cache
+    sudoku_native_stats_t native_stats;    // Native engine work on the last puzzle
+    int solution_count;                    // Counting mode: solutions found, capped at solution_cap
+    bool limit_reached;                    // A limit stopped the search; puzzle then holds the cells proven so far
+    double gap;                            // SCIPgetGap() when limit_reached
+
+    // Warm start (sudoku_session.h): a nearby grid of the same order,
+    // usually the solution before an edit, whose digits the native search
+    // tries first and SCIP gets as a partial start solution
+    sudoku_grid_t guide;
+    bool use_guide;
+
+    // Portfolio mode
+    sudoku_engine_t race_winner;           // SUDOKU_ENGINE_NATIVE or SUDOKU_ENGINE_SCIP for the last puzzle
+    atomic_bool scip_cancel;               // Set when the native engine won, interrupts SCIP (sudoku_portfolio.h)
+} sudoku_ctx_t;
+
+void sudoku_ctx_init(sudoku_ctx_t *ctx);
+SCIP_RETCODE sudoku_ctx_free(sudoku_ctx_t *ctx);
+
+// data is a puzzle of any order in one of the formats described in
+// sudoku_parser.h
 bool validate_sudoku_data(const char *data, char **error_msg);
+int solve_sudoku_ctx(sudoku_ctx_t *ctx, const char *data, char **error_msg);
+
+// Solves an already parsed puzzle of any order on a context owned by the
+// calling thread; sudoku_thread_cleanup() releases it before the thread
+// exits. *solution, if solution is not NULL, is allocated and receives the
+// grid as sudoku_format_grid() writes it: the solution, or on
+// SUDOKU_LIMIT_REACHED the givens plus the cells proven so far. info may be
+// NULL. Counting (solution_cap > 0) and the native engines need 9x9.
+int solve_sudoku_grid(const sudoku_grid_t *puzzle, const sudoku_options_t *options, char **solution,
+                      sudoku_solve_info_t *info, char **error_msg);
+
+// 9x9 wrappers over solve_sudoku_grid(). solution, if not NULL, receives
+// the solved grid in line format (NUL-terminated, SUDOKU_PUZZLE_LEN + 1
+// bytes).
 int solve_sudoku(const char *data, char **error_msg);
-SCIP_RETCODE manage_sudoku_problem();
-SCIP_RETCODE init_model();
-SCIP_RETCODE add_variables();
-SCIP_RETCODE create_constraints();
-SCIP_RETCODE fix_variables();
-SCIP_RETCODE solve();
-void print_solution();
-SCIP_RETCODE free_model();
+int solve_sudoku_with_options(const char *data, const sudoku_options_t *options, char *solution, char **error_msg);
+// Same, reporting limit stops in info (may be NULL). On SUDOKU_LIMIT_REACHED
+// solution receives the partial grid: givens plus the cells SCIP had proven.
+int solve_sudoku_with_info(const char *data, const sudoku_options_t *options, char *solution,
+                           sudoku_solve_info_t *info, char **error_msg);
+// Counting mode of solve_sudoku_with_options(): *solution_count receives the
+// number of solutions found, capped at options->solution_cap (2 if unset).
+// The native budget bounds the count for every engine; SUDOKU_LIMIT_REACHED
+// means it ran out first and the count is a lower bound.
+int solve_sudoku_count(const char *data, const sudoku_options_t *options, char *solution, int *solution_count,
+                       char **error_msg);
+void sudoku_thread_cleanup(void);
+
+// Sets limits/time, limits/nodes and limits/memory from options (NULL
+// clears them); the persistent model needs this before every solve
+SCIP_RETCODE sudoku_apply_limits(SCIP *scip, const sudoku_options_t *options);
+// Whether SCIP stopped on one of the limits set by sudoku_apply_limits()
+bool sudoku_status_is_limit(SCIP_STATUS status);
+
+// Solves and prints the puzzle currently loaded in ctx->puzzle
+SCIP_RETCODE manage_sudoku_problem(sudoku_ctx_t *ctx);
+// SCIP_INVALIDDATA for a puzzle that is not 9x9 when counting or with the
+// native or DLX engine
+SCIP_RETCODE solve_puzzle(sudoku_ctx_t *ctx);
+// Loads the 9x9 sample puzzle
+void create_puzzle(sudoku_ctx_t *ctx);
+void print_puzzle(sudoku_ctx_t *ctx);
+// Creates SCIP and the model arrays for the order of ctx->puzzle
+SCIP_RETCODE init_model(sudoku_ctx_t *ctx);
+SCIP_RETCODE add_variables(sudoku_ctx_t *ctx);
+SCIP_RETCODE create_constraints(sudoku_ctx_t *ctx);
+SCIP_RETCODE fix_variables(sudoku_ctx_t *ctx);
+SCIP_RETCODE solve(sudoku_ctx_t *ctx);
+void print_solution(sudoku_ctx_t *ctx);
+SCIP_RETCODE free_model(sudoku_ctx_t *ctx);
+
+// Reduced model: variables only for (cell, digit) pairs the givens leave
+// open, constraints only over those
+SCIP_RETCODE add_reduced_variables(sudoku_ctx_t *ctx);
+SCIP_RETCODE create_reduced_constraints(sudoku_ctx_t *ctx);
+SCIP_RETCODE build_reduced_model(sudoku_ctx_t *ctx);
+
+// Persistent model template
+SCIP_RETCODE prepare_model(sudoku_ctx_t *ctx);
+SCIP_RETCODE reset_model(sudoku_ctx_t *ctx);
+SCIP_RETCODE release_model(sudoku_ctx_t *ctx);
 
 #endif
\ No newline at end of file
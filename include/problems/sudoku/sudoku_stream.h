@@ -0,0 +1,31 @@
+#ifndef SUDOKU_STREAM_H
+#define SUDOKU_STREAM_H
+
+#include <stddef.h>
+#include "problems/sudoku/sudoku_batch.h"
+#include "problems/sudoku/sudoku_binary.h"
+
+// Streaming bulk solve of a puzzle file with one SUDOKU_PUZZLE_LEN-character
+// puzzle per line. The input is memory-mapped and split into line-aligned
+// blocks that workers claim in file order; finished blocks pass through a
+// bounded reordering window so the output follows the input order while
+// only a few blocks per worker are held in memory.
+//
+// Every non-blank input line yields one output line: the solution, or the
+// input line unchanged when it is malformed, infeasible or failed (as in
+// solve_sudoku_batch()). Blank lines are dropped and "\r\n" is accepted.
+
+#define SUDOKU_STREAM_BLOCK_SIZE (1u << 20)  // Nominal input bytes per block
+#define SUDOKU_STREAM_WINDOW_PER_THREAD 4    // Blocks in flight per worker
+
+// Solves input_path into output_path. config and stats may be NULL. Returns EXIT_FAILURE on I/O errors or if no worker could start.
+int solve_sudoku_file(const char *input_path, const char *output_path,
+                      const sudoku_batch_config_t *config, sudoku_batch_stats_t *stats);
+
+// Same for a 9x9 file in the binary format of sudoku_binary.h: records go
+// through solve_sudoku_batch() in large chunks and the output is a binary
+// file of the same record count and compression.
+int solve_sudoku_binary_file(const char *input_path, const char *output_path,
+                             const sudoku_batch_config_t *config, sudoku_batch_stats_t *stats);
+
+#endif
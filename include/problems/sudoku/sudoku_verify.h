@@ -0,0 +1,45 @@
+#ifndef SUDOKU_VERIFY_H
+#define SUDOKU_VERIFY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bulk verification of solved 9x9 grids in the record layout of
+// sudoku_batch.h (SUDOKU_PUZZLE_LEN characters per grid, no separators).
+// A grid is valid if all 27 rows, columns and boxes hold 1-9 exactly once
+// and, when the puzzle is given, every given of the puzzle is kept.
+//
+// With AVX2, sudoku_verify_batch() takes SUDOKU_VERIFY_LANES grids at a
+// time: the records are transposed so that each 16-bit lane (two registers
+// per cell) belongs to one grid, every cell becomes a digit bit mask, and
+// each unit is the OR of its nine masks compared against 0x3FE. Other
+// builds and the batch tail check one grid at a time.
+
+#define SUDOKU_VERIFY_LANES 32
+
+// Scalar check of one record; puzzle may be NULL
+bool sudoku_verify_record(const char *solution, const char *puzzle);
+
+// Same for a decoded grid (values 0-9)
+bool sudoku_verify_grid(const int grid[9][9]);
+
+// Verifies count records; puzzles and valid may be NULL. Returns the
+// number of valid grids.
+size_t sudoku_verify_batch(const char *solutions, const char *puzzles, size_t count, bool *valid);
+
+typedef struct {
+    size_t checked;
+    size_t valid;
+    size_t first_invalid;        // Record index, SIZE_MAX if all are valid
+    double elapsed;              // Seconds, including reading the files
+    double grids_per_second;
+} sudoku_verify_stats_t;
+
+// Verifies a solutions file against an optional puzzles file (NULL). Either
+// may be a line file or a binary file (sudoku_binary.h). In line files blank
+// lines are skipped and lines of the wrong length count as invalid grids.
+// Returns EXIT_FAILURE on I/O errors and if the files hold different
+// numbers of records; invalid grids are only reported in stats.
+int sudoku_verify_file(const char *solutions_path, const char *puzzles_path, sudoku_verify_stats_t *stats);
+
+#endif
@@ -1,11 +1,212 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "problem_manager/problem_manager.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+#include "problems/sudoku/sudoku_stream.h"
+#include "problems/sudoku/sudoku_verify.h"
 
-int main(void) {
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--threads N] [--engine auto|native|dlx|scip|portfolio] [--time-limit S] [--node-limit N]\n"
+            "          <puzzles.txt> <solutions.txt>\n"
+            "  Solves a file with one 81-character Sudoku per line, writing the\n"
+            "  solutions in input order (unsolvable lines are copied unchanged).\n"
+            "  The limits bound the search of every engine (native, DLX and SCIP) per\n"
+            "  puzzle; puzzles that hit them count as failed.\n"
+            "  Binary puzzle files (see pack) are detected and solved into binary files.\n"
+            "       %s pack [--compress] <puzzles.txt> <puzzles.sdkb>\n"
+            "       %s unpack <puzzles.sdkb> <puzzles.txt>\n"
+            "  Convert between the line format and the packed binary format.\n"
+            "       %s verify [--puzzles <puzzles>] <solutions>\n"
+            "  Checks every solved grid (and that it keeps its puzzle's givens); fails\n"
+            "  if any grid is invalid.\n"
+            "       %s blend <request.json>\n"
+            "  Solves a least-cost fertilizer blend and prints the answer as JSON.\n",
+            program, program, program, program, program);
+}
+
+static int convert(int argc, char **argv) {
+    bool pack = strcmp(argv[1], "pack") == 0;
+    bool compress = false;
+    const char *paths[2] = {NULL, NULL};
+    int npaths = 0;
+    for (int i = 2; i < argc; i++) {
+        if (pack && strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (argv[i][0] != '-' && npaths < 2) {
+            paths[npaths++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (npaths != 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t count = 0;
+    int result = pack ? sudoku_binary_pack_file(paths[0], paths[1], compress, &count)
+                      : sudoku_binary_unpack_file(paths[0], paths[1], &count);
+    fprintf(stderr, "%zu records %s\n", count, pack ? "packed" : "unpacked");
+    return result;
+}
+
+static int parse_engine(const char *name, sudoku_engine_t *engine) {
+    static const struct {
+        const char *name;
+        sudoku_engine_t engine;
+    } engines[] = {
+        {"auto", SUDOKU_ENGINE_AUTO},
+        {"native", SUDOKU_ENGINE_NATIVE},
+        {"dlx", SUDOKU_ENGINE_DLX},
+        {"scip", SUDOKU_ENGINE_SCIP},
+        {"portfolio", SUDOKU_ENGINE_PORTFOLIO}
+    };
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        if (strcmp(name, engines[e].name) == 0) {
+            *engine = engines[e].engine;
+            return EXIT_SUCCESS;
+        }
+    }
+    return EXIT_FAILURE;
+}
+
+static int verify(int argc, char **argv) {
+    const char *puzzles = NULL;
+    const char *solutions = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--puzzles") == 0 && i + 1 < argc) {
+            puzzles = argv[++i];
+        } else if (argv[i][0] != '-' && !solutions) {
+            solutions = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!solutions) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    sudoku_verify_stats_t stats;
+    if (sudoku_verify_file(solutions, puzzles, &stats) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "%zu of %zu grids valid in %.3f s (%.0f grids/s)\n", stats.valid, stats.checked,
+            stats.elapsed, stats.grids_per_second);
+    if (stats.valid < stats.checked) {
+        fprintf(stderr, "First invalid grid: record %zu\n", stats.first_invalid + 1);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int blend(int argc, char **argv) {
+    if (argc != 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *file = fopen(argv[2], "rb");
+    if (!file) {
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+    char *data = NULL;
+    size_t len = 0;
+    size_t cap = 0;
+    size_t got = 0;
+    do {
+        if (len + 1 >= cap) {
+            cap = cap ? cap * 2 : 65536;
+            char *grown = realloc(data, cap);
+            if (!grown) {
+                free(data);
+                fclose(file);
+                fprintf(stderr, "Out of memory\n");
+                return EXIT_FAILURE;
+            }
+            data = grown;
+        }
+        got = fread(data + len, 1, cap - len - 1, file);
+        len += got;
+    } while (got > 0);
+    fclose(file);
+    data[len] = '\0';
+
+    char *solution = NULL;
+    char *error_msg = NULL;
+    int result = solve_fertilizer_mixing(data, &solution, &error_msg);
+    if (result == EXIT_SUCCESS) {
+        printf("%s\n", solution);
+    } else {
+        fprintf(stderr, "%s\n", error_msg ? error_msg : "Failed to solve fertilizer mixing problem");
+    }
+    fertilizer_thread_cleanup();
+    free(solution);
+    free(error_msg);
+    free(data);
+    return result;
+}
+
+int main(int argc, char **argv) {
     #ifdef DEBUG
         printf("[DEBUG] Starting in debug mode\n");
     #endif
-    
-    return 0;
+
+    if (argc < 2) {
+        return 0;
+    }
+    if (strcmp(argv[1], "pack") == 0 || strcmp(argv[1], "unpack") == 0) {
+        return convert(argc, argv);
+    }
+    if (strcmp(argv[1], "verify") == 0) {
+        return verify(argc, argv);
+    }
+    if (strcmp(argv[1], "blend") == 0) {
+        return blend(argc, argv);
+    }
+
+    sudoku_batch_config_t config;
+    sudoku_batch_default_config(&config);
+    const char *paths[2] = {NULL, NULL};
+    int npaths = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            if (parse_engine(argv[++i], &config.options.engine) != EXIT_SUCCESS) {
+                fprintf(stderr, "Unknown engine: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) {
+            config.options.time_limit = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--node-limit") == 0 && i + 1 < argc) {
+            config.options.node_limit = atol(argv[++i]);
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (npaths < 2) {
+            paths[npaths++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (npaths != 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    sudoku_batch_stats_t stats = {0};
+    int result = sudoku_binary_file_detect(paths[0])
+        ? solve_sudoku_binary_file(paths[0], paths[1], &config, &stats)
+        : solve_sudoku_file(paths[0], paths[1], &config, &stats);
+    fprintf(stderr, "%zu solved, %zu infeasible, %zu invalid, %zu failed in %.3f s (%.0f puzzles/s, %d threads)\n",
+            stats.solved, stats.infeasible, stats.invalid, stats.failed, stats.elapsed,
+            stats.puzzles_per_second, stats.threads);
+    return result;
 }
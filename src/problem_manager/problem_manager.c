@@ -2,25 +2,107 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include "problem_manager/problem_manager.h"
-#include "problems/sudoku/sudoku_solver.h"
-#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+#include "problem_manager_options.h"
 
 
+static sudoku_engine_t sudoku_engine_for(problem_manager_engine_t engine) {
+    switch (engine) {
+        case ENGINE_SCIP:
+            return SUDOKU_ENGINE_SCIP;
+        case ENGINE_NATIVE:
+            return SUDOKU_ENGINE_NATIVE;
+        case ENGINE_DLX:
+            return SUDOKU_ENGINE_DLX;
+        case ENGINE_PORTFOLIO:
+            return SUDOKU_ENGINE_PORTFOLIO;
+        case ENGINE_DEFAULT:
+        default:
+            return SUDOKU_ENGINE_AUTO;
+    }
+}
+
+void problem_manager_sudoku_options(const problem_manager_options_t *options, sudoku_options_t *sudoku_options) {
+    sudoku_default_options(sudoku_options);
+    if (options) {
+        sudoku_options->engine = sudoku_engine_for(options->engine);
+        sudoku_options->solution_cap = options->solution_cap;
+        // Zero means the default, a single counting thread
+        sudoku_options->count_threads = options->threads > 0 ? options->threads : 1;
+        sudoku_options->time_limit = options->time_limit;
+        sudoku_options->node_limit = options->node_limit;
+        sudoku_options->memory_limit = options->memory_limit;
+    }
+}
+
+fertilizer_backend_t problem_manager_fertilizer_backend(const problem_manager_options_t *options) {
+    switch (options ? options->engine : ENGINE_DEFAULT) {
+        case ENGINE_SCIP:
+            return FERTILIZER_BACKEND_SCIP;
+        case ENGINE_LP:
+            return FERTILIZER_BACKEND_LP;
+        default:
+            return FERTILIZER_BACKEND_AUTO;
+    }
+}
+
 solver_result_t problem_manager_dispatch_solver(problem_manager_type_t type, const char *data) {
-    solver_result_t result = {0, NULL};
+    return problem_manager_dispatch_solver_with_options(type, data, NULL);
+}
+
+solver_result_t problem_manager_dispatch_solver_with_options(problem_manager_type_t type, const char *data,
+                                                             const problem_manager_options_t *options) {
+    solver_result_t result = {0, NULL, NULL, 0, 0.0};
     char *error_msg = NULL;
     
     switch (type) {
         case TYPE_SUDOKU: {
             printf("Dispatching Sudoku problem\n");
             
-            int retcode = solve_sudoku(data, &error_msg);
+            sudoku_options_t sudoku_options;
+            problem_manager_sudoku_options(options, &sudoku_options);
+            sudoku_solve_info_t info = {false, 0.0, 0};
             
-            if (retcode == EXIT_SUCCESS) {
+            // Parsed once, any order; the solver routes by order
+            sudoku_grid_t puzzle;
+            char *solution = NULL;
+            int retcode = EXIT_FAILURE;
+            sudoku_parse_status_t parse_status = sudoku_parse_grid(data, &puzzle);
+            if (parse_status != SUDOKU_PARSE_OK) {
+                error_msg = strdup(sudoku_parse_error(parse_status));
+            } else {
+                retcode = solve_sudoku_grid(&puzzle, &sudoku_options, &solution, &info, &error_msg);
+            }
+            result.solution_count = info.solution_count;
+            
+            if (retcode == EXIT_SUCCESS && !info.limit_reached) {
                 result.status = 0;
-                result.message = strdup("Sudoku solved successfully");
+                if (sudoku_options.solution_cap > 0) {
+                    // A cap of 1 stops at the first solution and proves nothing
+                    // about uniqueness
+                    const char *message = "Sudoku has a solution";
+                    if (sudoku_options.solution_cap >= 2) {
+                        message = result.solution_count == 1 ? "Sudoku has a unique solution"
+                                                             : "Sudoku has multiple solutions";
+                    }
+                    result.message = strdup(message);
+                } else {
+                    result.message = strdup("Sudoku solved successfully");
+                }
+                result.solution = solution;
+            } else if (retcode == EXIT_SUCCESS || retcode == SUDOKU_LIMIT_REACHED) {
+                // Stopped by a limit: the incumbent, or the partial grid without one
+                result.status = PROBLEM_MANAGER_LIMIT_REACHED;
+                if (error_msg) {
+                    result.message = error_msg;
+                } else if (sudoku_options.solution_cap > 0) {
+                    result.message = strdup("Search budget reached, the solution count is a lower bound");
+                } else {
+                    result.message = strdup("Solver limit reached, returning the best incumbent");
+                }
+                result.solution = solution;
+                result.gap = info.gap;
             } else {
+                free(solution);
                 result.status = retcode;
                 result.message = error_msg ? error_msg : strdup("Failed to solve Sudoku");
             }
@@ -29,7 +111,8 @@ solver_result_t problem_manager_dispatch_solver(problem_manager_type_t type, con
         case TYPE_FERTILIZER_MIXING: {
             printf("Dispatching fertilizer mixing problem\n");
             
-            int retcode = solve_fertilizer_mixing(data, &error_msg);
+            fertilizer_backend_t backend = problem_manager_fertilizer_backend(options);
+            int retcode = solve_fertilizer_mixing_with_backend(data, backend, &result.solution, &error_msg);
             
             if (retcode == EXIT_SUCCESS) {
                 result.status = 0;
@@ -47,4 +130,11 @@ solver_result_t problem_manager_dispatch_solver(problem_manager_type_t type, con
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+void problem_manager_free_result(solver_result_t *result) {
+    free(result->message);
+    free(result->solution);
+    result->message = NULL;
+    result->solution = NULL;
+}
@@ -0,0 +1,17 @@
+#ifndef PROBLEM_MANAGER_OPTIONS_H
+#define PROBLEM_MANAGER_OPTIONS_H
+
+#include "problem_manager/problem_manager.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+#include "problems/sudoku/sudoku_solver.h"
+
+// Internal to the problem manager (and its tests): how request options
+// turn into the solvers' own. options may be NULL for the defaults.
+
+void problem_manager_sudoku_options(const problem_manager_options_t *options, sudoku_options_t *sudoku_options);
+
+// Blends go to the LP backend unless SCIP is asked for; the Sudoku engines
+// do not apply
+fertilizer_backend_t problem_manager_fertilizer_backend(const problem_manager_options_t *options);
+
+#endif
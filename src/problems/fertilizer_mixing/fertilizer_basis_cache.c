@@ -0,0 +1,429 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_basis_cache.h"
+
+// Smallest pivot accepted when inverting B; fractions are at least ~1e-3
+#define PIVOT_TOLERANCE 1e-12
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+    // FNV-1a
+    const unsigned char *bytes = data;
+    for (size_t n = 0; n < size; n++) {
+        hash ^= bytes[n];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t hash_catalog(const fertilizer_problem_t *problem) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hash_bytes(hash, &problem->product_count, sizeof(problem->product_count));
+    hash = hash_bytes(hash, &problem->nutrient_count, sizeof(problem->nutrient_count));
+    for (int i = 0; i < problem->product_count; i++) {
+        hash = hash_bytes(hash, problem->products[i].content,
+                          (size_t)problem->nutrient_count * sizeof(problem->products[i].content[0]));
+    }
+    return hash;
+}
+
+static bool same_catalog(const fertilizer_basis_catalog_t *catalog, const fertilizer_problem_t *problem,
+                         uint64_t hash) {
+    if (catalog->hash != hash || catalog->product_count != problem->product_count ||
+        catalog->nutrient_count != problem->nutrient_count) {
+        return false;
+    }
+    int m = catalog->nutrient_count;
+    for (int i = 0; i < catalog->product_count; i++) {
+        if (memcmp(&catalog->content[i * m], problem->products[i].content, (size_t)m * sizeof(double)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static fertilizer_basis_catalog_t *find_catalog(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                                uint64_t hash) {
+    for (size_t c = 0; c < cache->count; c++) {
+        if (same_catalog(&cache->catalogs[c], problem, hash)) {
+            return &cache->catalogs[c];
+        }
+    }
+    return NULL;
+}
+
+static void free_catalog(fertilizer_basis_catalog_t *catalog) {
+    free(catalog->content);
+    free(catalog->statuses);
+    memset(catalog, 0, sizeof(*catalog));
+}
+
+void fertilizer_basis_variable_bounds(const fertilizer_problem_t *problem, int v, double *lower, double *upper) {
+    if (v < problem->product_count) {
+        *lower = problem->products[v].min_amount;
+        *upper = problem->products[v].max_amount;
+    } else {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[v - problem->product_count];
+        *lower = nutrient->min * problem->area;
+        *upper = nutrient->max * problem->area;
+    }
+}
+
+static bool violates(double value, double lower, double upper) {
+    double tolerance = FERTILIZER_BASIS_CACHE_TOLERANCE;
+    return value < lower - tolerance * fmax(1.0, fabs(lower)) || value > upper + tolerance * fmax(1.0, fabs(upper));
+}
+
+// Whether basis is optimal for problem's bounds and prices; if so the
+// product amounts are left in amounts
+static bool basis_is_optimal(const fertilizer_basis_catalog_t *catalog, const fertilizer_cached_basis_t *basis,
+                             const fertilizer_problem_t *problem, double *amounts) {
+    int n = catalog->product_count;
+    int m = catalog->nutrient_count;
+    const double *content = catalog->content;
+    double lower = 0.0;
+    double upper = 0.0;
+
+    // q = N z_N with the nonbasic variables at the bounds their status names
+    double q[FERTILIZER_MAX_NUTRIENTS] = {0};
+    for (int v = 0; v < n + m; v++) {
+        int status = basis->status[v];
+        if (status == SCIP_BASESTAT_BASIC) {
+            continue;
+        }
+        fertilizer_basis_variable_bounds(problem, v, &lower, &upper);
+        double value = status == SCIP_BASESTAT_LOWER ? lower : status == SCIP_BASESTAT_UPPER ? upper : HUGE_VAL;
+        if (isinf(value)) {
+            return false;
+        }
+        if (v < n) {
+            amounts[v] = value;
+            for (int k = 0; k < m; k++) {
+                q[k] += content[v * m + k] * value;
+            }
+        } else {
+            q[v - n] -= value;
+        }
+    }
+
+    // Primal: x_B = -B^-1 q within bounds
+    for (int j = 0; j < m; j++) {
+        double value = 0.0;
+        for (int r = 0; r < m; r++) {
+            value -= basis->inverse[j * m + r] * q[r];
+        }
+        fertilizer_basis_variable_bounds(problem, basis->basic[j], &lower, &upper);
+        if (violates(value, lower, upper)) {
+            return false;
+        }
+        if (basis->basic[j] < n) {
+            amounts[basis->basic[j]] = value;
+        }
+    }
+
+    // Dual: y^T = c_B^T B^-1, activities cost nothing
+    double y[FERTILIZER_MAX_NUTRIENTS] = {0};
+    for (int j = 0; j < m; j++) {
+        if (basis->basic[j] >= n) {
+            continue;
+        }
+        double price = problem->products[basis->basic[j]].price;
+        for (int r = 0; r < m; r++) {
+            y[r] += price * basis->inverse[j * m + r];
+        }
+    }
+    // Reduced costs: c_i - y^T A_i for products, y_r for activities (column -e_r)
+    for (int v = 0; v < n + m; v++) {
+        int status = basis->status[v];
+        if (status == SCIP_BASESTAT_BASIC) {
+            continue;
+        }
+        fertilizer_basis_variable_bounds(problem, v, &lower, &upper);
+        if (lower == upper) {
+            continue;  // Fixed: either sign is optimal
+        }
+        double reduced = 0.0;
+        double scale = 1.0;
+        if (v < n) {
+            double price = problem->products[v].price;
+            reduced = price;
+            for (int k = 0; k < m; k++) {
+                reduced -= y[k] * content[v * m + k];
+            }
+            scale = fmax(1.0, fabs(price));
+        } else {
+            reduced = y[v - n];
+        }
+        double tolerance = FERTILIZER_BASIS_CACHE_TOLERANCE * scale;
+        if ((status == SCIP_BASESTAT_LOWER && reduced < -tolerance) ||
+            (status == SCIP_BASESTAT_UPPER && reduced > tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// B has columns A_i for basic products and -e_r for basic activities; it
+// is inverted by Gauss-Jordan elimination with partial pivoting
+bool fertilizer_basis_invert(const fertilizer_problem_t *problem, const int *col_basis, const int *row_basis,
+                             fertilizer_cached_basis_t *basis) {
+    int n = problem->product_count;
+    int m = problem->nutrient_count;
+    int count = 0;
+    for (int v = 0; v < n + m; v++) {
+        int status = v < n ? col_basis[v] : row_basis[v - n];
+        if (status == SCIP_BASESTAT_BASIC) {
+            if (count == m) {
+                return false;
+            }
+            basis->basic[count++] = v;
+        }
+    }
+    if (count != m) {
+        return false;
+    }
+
+    double work[FERTILIZER_MAX_NUTRIENTS * FERTILIZER_MAX_NUTRIENTS];
+    double *inverse = basis->inverse;
+    for (int r = 0; r < m; r++) {
+        for (int j = 0; j < m; j++) {
+            int v = basis->basic[j];
+            work[r * m + j] = v < n ? problem->products[v].content[r] : (v - n == r ? -1.0 : 0.0);
+            inverse[r * m + j] = r == j ? 1.0 : 0.0;
+        }
+    }
+    for (int col = 0; col < m; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < m; r++) {
+            if (fabs(work[r * m + col]) > fabs(work[pivot * m + col])) {
+                pivot = r;
+            }
+        }
+        if (fabs(work[pivot * m + col]) < PIVOT_TOLERANCE) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int c = 0; c < m; c++) {
+                double swap = work[col * m + c];
+                work[col * m + c] = work[pivot * m + c];
+                work[pivot * m + c] = swap;
+                swap = inverse[col * m + c];
+                inverse[col * m + c] = inverse[pivot * m + c];
+                inverse[pivot * m + c] = swap;
+            }
+        }
+        double scale = 1.0 / work[col * m + col];
+        for (int c = 0; c < m; c++) {
+            work[col * m + c] *= scale;
+            inverse[col * m + c] *= scale;
+        }
+        for (int r = 0; r < m; r++) {
+            double factor = work[r * m + col];
+            if (r == col || factor == 0.0) {
+                continue;
+            }
+            for (int c = 0; c < m; c++) {
+                work[r * m + c] -= factor * work[col * m + c];
+                inverse[r * m + c] -= factor * inverse[col * m + c];
+            }
+        }
+    }
+    return true;
+}
+
+// Moves bases[index] to the front, keeping the order of the others
+static void move_to_front(fertilizer_basis_catalog_t *catalog, int index) {
+    fertilizer_cached_basis_t basis = catalog->bases[index];
+    memmove(&catalog->bases[1], &catalog->bases[0], (size_t)index * sizeof(basis));
+    catalog->bases[0] = basis;
+}
+
+// A free slot for a new catalog, evicting the least recently used one when
+// full; NULL when out of memory
+static fertilizer_basis_catalog_t *add_catalog(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                               uint64_t hash) {
+    fertilizer_basis_catalog_t *catalog = NULL;
+    if (cache->count < cache->capacity) {
+        catalog = &cache->catalogs[cache->count++];
+    } else {
+        catalog = &cache->catalogs[0];
+        for (size_t c = 1; c < cache->count; c++) {
+            if (cache->catalogs[c].last_used < catalog->last_used) {
+                catalog = &cache->catalogs[c];
+            }
+        }
+        free_catalog(catalog);
+        cache->stats.evictions++;
+    }
+
+    int n = problem->product_count;
+    int m = problem->nutrient_count;
+    catalog->content = malloc((size_t)n * (size_t)m * sizeof(*catalog->content));
+    catalog->statuses = malloc((size_t)FERTILIZER_BASIS_CACHE_BASES * (size_t)(n + m) * sizeof(*catalog->statuses));
+    if (!catalog->content || !catalog->statuses) {
+        // Leave an empty catalog behind: it matches nothing and is reused
+        free_catalog(catalog);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        memcpy(&catalog->content[i * m], problem->products[i].content, (size_t)m * sizeof(double));
+    }
+    for (int b = 0; b < FERTILIZER_BASIS_CACHE_BASES; b++) {
+        catalog->bases[b].status = &catalog->statuses[b * (n + m)];
+    }
+    catalog->hash = hash;
+    catalog->product_count = n;
+    catalog->nutrient_count = m;
+    return catalog;
+}
+
+int fertilizer_basis_cache_init(fertilizer_basis_cache_t *cache, size_t capacity) {
+    memset(cache, 0, sizeof(*cache));
+    cache->catalogs = calloc(capacity > 0 ? capacity : 1, sizeof(*cache->catalogs));
+    if (!cache->catalogs) {
+        return EXIT_FAILURE;
+    }
+    cache->capacity = capacity;
+    cache->stats.capacity = capacity;
+    pthread_mutex_init(&cache->lock, NULL);
+    return EXIT_SUCCESS;
+}
+
+void fertilizer_basis_cache_free(fertilizer_basis_cache_t *cache) {
+    if (!cache->catalogs) {
+        return;
+    }
+    pthread_mutex_destroy(&cache->lock);
+    for (size_t c = 0; c < cache->count; c++) {
+        free_catalog(&cache->catalogs[c]);
+    }
+    free(cache->catalogs);
+    memset(cache, 0, sizeof(*cache));
+}
+
+bool fertilizer_basis_cache_lookup(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                   fertilizer_solution_t *solution, int *col_basis, int *row_basis, bool *warm) {
+    *warm = false;
+    uint64_t hash = hash_catalog(problem);
+    int n = problem->product_count;
+    bool hit = false;
+
+    pthread_mutex_lock(&cache->lock);
+    fertilizer_basis_catalog_t *catalog = find_catalog(cache, problem, hash);
+    if (catalog) {
+        catalog->last_used = ++cache->clock;
+        for (int b = 0; b < catalog->basis_count && !hit; b++) {
+            if (basis_is_optimal(catalog, &catalog->bases[b], problem, solution->amounts)) {
+                move_to_front(catalog, b);
+                hit = true;
+            }
+        }
+        // The hit basis or else the most recent one
+        if (catalog->basis_count > 0) {
+            const int *status = catalog->bases[0].status;
+            memcpy(col_basis, status, (size_t)n * sizeof(*col_basis));
+            memcpy(row_basis, &status[n], (size_t)problem->nutrient_count * sizeof(*row_basis));
+            *warm = !hit;
+        }
+    }
+    if (hit) {
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+        cache->stats.warm_starts += *warm;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (hit) {
+        solution->cost = 0.0;
+        for (int i = 0; i < n; i++) {
+            solution->cost += problem->products[i].price * solution->amounts[i];
+        }
+        fertilizer_solution_finish(problem, solution, FERTILIZER_BASIS_CACHE_TOLERANCE);
+        solution->status = FERTILIZER_OPTIMAL;
+    }
+    return hit;
+}
+
+void fertilizer_basis_cache_insert(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                                   const int *col_basis, const int *row_basis) {
+    if (cache->capacity == 0) {
+        return;
+    }
+    // Invert outside the lock
+    fertilizer_cached_basis_t basis;
+    if (!fertilizer_basis_invert(problem, col_basis, row_basis, &basis)) {
+        return;
+    }
+    uint64_t hash = hash_catalog(problem);
+    int n = problem->product_count;
+    int m = problem->nutrient_count;
+
+    pthread_mutex_lock(&cache->lock);
+    fertilizer_basis_catalog_t *catalog = find_catalog(cache, problem, hash);
+    if (!catalog) {
+        catalog = add_catalog(cache, problem, hash);
+    }
+    if (catalog) {
+        catalog->last_used = ++cache->clock;
+        // The same basis again only moves up; otherwise the oldest one is
+        // overwritten
+        int index = 0;
+        while (index < catalog->basis_count &&
+               (memcmp(catalog->bases[index].status, col_basis, (size_t)n * sizeof(*col_basis)) != 0 ||
+                memcmp(&catalog->bases[index].status[n], row_basis, (size_t)m * sizeof(*row_basis)) != 0)) {
+            index++;
+        }
+        if (index == catalog->basis_count) {
+            if (catalog->basis_count < FERTILIZER_BASIS_CACHE_BASES) {
+                catalog->basis_count++;
+            } else {
+                index--;
+            }
+            fertilizer_cached_basis_t *slot = &catalog->bases[index];
+            memcpy(slot->status, col_basis, (size_t)n * sizeof(*col_basis));
+            memcpy(&slot->status[n], row_basis, (size_t)m * sizeof(*row_basis));
+            memcpy(slot->basic, basis.basic, sizeof(basis.basic));
+            memcpy(slot->inverse, basis.inverse, sizeof(basis.inverse));
+            cache->stats.insertions++;
+        }
+        move_to_front(catalog, index);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void fertilizer_basis_cache_clear(fertilizer_basis_cache_t *cache) {
+    pthread_mutex_lock(&cache->lock);
+    for (size_t c = 0; c < cache->count; c++) {
+        free_catalog(&cache->catalogs[c]);
+    }
+    cache->count = 0;
+    cache->clock = 0;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    cache->stats.capacity = cache->capacity;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void fertilizer_basis_cache_get_stats(fertilizer_basis_cache_t *cache, fertilizer_basis_cache_stats_t *stats) {
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    stats->entries = cache->count;
+    size_t lookups = stats->hits + stats->misses;
+    stats->hit_rate = lookups > 0 ? (double)stats->hits / (double)lookups : 0.0;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static fertilizer_basis_cache_t basis_cache;
+static bool basis_cache_ready = false;
+static pthread_once_t basis_cache_once = PTHREAD_ONCE_INIT;
+
+static void init_basis_cache(void) {
+    basis_cache_ready =
+        fertilizer_basis_cache_init(&basis_cache, FERTILIZER_BASIS_CACHE_DEFAULT_CAPACITY) == EXIT_SUCCESS;
+}
+
+fertilizer_basis_cache_t *fertilizer_basis_cache(void) {
+    pthread_once(&basis_cache_once, init_basis_cache);
+    return basis_cache_ready ? &basis_cache : NULL;
+}
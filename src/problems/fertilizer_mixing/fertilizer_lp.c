@@ -0,0 +1,211 @@
+#include <stdlib.h>
+#include <string.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_lp.h"
+#include "problems/fertilizer_mixing/fertilizer_sensitivity.h"
+
+int fertilizer_lp_matrix_build(const fertilizer_problem_t *problem, double infinity, bool all_rows,
+                               fertilizer_lp_matrix_t *matrix) {
+    memset(matrix, 0, sizeof(*matrix));
+
+    // Rows only for nutrients with a bound; row_of maps nutrients to rows
+    int row_of[FERTILIZER_MAX_NUTRIENTS];
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+        row_of[k] = -1;
+        if (all_rows || nutrient->min > 0.0 || !isinf(nutrient->max)) {
+            row_of[k] = matrix->nrows;
+            matrix->row_nutrient[matrix->nrows++] = k;
+        }
+    }
+
+    size_t ncols = (size_t)problem->product_count;
+    size_t nnonz = 0;
+    for (int i = 0; i < problem->product_count; i++) {
+        for (int k = 0; k < problem->nutrient_count; k++) {
+            nnonz += row_of[k] >= 0 && problem->products[i].content[k] > 0.0;
+        }
+    }
+
+    matrix->ncols = problem->product_count;
+    matrix->obj = malloc(ncols * sizeof(*matrix->obj));
+    matrix->lb = malloc(ncols * sizeof(*matrix->lb));
+    matrix->ub = malloc(ncols * sizeof(*matrix->ub));
+    matrix->beg = malloc(ncols * sizeof(*matrix->beg));
+    matrix->lhs = malloc(FERTILIZER_MAX_NUTRIENTS * sizeof(*matrix->lhs));
+    matrix->rhs = malloc(FERTILIZER_MAX_NUTRIENTS * sizeof(*matrix->rhs));
+    // At least one entry so an empty matrix is not mistaken for a failure
+    matrix->ind = malloc((nnonz + 1) * sizeof(*matrix->ind));
+    matrix->val = malloc((nnonz + 1) * sizeof(*matrix->val));
+    if (!matrix->obj || !matrix->lb || !matrix->ub || !matrix->beg || !matrix->lhs || !matrix->rhs || !matrix->ind ||
+        !matrix->val) {
+        fertilizer_lp_matrix_free(matrix);
+        return EXIT_FAILURE;
+    }
+
+    for (int r = 0; r < matrix->nrows; r++) {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[matrix->row_nutrient[r]];
+        matrix->lhs[r] = nutrient->min * problem->area;
+        matrix->rhs[r] = isinf(nutrient->max) ? infinity : nutrient->max * problem->area;
+    }
+    for (int i = 0; i < problem->product_count; i++) {
+        const fertilizer_product_t *product = &problem->products[i];
+        matrix->obj[i] = product->price;
+        matrix->lb[i] = product->min_amount;
+        matrix->ub[i] = isinf(product->max_amount) ? infinity : product->max_amount;
+        matrix->beg[i] = matrix->nnonz;
+        for (int r = 0; r < matrix->nrows; r++) {
+            double fraction = product->content[matrix->row_nutrient[r]];
+            if (fraction > 0.0) {
+                matrix->ind[matrix->nnonz] = r;
+                matrix->val[matrix->nnonz] = fraction;
+                matrix->nnonz++;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+void fertilizer_lp_matrix_free(fertilizer_lp_matrix_t *matrix) {
+    free(matrix->obj);
+    free(matrix->lb);
+    free(matrix->ub);
+    free(matrix->lhs);
+    free(matrix->rhs);
+    free(matrix->beg);
+    free(matrix->ind);
+    free(matrix->val);
+    memset(matrix, 0, sizeof(*matrix));
+}
+
+SCIP_RETCODE fertilizer_lp_create(SCIP_LPI **lpi) {
+    if (!*lpi) {
+        SCIP_CALL(SCIPlpiCreate(lpi, NULL, "fertilizer_mixing", SCIP_OBJSEN_MINIMIZE));
+        SCIP_CALL(SCIPlpiSetIntpar(*lpi, SCIP_LPPAR_LPINFO, FALSE));
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE fertilizer_lp_load(SCIP_LPI *lpi, const fertilizer_lp_matrix_t *matrix) {
+    SCIP_CALL(SCIPlpiLoadColLP(lpi, SCIP_OBJSEN_MINIMIZE, matrix->ncols, matrix->obj, matrix->lb, matrix->ub, NULL,
+                               matrix->nrows, matrix->lhs, matrix->rhs, NULL, matrix->nnonz, matrix->beg,
+                               matrix->ind, matrix->val));
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE fertilizer_lp_extract(SCIP_LPI *lpi, const fertilizer_problem_t *problem,
+                                   fertilizer_solution_t *solution) {
+    solution->status = FERTILIZER_NOT_SOLVED;
+    if (SCIPlpiIsOptimal(lpi)) {
+        SCIP_Real feastol = 0.0;
+        SCIP_CALL(SCIPlpiGetRealpar(lpi, SCIP_LPPAR_FEASTOL, &feastol));
+        SCIP_CALL(SCIPlpiGetSol(lpi, &solution->cost, solution->amounts, NULL, NULL, NULL));
+        fertilizer_solution_finish(problem, solution, feastol);
+        solution->status = FERTILIZER_OPTIMAL;
+    } else if (SCIPlpiIsPrimalInfeasible(lpi)) {
+        solution->status = FERTILIZER_INFEASIBLE;
+    } else if (SCIPlpiIsPrimalUnbounded(lpi) || SCIPlpiIsDualInfeasible(lpi)) {
+        solution->status = FERTILIZER_UNBOUNDED;
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE solve_matrix(SCIP_LPI *lpi, const fertilizer_problem_t *problem,
+                                 const fertilizer_lp_matrix_t *matrix, fertilizer_solution_t *solution) {
+    SCIP_CALL(fertilizer_lp_load(lpi, matrix));
+    SCIP_CALL(SCIPlpiSolveDual(lpi));
+    SCIP_CALL(fertilizer_lp_extract(lpi, problem, solution));
+    return SCIP_OKAY;
+}
+
+// Sensitivity from the final basis; nutrients left out of the LP count as
+// 0 <= activity rows with a basic activity
+static SCIP_RETCODE matrix_sensitivity(SCIP_LPI *lpi, const fertilizer_problem_t *problem,
+                                       const fertilizer_lp_matrix_t *matrix, fertilizer_solution_t *solution) {
+    int *col_basis = malloc((size_t)problem->product_count * sizeof(*col_basis));
+    if (!col_basis) {
+        return SCIP_NOMEMORY;
+    }
+    int lp_rows[FERTILIZER_MAX_NUTRIENTS];
+    SCIP_RETCODE retcode = SCIPlpiGetBase(lpi, col_basis, lp_rows);
+    if (retcode == SCIP_OKAY) {
+        int row_basis[FERTILIZER_MAX_NUTRIENTS];
+        for (int k = 0; k < problem->nutrient_count; k++) {
+            row_basis[k] = SCIP_BASESTAT_BASIC;
+        }
+        for (int r = 0; r < matrix->nrows; r++) {
+            row_basis[matrix->row_nutrient[r]] = lp_rows[r];
+        }
+        fertilizer_sensitivity_compute(problem, col_basis, row_basis, solution);
+    }
+    free(col_basis);
+    return retcode;
+}
+
+SCIP_RETCODE fertilizer_lp_solve(SCIP_LPI **lpi, const fertilizer_problem_t *problem,
+                                 fertilizer_solution_t *solution, bool sensitivity) {
+    solution->status = FERTILIZER_NOT_SOLVED;
+    solution->sensitivity.valid = false;
+    SCIP_CALL(fertilizer_lp_create(lpi));
+    fertilizer_lp_matrix_t matrix;
+    if (fertilizer_lp_matrix_build(problem, SCIPlpiInfinity(*lpi), false, &matrix) != EXIT_SUCCESS) {
+        return SCIP_NOMEMORY;
+    }
+    SCIP_RETCODE retcode = solve_matrix(*lpi, problem, &matrix, solution);
+    if (retcode == SCIP_OKAY && sensitivity && solution->status == FERTILIZER_OPTIMAL) {
+        retcode = matrix_sensitivity(*lpi, problem, &matrix, solution);
+    }
+    fertilizer_lp_matrix_free(&matrix);
+    return retcode;
+}
+
+static SCIP_RETCODE solve_from_basis(SCIP_LPI *lpi, fertilizer_basis_cache_t *cache,
+                                     const fertilizer_problem_t *problem, fertilizer_solution_t *solution,
+                                     int *col_basis, int *row_basis, bool warm) {
+    fertilizer_lp_matrix_t matrix;
+    if (fertilizer_lp_matrix_build(problem, SCIPlpiInfinity(lpi), true, &matrix) != EXIT_SUCCESS) {
+        return SCIP_NOMEMORY;
+    }
+    SCIP_RETCODE retcode = fertilizer_lp_load(lpi, &matrix);
+    fertilizer_lp_matrix_free(&matrix);
+    SCIP_CALL(retcode);
+    if (warm) {
+        SCIP_CALL(SCIPlpiSetBase(lpi, col_basis, row_basis));
+    }
+    SCIP_CALL(SCIPlpiSolveDual(lpi));
+    SCIP_CALL(fertilizer_lp_extract(lpi, problem, solution));
+    if (solution->status == FERTILIZER_OPTIMAL) {
+        SCIP_CALL(SCIPlpiGetBase(lpi, col_basis, row_basis));
+        fertilizer_basis_cache_insert(cache, problem, col_basis, row_basis);
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE fertilizer_lp_solve_cached(SCIP_LPI **lpi, fertilizer_basis_cache_t *cache,
+                                        const fertilizer_problem_t *problem, fertilizer_solution_t *solution,
+                                        bool sensitivity, bool *from_cache) {
+    solution->status = FERTILIZER_NOT_SOLVED;
+    solution->sensitivity.valid = false;
+    *from_cache = false;
+    int *col_basis = malloc((size_t)problem->product_count * sizeof(*col_basis));
+    int row_basis[FERTILIZER_MAX_NUTRIENTS];
+    if (!col_basis) {
+        return SCIP_NOMEMORY;
+    }
+    bool warm = false;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    if (fertilizer_basis_cache_lookup(cache, problem, solution, col_basis, row_basis, &warm)) {
+        *from_cache = true;
+    } else {
+        retcode = fertilizer_lp_create(lpi);
+        if (retcode == SCIP_OKAY) {
+            retcode = solve_from_basis(*lpi, cache, problem, solution, col_basis, row_basis, warm);
+        }
+    }
+    // Both paths leave the optimal basis in col_basis and row_basis
+    if (retcode == SCIP_OKAY && sensitivity && solution->status == FERTILIZER_OPTIMAL) {
+        fertilizer_sensitivity_compute(problem, col_basis, row_basis, solution);
+    }
+    free(col_basis);
+    return retcode;
+}
@@ -0,0 +1,612 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mongoose/mongoose.h"
+#include "problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+
+// Fractions may add up to slightly more than 1 from rounding in catalogs
+#define COMPOSITION_SLACK 1e-6
+
+static int fail(char **error_msg, const char *format, ...) {
+    if (error_msg) {
+        char message[160];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+        *error_msg = strdup(message);
+    }
+    return EXIT_FAILURE;
+}
+
+static bool is_null(struct mg_str token) {
+    return token.len == 4 && memcmp(token.buf, "null", 4) == 0;
+}
+
+// Unescapes a JSON string token (quotes included) into name
+static bool copy_name(struct mg_str token, char name[FERTILIZER_NAME_LEN]) {
+    if (token.len < 3 || token.buf[0] != '"' || token.len - 2 >= FERTILIZER_NAME_LEN) {
+        return false;
+    }
+    memset(name, 0, FERTILIZER_NAME_LEN);
+    return mg_json_unescape(mg_str_n(token.buf + 1, token.len - 2), name, FERTILIZER_NAME_LEN);
+}
+
+static bool is_key(struct mg_str key, const char *name) {
+    size_t len = strlen(name);
+    return key.len == len + 2 && memcmp(key.buf + 1, name, len) == 0;
+}
+
+// Number token; with optional set, null leaves *value unchanged. Tokens end
+// at a JSON delimiter, so strtod() cannot run past them.
+static bool read_number(struct mg_str token, bool optional, double *value) {
+    if (optional && is_null(token)) {
+        return true;
+    }
+    if (token.len == 0 || token.buf[0] == '"' || token.buf[0] == '{' || token.buf[0] == '[') {
+        return false;
+    }
+    char *end = NULL;
+    double number = strtod(token.buf, &end);
+    if (end != token.buf + token.len || !isfinite(number)) {
+        return false;
+    }
+    *value = number;
+    return true;
+}
+
+static int find_nutrient(const fertilizer_problem_t *problem, const char *name) {
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        if (strcmp(problem->nutrients[k].name, name) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static int parse_nutrients(struct mg_str nutrients, fertilizer_problem_t *problem, char **error_msg) {
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    while ((ofs = mg_json_next(nutrients, ofs, &key, &value)) > 0) {
+        if (problem->nutrient_count == FERTILIZER_MAX_NUTRIENTS) {
+            return fail(error_msg, "At most %d nutrients are supported", FERTILIZER_MAX_NUTRIENTS);
+        }
+        fertilizer_nutrient_t *nutrient = &problem->nutrients[problem->nutrient_count];
+        if (!copy_name(key, nutrient->name)) {
+            return fail(error_msg, "Invalid nutrient name");
+        }
+        if (find_nutrient(problem, nutrient->name) >= 0) {
+            return fail(error_msg, "Duplicate nutrient '%s'", nutrient->name);
+        }
+        if (value.len == 0 || value.buf[0] != '{') {
+            return fail(error_msg, "Nutrient '%s' must be an object with min and/or max", nutrient->name);
+        }
+        nutrient->min = 0.0;
+        nutrient->max = FERTILIZER_UNLIMITED;
+        struct mg_str member;
+        struct mg_str bound;
+        size_t member_ofs = 0;
+        while ((member_ofs = mg_json_next(value, member_ofs, &member, &bound)) > 0) {
+            double *target = is_key(member, "min") ? &nutrient->min : is_key(member, "max") ? &nutrient->max : NULL;
+            if (target && !read_number(bound, true, target)) {
+                return fail(error_msg, "Nutrient '%s' has a non-numeric bound", nutrient->name);
+            }
+        }
+        if (nutrient->min < 0.0 || nutrient->min > nutrient->max) {
+            return fail(error_msg, "Nutrient '%s' needs 0 <= min <= max", nutrient->name);
+        }
+        problem->nutrient_count++;
+    }
+    if (problem->nutrient_count == 0) {
+        return fail(error_msg, "No nutrient targets given");
+    }
+    return EXIT_SUCCESS;
+}
+
+static int parse_composition(struct mg_str composition, const fertilizer_problem_t *problem,
+                             fertilizer_product_t *product, char **error_msg) {
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    double total = 0.0;
+    while ((ofs = mg_json_next(composition, ofs, &key, &value)) > 0) {
+        char name[FERTILIZER_NAME_LEN];
+        double fraction = NAN;
+        if (!read_number(value, false, &fraction) || !(fraction >= 0.0 && fraction <= 1.0)) {
+            return fail(error_msg, "Product '%s' has a composition fraction outside [0, 1]", product->name);
+        }
+        total += fraction;
+        int k = copy_name(key, name) ? find_nutrient(problem, name) : -1;
+        if (k >= 0) {
+            product->content[k] = fraction;
+        }
+    }
+    if (total > 1.0 + COMPOSITION_SLACK) {
+        return fail(error_msg, "Product '%s' has fractions adding up to more than 1", product->name);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Reads the members in a single pass: catalogs have hundreds of products,
+// and a path lookup per member would rescan each product object
+static int parse_product(struct mg_str obj, const fertilizer_problem_t *problem, fertilizer_product_t *product,
+                         int index, char **error_msg) {
+    if (obj.len == 0 || obj.buf[0] != '{') {
+        return fail(error_msg, "Product %d is not an object", index);
+    }
+    struct mg_str name = {NULL, 0};
+    struct mg_str price = {NULL, 0};
+    struct mg_str composition = {NULL, 0};
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    product->min_amount = 0.0;
+    product->max_amount = FERTILIZER_UNLIMITED;
+    bool amounts_ok = true;
+    while ((ofs = mg_json_next(obj, ofs, &key, &value)) > 0) {
+        if (is_key(key, "name")) {
+            name = value;
+        } else if (is_key(key, "price")) {
+            price = value;
+        } else if (is_key(key, "composition")) {
+            composition = value;
+        } else if (is_key(key, "min")) {
+            amounts_ok &= read_number(value, true, &product->min_amount);
+        } else if (is_key(key, "available")) {
+            amounts_ok &= read_number(value, true, &product->max_amount);
+        }
+    }
+
+    if (!copy_name(name, product->name)) {
+        return fail(error_msg, "Product %d needs a name of at most %d characters", index, FERTILIZER_NAME_LEN - 1);
+    }
+    if (!read_number(price, false, &product->price)) {
+        return fail(error_msg, "Product '%s' needs a numeric price", product->name);
+    }
+    if (!amounts_ok) {
+        return fail(error_msg, "Product '%s' has a non-numeric amount limit", product->name);
+    }
+    if (product->min_amount < 0.0 || product->min_amount > product->max_amount) {
+        return fail(error_msg, "Product '%s' needs 0 <= min <= available", product->name);
+    }
+    if (composition.len == 0 || composition.buf[0] != '{') {
+        return fail(error_msg, "Product '%s' needs a composition object", product->name);
+    }
+    memset(product->content, 0, sizeof(product->content));
+    return parse_composition(composition, problem, product, error_msg);
+}
+
+// Single pass with a growing array; counting first would scan the catalog
+// once more
+static int parse_products(struct mg_str products, fertilizer_problem_t *problem, char **error_msg) {
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    int capacity = 0;
+    while ((ofs = mg_json_next(products, ofs, &key, &value)) > 0) {
+        if (problem->product_count == FERTILIZER_MAX_PRODUCTS) {
+            return fail(error_msg, "At most %d products are supported", FERTILIZER_MAX_PRODUCTS);
+        }
+        if (problem->product_count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            fertilizer_product_t *grown = realloc(problem->products, (size_t)capacity * sizeof(*grown));
+            if (!grown) {
+                return fail(error_msg, "Out of memory");
+            }
+            problem->products = grown;
+        }
+        fertilizer_product_t *product = &problem->products[problem->product_count];
+        if (parse_product(value, problem, product, problem->product_count, error_msg) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        problem->product_count++;
+    }
+    if (problem->product_count == 0) {
+        return fail(error_msg, "The product catalog is empty");
+    }
+    return EXIT_SUCCESS;
+}
+
+int fertilizer_parse(const char *data, fertilizer_problem_t *problem, char **error_msg) {
+    memset(problem, 0, sizeof(*problem));
+    if (!data || data[0] == '\0') {
+        return fail(error_msg, "No data provided");
+    }
+    const char *start = data + strspn(data, " \t\r\n");
+    if (*start != '{') {
+        return fail(error_msg, "Fertilizer data must be a JSON object");
+    }
+
+    // Top-level members in one pass, like the products below
+    struct mg_str json = mg_str(start);
+    struct mg_str area = {NULL, 0};
+    struct mg_str nutrients = {NULL, 0};
+    struct mg_str products = {NULL, 0};
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    while ((ofs = mg_json_next(json, ofs, &key, &value)) > 0) {
+        if (is_key(key, "area")) {
+            area = value;
+        } else if (is_key(key, "nutrients")) {
+            nutrients = value;
+        } else if (is_key(key, "products")) {
+            products = value;
+        }
+    }
+
+    problem->area = 1.0;
+    if ((area.buf && !read_number(area, true, &problem->area)) || !(problem->area > 0.0)) {
+        return fail(error_msg, "Area must be a positive number of hectares");
+    }
+    if (nutrients.len == 0 || nutrients.buf[0] != '{') {
+        return fail(error_msg, "Missing nutrients object");
+    }
+    if (parse_nutrients(nutrients, problem, error_msg) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if (products.len == 0 || products.buf[0] != '[') {
+        return fail(error_msg, "Missing products array");
+    }
+    if (parse_products(products, problem, error_msg) != EXIT_SUCCESS) {
+        fertilizer_problem_free(problem);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+void fertilizer_problem_free(fertilizer_problem_t *problem) {
+    free(problem->products);
+    problem->products = NULL;
+    problem->product_count = 0;
+}
+
+static int find_product(const fertilizer_problem_t *problem, const char *name) {
+    for (int i = 0; i < problem->product_count; i++) {
+        if (strcmp(problem->products[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int parse_price_updates(struct mg_str prices, const fertilizer_problem_t *problem,
+                               fertilizer_update_t *update, char **error_msg) {
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    int count = 0;
+    while ((ofs = mg_json_next(prices, ofs, &key, &value)) > 0) {
+        count++;
+    }
+    if (count > problem->product_count) {
+        return fail(error_msg, "More prices than products");
+    }
+    update->price_products = malloc((size_t)(count ? count : 1) * sizeof(*update->price_products));
+    update->prices = malloc((size_t)(count ? count : 1) * sizeof(*update->prices));
+    if (!update->price_products || !update->prices) {
+        return fail(error_msg, "Out of memory");
+    }
+
+    ofs = 0;
+    while ((ofs = mg_json_next(prices, ofs, &key, &value)) > 0) {
+        char name[FERTILIZER_NAME_LEN];
+        int i = copy_name(key, name) ? find_product(problem, name) : -1;
+        if (i < 0) {
+            return fail(error_msg, "Unknown product in price update");
+        }
+        double price = NAN;
+        if (!read_number(value, false, &price)) {
+            return fail(error_msg, "Product '%s' needs a numeric price", name);
+        }
+        update->price_products[update->price_count] = i;
+        update->prices[update->price_count] = price;
+        update->price_count++;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int parse_target_updates(struct mg_str nutrients, const fertilizer_problem_t *problem,
+                                fertilizer_update_t *update, char **error_msg) {
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    while ((ofs = mg_json_next(nutrients, ofs, &key, &value)) > 0) {
+        char name[FERTILIZER_NAME_LEN];
+        int k = copy_name(key, name) ? find_nutrient(problem, name) : -1;
+        if (k < 0) {
+            return fail(error_msg, "Unknown nutrient in target update");
+        }
+        for (int t = 0; t < update->target_count; t++) {
+            if (update->target_nutrients[t] == k) {
+                return fail(error_msg, "Duplicate nutrient '%s'", name);
+            }
+        }
+        if (value.len == 0 || value.buf[0] != '{') {
+            return fail(error_msg, "Nutrient '%s' must be an object with min and/or max", name);
+        }
+        int t = update->target_count;
+        double min = problem->nutrients[k].min;
+        double max = problem->nutrients[k].max;
+        struct mg_str member;
+        struct mg_str bound;
+        size_t member_ofs = 0;
+        while ((member_ofs = mg_json_next(value, member_ofs, &member, &bound)) > 0) {
+            bool is_min = is_key(member, "min");
+            if (!is_min && !is_key(member, "max")) {
+                continue;
+            }
+            // null reopens the bound
+            double *target = is_min ? &min : &max;
+            *target = is_min ? 0.0 : FERTILIZER_UNLIMITED;
+            if (!read_number(bound, true, target)) {
+                return fail(error_msg, "Nutrient '%s' has a non-numeric bound", name);
+            }
+        }
+        if (min < 0.0 || min > max) {
+            return fail(error_msg, "Nutrient '%s' needs 0 <= min <= max", name);
+        }
+        update->target_nutrients[t] = k;
+        update->target_min[t] = min;
+        update->target_max[t] = max;
+        update->target_count++;
+    }
+    return EXIT_SUCCESS;
+}
+
+int fertilizer_parse_update(const char *data, const fertilizer_problem_t *problem, fertilizer_update_t *update,
+                            char **error_msg) {
+    memset(update, 0, sizeof(*update));
+    if (!data || data[0] == '\0') {
+        return fail(error_msg, "No data provided");
+    }
+    const char *start = data + strspn(data, " \t\r\n");
+    if (*start != '{') {
+        return fail(error_msg, "Update must be a JSON object");
+    }
+
+    struct mg_str json = mg_str(start);
+    struct mg_str key;
+    struct mg_str value;
+    size_t ofs = 0;
+    int status = EXIT_SUCCESS;
+    while (status == EXIT_SUCCESS && (ofs = mg_json_next(json, ofs, &key, &value)) > 0) {
+        if (is_key(key, "prices") && value.len > 0 && value.buf[0] == '{' && !update->prices) {
+            status = parse_price_updates(value, problem, update, error_msg);
+        } else if (is_key(key, "nutrients") && value.len > 0 && value.buf[0] == '{' && update->target_count == 0) {
+            status = parse_target_updates(value, problem, update, error_msg);
+        } else if (is_key(key, "prices") || is_key(key, "nutrients")) {
+            status = fail(error_msg, "Update needs prices and nutrients as objects, each given once");
+        }
+    }
+    if (status != EXIT_SUCCESS) {
+        fertilizer_update_free(update);
+    }
+    return status;
+}
+
+void fertilizer_update_free(fertilizer_update_t *update) {
+    free(update->price_products);
+    free(update->prices);
+    memset(update, 0, sizeof(*update));
+}
+
+void fertilizer_problem_apply(fertilizer_problem_t *problem, const fertilizer_update_t *update) {
+    for (int n = 0; n < update->price_count; n++) {
+        problem->products[update->price_products[n]].price = update->prices[n];
+    }
+    for (int t = 0; t < update->target_count; t++) {
+        fertilizer_nutrient_t *nutrient = &problem->nutrients[update->target_nutrients[t]];
+        nutrient->min = update->target_min[t];
+        nutrient->max = update->target_max[t];
+    }
+}
+
+int fertilizer_solution_init(fertilizer_solution_t *solution, const fertilizer_problem_t *problem) {
+    memset(solution, 0, sizeof(*solution));
+    solution->status = FERTILIZER_NOT_SOLVED;
+    solution->amounts = calloc((size_t)problem->product_count, sizeof(*solution->amounts));
+    solution->product_binding = calloc((size_t)problem->product_count, sizeof(*solution->product_binding));
+    // One block behind the three per-product sensitivity arrays
+    fertilizer_sensitivity_t *sensitivity = &solution->sensitivity;
+    sensitivity->reduced_cost = calloc(3 * (size_t)problem->product_count, sizeof(*sensitivity->reduced_cost));
+    if (!solution->amounts || !solution->product_binding || !sensitivity->reduced_cost) {
+        fertilizer_solution_free(solution);
+        return EXIT_FAILURE;
+    }
+    sensitivity->price_low = sensitivity->reduced_cost + problem->product_count;
+    sensitivity->price_high = sensitivity->price_low + problem->product_count;
+    return EXIT_SUCCESS;
+}
+
+void fertilizer_solution_free(fertilizer_solution_t *solution) {
+    free(solution->amounts);
+    free(solution->product_binding);
+    free(solution->sensitivity.reduced_cost);
+    solution->amounts = NULL;
+    solution->product_binding = NULL;
+    memset(&solution->sensitivity, 0, sizeof(solution->sensitivity));
+}
+
+static bool feas_eq(double a, double b, double feastol) {
+    double scale = fmax(fmax(fabs(a), fabs(b)), 1.0);
+    return fabs(a - b) <= feastol * scale;
+}
+
+static fertilizer_bound_t binding_bound(double value, double lower, double upper, double feastol) {
+    if (!isinf(upper) && feas_eq(value, upper, feastol)) {
+        return FERTILIZER_BOUND_MAX;
+    }
+    if (lower > 0.0 && feas_eq(value, lower, feastol)) {
+        return FERTILIZER_BOUND_MIN;
+    }
+    return FERTILIZER_BOUND_NONE;
+}
+
+void fertilizer_solution_finish(const fertilizer_problem_t *problem, fertilizer_solution_t *solution, double feastol) {
+    double supplied[FERTILIZER_MAX_NUTRIENTS] = {0};
+    for (int i = 0; i < problem->product_count; i++) {
+        const fertilizer_product_t *product = &problem->products[i];
+        // Unused products read as exactly zero
+        if (feas_eq(solution->amounts[i], 0.0, feastol)) {
+            solution->amounts[i] = 0.0;
+        }
+        double amount = solution->amounts[i];
+        solution->product_binding[i] = binding_bound(amount, product->min_amount, product->max_amount, feastol);
+        for (int k = 0; k < problem->nutrient_count; k++) {
+            supplied[k] += product->content[k] * amount;
+        }
+    }
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+        solution->supplied[k] = supplied[k] / problem->area;
+        solution->nutrient_binding[k] = binding_bound(supplied[k], nutrient->min * problem->area,
+                                                      nutrient->max * problem->area, feastol);
+    }
+}
+
+// Growable output buffer; a failed allocation sticks and makes the result NULL
+typedef struct {
+    char *text;
+    size_t len;
+    size_t cap;
+    bool failed;
+} json_buffer_t;
+
+static void append(json_buffer_t *out, const char *format, ...) {
+    if (out->failed) {
+        return;
+    }
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out->text + out->len, out->cap - out->len, format, args);
+        va_end(args);
+        if (written < 0) {
+            out->failed = true;
+            return;
+        }
+        if ((size_t)written < out->cap - out->len) {
+            out->len += (size_t)written;
+            return;
+        }
+        size_t cap = out->cap * 2 + (size_t)written;
+        char *text = realloc(out->text, cap);
+        if (!text) {
+            out->failed = true;
+            return;
+        }
+        out->text = text;
+        out->cap = cap;
+    }
+}
+
+static void append_name(json_buffer_t *out, const char *name) {
+    append(out, "\"");
+    for (const char *c = name; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            append(out, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            append(out, "\\u%04x", (unsigned)*c);
+        } else {
+            append(out, "%c", *c);
+        }
+    }
+    append(out, "\"");
+}
+
+static void append_bound(json_buffer_t *out, double bound) {
+    if (isinf(bound)) {
+        append(out, "null");
+    } else {
+        append(out, "%.10g", bound);
+    }
+}
+
+static void append_range(json_buffer_t *out, double low, double high) {
+    append(out, "[");
+    append_bound(out, low);
+    append(out, ",");
+    append_bound(out, high);
+    append(out, "]");
+}
+
+static void append_sensitivity(json_buffer_t *out, const fertilizer_problem_t *problem,
+                               const fertilizer_sensitivity_t *sensitivity) {
+    append(out, ",\"sensitivity\":{\"products\":[");
+    for (int i = 0; i < problem->product_count; i++) {
+        append(out, i == 0 ? "{\"name\":" : ",{\"name\":");
+        append_name(out, problem->products[i].name);
+        append(out, ",\"reduced_cost\":%.10g,\"price_range\":", sensitivity->reduced_cost[i]);
+        append_range(out, sensitivity->price_low[i], sensitivity->price_high[i]);
+        append(out, "}");
+    }
+    append(out, "],\"nutrients\":[");
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        append(out, k == 0 ? "{\"name\":" : ",{\"name\":");
+        append_name(out, problem->nutrients[k].name);
+        append(out, ",\"shadow_price\":%.10g,\"target_range\":", sensitivity->shadow_price[k]);
+        if (isnan(sensitivity->target_low[k])) {
+            append(out, "null");
+        } else {
+            append_range(out, sensitivity->target_low[k], sensitivity->target_high[k]);
+        }
+        append(out, "}");
+    }
+    append(out, "]}");
+}
+
+static const char *binding_name(fertilizer_bound_t binding) {
+    switch (binding) {
+        case FERTILIZER_BOUND_MIN:
+            return "\"min\"";
+        case FERTILIZER_BOUND_MAX:
+            return "\"max\"";
+        case FERTILIZER_BOUND_NONE:
+        default:
+            return "null";
+    }
+}
+
+char *fertilizer_format_solution(const fertilizer_problem_t *problem, const fertilizer_solution_t *solution) {
+    json_buffer_t out = {malloc(256), 0, 256, false};
+    if (!out.text) {
+        return NULL;
+    }
+
+    append(&out, "{\"cost\":%.10g,\"area\":%.10g,\"products\":[", solution->cost, problem->area);
+    bool first = true;
+    for (int i = 0; i < problem->product_count; i++) {
+        if (solution->amounts[i] == 0.0 && solution->product_binding[i] == FERTILIZER_BOUND_NONE) {
+            continue;
+        }
+        append(&out, first ? "{\"name\":" : ",{\"name\":");
+        append_name(&out, problem->products[i].name);
+        append(&out, ",\"kg\":%.10g,\"binding\":%s}", solution->amounts[i], binding_name(solution->product_binding[i]));
+        first = false;
+    }
+    append(&out, "],\"nutrients\":[");
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+        append(&out, k == 0 ? "{\"name\":" : ",{\"name\":");
+        append_name(&out, nutrient->name);
+        append(&out, ",\"kg_per_ha\":%.10g,\"min\":", solution->supplied[k]);
+        append_bound(&out, nutrient->min);
+        append(&out, ",\"max\":");
+        append_bound(&out, nutrient->max);
+        append(&out, ",\"binding\":%s}", binding_name(solution->nutrient_binding[k]));
+    }
+    append(&out, "]");
+    if (solution->sensitivity.valid) {
+        append_sensitivity(&out, problem, &solution->sensitivity);
+    }
+    append(&out, "}");
+
+    if (out.failed) {
+        free(out.text);
+        return NULL;
+    }
+    return out.text;
+}
@@ -1,40 +1,252 @@
-#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <scip/scip.h>
+#include <scip/scipdefplugins.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_mixing_solver.h"
 
-bool validate_fertilizer_mixing_data(const char *data, char **error_msg) {
-    if (!data) {
-        if (error_msg) {
-            *error_msg = strdup("No data provided");
+// Each thread keeps its own SCIP instance and LP so the plugins are only
+// loaded once per thread
+static _Thread_local fertilizer_ctx_t thread_ctx;
+static _Thread_local bool thread_ctx_ready = false;
+
+void fertilizer_ctx_init(fertilizer_ctx_t *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+SCIP_RETCODE fertilizer_ctx_free(fertilizer_ctx_t *ctx) {
+    if (ctx->scip) {
+        SCIP_CALL(SCIPfree(&ctx->scip));
+    }
+    if (ctx->lpi) {
+        SCIP_CALL(SCIPlpiFree(&ctx->lpi));
+    }
+    fertilizer_backend_t backend = ctx->backend;
+    fertilizer_basis_cache_t *cache = ctx->cache;
+    bool sensitivity = ctx->sensitivity;
+    fertilizer_ctx_init(ctx);
+    ctx->backend = backend;
+    ctx->cache = cache;
+    ctx->sensitivity = sensitivity;
+    return SCIP_OKAY;
+}
+
+void fertilizer_thread_cleanup(void) {
+    if (thread_ctx_ready) {
+        fertilizer_ctx_free(&thread_ctx);
+        thread_ctx_ready = false;
+    }
+}
+
+static SCIP_RETCODE create_scip(fertilizer_ctx_t *ctx) {
+    SCIP_CALL(SCIPcreate(&ctx->scip));
+    SCIP_CALL(SCIPincludeDefaultPlugins(ctx->scip));
+    SCIP_CALL(SCIPsetIntParam(ctx->scip, "display/verblevel", 0));
+
+    // A pure LP is solved by the root relaxation; everything around it only
+    // adds latency (and presolving would replace the rows we read back)
+    SCIP_CALL(SCIPsetPresolving(ctx->scip, SCIP_PARAMSETTING_OFF, TRUE));
+    SCIP_CALL(SCIPsetHeuristics(ctx->scip, SCIP_PARAMSETTING_OFF, TRUE));
+    SCIP_CALL(SCIPsetSeparating(ctx->scip, SCIP_PARAMSETTING_OFF, TRUE));
+    SCIP_CALL(SCIPsetIntParam(ctx->scip, "propagating/maxrounds", 0));
+    SCIP_CALL(SCIPsetIntParam(ctx->scip, "propagating/maxroundsroot", 0));
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE add_product_variables(SCIP *scip, const fertilizer_problem_t *problem, SCIP_VAR **vars) {
+    for (int i = 0; i < problem->product_count; i++) {
+        const fertilizer_product_t *product = &problem->products[i];
+        double upper = isinf(product->max_amount) ? SCIPinfinity(scip) : product->max_amount;
+        SCIP_CALL(SCIPcreateVarBasic(scip, &vars[i], product->name, product->min_amount, upper, product->price,
+                                     SCIP_VARTYPE_CONTINUOUS));
+        SCIP_CALL(SCIPaddVar(scip, vars[i]));
+    }
+    return SCIP_OKAY;
+}
+
+// One row per bounded nutrient, over the products that contain it
+static SCIP_RETCODE add_nutrient_rows(SCIP *scip, const fertilizer_problem_t *problem, SCIP_VAR **vars,
+                                      SCIP_VAR **row_vars, SCIP_Real *row_coefs) {
+    for (int k = 0; k < problem->nutrient_count; k++) {
+        const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+        if (nutrient->min <= 0.0 && isinf(nutrient->max)) {
+            continue;
         }
-        return false;
+        int nnz = 0;
+        for (int i = 0; i < problem->product_count; i++) {
+            if (problem->products[i].content[k] > 0.0) {
+                row_vars[nnz] = vars[i];
+                row_coefs[nnz] = problem->products[i].content[k];
+                nnz++;
+            }
+        }
+        double lhs = nutrient->min * problem->area;
+        double rhs = isinf(nutrient->max) ? SCIPinfinity(scip) : nutrient->max * problem->area;
+
+        SCIP_CONS *cons = NULL;
+        SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, nutrient->name, nnz, row_vars, row_coefs, lhs, rhs));
+        SCIP_CALL(SCIPaddCons(scip, cons));
+        SCIP_CALL(SCIPreleaseCons(scip, &cons));
     }
-    
-    // Check if data is empty or too short
-    size_t len = strlen(data);
-    if (len == 0) {
-        if (error_msg) {
-            *error_msg = strdup("Empty data provided");
+    return SCIP_OKAY;
+}
+
+static void extract_solution(SCIP *scip, const fertilizer_problem_t *problem, SCIP_VAR **vars,
+                             fertilizer_solution_t *solution) {
+    SCIP_SOL *sol = SCIPgetBestSol(scip);
+    solution->cost = SCIPgetSolOrigObj(scip, sol);
+    for (int i = 0; i < problem->product_count; i++) {
+        solution->amounts[i] = SCIPgetSolVal(scip, sol, vars[i]);
+    }
+    fertilizer_solution_finish(problem, solution, SCIPfeastol(scip));
+}
+
+static SCIP_RETCODE build_and_solve(SCIP *scip, const fertilizer_problem_t *problem, SCIP_VAR **vars,
+                                    SCIP_VAR **row_vars, SCIP_Real *row_coefs, fertilizer_solution_t *solution) {
+    SCIP_CALL(SCIPcreateProbBasic(scip, "fertilizer_mixing"));
+    SCIP_CALL(add_product_variables(scip, problem, vars));
+    SCIP_CALL(add_nutrient_rows(scip, problem, vars, row_vars, row_coefs));
+    SCIP_CALL(SCIPsolve(scip));
+
+    switch (SCIPgetStatus(scip)) {
+        case SCIP_STATUS_OPTIMAL:
+            solution->status = FERTILIZER_OPTIMAL;
+            extract_solution(scip, problem, vars, solution);
+            break;
+        case SCIP_STATUS_INFEASIBLE:
+            solution->status = FERTILIZER_INFEASIBLE;
+            break;
+        case SCIP_STATUS_UNBOUNDED:
+        case SCIP_STATUS_INFORUNBD:
+            solution->status = FERTILIZER_UNBOUNDED;
+            break;
+        default:
+            solution->status = FERTILIZER_NOT_SOLVED;
+            break;
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE solve_with_scip(fertilizer_ctx_t *ctx, const fertilizer_problem_t *problem,
+                                    fertilizer_solution_t *solution) {
+    if (!ctx->scip) {
+        SCIP_CALL(create_scip(ctx));
+    }
+    solution->status = FERTILIZER_NOT_SOLVED;
+
+    size_t count = (size_t)problem->product_count;
+    SCIP_VAR **vars = calloc(count, sizeof(*vars));
+    SCIP_VAR **row_vars = malloc(count * sizeof(*row_vars));
+    SCIP_Real *row_coefs = malloc(count * sizeof(*row_coefs));
+    if (!vars || !row_vars || !row_coefs) {
+        free(vars);
+        free(row_vars);
+        free(row_coefs);
+        return SCIP_NOMEMORY;
+    }
+
+    SCIP_RETCODE retcode = build_and_solve(ctx->scip, problem, vars, row_vars, row_coefs, solution);
+
+    // Free the problem even after a failure so the next solve starts clean
+    for (size_t i = 0; i < count; i++) {
+        if (vars[i]) {
+            SCIPreleaseVar(ctx->scip, &vars[i]);
         }
+    }
+    SCIP_RETCODE free_retcode = SCIPfreeProb(ctx->scip);
+    free(vars);
+    free(row_vars);
+    free(row_coefs);
+    return retcode != SCIP_OKAY ? retcode : free_retcode;
+}
+
+SCIP_RETCODE fertilizer_solve(fertilizer_ctx_t *ctx, const fertilizer_problem_t *problem,
+                              fertilizer_solution_t *solution) {
+    ctx->from_cache = false;
+    solution->sensitivity.valid = false;
+    if (ctx->backend == FERTILIZER_BACKEND_SCIP) {
+        return solve_with_scip(ctx, problem, solution);
+    }
+    SCIP_RETCODE retcode = ctx->cache ? fertilizer_lp_solve_cached(&ctx->lpi, ctx->cache, problem, solution,
+                                                                   ctx->sensitivity, &ctx->from_cache)
+                                      : fertilizer_lp_solve(&ctx->lpi, problem, solution, ctx->sensitivity);
+    if (ctx->backend == FERTILIZER_BACKEND_AUTO &&
+        (retcode == SCIP_LPERROR || (retcode == SCIP_OKAY && solution->status == FERTILIZER_NOT_SOLVED))) {
+        // SoPlex gave up (numerical trouble, iteration limit): SCIP's LP
+        // solving loop gets another try, without sensitivity
+        return solve_with_scip(ctx, problem, solution);
+    }
+    return retcode;
+}
+
+bool validate_fertilizer_mixing_data(const char *data, char **error_msg) {
+    fertilizer_problem_t problem;
+    if (fertilizer_parse(data, &problem, error_msg) != EXIT_SUCCESS) {
         return false;
     }
-    
-    // Add more specific validation as needed
-    // For example, check if the data is valid JSON if that's the expected format
-    
+    fertilizer_problem_free(&problem);
     return true;
 }
 
-int solve_fertilizer_mixing(const char *data, char **error_msg) {
-    // Validate input data
-    if (!validate_fertilizer_mixing_data(data, error_msg)) {
+static const char *status_error(fertilizer_status_t status) {
+    switch (status) {
+        case FERTILIZER_INFEASIBLE:
+            return "No blend meets the nutrient targets within the availability limits";
+        case FERTILIZER_UNBOUNDED:
+            return "Blend cost is unbounded (negative prices without availability limits)";
+        case FERTILIZER_NOT_SOLVED:
+        default:
+            return "Failed to solve fertilizer mixing problem";
+    }
+}
+
+int solve_fertilizer_mixing(const char *data, char **solution, char **error_msg) {
+    return solve_fertilizer_mixing_with_backend(data, FERTILIZER_BACKEND_AUTO, solution, error_msg);
+}
+
+int solve_fertilizer_mixing_with_backend(const char *data, fertilizer_backend_t backend, char **solution,
+                                         char **error_msg) {
+    fertilizer_problem_t problem;
+    if (fertilizer_parse(data, &problem, error_msg) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    fertilizer_solution_t result;
+    if (fertilizer_solution_init(&result, &problem) != EXIT_SUCCESS) {
+        fertilizer_problem_free(&problem);
+        if (error_msg) {
+            *error_msg = strdup("Out of memory");
+        }
         return EXIT_FAILURE;
     }
-    
-    printf("Fertilizer mixing solver received data: %s\n", data);
-    
-    // TODO: Implement actual solver logic
-    // For now, just return success
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+
+    if (!thread_ctx_ready) {
+        fertilizer_ctx_init(&thread_ctx);
+        thread_ctx_ready = true;
+    }
+    thread_ctx.backend = backend;
+    thread_ctx.cache = fertilizer_basis_cache();
+    thread_ctx.sensitivity = true;
+    SCIP_RETCODE retcode = fertilizer_solve(&thread_ctx, &problem, &result);
+
+    int status = EXIT_FAILURE;
+    if (retcode == SCIP_OKAY && result.status == FERTILIZER_OPTIMAL) {
+        char *text = fertilizer_format_solution(&problem, &result);
+        if (text) {
+            status = EXIT_SUCCESS;
+            if (solution) {
+                *solution = text;
+            } else {
+                free(text);
+            }
+        } else if (error_msg) {
+            *error_msg = strdup("Out of memory");
+        }
+    } else if (error_msg) {
+        *error_msg = strdup(status_error(retcode == SCIP_OKAY ? result.status : FERTILIZER_NOT_SOLVED));
+    }
+
+    fertilizer_solution_free(&result);
+    fertilizer_problem_free(&problem);
+    return status;
+}
@@ -0,0 +1,163 @@
+#include <math.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_sensitivity.h"
+
+// Entries of B^-1 rows and columns below this are treated as zero
+#define RATIO_TOLERANCE 1e-12
+
+static int status_of(const fertilizer_problem_t *problem, const int *col_basis, const int *row_basis, int v) {
+    return v < problem->product_count ? col_basis[v] : row_basis[v - problem->product_count];
+}
+
+// Range of a basic product's price change: row holds its row of B^-1
+static void basic_price_range(const fertilizer_problem_t *problem, const int *col_basis, const int *row_basis,
+                              const double *row, const fertilizer_sensitivity_t *sensitivity, const double *y,
+                              double *low, double *high) {
+    int n = problem->product_count;
+    int m = problem->nutrient_count;
+    *low = -HUGE_VAL;
+    *high = HUGE_VAL;
+    for (int v = 0; v < n + m; v++) {
+        int status = status_of(problem, col_basis, row_basis, v);
+        double lower = 0.0;
+        double upper = 0.0;
+        fertilizer_basis_variable_bounds(problem, v, &lower, &upper);
+        if (status == SCIP_BASESTAT_BASIC || lower == upper) {
+            continue;
+        }
+        // A price change delta moves the reduced cost d_v to d_v - delta * alpha
+        double alpha = 0.0;
+        double reduced = 0.0;
+        if (v < n) {
+            for (int r = 0; r < m; r++) {
+                alpha += row[r] * problem->products[v].content[r];
+            }
+            reduced = sensitivity->reduced_cost[v];
+        } else {
+            alpha = -row[v - n];
+            reduced = y[v - n];
+        }
+        if (fabs(alpha) < RATIO_TOLERANCE) {
+            continue;
+        }
+        double ratio = reduced / alpha;
+        // At its lower bound d_v must stay >= 0, at its upper bound <= 0
+        if ((status == SCIP_BASESTAT_LOWER) == (alpha > 0.0)) {
+            *high = fmin(*high, ratio);
+        } else {
+            *low = fmax(*low, ratio);
+        }
+    }
+    // Degenerate bases can put the current price a hair outside
+    *low = fmin(*low, 0.0);
+    *high = fmax(*high, 0.0);
+}
+
+// Range of the change of nutrient k's binding bound, now at value, keeping
+// the basic variables (values in basic_value) within bounds
+static void target_range(const fertilizer_problem_t *problem, const fertilizer_cached_basis_t *basis,
+                         const double *basic_value, int k, bool at_min, double value, double *low, double *high) {
+    int m = problem->nutrient_count;
+    *low = -HUGE_VAL;
+    *high = HUGE_VAL;
+    for (int j = 0; j < m; j++) {
+        double column = basis->inverse[j * m + k];
+        if (fabs(column) < RATIO_TOLERANCE) {
+            continue;
+        }
+        double lower = 0.0;
+        double upper = 0.0;
+        fertilizer_basis_variable_bounds(problem, basis->basic[j], &lower, &upper);
+        double to_lower = (lower - basic_value[j]) / column;
+        double to_upper = (upper - basic_value[j]) / column;
+        *low = fmax(*low, column > 0.0 ? to_lower : to_upper);
+        *high = fmin(*high, column > 0.0 ? to_upper : to_lower);
+    }
+    // The target cannot pass the nutrient's other bound, nor a minimum go
+    // below zero
+    const fertilizer_nutrient_t *nutrient = &problem->nutrients[k];
+    if (at_min) {
+        *low = fmax(*low, -value);
+        *high = fmin(*high, nutrient->max * problem->area - value);
+    } else {
+        *low = fmax(*low, nutrient->min * problem->area - value);
+    }
+    *low = fmin(*low, 0.0);
+    *high = fmax(*high, 0.0);
+}
+
+void fertilizer_sensitivity_compute(const fertilizer_problem_t *problem, const int *col_basis,
+                                    const int *row_basis, fertilizer_solution_t *solution) {
+    fertilizer_sensitivity_t *sensitivity = &solution->sensitivity;
+    sensitivity->valid = false;
+    fertilizer_cached_basis_t basis;
+    if (!sensitivity->reduced_cost || !fertilizer_basis_invert(problem, col_basis, row_basis, &basis)) {
+        return;
+    }
+    int n = problem->product_count;
+    int m = problem->nutrient_count;
+
+    // Duals and the values of the basic variables
+    double y[FERTILIZER_MAX_NUTRIENTS] = {0};
+    double basic_value[FERTILIZER_MAX_NUTRIENTS];
+    for (int j = 0; j < m; j++) {
+        int v = basis.basic[j];
+        basic_value[j] = v < n ? solution->amounts[v] : solution->supplied[v - n] * problem->area;
+        if (v >= n) {
+            continue;
+        }
+        for (int r = 0; r < m; r++) {
+            y[r] += problem->products[v].price * basis.inverse[j * m + r];
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        const fertilizer_product_t *product = &problem->products[i];
+        double reduced = product->price;
+        for (int r = 0; r < m; r++) {
+            reduced -= y[r] * product->content[r];
+        }
+        sensitivity->price_low[i] = -HUGE_VAL;
+        sensitivity->price_high[i] = HUGE_VAL;
+        if (col_basis[i] == SCIP_BASESTAT_BASIC) {
+            sensitivity->reduced_cost[i] = 0.0;
+        } else if (product->min_amount == product->max_amount) {
+            sensitivity->reduced_cost[i] = reduced;
+        } else if (col_basis[i] == SCIP_BASESTAT_UPPER) {
+            sensitivity->reduced_cost[i] = reduced;
+            sensitivity->price_high[i] = product->price - fmin(reduced, 0.0);
+        } else {
+            sensitivity->reduced_cost[i] = reduced;
+            sensitivity->price_low[i] = product->price - fmax(reduced, 0.0);
+        }
+    }
+    for (int j = 0; j < m; j++) {
+        int i = basis.basic[j];
+        if (i >= n) {
+            continue;
+        }
+        double low = 0.0;
+        double high = 0.0;
+        basic_price_range(problem, col_basis, row_basis, &basis.inverse[j * m], sensitivity, y, &low, &high);
+        sensitivity->price_low[i] = problem->products[i].price + low;
+        sensitivity->price_high[i] = problem->products[i].price + high;
+    }
+
+    for (int k = 0; k < m; k++) {
+        sensitivity->target_low[k] = NAN;
+        sensitivity->target_high[k] = NAN;
+        if (row_basis[k] == SCIP_BASESTAT_BASIC) {
+            sensitivity->shadow_price[k] = 0.0;
+            continue;
+        }
+        sensitivity->shadow_price[k] = y[k] * problem->area;
+        bool at_min = row_basis[k] == SCIP_BASESTAT_LOWER;
+        double value = (at_min ? problem->nutrients[k].min : problem->nutrients[k].max) * problem->area;
+        double low = 0.0;
+        double high = 0.0;
+        target_range(problem, &basis, basic_value, k, at_min, value, &low, &high);
+        sensitivity->target_low[k] = (value + low) / problem->area;
+        sensitivity->target_high[k] = (value + high) / problem->area;
+    }
+    sensitivity->valid = true;
+}
@@ -0,0 +1,121 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lpi/lpi.h>
+#include "problems/fertilizer_mixing/fertilizer_sensitivity.h"
+#include "problems/fertilizer_mixing/fertilizer_session.h"
+
+void fertilizer_session_init(fertilizer_session_t *session) {
+    memset(session, 0, sizeof(*session));
+    fertilizer_ctx_init(&session->ctx);
+}
+
+SCIP_RETCODE fertilizer_session_free(fertilizer_session_t *session) {
+    SCIP_RETCODE retcode = fertilizer_ctx_free(&session->ctx);
+    fertilizer_solution_free(&session->solution);
+    fertilizer_problem_free(&session->problem);
+    free(session->col_basis);
+    session->col_basis = NULL;
+    session->basis_valid = false;
+    session->lp_at_basis = false;
+    return retcode;
+}
+
+// Extracts the answer and keeps the basis if it is optimal
+static SCIP_RETCODE finish_lp_solve(fertilizer_session_t *session) {
+    SCIP_CALL(fertilizer_lp_extract(session->ctx.lpi, &session->problem, &session->solution));
+    session->lp_at_basis = session->solution.status == FERTILIZER_OPTIMAL;
+    session->solution.sensitivity.valid = false;
+    if (session->lp_at_basis) {
+        SCIP_CALL(SCIPlpiGetBase(session->ctx.lpi, session->col_basis, session->row_basis));
+        session->basis_valid = true;
+        if (session->ctx.sensitivity) {
+            fertilizer_sensitivity_compute(&session->problem, session->col_basis, session->row_basis,
+                                           &session->solution);
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE load_lp(fertilizer_session_t *session) {
+    SCIP_CALL(fertilizer_lp_create(&session->ctx.lpi));
+    fertilizer_lp_matrix_t matrix;
+    if (fertilizer_lp_matrix_build(&session->problem, SCIPlpiInfinity(session->ctx.lpi), true, &matrix) !=
+        EXIT_SUCCESS) {
+        return SCIP_NOMEMORY;
+    }
+    SCIP_RETCODE retcode = fertilizer_lp_load(session->ctx.lpi, &matrix);
+    fertilizer_lp_matrix_free(&matrix);
+    SCIP_CALL(retcode);
+    SCIP_CALL(SCIPlpiSolveDual(session->ctx.lpi));
+    return finish_lp_solve(session);
+}
+
+SCIP_RETCODE fertilizer_session_load(fertilizer_session_t *session, fertilizer_problem_t *problem) {
+    fertilizer_solution_free(&session->solution);
+    fertilizer_problem_free(&session->problem);
+    free(session->col_basis);
+    session->col_basis = NULL;
+    session->basis_valid = false;
+    session->lp_at_basis = false;
+
+    session->problem = *problem;
+    memset(problem, 0, sizeof(*problem));
+    session->col_basis = malloc((size_t)session->problem.product_count * sizeof(*session->col_basis));
+    if (!session->col_basis || fertilizer_solution_init(&session->solution, &session->problem) != EXIT_SUCCESS) {
+        return SCIP_NOMEMORY;
+    }
+
+    session->stats.cold++;
+    return load_lp(session);
+}
+
+// Pushes the changed prices and targets into the loaded LP
+static SCIP_RETCODE change_lp(fertilizer_session_t *session, const fertilizer_update_t *update) {
+    SCIP_LPI *lpi = session->ctx.lpi;
+    if (update->price_count > 0) {
+        SCIP_CALL(SCIPlpiChgObj(lpi, update->price_count, update->price_products, update->prices));
+    }
+    if (update->target_count > 0) {
+        // Rows are nutrients one to one (all_rows)
+        double infinity = SCIPlpiInfinity(lpi);
+        double lhs[FERTILIZER_MAX_NUTRIENTS];
+        double rhs[FERTILIZER_MAX_NUTRIENTS];
+        for (int t = 0; t < update->target_count; t++) {
+            lhs[t] = update->target_min[t] * session->problem.area;
+            rhs[t] = isinf(update->target_max[t]) ? infinity : update->target_max[t] * session->problem.area;
+        }
+        SCIP_CALL(SCIPlpiChgSides(lpi, update->target_count, update->target_nutrients, lhs, rhs));
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE fertilizer_session_update(fertilizer_session_t *session, const fertilizer_update_t *update) {
+    if (!session->problem.products) {
+        return SCIP_INVALIDDATA;  // Nothing loaded
+    }
+    fertilizer_problem_apply(&session->problem, update);
+    session->stats.updates++;
+
+    SCIP_LPI *lpi = session->ctx.lpi;
+    SCIP_CALL(change_lp(session, update));
+    bool warm = session->basis_valid;
+    if (warm && !session->lp_at_basis) {
+        SCIP_CALL(SCIPlpiSetBase(lpi, session->col_basis, session->row_basis));
+    }
+    if (update->target_count == 0) {
+        SCIP_CALL(SCIPlpiSolvePrimal(lpi));
+    } else {
+        SCIP_CALL(SCIPlpiSolveDual(lpi));
+    }
+
+    if (warm) {
+        int iterations = 0;
+        SCIP_CALL(SCIPlpiGetIterations(lpi, &iterations));
+        session->stats.warm++;
+        session->stats.iterations += iterations;
+    } else {
+        session->stats.cold++;
+    }
+    return finish_lp_solve(session);
+}
@@ -0,0 +1,155 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "problems/sudoku/sudoku_batch.h"
+#include "sudoku_budget.h"
+
+// Puzzles handed out per grab of the shared cursor: large enough to keep
+// contention low, small enough to balance uneven puzzle difficulty
+#define BATCH_CHUNK 64
+
+typedef struct {
+    const char *puzzles;
+    char *solutions;
+    sudoku_batch_status_t *status;
+    size_t count;
+    atomic_size_t next;
+} batch_job_t;
+
+typedef struct {
+    batch_job_t *job;
+    pthread_t thread;
+    sudoku_ctx_t ctx;            // Per-worker solver state, SCIP model included
+    size_t totals[4];            // Indexed by sudoku_batch_status_t
+} batch_worker_t;
+
+sudoku_batch_status_t sudoku_batch_solve_record(sudoku_ctx_t *ctx, const char *record, char *solution) {
+    sudoku_grid_init(&ctx->puzzle, 3);
+    switch (sudoku_parse_line(record, sudoku_grid_rows(&ctx->puzzle))) {
+        case SUDOKU_PARSE_OK:
+            break;
+        case SUDOKU_PARSE_DUPLICATE:
+            return SUDOKU_BATCH_INFEASIBLE;
+        default:
+            return SUDOKU_BATCH_INVALID;
+    }
+    if (solve_puzzle(ctx) != SCIP_OKAY || ctx->limit_reached) {
+        return SUDOKU_BATCH_ERROR;
+    }
+    if (!ctx->has_solution) {
+        return SUDOKU_BATCH_INFEASIBLE;
+    }
+    sudoku_format_line((const int (*)[9])sudoku_grid_rows(&ctx->puzzle), solution);
+    return SUDOKU_BATCH_SOLVED;
+}
+
+static void *batch_worker(void *arg) {
+    batch_worker_t *worker = arg;
+    batch_job_t *job = worker->job;
+
+    for (;;) {
+        size_t begin = atomic_fetch_add(&job->next, BATCH_CHUNK);
+        if (begin >= job->count) {
+            break;
+        }
+        size_t end = begin + BATCH_CHUNK < job->count ? begin + BATCH_CHUNK : job->count;
+
+        for (size_t n = begin; n < end; n++) {
+            const char *record = job->puzzles + n * SUDOKU_PUZZLE_LEN;
+            char *solution = job->solutions + n * SUDOKU_PUZZLE_LEN;
+
+            sudoku_batch_status_t result = sudoku_batch_solve_record(&worker->ctx, record, solution);
+            if (result != SUDOKU_BATCH_SOLVED) {
+                memcpy(solution, record, SUDOKU_PUZZLE_LEN);
+            }
+            if (job->status) {
+                job->status[n] = result;
+            }
+            worker->totals[result]++;
+        }
+    }
+    return NULL;
+}
+
+void sudoku_batch_default_config(sudoku_batch_config_t *config) {
+    config->threads = 0;
+    sudoku_default_options(&config->options);
+}
+
+int solve_sudoku_batch(const char *puzzles, size_t count, char *solutions,
+                       sudoku_batch_status_t *status, const sudoku_batch_config_t *config,
+                       sudoku_batch_stats_t *stats) {
+    sudoku_batch_config_t defaults;
+    if (!config) {
+        sudoku_batch_default_config(&defaults);
+        config = &defaults;
+    }
+    if ((!puzzles || !solutions) && count > 0) {
+        return EXIT_FAILURE;
+    }
+
+    int threads = config->threads;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    // No point in idle workers for small batches
+    size_t chunks = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    if (chunks < (size_t)threads) {
+        threads = chunks > 0 ? (int)chunks : 1;
+    }
+
+    batch_job_t job = {
+        .puzzles = puzzles,
+        .solutions = solutions,
+        .status = status,
+        .count = count
+    };
+    atomic_init(&job.next, 0);
+
+    batch_worker_t *workers = calloc((size_t)threads, sizeof(*workers));
+    if (!workers) {
+        return EXIT_FAILURE;
+    }
+
+    double start = sudoku_now_seconds();
+    int started = 0;
+    for (; started < threads; started++) {
+        batch_worker_t *worker = &workers[started];
+        worker->job = &job;
+        sudoku_ctx_init(&worker->ctx);
+        worker->ctx.options = config->options;
+        if (pthread_create(&worker->thread, NULL, batch_worker, worker) != 0) {
+            fprintf(stderr, "Error starting batch worker %d\n", started);
+            break;
+        }
+    }
+    // Workers that did start still drain the whole batch
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed = sudoku_now_seconds() - start;
+
+    sudoku_batch_stats_t totals = {0};
+    totals.threads = started;
+    totals.elapsed = elapsed;
+    for (int t = 0; t < started; t++) {
+        totals.solved += workers[t].totals[SUDOKU_BATCH_SOLVED];
+        totals.infeasible += workers[t].totals[SUDOKU_BATCH_INFEASIBLE];
+        totals.invalid += workers[t].totals[SUDOKU_BATCH_INVALID];
+        totals.failed += workers[t].totals[SUDOKU_BATCH_ERROR];
+        sudoku_ctx_free(&workers[t].ctx);
+    }
+    totals.puzzles_per_second = elapsed > 0.0 ? (double)count / elapsed : 0.0;
+    if (stats) {
+        *stats = totals;
+    }
+
+    free(workers);
+    return started > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,636 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include "problems/sudoku/sudoku_binary.h"
+#include "problems/sudoku/sudoku_parser.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define OUTPUT_BYTES (1u << 16)  // Deflate output and inflate input buffers
+// Packed records leave little for the higher levels, which cost several times the time
+#define DEFLATE_LEVEL Z_BEST_SPEED
+
+// Packs 16 characters into 8 bytes. Validation is as in the parser:
+// digits become their value, '.' becomes 0; returns false on anything else.
+#if defined(__SSE2__)
+static inline bool pack16(const char *src, uint8_t *dst) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)src);
+    __m128i values = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+    __m128i is_dot = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('.'));
+    values = _mm_and_si128(values, is_digit);
+    // The (low, high) bytes of every 16-bit lane become low | high << 4
+    __m128i pairs = _mm_or_si128(_mm_and_si128(values, _mm_set1_epi16(0x00FF)),
+                                 _mm_slli_epi16(_mm_srli_epi16(values, 8), 4));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(pairs, pairs));
+    return _mm_movemask_epi8(_mm_or_si128(is_digit, is_dot)) == 0xFFFF;
+}
+
+// Unpacks 8 bytes into 16 characters
+static inline void unpack16(const uint8_t *src, char *dst) {
+    __m128i bytes = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+    __m128i low = _mm_and_si128(bytes, _mm_set1_epi16(0x000F));
+    __m128i high = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi16(0x000F)), 8);
+    _mm_storeu_si128((__m128i *)dst, _mm_add_epi8(_mm_or_si128(low, high), _mm_set1_epi8('0')));
+}
+#endif
+
+#if defined(__AVX2__)
+static inline bool pack32(const char *src, uint8_t *dst) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)src);
+    __m256i values = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    __m256i is_dot = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('.'));
+    values = _mm256_and_si256(values, is_digit);
+    __m256i pairs = _mm256_or_si256(_mm256_and_si256(values, _mm256_set1_epi16(0x00FF)),
+                                    _mm256_slli_epi16(_mm256_srli_epi16(values, 8), 4));
+    // packus works per 128-bit lane; the results are qwords 0 and 2
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(pairs, pairs), 0x08);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(packed));
+    return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_dot)) == 0xFFFFFFFFu;
+}
+
+static inline void unpack32(const uint8_t *src, char *dst) {
+    __m256i bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+    __m256i low = _mm256_and_si256(bytes, _mm256_set1_epi16(0x000F));
+    __m256i high = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi16(0x000F)), 8);
+    _mm256_storeu_si256((__m256i *)dst, _mm256_add_epi8(_mm256_or_si256(low, high), _mm256_set1_epi8('0')));
+}
+#endif
+
+static inline bool pack_scalar(char ch, uint8_t *value) {
+    if (ch >= '0' && ch <= '9') {
+        *value = (uint8_t)(ch - '0');
+        return true;
+    }
+    *value = 0;
+    return ch == '.';
+}
+
+bool sudoku_pack_cells(const char *text, size_t cells, uint8_t *packed) {
+    size_t done = 0;
+    bool valid = true;
+
+#if defined(__AVX2__)
+    for (; valid && done + 32 <= cells; done += 32) {
+        valid = pack32(text + done, packed + done / 2);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; valid && done + 16 <= cells; done += 16) {
+        valid = pack16(text + done, packed + done / 2);
+    }
+#endif
+    for (; valid && done < cells; done += 2) {
+        uint8_t low;
+        uint8_t high = 0;
+        valid = pack_scalar(text[done], &low) && (done + 1 == cells || pack_scalar(text[done + 1], &high));
+        packed[done / 2] = (uint8_t)(low | high << 4);
+    }
+    return valid;
+}
+
+void sudoku_unpack_cells(const uint8_t *packed, size_t cells, char *text) {
+    size_t done = 0;
+
+#if defined(__AVX2__)
+    for (; done + 32 <= cells; done += 32) {
+        unpack32(packed + done / 2, text + done);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; done + 16 <= cells; done += 16) {
+        unpack16(packed + done / 2, text + done);
+    }
+#endif
+    for (; done < cells; done += 2) {
+        text[done] = (char)('0' + (packed[done / 2] & 0x0F));
+        if (done + 1 < cells) {
+            text[done + 1] = (char)('0' + (packed[done / 2] >> 4));
+        }
+    }
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    for (int b = 0; b < 4; b++) {
+        out[b] = (uint8_t)(value >> (8 * b));
+    }
+}
+
+static void put_u64(uint8_t *out, uint64_t value) {
+    for (int b = 0; b < 8; b++) {
+        out[b] = (uint8_t)(value >> (8 * b));
+    }
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+    uint32_t value = 0;
+    for (int b = 3; b >= 0; b--) {
+        value = value << 8 | in[b];
+    }
+    return value;
+}
+
+static uint64_t get_u64(const uint8_t *in) {
+    uint64_t value = 0;
+    for (int b = 7; b >= 0; b--) {
+        value = value << 8 | in[b];
+    }
+    return value;
+}
+
+static size_t order_cells(int order) {
+    return (size_t)(order * order) * (size_t)(order * order);
+}
+
+static bool order_supported(int order) {
+    return order == 2 || order == 3;
+}
+
+// zlib's crc32() takes 32-bit lengths
+static uint32_t update_crc(uint32_t crc, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        uInt step = len > (1u << 30) ? (1u << 30) : (uInt)len;
+        crc = (uint32_t)crc32(crc, data, step);
+        data += step;
+        len -= step;
+    }
+    return crc;
+}
+
+static void init_header(sudoku_binary_header_t *header, int order, bool compress) {
+    memset(header, 0, sizeof(*header));
+    header->order = order;
+    header->flags = compress ? SUDOKU_BINARY_COMPRESSED : 0;
+    header->record_bytes = (uint32_t)((order_cells(order) + 1) / 2);
+}
+
+void sudoku_binary_encode_header(const sudoku_binary_header_t *header, uint8_t out[SUDOKU_BINARY_HEADER_SIZE]) {
+    memset(out, 0, SUDOKU_BINARY_HEADER_SIZE);
+    memcpy(out, SUDOKU_BINARY_MAGIC, 4);
+    out[4] = SUDOKU_BINARY_VERSION;
+    out[5] = (uint8_t)header->order;
+    out[6] = (uint8_t)header->flags;
+    put_u64(out + 8, header->count);
+    put_u64(out + 16, header->payload_bytes);
+    put_u32(out + 24, header->checksum);
+    put_u32(out + 28, header->record_bytes);
+}
+
+bool sudoku_binary_decode_header(const uint8_t in[SUDOKU_BINARY_HEADER_SIZE], sudoku_binary_header_t *header) {
+    if (memcmp(in, SUDOKU_BINARY_MAGIC, 4) != 0 || in[4] != SUDOKU_BINARY_VERSION || in[7] != 0) {
+        return false;
+    }
+    header->order = in[5];
+    header->flags = in[6];
+    header->count = get_u64(in + 8);
+    header->payload_bytes = get_u64(in + 16);
+    header->checksum = get_u32(in + 24);
+    header->record_bytes = get_u32(in + 28);
+    return order_supported(header->order) && (header->flags & ~SUDOKU_BINARY_COMPRESSED) == 0
+        && header->record_bytes == (order_cells(header->order) + 1) / 2;
+}
+
+int sudoku_binary_encode(const char *records, size_t count, int order, bool compress, uint8_t **out,
+                         size_t *out_len) {
+    *out = NULL;
+    *out_len = 0;
+    if (!order_supported(order)) {
+        return EXIT_FAILURE;
+    }
+    sudoku_binary_header_t header;
+    init_header(&header, order, compress);
+    size_t cells = order_cells(order);
+    if (count > (SIZE_MAX - SUDOKU_BINARY_HEADER_SIZE) / 2 / cells) {
+        return EXIT_FAILURE;
+    }
+    size_t raw_len = count * header.record_bytes;
+
+    uint8_t *raw = malloc(raw_len > 0 ? raw_len : 1);
+    if (!raw) {
+        return EXIT_FAILURE;
+    }
+    for (size_t n = 0; n < count; n++) {
+        if (!sudoku_pack_cells(records + n * cells, cells, raw + n * header.record_bytes)) {
+            free(raw);
+            return EXIT_FAILURE;
+        }
+    }
+
+    uLongf stored = compress ? compressBound((uLong)raw_len) : (uLongf)raw_len;
+    uint8_t *buffer = malloc(SUDOKU_BINARY_HEADER_SIZE + (size_t)stored);
+    if (!buffer) {
+        free(raw);
+        return EXIT_FAILURE;
+    }
+    if (compress) {
+        if (compress2(buffer + SUDOKU_BINARY_HEADER_SIZE, &stored, raw, (uLong)raw_len, DEFLATE_LEVEL) != Z_OK) {
+            free(raw);
+            free(buffer);
+            return EXIT_FAILURE;
+        }
+    } else {
+        memcpy(buffer + SUDOKU_BINARY_HEADER_SIZE, raw, raw_len);
+    }
+
+    header.count = count;
+    header.payload_bytes = stored;
+    header.checksum = update_crc((uint32_t)crc32(0L, Z_NULL, 0), raw, raw_len);
+    sudoku_binary_encode_header(&header, buffer);
+    free(raw);
+
+    *out = buffer;
+    *out_len = SUDOKU_BINARY_HEADER_SIZE + (size_t)stored;
+    return EXIT_SUCCESS;
+}
+
+int sudoku_binary_decode(const uint8_t *data, size_t len, char **records, size_t *count, int *order) {
+    *records = NULL;
+    *count = 0;
+    sudoku_binary_header_t header;
+    if (len < SUDOKU_BINARY_HEADER_SIZE || !sudoku_binary_decode_header(data, &header)
+        || header.payload_bytes > len - SUDOKU_BINARY_HEADER_SIZE
+        || header.count > SIZE_MAX / order_cells(header.order)) {
+        return EXIT_FAILURE;
+    }
+    size_t cells = order_cells(header.order);
+    size_t raw_len = (size_t)header.count * header.record_bytes;
+    const uint8_t *payload = data + SUDOKU_BINARY_HEADER_SIZE;
+
+    uint8_t *raw = NULL;
+    if (header.flags & SUDOKU_BINARY_COMPRESSED) {
+        raw = malloc(raw_len > 0 ? raw_len : 1);
+        uLongf inflated = (uLongf)raw_len;
+        if (!raw || uncompress(raw, &inflated, payload, (uLong)header.payload_bytes) != Z_OK
+            || inflated != raw_len) {
+            free(raw);
+            return EXIT_FAILURE;
+        }
+    } else if (header.payload_bytes != raw_len) {
+        return EXIT_FAILURE;
+    }
+    const uint8_t *packed = raw ? raw : payload;
+
+    char *text = malloc(header.count > 0 ? (size_t)header.count * cells : 1);
+    bool valid = text && update_crc((uint32_t)crc32(0L, Z_NULL, 0), packed, raw_len) == header.checksum;
+    for (size_t n = 0; valid && n < header.count; n++) {
+        sudoku_unpack_cells(packed + n * header.record_bytes, cells, text + n * cells);
+    }
+    free(raw);
+    if (!valid) {
+        free(text);
+        return EXIT_FAILURE;
+    }
+
+    *records = text;
+    *count = (size_t)header.count;
+    if (order) {
+        *order = header.order;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Runs deflate over data (NULL with Z_FINISH) and writes what it produces
+static bool deflate_to_file(sudoku_binary_writer_t *writer, const uint8_t *data, size_t len, int flush) {
+    z_stream *stream = &writer->zstream;
+    stream->next_in = (Bytef *)data;
+    stream->avail_in = (uInt)len;
+    int ret;
+    do {
+        stream->next_out = writer->output;
+        stream->avail_out = OUTPUT_BYTES;
+        ret = deflate(stream, flush);
+        if (ret == Z_STREAM_ERROR) {
+            return false;
+        }
+        size_t have = OUTPUT_BYTES - stream->avail_out;
+        if (have > 0 && fwrite(writer->output, 1, have, writer->file) != have) {
+            return false;
+        }
+        writer->header.payload_bytes += have;
+    } while (stream->avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+    return true;
+}
+
+int sudoku_binary_writer_open(sudoku_binary_writer_t *writer, const char *path, int order, bool compress) {
+    memset(writer, 0, sizeof(*writer));
+    if (!order_supported(order)) {
+        return EXIT_FAILURE;
+    }
+    init_header(&writer->header, order, compress);
+    writer->crc = (uint32_t)crc32(0L, Z_NULL, 0);
+    writer->packed = malloc((size_t)SUDOKU_BINARY_CHUNK * writer->header.record_bytes);
+    writer->output = compress ? malloc(OUTPUT_BYTES) : NULL;
+    if (!writer->packed || (compress && !writer->output)) {
+        free(writer->packed);
+        free(writer->output);
+        return EXIT_FAILURE;
+    }
+    if (compress && deflateInit(&writer->zstream, DEFLATE_LEVEL) != Z_OK) {
+        free(writer->packed);
+        free(writer->output);
+        return EXIT_FAILURE;
+    }
+
+    // The header is written again with the totals on close
+    uint8_t bytes[SUDOKU_BINARY_HEADER_SIZE];
+    sudoku_binary_encode_header(&writer->header, bytes);
+    writer->file = fopen(path, "wb");
+    if (!writer->file || fwrite(bytes, 1, sizeof(bytes), writer->file) != sizeof(bytes)) {
+        perror(path);
+        if (writer->file) {
+            fclose(writer->file);
+        }
+        if (compress) {
+            deflateEnd(&writer->zstream);
+        }
+        free(writer->packed);
+        free(writer->output);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int sudoku_binary_write(sudoku_binary_writer_t *writer, const char *records, size_t count) {
+    size_t cells = order_cells(writer->header.order);
+    size_t record_bytes = writer->header.record_bytes;
+
+    for (size_t done = 0; done < count && !writer->failed;) {
+        size_t step = count - done < SUDOKU_BINARY_CHUNK ? count - done : SUDOKU_BINARY_CHUNK;
+        for (size_t n = 0; n < step && !writer->failed; n++) {
+            writer->failed = !sudoku_pack_cells(records + (done + n) * cells, cells, writer->packed + n * record_bytes);
+        }
+        if (writer->failed) {
+            break;
+        }
+
+        size_t bytes = step * record_bytes;
+        writer->crc = update_crc(writer->crc, writer->packed, bytes);
+        if (writer->header.flags & SUDOKU_BINARY_COMPRESSED) {
+            writer->failed = !deflate_to_file(writer, writer->packed, bytes, Z_NO_FLUSH);
+        } else {
+            writer->failed = fwrite(writer->packed, 1, bytes, writer->file) != bytes;
+            writer->header.payload_bytes += bytes;
+        }
+        writer->header.count += step;
+        done += step;
+    }
+    return writer->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int sudoku_binary_writer_close(sudoku_binary_writer_t *writer) {
+    if (!writer->file) {
+        return EXIT_FAILURE;
+    }
+    if (writer->header.flags & SUDOKU_BINARY_COMPRESSED) {
+        if (!writer->failed) {
+            writer->failed = !deflate_to_file(writer, NULL, 0, Z_FINISH);
+        }
+        deflateEnd(&writer->zstream);
+    }
+
+    writer->header.checksum = writer->crc;
+    uint8_t bytes[SUDOKU_BINARY_HEADER_SIZE];
+    sudoku_binary_encode_header(&writer->header, bytes);
+    if (!writer->failed) {
+        writer->failed = fseek(writer->file, 0, SEEK_SET) != 0
+            || fwrite(bytes, 1, sizeof(bytes), writer->file) != sizeof(bytes);
+    }
+    if (fclose(writer->file) != 0) {
+        writer->failed = true;
+    }
+    writer->file = NULL;
+    free(writer->packed);
+    free(writer->output);
+    writer->packed = NULL;
+    writer->output = NULL;
+    return writer->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int sudoku_binary_reader_open(sudoku_binary_reader_t *reader, const char *path, sudoku_binary_header_t *header) {
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    uint8_t bytes[SUDOKU_BINARY_HEADER_SIZE];
+    if (fread(bytes, 1, sizeof(bytes), reader->file) != sizeof(bytes)
+        || !sudoku_binary_decode_header(bytes, &reader->header)) {
+        fprintf(stderr, "%s: not a binary puzzle file\n", path);
+        fclose(reader->file);
+        reader->file = NULL;
+        return EXIT_FAILURE;
+    }
+
+    bool compressed = reader->header.flags & SUDOKU_BINARY_COMPRESSED;
+    reader->remaining = reader->header.count;
+    reader->payload_left = reader->header.payload_bytes;
+    reader->crc = (uint32_t)crc32(0L, Z_NULL, 0);
+    reader->packed = malloc((size_t)SUDOKU_BINARY_CHUNK * reader->header.record_bytes);
+    reader->input = compressed ? malloc(OUTPUT_BYTES) : NULL;
+    if (!reader->packed || (compressed && (!reader->input || inflateInit(&reader->zstream) != Z_OK))) {
+        free(reader->packed);
+        free(reader->input);
+        fclose(reader->file);
+        reader->file = NULL;
+        return EXIT_FAILURE;
+    }
+    if (header) {
+        *header = reader->header;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Fills len bytes of packed records from the payload
+static bool read_payload(sudoku_binary_reader_t *reader, size_t len) {
+    if (!(reader->header.flags & SUDOKU_BINARY_COMPRESSED)) {
+        if (len > reader->payload_left || fread(reader->packed, 1, len, reader->file) != len) {
+            return false;
+        }
+        reader->payload_left -= len;
+        return true;
+    }
+
+    z_stream *stream = &reader->zstream;
+    stream->next_out = reader->packed;
+    stream->avail_out = (uInt)len;
+    while (stream->avail_out > 0) {
+        if (stream->avail_in == 0) {
+            size_t want = reader->payload_left < OUTPUT_BYTES ? (size_t)reader->payload_left : OUTPUT_BYTES;
+            size_t got = want > 0 ? fread(reader->input, 1, want, reader->file) : 0;
+            if (got == 0) {
+                return false;
+            }
+            reader->payload_left -= got;
+            stream->next_in = reader->input;
+            stream->avail_in = (uInt)got;
+        }
+        int ret = inflate(stream, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END ? stream->avail_out > 0 : ret != Z_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t sudoku_binary_read(sudoku_binary_reader_t *reader, char *records, size_t max) {
+    if (!reader->file || reader->failed || reader->remaining == 0) {
+        return 0;
+    }
+    size_t cells = order_cells(reader->header.order);
+    size_t record_bytes = reader->header.record_bytes;
+    size_t total = reader->remaining < max ? (size_t)reader->remaining : max;
+
+    for (size_t done = 0; done < total;) {
+        size_t step = total - done < SUDOKU_BINARY_CHUNK ? total - done : SUDOKU_BINARY_CHUNK;
+        if (!read_payload(reader, step * record_bytes)) {
+            reader->failed = true;
+            return 0;
+        }
+        reader->crc = update_crc(reader->crc, reader->packed, step * record_bytes);
+        for (size_t n = 0; n < step; n++) {
+            sudoku_unpack_cells(reader->packed + n * record_bytes, cells, records + (done + n) * cells);
+        }
+        done += step;
+    }
+
+    reader->remaining -= total;
+    if (reader->remaining == 0 && reader->crc != reader->header.checksum) {
+        reader->failed = true;
+        return 0;
+    }
+    return total;
+}
+
+int sudoku_binary_reader_close(sudoku_binary_reader_t *reader) {
+    if (!reader->file) {
+        return EXIT_FAILURE;
+    }
+    if (reader->header.flags & SUDOKU_BINARY_COMPRESSED) {
+        inflateEnd(&reader->zstream);
+    }
+    fclose(reader->file);
+    reader->file = NULL;
+    free(reader->packed);
+    free(reader->input);
+    reader->packed = NULL;
+    reader->input = NULL;
+    return reader->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+bool sudoku_binary_file_detect(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    char magic[4];
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && memcmp(magic, SUDOKU_BINARY_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return binary;
+}
+
+int sudoku_binary_pack_file(const char *text_path, const char *binary_path, bool compress, size_t *count) {
+    FILE *input = fopen(text_path, "rb");
+    if (!input) {
+        perror(text_path);
+        return EXIT_FAILURE;
+    }
+    sudoku_binary_writer_t writer;
+    if (sudoku_binary_writer_open(&writer, binary_path, 3, compress) != EXIT_SUCCESS) {
+        fclose(input);
+        return EXIT_FAILURE;
+    }
+
+    char *records = malloc((size_t)SUDOKU_BINARY_CHUNK * SUDOKU_PUZZLE_LEN);
+    char *line = NULL;
+    size_t capacity = 0;
+    size_t pending = 0;
+    size_t lineno = 0;
+    bool ok = records != NULL;
+    ssize_t len;
+    while (ok && (len = getline(&line, &capacity, input)) >= 0) {
+        lineno++;
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+            len--;
+        }
+        if (len == 0) {
+            continue;
+        }
+        if (len != SUDOKU_PUZZLE_LEN) {
+            fprintf(stderr, "%s:%zu: expected %d characters\n", text_path, lineno, SUDOKU_PUZZLE_LEN);
+            ok = false;
+            break;
+        }
+        memcpy(records + pending * SUDOKU_PUZZLE_LEN, line, SUDOKU_PUZZLE_LEN);
+        if (++pending == SUDOKU_BINARY_CHUNK) {
+            ok = sudoku_binary_write(&writer, records, pending) == EXIT_SUCCESS;
+            pending = 0;
+        }
+    }
+    if (ok && pending > 0) {
+        ok = sudoku_binary_write(&writer, records, pending) == EXIT_SUCCESS;
+    }
+    if (ok && ferror(input)) {
+        perror(text_path);
+        ok = false;
+    }
+    if (!ok && writer.failed) {
+        fprintf(stderr, "%s: invalid record or write error\n", binary_path);
+    }
+
+    size_t written = (size_t)writer.header.count;
+    writer.failed = writer.failed || !ok;
+    ok = sudoku_binary_writer_close(&writer) == EXIT_SUCCESS;
+    free(line);
+    free(records);
+    fclose(input);
+    if (count) {
+        *count = written;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int sudoku_binary_unpack_file(const char *binary_path, const char *text_path, size_t *count) {
+    sudoku_binary_reader_t reader;
+    sudoku_binary_header_t header;
+    if (sudoku_binary_reader_open(&reader, binary_path, &header) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    FILE *output = fopen(text_path, "wb");
+    size_t cells = order_cells(header.order);
+    char *records = malloc((size_t)SUDOKU_BINARY_CHUNK * cells);
+    char *lines = malloc((size_t)SUDOKU_BINARY_CHUNK * (cells + 1));
+    bool ok = output && records && lines;
+    if (!output) {
+        perror(text_path);
+    }
+
+    size_t total = 0;
+    size_t got;
+    while (ok && (got = sudoku_binary_read(&reader, records, SUDOKU_BINARY_CHUNK)) > 0) {
+        for (size_t n = 0; n < got; n++) {
+            memcpy(lines + n * (cells + 1), records + n * cells, cells);
+            lines[n * (cells + 1) + cells] = '\n';
+        }
+        ok = fwrite(lines, cells + 1, got, output) == got;
+        total += got;
+    }
+    if (reader.failed) {
+        fprintf(stderr, "%s: truncated or corrupt payload\n", binary_path);
+    }
+    ok = sudoku_binary_reader_close(&reader) == EXIT_SUCCESS && ok;
+    if (output && fclose(output) != 0) {
+        ok = false;
+    }
+    free(records);
+    free(lines);
+    if (count) {
+        *count = total;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+#ifndef SUDOKU_BUDGET_H
+#define SUDOKU_BUDGET_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+#include "problems/sudoku/sudoku_propagation.h"
+
+// Internal to the Sudoku sources: the monotonic clock used for timings and
+// deadlines, and the node, time and cancellation budget of the native
+// searches. Includers define _POSIX_C_SOURCE for clock_gettime().
+
+static inline double sudoku_now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const sudoku_native_limits_t *limits;  // NULL for no budget
+    long node_limit;        // From limits; a search may split it between workers
+    double deadline;        // sudoku_now_seconds() at which the time limit runs out
+    bool limit_reached;     // Sticky once a limit stopped the search
+} sudoku_budget_t;
+
+static inline void sudoku_budget_init(sudoku_budget_t *budget, const sudoku_native_limits_t *limits) {
+    budget->limits = limits;
+    budget->node_limit = limits ? limits->node_limit : 0;
+    budget->deadline = limits && limits->time_limit > 0 ? sudoku_now_seconds() + limits->time_limit : 0.0;
+    budget->limit_reached = false;
+}
+
+// Whether a search that has taken nodes nodes must stop
+static inline bool sudoku_budget_exhausted(sudoku_budget_t *budget, long nodes) {
+    const sudoku_native_limits_t *limits = budget->limits;
+    if (!limits) {
+        return false;
+    }
+    if (budget->node_limit > 0 && nodes >= budget->node_limit) {
+        budget->limit_reached = true;
+    }
+    if (limits->cancel && atomic_load_explicit(limits->cancel, memory_order_relaxed)) {
+        budget->limit_reached = true;
+    }
+    // Reading the clock on every node would dominate easy searches
+    if (limits->time_limit > 0 && (nodes & 0xFF) == 0 && sudoku_now_seconds() > budget->deadline) {
+        budget->limit_reached = true;
+    }
+    return budget->limit_reached;
+}
+
+#endif
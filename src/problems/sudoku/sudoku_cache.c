@@ -0,0 +1,184 @@
+#include <stdlib.h>
+#include <string.h>
+#include "problems/sudoku/sudoku_cache.h"
+
+#define CACHE_NONE (-1)
+
+static uint64_t hash_key(const char *key) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < SUDOKU_PUZZLE_LEN; i++) {
+        hash ^= (unsigned char)key[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static int32_t find_entry(const sudoku_cache_t *cache, const char *key, uint64_t hash) {
+    int32_t index = cache->buckets[hash & cache->bucket_mask];
+    while (index != CACHE_NONE) {
+        const sudoku_cache_entry_t *entry = &cache->entries[index];
+        if (entry->hash == hash && memcmp(entry->key, key, SUDOKU_PUZZLE_LEN) == 0) {
+            return index;
+        }
+        index = entry->chain;
+    }
+    return CACHE_NONE;
+}
+
+static void unlink_lru(sudoku_cache_t *cache, int32_t index) {
+    sudoku_cache_entry_t *entry = &cache->entries[index];
+    if (entry->prev != CACHE_NONE) {
+        cache->entries[entry->prev].next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next != CACHE_NONE) {
+        cache->entries[entry->next].prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+}
+
+static void push_front(sudoku_cache_t *cache, int32_t index) {
+    sudoku_cache_entry_t *entry = &cache->entries[index];
+    entry->prev = CACHE_NONE;
+    entry->next = cache->head;
+    if (cache->head != CACHE_NONE) {
+        cache->entries[cache->head].prev = index;
+    }
+    cache->head = index;
+    if (cache->tail == CACHE_NONE) {
+        cache->tail = index;
+    }
+}
+
+static void unlink_bucket(sudoku_cache_t *cache, int32_t index) {
+    int32_t *link = &cache->buckets[cache->entries[index].hash & cache->bucket_mask];
+    while (*link != index) {
+        link = &cache->entries[*link].chain;
+    }
+    *link = cache->entries[index].chain;
+}
+
+static void reset_entries(sudoku_cache_t *cache) {
+    for (size_t b = 0; b <= cache->bucket_mask; b++) {
+        cache->buckets[b] = CACHE_NONE;
+    }
+    cache->count = 0;
+    cache->head = CACHE_NONE;
+    cache->tail = CACHE_NONE;
+}
+
+int sudoku_cache_init(sudoku_cache_t *cache, size_t capacity) {
+    memset(cache, 0, sizeof(*cache));
+    if (capacity > INT32_MAX / 2) {
+        return EXIT_FAILURE;
+    }
+
+    // Power-of-two bucket count, load factor at most 1
+    size_t buckets = 1;
+    while (buckets < capacity) {
+        buckets <<= 1;
+    }
+    cache->entries = capacity > 0 ? malloc(capacity * sizeof(*cache->entries)) : NULL;
+    cache->buckets = malloc(buckets * sizeof(*cache->buckets));
+    if ((capacity > 0 && !cache->entries) || !cache->buckets) {
+        free(cache->entries);
+        free(cache->buckets);
+        memset(cache, 0, sizeof(*cache));
+        return EXIT_FAILURE;
+    }
+    cache->capacity = capacity;
+    cache->bucket_mask = buckets - 1;
+    cache->stats.capacity = capacity;
+    reset_entries(cache);
+    pthread_mutex_init(&cache->lock, NULL);
+    return EXIT_SUCCESS;
+}
+
+void sudoku_cache_free(sudoku_cache_t *cache) {
+    if (!cache->buckets) {
+        return;
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->entries);
+    free(cache->buckets);
+    memset(cache, 0, sizeof(*cache));
+}
+
+bool sudoku_cache_lookup(sudoku_cache_t *cache, const char *key, char *solution) {
+    uint64_t hash = hash_key(key);
+
+    pthread_mutex_lock(&cache->lock);
+    int32_t index = find_entry(cache, key, hash);
+    if (index != CACHE_NONE) {
+        memcpy(solution, cache->entries[index].solution, SUDOKU_PUZZLE_LEN);
+        unlink_lru(cache, index);
+        push_front(cache, index);
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return index != CACHE_NONE;
+}
+
+void sudoku_cache_insert(sudoku_cache_t *cache, const char *key, const char *solution) {
+    if (cache->capacity == 0) {
+        return;
+    }
+    uint64_t hash = hash_key(key);
+
+    pthread_mutex_lock(&cache->lock);
+    int32_t index = find_entry(cache, key, hash);
+    if (index != CACHE_NONE) {
+        unlink_lru(cache, index);
+    } else {
+        if (cache->count < cache->capacity) {
+            index = (int32_t)cache->count++;
+        } else {
+            index = cache->tail;
+            unlink_lru(cache, index);
+            unlink_bucket(cache, index);
+            cache->stats.evictions++;
+        }
+        sudoku_cache_entry_t *entry = &cache->entries[index];
+        memcpy(entry->key, key, SUDOKU_PUZZLE_LEN);
+        entry->hash = hash;
+        entry->chain = cache->buckets[hash & cache->bucket_mask];
+        cache->buckets[hash & cache->bucket_mask] = index;
+        cache->stats.insertions++;
+    }
+    memcpy(cache->entries[index].solution, solution, SUDOKU_PUZZLE_LEN);
+    push_front(cache, index);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void sudoku_cache_clear(sudoku_cache_t *cache) {
+    pthread_mutex_lock(&cache->lock);
+    reset_entries(cache);
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    cache->stats.capacity = cache->capacity;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void sudoku_cache_get_stats(sudoku_cache_t *cache, sudoku_cache_stats_t *stats) {
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    stats->entries = cache->count;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static sudoku_cache_t solution_cache;
+static bool solution_cache_ready = false;
+static pthread_once_t solution_cache_once = PTHREAD_ONCE_INIT;
+
+static void init_solution_cache(void) {
+    solution_cache_ready = sudoku_cache_init(&solution_cache, SUDOKU_CACHE_DEFAULT_CAPACITY) == EXIT_SUCCESS;
+}
+
+sudoku_cache_t *sudoku_solution_cache(void) {
+    pthread_once(&solution_cache_once, init_solution_cache);
+    return solution_cache_ready ? &solution_cache : NULL;
+}
@@ -0,0 +1,334 @@
+#include <string.h>
+#include "problems/sudoku/sudoku_canonical.h"
+
+// The canonical grid is the smallest under a two-level order: first the
+// pattern of givens (row-major, empty before given), then the relabeled
+// digits (row-major, digits numbered in order of first appearance).
+//
+// For a fixed row order the smallest pattern needs no search: sorting the
+// columns of each stack by their column vector (top row most significant)
+// and then the stacks by their 3x9 block read row-major minimizes the
+// pattern row by row. Rows are chosen one at a time, keeping only the
+// candidates whose sorted prefix is smallest, since that prefix is also
+// the prefix of the final grid. Row orders and column orders that tie on
+// the pattern are then compared on the digits.
+//
+// Lines without givens that could be swapped with each other are tried
+// only once: swapping them maps the puzzle onto itself.
+
+typedef struct {
+    int src[9][9];            // Puzzle in the current orientation
+    int masks[9];             // Givens per row, bit c for column c
+    bool transposed;
+    int rows[9];
+    int pattern[9];           // Sorted pattern of the chosen rows
+
+    int best_pattern[9];      // Row masks of the best pattern, first column in bit 8
+    bool has_pattern;
+    int best[81];             // Best relabeled grid among those with best_pattern
+    sudoku_transform_t best_transform;
+    bool has_best;
+} canon_search_t;
+
+// Sorted column order for the rows chosen so far
+typedef struct {
+    int vectors[9];           // Column vectors, row 0 in bit 8
+    int cols[9];              // Column order, 3 per stack slot
+    int stack_keys[3];        // Block key of the stack in each slot
+} canon_layout_t;
+
+// Line index (row or column) allowed at position pos: positions 0, 3 and 6
+// open a band/stack that is still untouched, the others continue the
+// band/stack of the previous position
+static bool line_allowed(int pos, int line, int used, int group) {
+    if (used & (1 << line)) {
+        return false;
+    }
+    if (pos % 3 != 0) {
+        return line / 3 == group;
+    }
+    return ((used >> (3 * (line / 3))) & 7) == 0;
+}
+
+static void sort3(int items[3], const int keys[]) {
+    for (int a = 0; a < 2; a++) {
+        for (int b = a + 1; b < 3; b++) {
+            if (keys[items[b]] < keys[items[a]]) {
+                int tmp = items[a];
+                items[a] = items[b];
+                items[b] = tmp;
+            }
+        }
+    }
+}
+
+// Spreads the 9 bits of a column vector to every third bit, so that three
+// vectors interleave into their block read row-major
+static int spread_bits(int vector) {
+    uint32_t x = (uint32_t)vector & 0x1ffu;
+    x = (x | (x << 16)) & 0xff0000ffu;
+    x = (x | (x << 8)) & 0x0300f00fu;
+    x = (x | (x << 4)) & 0x030c30c3u;
+    x = (x | (x << 2)) & 0x09249249u;
+    return (int)x;
+}
+
+// Sorts the columns of each stack by vector, then the stacks by block
+static void sort_layout(canon_layout_t *layout) {
+    int stack_cols[3][3];
+    int keys[3];
+    for (int t = 0; t < 3; t++) {
+        for (int k = 0; k < 3; k++) {
+            stack_cols[t][k] = 3 * t + k;
+        }
+        sort3(stack_cols[t], layout->vectors);
+        keys[t] = (spread_bits(layout->vectors[stack_cols[t][0]]) << 2)
+                | (spread_bits(layout->vectors[stack_cols[t][1]]) << 1)
+                | spread_bits(layout->vectors[stack_cols[t][2]]);
+    }
+
+    int stacks[3] = {0, 1, 2};
+    sort3(stacks, keys);
+    for (int slot = 0; slot < 3; slot++) {
+        layout->stack_keys[slot] = keys[stacks[slot]];
+        for (int k = 0; k < 3; k++) {
+            layout->cols[3 * slot + k] = stack_cols[stacks[slot]][k];
+        }
+    }
+}
+
+// Lexicographic comparison of the first n pattern rows
+static int compare_rows(const int *a, const int *b, int n) {
+    for (int i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static int pattern_row(int mask, const int cols[9]) {
+    int row = 0;
+    for (int j = 0; j < 9; j++) {
+        row |= ((mask >> cols[j]) & 1) << (8 - j);
+    }
+    return row;
+}
+
+// Relabels the grid under cols and compares it with the best one,
+// stopping at the first larger cell. Returns true if it became the best.
+static bool try_digits(canon_search_t *s, const int cols[9]) {
+    int digits[10] = {0};
+    int next = 0;
+    int grid[81];
+    bool less = !s->has_best;
+
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int value = s->src[s->rows[i]][cols[j]];
+            if (value != 0) {
+                if (digits[value] == 0) {
+                    digits[value] = ++next;
+                }
+                value = digits[value];
+            }
+            int cell = 9 * i + j;
+            if (!less) {
+                if (value > s->best[cell]) {
+                    return false;
+                }
+                less = value < s->best[cell];
+            }
+            grid[cell] = value;
+        }
+    }
+    if (!less) {
+        return false;
+    }
+
+    memcpy(s->best, grid, sizeof(s->best));
+    s->has_best = true;
+    sudoku_transform_t *transform = &s->best_transform;
+    transform->transposed = s->transposed;
+    for (int i = 0; i < 9; i++) {
+        transform->rows[i] = (uint8_t)s->rows[i];
+        transform->cols[i] = (uint8_t)cols[i];
+    }
+    // Digits absent from the puzzle take the remaining labels in order, so
+    // the map stays a bijection for solutions
+    transform->digits[0] = 0;
+    for (int d = 1; d <= 9; d++) {
+        transform->digits[d] = (uint8_t)(digits[d] ? digits[d] : ++next);
+    }
+    return true;
+}
+
+// Orders of three items that keep keys[] (given in sorted order) sorted.
+// Equal zero keys stand for empty lines, which are only tried in one order.
+static int tied_orders(const int keys[3], int orders[6][3]) {
+    static const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    int count = 0;
+    for (int p = 0; p < 6; p++) {
+        bool ok = true;
+        for (int k = 0; k < 3 && ok; k++) {
+            ok = keys[perms[p][k]] == keys[k];
+            for (int l = 0; l < k && ok; l++) {
+                ok = keys[k] != 0 || keys[l] != 0 || perms[p][l] < perms[p][k];
+            }
+        }
+        if (ok) {
+            memcpy(orders[count++], perms[p], sizeof(perms[p]));
+        }
+    }
+    return count;
+}
+
+// Complete row order: compares the pattern, then the digits of every
+// column order that ties on the pattern
+static void finish_rows(canon_search_t *s, const canon_layout_t *layout) {
+    int order = s->has_pattern ? compare_rows(s->pattern, s->best_pattern, 9) : -1;
+    if (order > 0) {
+        return;
+    }
+    if (order < 0) {
+        memcpy(s->best_pattern, s->pattern, sizeof(s->pattern));
+        s->has_pattern = true;
+        s->has_best = false;
+    }
+
+    int stack_orders[6][3];
+    int nstack = tied_orders(layout->stack_keys, stack_orders);
+    int col_orders[3][6][3];
+    int ncol[3];
+    for (int slot = 0; slot < 3; slot++) {
+        int keys[3];
+        for (int k = 0; k < 3; k++) {
+            keys[k] = layout->vectors[layout->cols[3 * slot + k]];
+        }
+        ncol[slot] = tied_orders(keys, col_orders[slot]);
+    }
+
+    for (int a = 0; a < nstack; a++) {
+        for (int x = 0; x < ncol[stack_orders[a][0]]; x++) {
+            for (int y = 0; y < ncol[stack_orders[a][1]]; y++) {
+                for (int z = 0; z < ncol[stack_orders[a][2]]; z++) {
+                    const int picks[3] = {x, y, z};
+                    int cols[9];
+                    for (int slot = 0; slot < 3; slot++) {
+                        int from = stack_orders[a][slot];
+                        for (int k = 0; k < 3; k++) {
+                            cols[3 * slot + k] = layout->cols[3 * from + col_orders[from][picks[slot]][k]];
+                        }
+                    }
+                    try_digits(s, cols);
+                }
+            }
+        }
+    }
+}
+
+// The first rows of a sorted layout stay put when more rows are added, so
+// candidates for row i only differ in the sorted pattern of row i
+static void search_rows(canon_search_t *s, int i, int used, int band, const canon_layout_t *layout) {
+    if (i == 9) {
+        finish_rows(s, layout);
+        return;
+    }
+
+    canon_layout_t layouts[9];
+    int values[9];
+    int smallest = -1;
+    for (int r = 0; r < 9; r++) {
+        values[r] = -1;
+        if (!line_allowed(i, r, used, band)) {
+            continue;
+        }
+        if (s->masks[r] == 0) {
+            bool swappable = false;
+            for (int q = 3 * (r / 3); q < r && !swappable; q++) {
+                swappable = s->masks[q] == 0 && line_allowed(i, q, used, band);
+            }
+            if (swappable) {
+                continue;
+            }
+        }
+
+        for (int c = 0; c < 9; c++) {
+            layouts[r].vectors[c] = layout->vectors[c] | (((s->masks[r] >> c) & 1) << (8 - i));
+        }
+        sort_layout(&layouts[r]);
+        values[r] = pattern_row(s->masks[r], layouts[r].cols);
+        if (smallest < 0 || values[r] < values[smallest]) {
+            smallest = r;
+        }
+    }
+    if (smallest < 0) {
+        return;
+    }
+    s->pattern[i] = values[smallest];
+    if (s->has_pattern && compare_rows(s->pattern, s->best_pattern, i + 1) > 0) {
+        return;
+    }
+
+    for (int r = 0; r < 9; r++) {
+        if (values[r] == values[smallest]) {
+            s->rows[i] = r;
+            search_rows(s, i + 1, used | (1 << r), r / 3, &layouts[r]);
+        }
+    }
+}
+
+void sudoku_canonicalize(const int puzzle[9][9], int canonical[9][9], sudoku_transform_t *transform) {
+    canon_search_t s;
+    memset(&s, 0, sizeof(s));
+
+    for (int orientation = 0; orientation < 2; orientation++) {
+        s.transposed = orientation == 1;
+        for (int i = 0; i < 9; i++) {
+            s.masks[i] = 0;
+            for (int j = 0; j < 9; j++) {
+                s.src[i][j] = s.transposed ? puzzle[j][i] : puzzle[i][j];
+                s.masks[i] |= (s.src[i][j] != 0) << j;
+            }
+        }
+        canon_layout_t empty;
+        memset(&empty, 0, sizeof(empty));
+        search_rows(&s, 0, 0, 0, &empty);
+    }
+
+    for (int cell = 0; cell < 81; cell++) {
+        canonical[cell / 9][cell % 9] = s.best[cell];
+    }
+    if (transform) {
+        *transform = s.best_transform;
+    }
+}
+
+void sudoku_transform_apply(const sudoku_transform_t *transform, const int grid[9][9], int out[9][9]) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int r = transform->rows[i];
+            int c = transform->cols[j];
+            int value = transform->transposed ? grid[c][r] : grid[r][c];
+            out[i][j] = transform->digits[value];
+        }
+    }
+}
+
+void sudoku_transform_invert(const sudoku_transform_t *transform, const int grid[9][9], int out[9][9]) {
+    int labels[10];
+    for (int d = 0; d <= 9; d++) {
+        labels[transform->digits[d]] = d;
+    }
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int r = transform->rows[i];
+            int c = transform->cols[j];
+            if (transform->transposed) {
+                out[c][r] = labels[grid[i][j]];
+            } else {
+                out[r][c] = labels[grid[i][j]];
+            }
+        }
+    }
+}
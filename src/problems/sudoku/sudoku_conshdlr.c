@@ -0,0 +1,564 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "problems/sudoku/sudoku_conshdlr.h"
+
+#define CONSHDLR_DESC          "all digits distinct in a Sudoku unit"
+#define CONSHDLR_ENFOPRIORITY  -900000  // After integrality, before the linear handler
+#define CONSHDLR_CHECKPRIORITY -900000
+#define CONSHDLR_EAGERFREQ     100
+#define CONSHDLR_NEEDSCONS     TRUE
+#define CONSHDLR_PROPFREQ      1
+#define CONSHDLR_DELAYPROP     FALSE
+#define CONSHDLR_PROPTIMING    SCIP_PROPTIMING_BEFORELP
+
+// Row r of a unit: digit r for r < 9, cell r - 9 otherwise
+#define UNIT_ROWS 18
+
+// Why a bound was changed, packed into the inferinfo of the change as
+// reason | cell_a << 3 | cell_b << 7 | digit << 11
+typedef enum {
+    INFER_PLACED,        // digit is placed in cell_a
+    INFER_NAKED_SINGLE,  // cell_a has no other candidate
+    INFER_HIDDEN_SINGLE, // digit has no other cell than cell_a
+    INFER_NAKED_PAIR     // cell_a and cell_b share the same two candidates
+} infer_reason_t;
+
+struct SCIP_ConsData {
+    SCIP_VAR* vars[9][9];     // [cell][digit], NULL if ruled out up front
+    int givens[9];            // Digit of a given cell without variables, 0 otherwise
+    SCIP_ROW* rows[UNIT_ROWS];  // LP rows, created on the first violation
+};
+
+// Candidate masks of one unit under the current local bounds
+typedef struct {
+    uint16_t candidates[9];   // Bit d: digit d+1 still possible in the cell
+    int placed[9];            // Digit index placed in the cell, -1 if open
+} unit_state_t;
+
+static int encode_inference(infer_reason_t reason, int cell_a, int cell_b, int digit) {
+    return (int)reason | cell_a << 3 | cell_b << 7 | digit << 11;
+}
+
+static SCIP_RETCODE consdata_create(SCIP* scip, SCIP_CONSDATA** consdata, SCIP_VAR* vars[9][9], const int givens[9]) {
+    SCIP_CALL(SCIPallocBlockMemory(scip, consdata));
+    memset(*consdata, 0, sizeof(**consdata));
+    for (int cell = 0; cell < 9; cell++) {
+        for (int digit = 0; digit < 9; digit++) {
+            if (vars[cell][digit] != NULL) {
+                SCIP_CALL(SCIPcaptureVar(scip, vars[cell][digit]));
+                (*consdata)->vars[cell][digit] = vars[cell][digit];
+            }
+        }
+        (*consdata)->givens[cell] = givens ? givens[cell] : 0;
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE release_rows(SCIP* scip, SCIP_CONSDATA* consdata) {
+    for (int r = 0; r < UNIT_ROWS; r++) {
+        if (consdata->rows[r] != NULL) {
+            SCIP_CALL(SCIPreleaseRow(scip, &consdata->rows[r]));
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_VAR* row_var(const SCIP_CONSDATA* consdata, int r, int n) {
+    return r < 9 ? consdata->vars[n][r] : consdata->vars[r - 9][n];
+}
+
+// Right-hand side of row r: the unit needs every digit once and every cell
+// filled once, minus what the givens already cover
+static SCIP_Real row_rhs(const SCIP_CONSDATA* consdata, int r) {
+    if (r >= 9) {
+        return consdata->givens[r - 9] > 0 ? 0.0 : 1.0;
+    }
+    int given = 0;
+    for (int cell = 0; cell < 9; cell++) {
+        given += consdata->givens[cell] == r + 1;
+    }
+    return 1.0 - given;
+}
+
+static SCIP_Bool row_violated(SCIP* scip, const SCIP_CONSDATA* consdata, SCIP_SOL* sol, int r) {
+    SCIP_Real activity = 0.0;
+    for (int n = 0; n < 9; n++) {
+        SCIP_VAR* var = row_var(consdata, r, n);
+        if (var != NULL) {
+            activity += SCIPgetSolVal(scip, sol, var);
+        }
+    }
+    return !SCIPisFeasEQ(scip, activity, row_rhs(consdata, r));
+}
+
+static SCIP_Bool unit_violated(SCIP* scip, const SCIP_CONSDATA* consdata, SCIP_SOL* sol) {
+    for (int r = 0; r < UNIT_ROWS; r++) {
+        if (row_violated(scip, consdata, sol, r)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Returns FALSE if a cell already holds two digits
+static SCIP_Bool load_state(const SCIP_CONSDATA* consdata, unit_state_t* state) {
+    for (int cell = 0; cell < 9; cell++) {
+        state->candidates[cell] = 0;
+        state->placed[cell] = -1;
+        if (consdata->givens[cell] > 0) {
+            state->candidates[cell] = (uint16_t)(1u << (consdata->givens[cell] - 1));
+            state->placed[cell] = consdata->givens[cell] - 1;
+            continue;
+        }
+        for (int digit = 0; digit < 9; digit++) {
+            SCIP_VAR* var = consdata->vars[cell][digit];
+            if (var == NULL || SCIPvarGetUbLocal(var) < 0.5) {
+                continue;
+            }
+            state->candidates[cell] |= (uint16_t)(1u << digit);
+            if (SCIPvarGetLbLocal(var) > 0.5) {
+                if (state->placed[cell] >= 0) {
+                    return FALSE;
+                }
+                state->placed[cell] = digit;
+            }
+        }
+    }
+    return TRUE;
+}
+
+static SCIP_RETCODE infer(SCIP* scip, SCIP_CONS* cons, SCIP_VAR* var, SCIP_Bool value, int inferinfo,
+                          SCIP_Bool* cutoff, int* nfixed) {
+    SCIP_Bool infeasible = FALSE;
+    SCIP_Bool tightened = FALSE;
+    SCIP_CALL(SCIPinferBinvarCons(scip, var, value, cons, inferinfo, &infeasible, &tightened));
+    if (infeasible) {
+        *cutoff = TRUE;
+    } else if (tightened) {
+        (*nfixed)++;
+    }
+    return SCIP_OKAY;
+}
+
+// Placed digits leave their cell and the other cells of the unit
+static SCIP_RETCODE propagate_placed(SCIP* scip, SCIP_CONS* cons, const unit_state_t* state, SCIP_Bool* cutoff,
+                                     int* nfixed) {
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    uint16_t placed_digits = 0;
+    for (int a = 0; a < 9 && !*cutoff; a++) {
+        int digit = state->placed[a];
+        if (digit < 0) {
+            continue;
+        }
+        if (placed_digits & (1u << digit)) {
+            *cutoff = TRUE;  // Same digit twice in the unit
+            break;
+        }
+        placed_digits |= (uint16_t)(1u << digit);
+
+        int inferinfo = encode_inference(INFER_PLACED, a, 0, digit);
+        for (int other = 0; other < 9 && !*cutoff; other++) {
+            if (other != digit && (state->candidates[a] & (1u << other))) {
+                SCIP_CALL(infer(scip, cons, consdata->vars[a][other], FALSE, inferinfo, cutoff, nfixed));
+            }
+        }
+        for (int b = 0; b < 9 && !*cutoff; b++) {
+            if (b != a && (state->candidates[b] & (1u << digit))) {
+                SCIP_CALL(infer(scip, cons, consdata->vars[b][digit], FALSE, inferinfo, cutoff, nfixed));
+            }
+        }
+    }
+    return SCIP_OKAY;
+}
+
+// Naked and hidden singles; an empty cell or a digit without a cell is a cutoff
+static SCIP_RETCODE propagate_singles(SCIP* scip, SCIP_CONS* cons, const unit_state_t* state, SCIP_Bool* cutoff,
+                                      int* nfixed) {
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    for (int a = 0; a < 9 && !*cutoff; a++) {
+        uint16_t mask = state->candidates[a];
+        if (mask == 0) {
+            *cutoff = TRUE;
+        } else if (state->placed[a] < 0 && (mask & (mask - 1)) == 0) {
+            int digit = __builtin_ctz(mask);
+            SCIP_CALL(infer(scip, cons, consdata->vars[a][digit], TRUE,
+                            encode_inference(INFER_NAKED_SINGLE, a, 0, digit), cutoff, nfixed));
+        }
+    }
+    for (int digit = 0; digit < 9 && !*cutoff; digit++) {
+        int count = 0;
+        int last = -1;
+        for (int a = 0; a < 9; a++) {
+            if (state->candidates[a] & (1u << digit)) {
+                count++;
+                last = a;
+            }
+        }
+        if (count == 0) {
+            *cutoff = row_rhs(consdata, digit) > 0.5;
+        } else if (count == 1 && state->placed[last] < 0) {
+            SCIP_CALL(infer(scip, cons, consdata->vars[last][digit], TRUE,
+                            encode_inference(INFER_HIDDEN_SINGLE, last, 0, digit), cutoff, nfixed));
+        }
+    }
+    return SCIP_OKAY;
+}
+
+// Two open cells limited to the same two digits take both of them
+static SCIP_RETCODE propagate_pairs(SCIP* scip, SCIP_CONS* cons, const unit_state_t* state, SCIP_Bool* cutoff,
+                                    int* nfixed) {
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    for (int a = 0; a < 9 && !*cutoff; a++) {
+        uint16_t pair = state->candidates[a];
+        if (state->placed[a] >= 0 || __builtin_popcount(pair) != 2) {
+            continue;
+        }
+        for (int b = a + 1; b < 9 && !*cutoff; b++) {
+            if (state->placed[b] >= 0 || state->candidates[b] != pair) {
+                continue;
+            }
+            for (int c = 0; c < 9 && !*cutoff; c++) {
+                uint16_t shared = state->candidates[c] & pair;
+                if (c == a || c == b || shared == 0) {
+                    continue;
+                }
+                for (int digit = 0; digit < 9 && !*cutoff; digit++) {
+                    if (shared & (1u << digit)) {
+                        SCIP_CALL(infer(scip, cons, consdata->vars[c][digit], FALSE,
+                                        encode_inference(INFER_NAKED_PAIR, a, b, digit), cutoff, nfixed));
+                    }
+                }
+            }
+        }
+    }
+    return SCIP_OKAY;
+}
+
+// Applies the rules in order of cost until the unit reaches a fixpoint;
+// the masks are reloaded after every round that changed a bound
+static SCIP_RETCODE propagate_unit(SCIP* scip, SCIP_CONS* cons, SCIP_Bool* cutoff, int* nfixed) {
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    unit_state_t state;
+    int before;
+    do {
+        before = *nfixed;
+        if (!load_state(consdata, &state)) {
+            *cutoff = TRUE;
+            break;
+        }
+        SCIP_CALL(propagate_placed(scip, cons, &state, cutoff, nfixed));
+        if (*cutoff || *nfixed > before) {
+            continue;
+        }
+        SCIP_CALL(propagate_singles(scip, cons, &state, cutoff, nfixed));
+        if (*cutoff || *nfixed > before) {
+            continue;
+        }
+        SCIP_CALL(propagate_pairs(scip, cons, &state, cutoff, nfixed));
+    } while (!*cutoff && *nfixed > before);
+
+    if (*nfixed > 0) {
+        SCIP_CALL(SCIPresetConsAge(scip, cons));
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE propagate_all(SCIP* scip, SCIP_CONS** conss, int nconss, SCIP_Bool* cutoff, int* nfixed) {
+    for (int c = 0; c < nconss && !*cutoff; c++) {
+        SCIP_CALL(propagate_unit(scip, conss[c], cutoff, nfixed));
+    }
+    return SCIP_OKAY;
+}
+
+// Enforcement without a usable LP row: propagate, else ask for branching
+static SCIP_RETCODE enforce_by_propagation(SCIP* scip, SCIP_CONS** conss, int nconss, SCIP_RESULT* result) {
+    SCIP_Bool cutoff = FALSE;
+    int nfixed = 0;
+    SCIP_CALL(propagate_all(scip, conss, nconss, &cutoff, &nfixed));
+    if (cutoff) {
+        *result = SCIP_CUTOFF;
+    } else if (nfixed > 0) {
+        *result = SCIP_REDUCEDDOM;
+    } else {
+        *result = SCIP_INFEASIBLE;
+    }
+    return SCIP_OKAY;
+}
+
+// Adds the violated rows of cons to the LP, creating them on first use
+static SCIP_RETCODE separate_unit(SCIP* scip, SCIP_CONS* cons, SCIP_Bool* cutoff, SCIP_Bool* separated,
+                                  SCIP_Bool* violated) {
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    for (int r = 0; r < UNIT_ROWS && !*cutoff; r++) {
+        if (!row_violated(scip, consdata, NULL, r)) {
+            continue;
+        }
+        *violated = TRUE;
+        if (consdata->rows[r] == NULL) {
+            char name[SCIP_MAXSTRLEN];
+            snprintf(name, sizeof(name), "%s_%c%d", SCIPconsGetName(cons), r < 9 ? 'd' : 'c', r % 9);
+            SCIP_Real rhs = row_rhs(consdata, r);
+            SCIP_CALL(SCIPcreateEmptyRowCons(scip, &consdata->rows[r], cons, name, rhs, rhs, FALSE, FALSE, TRUE));
+            for (int n = 0; n < 9; n++) {
+                SCIP_VAR* var = row_var(consdata, r, n);
+                if (var != NULL) {
+                    SCIP_CALL(SCIPaddVarToRow(scip, consdata->rows[r], var, 1.0));
+                }
+            }
+        }
+        if (!SCIProwIsInLP(consdata->rows[r])) {
+            SCIP_CALL(SCIPaddRow(scip, consdata->rows[r], FALSE, cutoff));
+            *separated = TRUE;
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSENFOLP(alldiff_enfolp) {
+    (void)conshdlr;
+    (void)nusefulconss;
+    (void)solinfeasible;
+    SCIP_Bool cutoff = FALSE;
+    SCIP_Bool separated = FALSE;
+    SCIP_Bool violated = FALSE;
+    for (int c = 0; c < nconss && !cutoff; c++) {
+        SCIP_CALL(separate_unit(scip, conss[c], &cutoff, &separated, &violated));
+    }
+
+    if (cutoff) {
+        *result = SCIP_CUTOFF;
+    } else if (separated) {
+        *result = SCIP_SEPARATED;
+    } else if (violated) {
+        // Violated although every row is in the LP: only numerics get here
+        SCIP_CALL(enforce_by_propagation(scip, conss, nconss, result));
+    } else {
+        *result = SCIP_FEASIBLE;
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSENFOPS(alldiff_enfops) {
+    (void)conshdlr;
+    (void)nusefulconss;
+    (void)solinfeasible;
+    (void)objinfeasible;
+    for (int c = 0; c < nconss; c++) {
+        if (unit_violated(scip, SCIPconsGetData(conss[c]), NULL)) {
+            return enforce_by_propagation(scip, conss, nconss, result);
+        }
+    }
+    *result = SCIP_FEASIBLE;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSCHECK(alldiff_check) {
+    (void)conshdlr;
+    (void)checkintegrality;
+    (void)checklprows;
+    *result = SCIP_FEASIBLE;
+    for (int c = 0; c < nconss; c++) {
+        if (unit_violated(scip, SCIPconsGetData(conss[c]), sol)) {
+            if (printreason) {
+                SCIPinfoMessage(scip, NULL, "violation: unit <%s> repeats or misses a digit\n", SCIPconsGetName(conss[c]));
+            }
+            *result = SCIP_INFEASIBLE;
+            if (!completely) {
+                break;
+            }
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSPROP(alldiff_prop) {
+    (void)conshdlr;
+    (void)nusefulconss;
+    (void)nmarkedconss;
+    (void)proptiming;
+    SCIP_Bool cutoff = FALSE;
+    int nfixed = 0;
+    SCIP_CALL(propagate_all(scip, conss, nconss, &cutoff, &nfixed));
+    if (cutoff) {
+        *result = SCIP_CUTOFF;
+    } else {
+        *result = nfixed > 0 ? SCIP_REDUCEDDOM : SCIP_DIDNOTFIND;
+    }
+    return SCIP_OKAY;
+}
+
+// Upper bounds of the cell's variables that were already zero at bdchgidx
+static SCIP_RETCODE explain_cell(SCIP* scip, const SCIP_CONSDATA* consdata, int cell, SCIP_BDCHGIDX* bdchgidx) {
+    for (int digit = 0; digit < 9; digit++) {
+        SCIP_VAR* var = consdata->vars[cell][digit];
+        if (var != NULL && SCIPgetVarUbAtIndex(scip, var, bdchgidx, FALSE) < 0.5) {
+            SCIP_CALL(SCIPaddConflictUb(scip, var, bdchgidx));
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSRESPROP(alldiff_resprop) {
+    (void)conshdlr;
+    (void)infervar;
+    (void)boundtype;
+    (void)relaxedbd;
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    infer_reason_t reason = (infer_reason_t)(inferinfo & 7);
+    int cell_a = (inferinfo >> 3) & 15;
+    int cell_b = (inferinfo >> 7) & 15;
+    int digit = (inferinfo >> 11) & 15;
+
+    switch (reason) {
+    case INFER_PLACED:
+        // Given cells have no variable and need no explanation
+        if (consdata->vars[cell_a][digit] != NULL) {
+            SCIP_CALL(SCIPaddConflictLb(scip, consdata->vars[cell_a][digit], bdchgidx));
+        }
+        break;
+    case INFER_NAKED_SINGLE:
+        SCIP_CALL(explain_cell(scip, consdata, cell_a, bdchgidx));
+        break;
+    case INFER_HIDDEN_SINGLE:
+        for (int b = 0; b < 9; b++) {
+            SCIP_VAR* var = consdata->vars[b][digit];
+            if (b != cell_a && var != NULL && SCIPgetVarUbAtIndex(scip, var, bdchgidx, FALSE) < 0.5) {
+                SCIP_CALL(SCIPaddConflictUb(scip, var, bdchgidx));
+            }
+        }
+        break;
+    case INFER_NAKED_PAIR:
+        SCIP_CALL(explain_cell(scip, consdata, cell_a, bdchgidx));
+        SCIP_CALL(explain_cell(scip, consdata, cell_b, bdchgidx));
+        break;
+    }
+    *result = SCIP_SUCCESS;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSLOCK(alldiff_lock) {
+    (void)conshdlr;
+    SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+    // Every variable sits in equalities, so it is locked both ways
+    for (int cell = 0; cell < 9; cell++) {
+        for (int digit = 0; digit < 9; digit++) {
+            if (consdata->vars[cell][digit] != NULL) {
+                SCIP_CALL(SCIPaddVarLocksType(scip, consdata->vars[cell][digit], locktype,
+                                              nlockspos + nlocksneg, nlockspos + nlocksneg));
+            }
+        }
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSTRANS(alldiff_trans) {
+    SCIP_CONSDATA* source = SCIPconsGetData(sourcecons);
+    SCIP_VAR* vars[9][9] = {{NULL}};
+    for (int cell = 0; cell < 9; cell++) {
+        for (int digit = 0; digit < 9; digit++) {
+            if (source->vars[cell][digit] != NULL) {
+                SCIP_CALL(SCIPgetTransformedVar(scip, source->vars[cell][digit], &vars[cell][digit]));
+            }
+        }
+    }
+
+    SCIP_CONSDATA* target = NULL;
+    SCIP_CALL(consdata_create(scip, &target, vars, source->givens));
+    SCIP_CALL(SCIPcreateCons(scip, targetcons, SCIPconsGetName(sourcecons), conshdlr, target,
+                             SCIPconsIsInitial(sourcecons), SCIPconsIsSeparated(sourcecons),
+                             SCIPconsIsEnforced(sourcecons), SCIPconsIsChecked(sourcecons),
+                             SCIPconsIsPropagated(sourcecons), SCIPconsIsLocal(sourcecons),
+                             SCIPconsIsModifiable(sourcecons), SCIPconsIsDynamic(sourcecons),
+                             SCIPconsIsRemovable(sourcecons), SCIPconsIsStickingAtNode(sourcecons)));
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSDELETE(alldiff_delete) {
+    (void)conshdlr;
+    (void)cons;
+    SCIP_CALL(release_rows(scip, *consdata));
+    for (int cell = 0; cell < 9; cell++) {
+        for (int digit = 0; digit < 9; digit++) {
+            if ((*consdata)->vars[cell][digit] != NULL) {
+                SCIP_CALL(SCIPreleaseVar(scip, &(*consdata)->vars[cell][digit]));
+            }
+        }
+    }
+    SCIPfreeBlockMemory(scip, consdata);
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSEXITSOL(alldiff_exitsol) {
+    (void)conshdlr;
+    (void)restart;
+    for (int c = 0; c < nconss; c++) {
+        SCIP_CALL(release_rows(scip, SCIPconsGetData(conss[c])));
+    }
+    return SCIP_OKAY;
+}
+
+// Sub-SCIPs of the primal heuristics get the handler and the constraints too
+static SCIP_DECL_CONSHDLRCOPY(alldiff_conshdlr_copy) {
+    (void)conshdlr;
+    SCIP_CALL(sudoku_include_alldiff_conshdlr(scip));
+    *valid = TRUE;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSCOPY(alldiff_copy) {
+    (void)sourceconshdlr;
+    SCIP_CONSDATA* source = SCIPconsGetData(sourcecons);
+    SCIP_VAR* vars[9][9] = {{NULL}};
+    *valid = TRUE;
+    for (int cell = 0; cell < 9 && *valid; cell++) {
+        for (int digit = 0; digit < 9 && *valid; digit++) {
+            if (source->vars[cell][digit] != NULL) {
+                SCIP_CALL(SCIPgetVarCopy(sourcescip, scip, source->vars[cell][digit], &vars[cell][digit],
+                                         varmap, consmap, global, valid));
+            }
+        }
+    }
+    if (!*valid) {
+        return SCIP_OKAY;
+    }
+
+    SCIP_CONSDATA* consdata = NULL;
+    SCIP_CALL(consdata_create(scip, &consdata, vars, source->givens));
+    SCIP_CALL(SCIPcreateCons(scip, cons, name != NULL ? name : SCIPconsGetName(sourcecons),
+                             SCIPfindConshdlr(scip, SUDOKU_ALLDIFF_CONSHDLR_NAME), consdata, initial, separate,
+                             enforce, check, propagate, local, modifiable, dynamic, removable, stickingatnode));
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE sudoku_include_alldiff_conshdlr(SCIP *scip) {
+    SCIP_CONSHDLR* conshdlr = NULL;
+    SCIP_CALL(SCIPincludeConshdlrBasic(scip, &conshdlr, SUDOKU_ALLDIFF_CONSHDLR_NAME, CONSHDLR_DESC,
+                                       CONSHDLR_ENFOPRIORITY, CONSHDLR_CHECKPRIORITY, CONSHDLR_EAGERFREQ,
+                                       CONSHDLR_NEEDSCONS, alldiff_enfolp, alldiff_enfops, alldiff_check,
+                                       alldiff_lock, NULL));
+    SCIP_CALL(SCIPsetConshdlrCopy(scip, conshdlr, alldiff_conshdlr_copy, alldiff_copy));
+    SCIP_CALL(SCIPsetConshdlrTrans(scip, conshdlr, alldiff_trans));
+    SCIP_CALL(SCIPsetConshdlrDelete(scip, conshdlr, alldiff_delete));
+    SCIP_CALL(SCIPsetConshdlrExitsol(scip, conshdlr, alldiff_exitsol));
+    SCIP_CALL(SCIPsetConshdlrProp(scip, conshdlr, alldiff_prop, CONSHDLR_PROPFREQ, CONSHDLR_DELAYPROP,
+                                  CONSHDLR_PROPTIMING));
+    SCIP_CALL(SCIPsetConshdlrResprop(scip, conshdlr, alldiff_resprop));
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE sudoku_create_alldiff_cons(SCIP *scip, SCIP_CONS **cons, const char *name, SCIP_VAR *vars[9][9],
+                                        const int givens[9]) {
+    SCIP_CONSHDLR* conshdlr = SCIPfindConshdlr(scip, SUDOKU_ALLDIFF_CONSHDLR_NAME);
+    if (conshdlr == NULL) {
+        fprintf(stderr, "Error: constraint handler %s is not included\n", SUDOKU_ALLDIFF_CONSHDLR_NAME);
+        return SCIP_PLUGINNOTFOUND;
+    }
+
+    SCIP_CONSDATA* consdata = NULL;
+    SCIP_CALL(consdata_create(scip, &consdata, vars, givens));
+    // initial = FALSE: the rows join the LP on demand, propagation does the work
+    SCIP_CALL(SCIPcreateCons(scip, cons, name, conshdlr, consdata, FALSE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE,
+                             FALSE, FALSE, FALSE));
+    return SCIP_OKAY;
+}
@@ -0,0 +1,196 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include "problems/sudoku/sudoku_dlx.h"
+#include "sudoku_budget.h"
+
+#define ROOT 0
+
+// Column layout, mirroring the constraint families of create_constraints()
+#define CELL_COLUMN(r, c) (1 + (r) * 9 + (c))
+#define ROW_COLUMN(r, d) (1 + 81 + (r) * 9 + (d))
+#define COL_COLUMN(c, d) (1 + 162 + (c) * 9 + (d))
+#define BOX_COLUMN(b, d) (1 + 243 + (b) * 9 + (d))
+
+typedef struct {
+    sudoku_dlx_t *dlx;
+    sudoku_budget_t budget;
+    sudoku_native_stats_t stats;
+    uint16_t solution[81];
+    int depth;
+} dlx_search_t;
+
+static sudoku_dlx_t dlx_template;
+static pthread_once_t dlx_template_once = PTHREAD_ONCE_INIT;
+
+static void build_template(void) {
+    sudoku_dlx_t *dlx = &dlx_template;
+
+    // Headers form a circular list around the root
+    for (int col = 0; col <= SUDOKU_DLX_COLUMNS; col++) {
+        dlx->left[col] = (uint16_t)(col == 0 ? SUDOKU_DLX_COLUMNS : col - 1);
+        dlx->right[col] = (uint16_t)(col == SUDOKU_DLX_COLUMNS ? 0 : col + 1);
+        dlx->up[col] = (uint16_t)col;
+        dlx->down[col] = (uint16_t)col;
+        dlx->column[col] = (uint16_t)col;
+        dlx->size[col] = 0;
+    }
+
+    int node = SUDOKU_DLX_COLUMNS + 1;
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            for (int d = 0; d < 9; d++) {
+                int columns[4] = {
+                    CELL_COLUMN(r, c),
+                    ROW_COLUMN(r, d),
+                    COL_COLUMN(c, d),
+                    BOX_COLUMN((r / 3) * 3 + c / 3, d)
+                };
+                int first = node;
+                for (int k = 0; k < 4; k++, node++) {
+                    int col = columns[k];
+                    // Append at the bottom of the column
+                    dlx->up[node] = dlx->up[col];
+                    dlx->down[node] = (uint16_t)col;
+                    dlx->down[dlx->up[col]] = (uint16_t)node;
+                    dlx->up[col] = (uint16_t)node;
+                    dlx->column[node] = (uint16_t)col;
+                    dlx->row[node] = (uint16_t)((r * 9 + c) * 9 + d);
+                    dlx->size[col]++;
+                    // Circular row list of the four nodes
+                    dlx->left[node] = (uint16_t)(k == 0 ? first + 3 : node - 1);
+                    dlx->right[node] = (uint16_t)(k == 3 ? first : node + 1);
+                }
+            }
+        }
+    }
+}
+
+static void cover(sudoku_dlx_t *dlx, int col) {
+    dlx->right[dlx->left[col]] = dlx->right[col];
+    dlx->left[dlx->right[col]] = dlx->left[col];
+    for (int i = dlx->down[col]; i != col; i = dlx->down[i]) {
+        for (int j = dlx->right[i]; j != i; j = dlx->right[j]) {
+            dlx->down[dlx->up[j]] = dlx->down[j];
+            dlx->up[dlx->down[j]] = dlx->up[j];
+            dlx->size[dlx->column[j]]--;
+        }
+    }
+}
+
+static void uncover(sudoku_dlx_t *dlx, int col) {
+    for (int i = dlx->up[col]; i != col; i = dlx->up[i]) {
+        for (int j = dlx->left[i]; j != i; j = dlx->left[j]) {
+            dlx->size[dlx->column[j]]++;
+            dlx->down[dlx->up[j]] = (uint16_t)j;
+            dlx->up[dlx->down[j]] = (uint16_t)j;
+        }
+    }
+    dlx->right[dlx->left[col]] = (uint16_t)col;
+    dlx->left[dlx->right[col]] = (uint16_t)col;
+}
+
+static bool search_cover(dlx_search_t *search) {
+    sudoku_dlx_t *dlx = search->dlx;
+    if (dlx->right[ROOT] == ROOT) {
+        return true;
+    }
+
+    // Column with the fewest remaining rows
+    int best = dlx->right[ROOT];
+    for (int col = dlx->right[best]; col != ROOT && dlx->size[best] > 1; col = dlx->right[col]) {
+        if (dlx->size[col] < dlx->size[best]) {
+            best = col;
+        }
+    }
+    if (dlx->size[best] == 0) {
+        return false;
+    }
+
+    bool found = false;
+    cover(dlx, best);
+    for (int i = dlx->down[best]; i != best && !found; i = dlx->down[i]) {
+        if (sudoku_budget_exhausted(&search->budget, search->stats.nodes)) {
+            break;
+        }
+        search->stats.nodes++;
+
+        search->solution[search->depth++] = dlx->row[i];
+        for (int j = dlx->right[i]; j != i; j = dlx->right[j]) {
+            cover(dlx, dlx->column[j]);
+        }
+        found = search_cover(search);
+        for (int j = dlx->left[i]; j != i; j = dlx->left[j]) {
+            uncover(dlx, dlx->column[j]);
+        }
+        if (!found) {
+            search->depth--;
+        }
+    }
+    uncover(dlx, best);
+    return found;
+}
+
+// Removes the columns satisfied by a given. Returns false when one of
+// them is already covered, i.e. two givens clash.
+static bool select_given(sudoku_dlx_t *dlx, bool covered[], int r, int c, int d) {
+    int columns[4] = {CELL_COLUMN(r, c), ROW_COLUMN(r, d), COL_COLUMN(c, d), BOX_COLUMN((r / 3) * 3 + c / 3, d)};
+    for (int k = 0; k < 4; k++) {
+        if (covered[columns[k]]) {
+            return false;
+        }
+    }
+    for (int k = 0; k < 4; k++) {
+        covered[columns[k]] = true;
+        cover(dlx, columns[k]);
+    }
+    return true;
+}
+
+sudoku_native_status_t sudoku_dlx_solve_with(sudoku_dlx_t *dlx, int grid[9][9],
+                                             const sudoku_native_limits_t *limits,
+                                             sudoku_native_stats_t *stats) {
+    pthread_once(&dlx_template_once, build_template);
+    memcpy(dlx, &dlx_template, sizeof(*dlx));
+
+    dlx_search_t search;
+    memset(&search, 0, sizeof(search));
+    search.dlx = dlx;
+    sudoku_budget_init(&search.budget, limits);
+
+    bool covered[SUDOKU_DLX_COLUMNS + 1] = {false};
+    sudoku_native_status_t status = SUDOKU_NATIVE_SOLVED;
+    for (int r = 0; r < 9 && status == SUDOKU_NATIVE_SOLVED; r++) {
+        for (int c = 0; c < 9; c++) {
+            int value = grid[r][c];
+            if (value < 0 || value > 9 || (value > 0 && !select_given(dlx, covered, r, c, value - 1))) {
+                status = SUDOKU_NATIVE_INFEASIBLE;
+                break;
+            }
+        }
+    }
+
+    if (status == SUDOKU_NATIVE_SOLVED && !search_cover(&search)) {
+        status = search.budget.limit_reached ? SUDOKU_NATIVE_LIMIT_REACHED : SUDOKU_NATIVE_INFEASIBLE;
+    }
+
+    if (status == SUDOKU_NATIVE_SOLVED) {
+        for (int k = 0; k < search.depth; k++) {
+            int cell = search.solution[k] / 9;
+            grid[cell / 9][cell % 9] = search.solution[k] % 9 + 1;
+        }
+    }
+    if (stats) {
+        *stats = search.stats;
+    }
+    return status;
+}
+
+sudoku_native_status_t sudoku_dlx_solve(int grid[9][9], const sudoku_native_limits_t *limits,
+                                        sudoku_native_stats_t *stats) {
+    // ~36 KB of links, kept per thread instead of on the stack
+    static _Thread_local sudoku_dlx_t dlx;
+    return sudoku_dlx_solve_with(&dlx, grid, limits, stats);
+}
@@ -0,0 +1,342 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "problems/sudoku/sudoku_generator.h"
+#include "problems/sudoku/sudoku_parser.h"
+#include "problems/sudoku/sudoku_propagation.h"
+#include "sudoku_budget.h"
+
+// Puzzles handed out per grab of the shared cursor, as in sudoku_batch.c
+#define GENERATOR_CHUNK 16
+// Clue swaps tried on one thinned puzzle to move it into the target tier
+#define GENERATOR_SWAPS 1024
+
+typedef struct {
+    uint64_t state;
+} generator_rng_t;
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static uint32_t rng_next(generator_rng_t *rng) {
+    // xorshift64*, upper bits
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return (uint32_t)((rng->state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+static void shuffle(int *values, int count, generator_rng_t *rng) {
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int)(rng_next(rng) % (uint32_t)(i + 1));
+        int tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+    }
+}
+
+// Permutation of the 9 lines that keeps bands (or stacks) together
+static void line_permutation(int perm[9], generator_rng_t *rng) {
+    int bands[3] = {0, 1, 2};
+    shuffle(bands, 3, rng);
+    for (int b = 0; b < 3; b++) {
+        int inner[3] = {0, 1, 2};
+        shuffle(inner, 3, rng);
+        for (int r = 0; r < 3; r++) {
+            perm[3 * b + r] = 3 * bands[b] + inner[r];
+        }
+    }
+}
+
+// Random solved grid: the three diagonal boxes do not constrain each
+// other, so random digits there always complete; row and column
+// permutations then spread the search's digit order bias
+static void random_solution(int grid[9][9], generator_rng_t *rng) {
+    int seed[9][9] = {{0}};
+    for (int box = 0; box < 3; box++) {
+        int digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        shuffle(digits, 9, rng);
+        for (int k = 0; k < 9; k++) {
+            seed[3 * box + k / 3][3 * box + k % 3] = digits[k];
+        }
+    }
+    sudoku_native_solve(seed, NULL, NULL);
+
+    int rows[9];
+    int cols[9];
+    line_permutation(rows, rng);
+    line_permutation(cols, rng);
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            grid[i][j] = seed[rows[i]][cols[j]];
+        }
+    }
+}
+
+static bool is_unique(const int puzzle[9][9]) {
+    int grid[9][9];
+    int count = 0;
+    memcpy(grid, puzzle, sizeof(grid));
+    return sudoku_native_count(grid, 2, NULL, NULL, &count) == SUDOKU_NATIVE_SOLVED && count == 1;
+}
+
+// Removes clues in random order down to target, skipping every removal
+// that would open up a second solution. Returns the clues left.
+static int thin_out(int puzzle[9][9], int target, generator_rng_t *rng) {
+    int cells[81];
+    for (int cell = 0; cell < 81; cell++) {
+        cells[cell] = cell;
+    }
+    shuffle(cells, 81, rng);
+
+    int clues = 81;
+    for (int n = 0; n < 81 && clues > target; n++) {
+        int row = cells[n] / 9;
+        int col = cells[n] % 9;
+        int value = puzzle[row][col];
+
+        puzzle[row][col] = 0;
+        // Fewer than 4 blanks cannot have a second solution
+        if (clues > 78 || is_unique((const int (*)[9])puzzle)) {
+            clues--;
+        } else {
+            puzzle[row][col] = value;
+        }
+    }
+    return clues;
+}
+
+// Search effort the grade is read from
+static long solve_nodes(const int puzzle[9][9]) {
+    int grid[9][9];
+    sudoku_native_stats_t stats;
+    memcpy(grid, puzzle, sizeof(grid));
+    sudoku_native_solve(grid, NULL, &stats);
+    return stats.nodes;
+}
+
+static sudoku_difficulty_t tier_of(long nodes) {
+    if (nodes == 0) {
+        return SUDOKU_DIFFICULTY_EASY;
+    }
+    return nodes <= SUDOKU_MEDIUM_MAX_NODES ? SUDOKU_DIFFICULTY_MEDIUM : SUDOKU_DIFFICULTY_HARD;
+}
+
+sudoku_difficulty_t sudoku_grade(const int puzzle[9][9]) {
+    return tier_of(solve_nodes(puzzle));
+}
+
+// Moves a thinned puzzle of the solved grid full towards the target tier
+// without changing its clue count: a random clue is swapped for a random
+// blank cell and the swap is kept when the puzzle stays unique and its
+// search effort does not move away from the target. Returns the tier
+// reached.
+static sudoku_difficulty_t reach_tier(int puzzle[9][9], const int full[9][9], sudoku_difficulty_t target,
+                                      generator_rng_t *rng) {
+    long nodes = solve_nodes((const int (*)[9])puzzle);
+    sudoku_difficulty_t tier = tier_of(nodes);
+    for (int swap = 0; swap < GENERATOR_SWAPS && target != SUDOKU_DIFFICULTY_ANY && tier != target; swap++) {
+        bool harder = tier < target;
+        int clue = 0;
+        int blank = 0;
+        do {
+            clue = (int)(rng_next(rng) % 81u);
+        } while (!puzzle[clue / 9][clue % 9]);
+        do {
+            blank = (int)(rng_next(rng) % 81u);
+        } while (puzzle[blank / 9][blank % 9]);
+
+        puzzle[clue / 9][clue % 9] = 0;
+        puzzle[blank / 9][blank % 9] = full[blank / 9][blank % 9];
+        long swapped = is_unique((const int (*)[9])puzzle) ? solve_nodes((const int (*)[9])puzzle) : -1;
+        if (swapped >= 0 && (harder ? swapped >= nodes : swapped <= nodes)) {
+            nodes = swapped;
+            tier = tier_of(nodes);
+        } else {
+            puzzle[blank / 9][blank % 9] = 0;
+            puzzle[clue / 9][clue % 9] = full[clue / 9][clue % 9];
+        }
+    }
+    return tier;
+}
+
+void sudoku_generator_default_config(sudoku_generator_config_t *config) {
+    config->clues = 30;
+    config->difficulty = SUDOKU_DIFFICULTY_ANY;
+    config->max_attempts = 100;
+    config->threads = 0;
+    config->seed = 1;
+}
+
+int sudoku_generate(uint64_t seed, const sudoku_generator_config_t *config, int puzzle[9][9],
+                    int solution[9][9], sudoku_difficulty_t *grade, int *attempts) {
+    sudoku_generator_config_t defaults;
+    if (!config) {
+        sudoku_generator_default_config(&defaults);
+        config = &defaults;
+    }
+    int target = config->clues < SUDOKU_MIN_CLUES ? SUDOKU_MIN_CLUES : config->clues > 80 ? 80 : config->clues;
+    generator_rng_t rng = {splitmix64(seed) | 1u};
+
+    int tries = 0;
+    int result = EXIT_FAILURE;
+    while (tries < config->max_attempts && result != EXIT_SUCCESS) {
+        tries++;
+        int full[9][9];
+        random_solution(full, &rng);
+        memcpy(puzzle, full, sizeof(full));
+        if (thin_out(puzzle, target, &rng) != target) {
+            continue;
+        }
+
+        sudoku_difficulty_t tier = reach_tier(puzzle, (const int (*)[9])full, config->difficulty, &rng);
+        if (config->difficulty != SUDOKU_DIFFICULTY_ANY && tier != config->difficulty) {
+            continue;
+        }
+        if (solution) {
+            memcpy(solution, full, sizeof(full));
+        }
+        if (grade) {
+            *grade = tier;
+        }
+        result = EXIT_SUCCESS;
+    }
+
+    if (attempts) {
+        *attempts = tries;
+    }
+    return result;
+}
+
+typedef struct {
+    const sudoku_generator_config_t *config;
+    char *puzzles;
+    char *solutions;
+    sudoku_difficulty_t *grades;
+    size_t count;
+    atomic_size_t next;
+} generator_job_t;
+
+typedef struct {
+    generator_job_t *job;
+    pthread_t thread;
+    size_t generated;
+    size_t failed;
+    size_t attempts;
+} generator_worker_t;
+
+static void *generator_worker(void *arg) {
+    generator_worker_t *worker = arg;
+    generator_job_t *job = worker->job;
+
+    for (;;) {
+        size_t begin = atomic_fetch_add(&job->next, GENERATOR_CHUNK);
+        if (begin >= job->count) {
+            break;
+        }
+        size_t end = begin + GENERATOR_CHUNK < job->count ? begin + GENERATOR_CHUNK : job->count;
+
+        for (size_t n = begin; n < end; n++) {
+            int puzzle[9][9];
+            int solution[9][9];
+            sudoku_difficulty_t grade = SUDOKU_DIFFICULTY_ANY;
+            int attempts = 0;
+
+            // The seed of puzzle n does not depend on which worker makes it
+            uint64_t seed = splitmix64(job->config->seed) ^ (uint64_t)n;
+            if (sudoku_generate(seed, job->config, puzzle, solution, &grade, &attempts) == EXIT_SUCCESS) {
+                worker->generated++;
+            } else {
+                memset(puzzle, 0, sizeof(puzzle));
+                memset(solution, 0, sizeof(solution));
+                grade = SUDOKU_DIFFICULTY_ANY;
+                worker->failed++;
+            }
+            worker->attempts += (size_t)attempts;
+
+            sudoku_format_line((const int (*)[9])puzzle, job->puzzles + n * SUDOKU_PUZZLE_LEN);
+            if (job->solutions) {
+                sudoku_format_line((const int (*)[9])solution, job->solutions + n * SUDOKU_PUZZLE_LEN);
+            }
+            if (job->grades) {
+                job->grades[n] = grade;
+            }
+        }
+    }
+    return NULL;
+}
+
+int sudoku_generate_batch(size_t count, char *puzzles, char *solutions, sudoku_difficulty_t *grades,
+                          const sudoku_generator_config_t *config, sudoku_generator_stats_t *stats) {
+    sudoku_generator_config_t defaults;
+    if (!config) {
+        sudoku_generator_default_config(&defaults);
+        config = &defaults;
+    }
+    if (!puzzles && count > 0) {
+        return EXIT_FAILURE;
+    }
+
+    int threads = config->threads;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    size_t chunks = (count + GENERATOR_CHUNK - 1) / GENERATOR_CHUNK;
+    if (chunks < (size_t)threads) {
+        threads = chunks > 0 ? (int)chunks : 1;
+    }
+
+    generator_job_t job = {
+        .config = config,
+        .puzzles = puzzles,
+        .solutions = solutions,
+        .grades = grades,
+        .count = count
+    };
+    atomic_init(&job.next, 0);
+
+    generator_worker_t *workers = calloc((size_t)threads, sizeof(*workers));
+    if (!workers) {
+        return EXIT_FAILURE;
+    }
+
+    double start = sudoku_now_seconds();
+    int started = 0;
+    for (; started < threads; started++) {
+        workers[started].job = &job;
+        if (pthread_create(&workers[started].thread, NULL, generator_worker, &workers[started]) != 0) {
+            fprintf(stderr, "Error starting generator worker %d\n", started);
+            break;
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed = sudoku_now_seconds() - start;
+
+    sudoku_generator_stats_t totals = {0};
+    totals.threads = started;
+    totals.elapsed = elapsed;
+    for (int t = 0; t < started; t++) {
+        totals.generated += workers[t].generated;
+        totals.failed += workers[t].failed;
+        totals.attempts += workers[t].attempts;
+    }
+    totals.puzzles_per_second = elapsed > 0.0 ? (double)totals.generated / elapsed : 0.0;
+    if (stats) {
+        *stats = totals;
+    }
+
+    free(workers);
+    return started > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
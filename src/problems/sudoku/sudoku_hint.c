@@ -0,0 +1,407 @@
+#include <string.h>
+#include "problems/sudoku/sudoku_hint.h"
+
+#define ALL_DIGITS 0x1FFu
+
+// Candidates after the marks; placed cells have none
+typedef struct {
+    uint8_t cells[81];
+    uint16_t candidates[81];
+    uint16_t digit_rows[9][9];   // [digit - 1][row]: columns where the digit is a candidate
+    uint16_t digit_cols[9][9];   // [digit - 1][col]: rows where the digit is a candidate
+} hint_state_t;
+
+static const char *technique_names[] = {
+    "none", "contradiction", "naked single", "hidden single", "naked pair",
+    "pointing", "claiming", "hidden pair", "x-wing"
+};
+
+static inline int box_of(int row, int col) {
+    return (row / 3) * 3 + col / 3;
+}
+
+static inline int unit_cell(int unit, int k) {
+    // Units 0-8 are rows, 9-17 columns, 18-26 boxes
+    if (unit < 9) {
+        return unit * 9 + k;
+    }
+    if (unit < 18) {
+        return k * 9 + (unit - 9);
+    }
+    int box = unit - 18;
+    return ((box / 3) * 3 + k / 3) * 9 + (box % 3) * 3 + k % 3;
+}
+
+// Cell k of a row, or of a column when by_columns
+static inline int line_cell(bool by_columns, int line, int k) {
+    return by_columns ? k * 9 + line : line * 9 + k;
+}
+
+static inline int digit_of(uint16_t mask) {
+    return __builtin_ctz(mask) + 1;
+}
+
+static void begin(sudoku_hint_t *hint, sudoku_hint_technique_t technique, int unit, uint16_t digits) {
+    memset(hint, 0, sizeof(*hint));
+    hint->technique = technique;
+    hint->unit = unit;
+    hint->digits = digits;
+    hint->placement_cell = -1;
+}
+
+static void add_cell(sudoku_hint_t *hint, int cell) {
+    if (hint->cell_count < SUDOKU_HINT_MAX_CELLS) {
+        hint->cells[hint->cell_count++] = cell;
+    }
+}
+
+static void eliminate(sudoku_hint_t *hint, const hint_state_t *state, int cell, uint16_t digits) {
+    uint16_t removed = state->candidates[cell] & digits & (uint16_t)~hint->eliminations[cell];
+    if (removed == 0) {
+        return;
+    }
+    if (hint->eliminations[cell] == 0) {
+        hint->elimination_count++;
+    }
+    hint->eliminations[cell] |= removed;
+}
+
+static bool place(sudoku_hint_t *hint, sudoku_hint_technique_t technique, int unit, int cell, int digit) {
+    begin(hint, technique, unit, (uint16_t)(1u << (digit - 1)));
+    add_cell(hint, cell);
+    hint->placement_cell = cell;
+    hint->placement_digit = digit;
+    return true;
+}
+
+// Builds the candidate state; reports clashing givens as a contradiction
+static bool load(const int grid[9][9], const uint16_t marks[81], hint_state_t *state, sudoku_hint_t *hint) {
+    uint16_t used[27] = {0};
+    memset(state->digit_rows, 0, sizeof(state->digit_rows));
+    memset(state->digit_cols, 0, sizeof(state->digit_cols));
+    int where[27][9];
+
+    for (int cell = 0; cell < 81; cell++) {
+        int row = cell / 9;
+        int col = cell % 9;
+        int digit = grid[row][col];
+        if (digit < 0 || digit > 9) {
+            begin(hint, SUDOKU_HINT_CONTRADICTION, -1, 0);
+            add_cell(hint, cell);
+            return false;
+        }
+        state->cells[cell] = (uint8_t)digit;
+        if (digit == 0) {
+            continue;
+        }
+        uint16_t bit = (uint16_t)(1u << (digit - 1));
+        int units[3] = {row, 9 + col, 18 + box_of(row, col)};
+        for (int u = 0; u < 3; u++) {
+            if (used[units[u]] & bit) {
+                begin(hint, SUDOKU_HINT_CONTRADICTION, units[u], bit);
+                add_cell(hint, where[units[u]][digit - 1]);
+                add_cell(hint, cell);
+                return false;
+            }
+            used[units[u]] |= bit;
+            where[units[u]][digit - 1] = cell;
+        }
+    }
+
+    for (int cell = 0; cell < 81; cell++) {
+        int row = cell / 9;
+        int col = cell % 9;
+        if (state->cells[cell]) {
+            state->candidates[cell] = 0;
+            continue;
+        }
+        uint16_t allowed = (uint16_t)(~(used[row] | used[9 + col] | used[18 + box_of(row, col)]) & ALL_DIGITS);
+        uint16_t marked = marks && marks[cell] ? marks[cell] : ALL_DIGITS;
+        state->candidates[cell] = allowed & marked;
+        for (uint16_t mask = state->candidates[cell]; mask; mask &= mask - 1) {
+            int d = __builtin_ctz(mask);
+            state->digit_rows[d][row] |= (uint16_t)(1u << col);
+            state->digit_cols[d][col] |= (uint16_t)(1u << row);
+        }
+    }
+    return true;
+}
+
+static bool find_dead_end(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int cell = 0; cell < 81; cell++) {
+        if (!state->cells[cell] && state->candidates[cell] == 0) {
+            begin(hint, SUDOKU_HINT_CONTRADICTION, -1, 0);
+            add_cell(hint, cell);
+            return true;
+        }
+    }
+    for (int unit = 0; unit < 27; unit++) {
+        uint16_t covered = 0;
+        for (int k = 0; k < 9; k++) {
+            int cell = unit_cell(unit, k);
+            covered |= state->cells[cell] ? (uint16_t)(1u << (state->cells[cell] - 1)) : state->candidates[cell];
+        }
+        if (covered != ALL_DIGITS) {
+            uint16_t missing = (uint16_t)(~covered & ALL_DIGITS);
+            begin(hint, SUDOKU_HINT_CONTRADICTION, unit, (uint16_t)(missing & -missing));
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool find_naked_single(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int cell = 0; cell < 81; cell++) {
+        uint16_t mask = state->candidates[cell];
+        if (mask && (mask & (mask - 1)) == 0) {
+            return place(hint, SUDOKU_HINT_NAKED_SINGLE, -1, cell, digit_of(mask));
+        }
+    }
+    return false;
+}
+
+static bool find_hidden_single(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int unit = 0; unit < 27; unit++) {
+        uint16_t seen_once = 0;
+        uint16_t seen_twice = 0;
+        for (int k = 0; k < 9; k++) {
+            uint16_t mask = state->candidates[unit_cell(unit, k)];
+            seen_twice |= seen_once & mask;
+            seen_once |= mask;
+        }
+        uint16_t single = seen_once & (uint16_t)~seen_twice;
+        if (single == 0) {
+            continue;
+        }
+        int digit = digit_of(single);
+        for (int k = 0; k < 9; k++) {
+            int cell = unit_cell(unit, k);
+            if (state->candidates[cell] & (1u << (digit - 1))) {
+                return place(hint, SUDOKU_HINT_HIDDEN_SINGLE, unit, cell, digit);
+            }
+        }
+    }
+    return false;
+}
+
+static bool find_naked_pair(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int unit = 0; unit < 27; unit++) {
+        for (int a = 0; a < 9; a++) {
+            int first = unit_cell(unit, a);
+            uint16_t pair = state->candidates[first];
+            if (__builtin_popcount(pair) != 2) {
+                continue;
+            }
+            for (int b = a + 1; b < 9; b++) {
+                int second = unit_cell(unit, b);
+                if (state->candidates[second] != pair) {
+                    continue;
+                }
+                begin(hint, SUDOKU_HINT_NAKED_PAIR, unit, pair);
+                add_cell(hint, first);
+                add_cell(hint, second);
+                for (int k = 0; k < 9; k++) {
+                    if (k != a && k != b) {
+                        eliminate(hint, state, unit_cell(unit, k), pair);
+                    }
+                }
+                if (hint->elimination_count > 0) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Pointing: a digit confined to one row (or column) within a box goes from
+// the rest of that line
+static bool find_pointing(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int box = 0; box < 9; box++) {
+        for (int by_columns = 0; by_columns < 2; by_columns++) {
+            const uint16_t (*lines)[9] = by_columns ? state->digit_cols : state->digit_rows;
+            int first = by_columns ? (box % 3) * 3 : (box / 3) * 3;
+            uint16_t slice = (uint16_t)(7u << (by_columns ? (box / 3) * 3 : (box % 3) * 3));
+
+            for (int d = 0; d < 9; d++) {
+                int line = -1;
+                int hits = 0;
+                for (int l = first; l < first + 3; l++) {
+                    if (lines[d][l] & slice) {
+                        line = l;
+                        hits++;
+                    }
+                }
+                uint16_t outside = hits == 1 ? lines[d][line] & (uint16_t)~slice : 0;
+                if (outside == 0) {
+                    continue;
+                }
+                uint16_t bit = (uint16_t)(1u << d);
+                begin(hint, SUDOKU_HINT_POINTING, 18 + box, bit);
+                for (uint16_t inside = lines[d][line] & slice; inside; inside &= inside - 1) {
+                    add_cell(hint, line_cell(by_columns, line, __builtin_ctz(inside)));
+                }
+                for (; outside; outside &= outside - 1) {
+                    eliminate(hint, state, line_cell(by_columns, line, __builtin_ctz(outside)), bit);
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Claiming: a digit confined to one box within a row (or column) goes from
+// the rest of that box
+static bool find_claiming(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int by_columns = 0; by_columns < 2; by_columns++) {
+        const uint16_t (*lines)[9] = by_columns ? state->digit_cols : state->digit_rows;
+
+        for (int line = 0; line < 9; line++) {
+            int first = (line / 3) * 3;
+            for (int d = 0; d < 9; d++) {
+                uint16_t mask = lines[d][line];
+                int shift = mask == 0 ? -1 : (__builtin_ctz(mask) / 3) * 3;
+                if (shift < 0 || (mask & (uint16_t)~(7u << shift)) != 0) {
+                    continue;
+                }
+                uint16_t slice = (uint16_t)(7u << shift);
+                bool outside = false;
+                for (int l = first; l < first + 3; l++) {
+                    outside |= l != line && (lines[d][l] & slice);
+                }
+                if (!outside) {
+                    continue;
+                }
+                uint16_t bit = (uint16_t)(1u << d);
+                begin(hint, SUDOKU_HINT_CLAIMING, by_columns ? 9 + line : line, bit);
+                for (; mask; mask &= mask - 1) {
+                    add_cell(hint, line_cell(by_columns, line, __builtin_ctz(mask)));
+                }
+                for (int l = first; l < first + 3; l++) {
+                    for (uint16_t other = l == line ? 0 : lines[d][l] & slice; other; other &= other - 1) {
+                        eliminate(hint, state, line_cell(by_columns, l, __builtin_ctz(other)), bit);
+                    }
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool find_hidden_pair(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int unit = 0; unit < 27; unit++) {
+        // Positions of each digit within the unit, bit k for cell k
+        uint16_t positions[9] = {0};
+        for (int k = 0; k < 9; k++) {
+            for (uint16_t mask = state->candidates[unit_cell(unit, k)]; mask; mask &= mask - 1) {
+                positions[__builtin_ctz(mask)] |= (uint16_t)(1u << k);
+            }
+        }
+        for (int d1 = 0; d1 < 9; d1++) {
+            if (__builtin_popcount(positions[d1]) != 2) {
+                continue;
+            }
+            for (int d2 = d1 + 1; d2 < 9; d2++) {
+                if (positions[d2] != positions[d1]) {
+                    continue;
+                }
+                uint16_t pair = (uint16_t)((1u << d1) | (1u << d2));
+                int a = __builtin_ctz(positions[d1]);
+                int b = 31 - __builtin_clz(positions[d1]);
+                begin(hint, SUDOKU_HINT_HIDDEN_PAIR, unit, pair);
+                add_cell(hint, unit_cell(unit, a));
+                add_cell(hint, unit_cell(unit, b));
+                eliminate(hint, state, unit_cell(unit, a), (uint16_t)~pair & ALL_DIGITS);
+                eliminate(hint, state, unit_cell(unit, b), (uint16_t)~pair & ALL_DIGITS);
+                if (hint->elimination_count > 0) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// X-wing: a digit with the same two places in two rows is confined to
+// those two columns there, so it goes from the rest of both columns (and
+// the same with rows and columns swapped)
+static bool find_x_wing(const hint_state_t *state, sudoku_hint_t *hint) {
+    for (int d = 0; d < 9; d++) {
+        for (int by_columns = 0; by_columns < 2; by_columns++) {
+            const uint16_t *lines = by_columns ? state->digit_cols[d] : state->digit_rows[d];
+            const uint16_t *covers = by_columns ? state->digit_rows[d] : state->digit_cols[d];
+
+            for (int l1 = 0; l1 < 9; l1++) {
+                if (__builtin_popcount(lines[l1]) != 2) {
+                    continue;
+                }
+                for (int l2 = l1 + 1; l2 < 9; l2++) {
+                    if (lines[l2] != lines[l1]) {
+                        continue;
+                    }
+                    int cover[2] = {__builtin_ctz(lines[l1]), 31 - __builtin_clz(lines[l1])};
+                    uint16_t base = (uint16_t)((1u << l1) | (1u << l2));
+                    if (((covers[cover[0]] | covers[cover[1]]) & (uint16_t)~base) == 0) {
+                        continue;
+                    }
+                    uint16_t bit = (uint16_t)(1u << d);
+                    begin(hint, SUDOKU_HINT_X_WING, -1, bit);
+                    for (int c = 0; c < 2; c++) {
+                        add_cell(hint, line_cell(by_columns, l1, cover[c]));
+                        add_cell(hint, line_cell(by_columns, l2, cover[c]));
+                        for (uint16_t other = covers[cover[c]] & (uint16_t)~base; other; other &= other - 1) {
+                            eliminate(hint, state, line_cell(by_columns, __builtin_ctz(other), cover[c]), bit);
+                        }
+                    }
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+sudoku_hint_technique_t sudoku_next_hint(const int grid[9][9], const uint16_t marks[81], sudoku_hint_t *hint) {
+    hint_state_t state;
+    if (!load(grid, marks, &state, hint)) {
+        return hint->technique;
+    }
+
+    if (find_dead_end(&state, hint) || find_naked_single(&state, hint) || find_hidden_single(&state, hint)
+        || find_naked_pair(&state, hint) || find_pointing(&state, hint) || find_claiming(&state, hint)
+        || find_hidden_pair(&state, hint)
+        || find_x_wing(&state, hint)) {
+        return hint->technique;
+    }
+    begin(hint, SUDOKU_HINT_NONE, -1, 0);
+    return SUDOKU_HINT_NONE;
+}
+
+void sudoku_hint_apply(const sudoku_hint_t *hint, int grid[9][9], uint16_t marks[81]) {
+    if (marks && hint->elimination_count > 0) {
+        hint_state_t state;
+        sudoku_hint_t ignored;
+        if (load((const int (*)[9])grid, marks, &state, &ignored)) {
+            for (int cell = 0; cell < 81; cell++) {
+                if (hint->eliminations[cell]) {
+                    marks[cell] = state.candidates[cell] & (uint16_t)~hint->eliminations[cell];
+                }
+            }
+        }
+    }
+    if (hint->placement_cell >= 0) {
+        grid[hint->placement_cell / 9][hint->placement_cell % 9] = hint->placement_digit;
+        if (marks) {
+            marks[hint->placement_cell] = 0;
+        }
+    }
+}
+
+const char *sudoku_hint_technique_name(sudoku_hint_technique_t technique) {
+    if ((unsigned)technique >= sizeof(technique_names) / sizeof(technique_names[0])) {
+        return "unknown";
+    }
+    return technique_names[technique];
+}
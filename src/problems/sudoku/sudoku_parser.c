@@ -0,0 +1,449 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "mongoose/mongoose.h"
+#include "problems/sudoku/sudoku_parser.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Digits already given per row, column and box of the line being parsed
+typedef struct {
+    uint16_t rows[9];
+    uint16_t cols[9];
+    uint16_t boxes[9];
+    bool duplicate;
+} line_givens_t;
+
+// Marks the givens of cells base.. selected by the bit mask; sets duplicate
+// on the first digit already in the cell's row, column or box
+static inline void mark_givens(line_givens_t *givens, const uint8_t *cells, int base, uint32_t mask) {
+    for (; mask && !givens->duplicate; mask &= mask - 1) {
+        int cell = base + __builtin_ctz(mask);
+        int row = cell / 9;
+        int col = cell % 9;
+        int box = (row / 3) * 3 + col / 3;
+        uint16_t bit = (uint16_t)(1u << cells[cell]);
+        givens->duplicate = ((givens->rows[row] | givens->cols[col] | givens->boxes[box]) & bit) != 0;
+        givens->rows[row] |= bit;
+        givens->cols[col] |= bit;
+        givens->boxes[box] |= bit;
+    }
+}
+
+// Classifies 16 bytes: digits become their value, '.' becomes 0. Returns
+// the movemask of valid bytes (0xFFFF when all of them are valid) and sets
+// *given to the movemask of nonzero digits.
+#if defined(__SSE2__)
+static inline unsigned classify16(const char *src, uint8_t *dst, uint32_t *given) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)src);
+    __m128i values = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    // Unsigned values <= 9 <=> min(values, 9) == values
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+    __m128i is_dot = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('.'));
+    __m128i digits = _mm_and_si128(values, is_digit);
+    _mm_storeu_si128((__m128i *)dst, digits);
+    *given = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(digits, _mm_setzero_si128())) & 0xFFFFu;
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(is_digit, is_dot));
+}
+#endif
+
+#if defined(__AVX2__)
+static inline uint32_t classify32(const char *src, uint8_t *dst, uint32_t *given) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)src);
+    __m256i values = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    __m256i is_dot = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('.'));
+    __m256i digits = _mm256_and_si256(values, is_digit);
+    _mm256_storeu_si256((__m256i *)dst, digits);
+    *given = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(digits, _mm256_setzero_si256()));
+    return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_dot));
+}
+#endif
+
+static inline bool classify_scalar(char ch, uint8_t *dst) {
+    if (ch >= '0' && ch <= '9') {
+        *dst = (uint8_t)(ch - '0');
+        return true;
+    }
+    *dst = 0;
+    return ch == '.';
+}
+
+// One pass over the line: each block is classified and its givens marked
+// before the next block is loaded. A bad character anywhere wins over a
+// duplicate.
+static sudoku_parse_status_t classify_line(const char *line, uint8_t cells[SUDOKU_PUZZLE_LEN]) {
+    line_givens_t givens = {0};
+    int done = 0;
+    bool valid = true;
+
+#if defined(__AVX2__)
+    for (; valid && done + 32 <= SUDOKU_PUZZLE_LEN; done += 32) {
+        uint32_t given = 0;
+        valid = classify32(line + done, cells + done, &given) == 0xFFFFFFFFu;
+        mark_givens(&givens, cells, done, given);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; valid && done + 16 <= SUDOKU_PUZZLE_LEN; done += 16) {
+        uint32_t given = 0;
+        valid = classify16(line + done, cells + done, &given) == 0xFFFFu;
+        mark_givens(&givens, cells, done, given);
+    }
+#endif
+    for (; valid && done < SUDOKU_PUZZLE_LEN; done++) {
+        valid = classify_scalar(line[done], &cells[done]);
+        mark_givens(&givens, cells, done, (uint32_t)(cells[done] != 0));
+    }
+    if (!valid) {
+        return SUDOKU_PARSE_BAD_CHAR;
+    }
+    return givens.duplicate ? SUDOKU_PARSE_DUPLICATE : SUDOKU_PARSE_OK;
+}
+
+static void cells_to_grid(const uint8_t cells[SUDOKU_PUZZLE_LEN], int grid[9][9]) {
+    for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+        grid[cell / 9][cell % 9] = cells[cell];
+    }
+}
+
+sudoku_parse_status_t sudoku_parse_line(const char *line, int grid[9][9]) {
+    uint8_t cells[SUDOKU_PUZZLE_LEN];
+    sudoku_parse_status_t status = classify_line(line, cells);
+    if (status == SUDOKU_PARSE_OK) {
+        cells_to_grid(cells, grid);
+    }
+    return status;
+}
+
+bool sudoku_grid_init(sudoku_grid_t *grid, int order) {
+    if (order < SUDOKU_MIN_ORDER || order > SUDOKU_MAX_ORDER) {
+        return false;
+    }
+    grid->order = order;
+    grid->size = order * order;
+    memset(grid->cells, 0, (size_t)(grid->size * grid->size) * sizeof(*grid->cells));
+    return true;
+}
+
+void sudoku_grid_copy(sudoku_grid_t *dst, const sudoku_grid_t *src) {
+    dst->order = src->order;
+    dst->size = src->size;
+    memcpy(dst->cells, src->cells, (size_t)(src->size * src->size) * sizeof(*src->cells));
+}
+
+void sudoku_grid_from_rows(sudoku_grid_t *grid, const int rows[9][9]) {
+    grid->order = 3;
+    grid->size = 9;
+    memcpy(grid->cells, rows, SUDOKU_PUZZLE_LEN * sizeof(*grid->cells));
+}
+
+bool sudoku_grid_consistent(const sudoku_grid_t *grid) {
+    uint64_t rows[SUDOKU_MAX_SIZE] = {0};
+    uint64_t cols[SUDOKU_MAX_SIZE] = {0};
+    uint64_t boxes[SUDOKU_MAX_SIZE] = {0};
+
+    for (int cell = 0; cell < grid->size * grid->size; cell++) {
+        int value = grid->cells[cell];
+        if (value == 0) {
+            continue;
+        }
+        if (value < 0 || value > grid->size) {
+            return false;
+        }
+        int row = cell / grid->size;
+        int col = cell % grid->size;
+        int box = sudoku_grid_box(grid, row, col);
+        uint64_t bit = 1ull << (value - 1);
+        if ((rows[row] | cols[col] | boxes[box]) & bit) {
+            return false;
+        }
+        rows[row] |= bit;
+        cols[col] |= bit;
+        boxes[box] |= bit;
+    }
+    return true;
+}
+
+bool sudoku_givens_consistent(const int grid[9][9]) {
+    sudoku_grid_t decoded;
+    sudoku_grid_from_rows(&decoded, grid);
+    return sudoku_grid_consistent(&decoded);
+}
+
+void sudoku_format_line(const int grid[9][9], char *line) {
+    for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+        line[cell] = (char)('0' + grid[cell / 9][cell % 9]);
+    }
+}
+
+// Line-format symbol of a value, '0' for empty cells
+static char symbol_for(int value) {
+    return (char)(value < 10 ? '0' + value : 'A' + value - 10);
+}
+
+static int value_for(char ch) {
+    if (ch == '.') {
+        return 0;
+    }
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    ch = (char)toupper((unsigned char)ch);
+    if (ch >= 'A' && ch <= 'Z') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+size_t sudoku_format_grid(const sudoku_grid_t *grid, char *out, size_t len) {
+    bool symbols = grid->size <= SUDOKU_MAX_SYMBOL;
+    size_t pos = 0;
+
+    for (int cell = 0; cell < grid->size * grid->size; cell++) {
+        char text[4];
+        int n = 1;
+        if (symbols) {
+            text[0] = symbol_for(grid->cells[cell]);
+        } else {
+            n = snprintf(text, sizeof(text), cell > 0 ? " %d" : "%d", grid->cells[cell]);
+        }
+        for (int i = 0; i < n; i++, pos++) {
+            if (pos + 1 < len) {
+                out[pos] = text[i];
+            }
+        }
+    }
+    if (len > 0) {
+        out[pos < len ? pos : len - 1] = '\0';
+    }
+    return pos;
+}
+
+static sudoku_parse_status_t check_givens(const sudoku_grid_t *grid) {
+    return sudoku_grid_consistent(grid) ? SUDOKU_PARSE_OK : SUDOKU_PARSE_DUPLICATE;
+}
+
+static bool is_separator(char ch) {
+    return ch == ',' || isspace((unsigned char)ch);
+}
+
+// Order whose grid has the given number of cells, 0 if none
+static int order_for_cells(size_t cells, int max_order) {
+    for (int order = SUDOKU_MIN_ORDER; order <= max_order; order++) {
+        if ((size_t)(order * order * order * order) == cells) {
+            return order;
+        }
+    }
+    return 0;
+}
+
+// Decimal number of at most two digits (SUDOKU_MAX_SIZE is 36)
+static int parse_number(const char *text, size_t len) {
+    if (len == 0 || len > 2) {
+        return -1;
+    }
+    int value = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+static sudoku_parse_status_t parse_symbols(const char *data, size_t len, sudoku_grid_t *grid) {
+    if (len == SUDOKU_PUZZLE_LEN) {
+        sudoku_grid_init(grid, 3);
+        return sudoku_parse_line(data, sudoku_grid_rows(grid));
+    }
+    if (!sudoku_grid_init(grid, order_for_cells(len, 5))) {
+        return SUDOKU_PARSE_BAD_LENGTH;
+    }
+    for (size_t cell = 0; cell < len; cell++) {
+        int value = value_for(data[cell]);
+        if (value < 0 || value > grid->size) {
+            return SUDOKU_PARSE_BAD_CHAR;
+        }
+        grid->cells[cell] = value;
+    }
+    return check_givens(grid);
+}
+
+static sudoku_parse_status_t parse_tokens(const char *data, size_t len, sudoku_grid_t *grid) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!is_separator(data[i]) && (i == 0 || is_separator(data[i - 1]))) {
+            count++;
+        }
+    }
+    if (!sudoku_grid_init(grid, order_for_cells(count, SUDOKU_MAX_ORDER))) {
+        return SUDOKU_PARSE_BAD_LENGTH;
+    }
+
+    int cell = 0;
+    size_t i = 0;
+    while (i < len) {
+        if (is_separator(data[i])) {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < len && !is_separator(data[i])) {
+            i++;
+        }
+        int value = parse_number(data + start, i - start);
+        if (value < 0 || value > grid->size) {
+            return SUDOKU_PARSE_BAD_CHAR;
+        }
+        grid->cells[cell++] = value;
+    }
+    return check_givens(grid);
+}
+
+static sudoku_parse_status_t parse_text(const char *data, size_t len, sudoku_grid_t *grid) {
+    for (size_t i = 0; i < len; i++) {
+        if (is_separator(data[i])) {
+            return parse_tokens(data, len, grid);
+        }
+    }
+    return parse_symbols(data, len, grid);
+}
+
+// Reads a JSON array of size rows of size cells; the order follows from
+// the length of the first row
+static sudoku_parse_status_t parse_json_rows(struct mg_str rows, sudoku_grid_t *grid) {
+    struct mg_str key;
+    struct mg_str row;
+    struct mg_str value;
+    size_t row_ofs = 0;
+    int r = 0;
+
+    while ((row_ofs = mg_json_next(rows, row_ofs, &key, &row)) > 0) {
+        if (row.len == 0 || row.buf[0] != '[') {
+            return SUDOKU_PARSE_BAD_JSON;
+        }
+        if (r == 0) {
+            size_t length = 0;
+            for (size_t ofs = 0; (ofs = mg_json_next(row, ofs, &key, &value)) > 0;) {
+                length++;
+            }
+            if (!sudoku_grid_init(grid, order_for_cells(length * length, SUDOKU_MAX_ORDER))) {
+                return SUDOKU_PARSE_BAD_LENGTH;
+            }
+        }
+        if (r >= grid->size) {
+            return SUDOKU_PARSE_BAD_LENGTH;
+        }
+
+        size_t cell_ofs = 0;
+        int c = 0;
+        while ((cell_ofs = mg_json_next(row, cell_ofs, &key, &value)) > 0) {
+            if (c >= grid->size) {
+                return SUDOKU_PARSE_BAD_LENGTH;
+            }
+            int number = 0;
+            if (!(value.len == 4 && memcmp(value.buf, "null", 4) == 0)) {
+                number = parse_number(value.buf, value.len);
+                if (number < 0 || number > grid->size) {
+                    return SUDOKU_PARSE_BAD_CHAR;
+                }
+            }
+            grid->cells[r * grid->size + c] = number;
+            c++;
+        }
+        if (c != grid->size) {
+            return SUDOKU_PARSE_BAD_LENGTH;
+        }
+        r++;
+    }
+    if (r == 0 || r != grid->size) {
+        return SUDOKU_PARSE_BAD_LENGTH;
+    }
+    return check_givens(grid);
+}
+
+static sudoku_parse_status_t parse_json(const char *data, size_t len, sudoku_grid_t *grid) {
+    struct mg_str json = mg_str_n(data, len);
+    int toklen = 0;
+    int offset = 0;
+
+    if (data[0] == '{') {
+        offset = mg_json_get(json, "$.grid", &toklen);
+        if (offset < 0) {
+            return SUDOKU_PARSE_BAD_JSON;
+        }
+        // "grid" given as a string in line or token format
+        if (data[offset] == '"') {
+            if (toklen < 2) {
+                return SUDOKU_PARSE_BAD_JSON;
+            }
+            return parse_text(data + offset + 1, (size_t)toklen - 2, grid);
+        }
+    } else {
+        offset = mg_json_get(json, "$", &toklen);
+    }
+    if (offset < 0 || data[offset] != '[') {
+        return SUDOKU_PARSE_BAD_JSON;
+    }
+    return parse_json_rows(mg_str_n(data + offset, (size_t)toklen), grid);
+}
+
+sudoku_parse_status_t sudoku_parse_grid(const char *data, sudoku_grid_t *grid) {
+    if (!data) {
+        return SUDOKU_PARSE_EMPTY;
+    }
+
+    // Trim surrounding whitespace (trailing newlines from files and clients)
+    size_t len = strlen(data);
+    while (len > 0 && isspace((unsigned char)*data)) {
+        data++;
+        len--;
+    }
+    while (len > 0 && isspace((unsigned char)data[len - 1])) {
+        len--;
+    }
+    if (len == 0) {
+        return SUDOKU_PARSE_EMPTY;
+    }
+
+    if (data[0] == '{' || data[0] == '[') {
+        return parse_json(data, len, grid);
+    }
+    return parse_text(data, len, grid);
+}
+
+sudoku_parse_status_t sudoku_parse(const char *data, int grid[9][9]) {
+    sudoku_grid_t parsed;
+    sudoku_parse_status_t status = sudoku_parse_grid(data, &parsed);
+    if (status != SUDOKU_PARSE_OK) {
+        return status;
+    }
+    if (parsed.order != 3) {
+        return SUDOKU_PARSE_BAD_LENGTH;
+    }
+    memcpy(grid, parsed.cells, SUDOKU_PUZZLE_LEN * sizeof(parsed.cells[0]));
+    return SUDOKU_PARSE_OK;
+}
+
+const char *sudoku_parse_error(sudoku_parse_status_t status) {
+    switch (status) {
+        case SUDOKU_PARSE_OK:
+            return "OK";
+        case SUDOKU_PARSE_EMPTY:
+            return "No puzzle data provided";
+        case SUDOKU_PARSE_BAD_LENGTH:
+            return "Puzzle must have n^4 cells for a box order n (81 for 9x9)";
+        case SUDOKU_PARSE_BAD_CHAR:
+            return "Puzzle cells must be digits 0-9 or '.' (A-Z or numbers above 9 for larger orders)";
+        case SUDOKU_PARSE_BAD_JSON:
+            return "Malformed JSON puzzle";
+        case SUDOKU_PARSE_DUPLICATE:
+            return "Puzzle has duplicate givens in a row, column or box";
+    }
+    return "Unknown parse error";
+}
@@ -0,0 +1,106 @@
+#include <pthread.h>
+#include <string.h>
+#include "problems/sudoku/sudoku_portfolio.h"
+
+#define EVENTHDLR_NAME "sudoku_cancel"
+#define EVENTHDLR_DESC "interrupts the solve once a portfolio race is lost"
+#define EVENTHDLR_EVENTS (SCIP_EVENTTYPE_NODESOLVED | SCIP_EVENTTYPE_LPSOLVED)
+
+struct SCIP_EventhdlrData {
+    atomic_bool *cancel;
+};
+
+static const char *class_names[SUDOKU_CLASS_COUNT] = {"sparse", "typical", "dense"};
+
+static sudoku_portfolio_stats_t portfolio_stats;
+static pthread_mutex_t portfolio_lock = PTHREAD_MUTEX_INITIALIZER;
+
+sudoku_puzzle_class_t sudoku_puzzle_class(const int puzzle[9][9]) {
+    int givens = 0;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            givens += puzzle[i][j] != 0;
+        }
+    }
+    if (givens <= 24) {
+        return SUDOKU_CLASS_SPARSE;
+    }
+    return givens <= 30 ? SUDOKU_CLASS_TYPICAL : SUDOKU_CLASS_DENSE;
+}
+
+const char *sudoku_puzzle_class_name(sudoku_puzzle_class_t puzzle_class) {
+    return puzzle_class < SUDOKU_CLASS_COUNT ? class_names[puzzle_class] : "unknown";
+}
+
+void sudoku_portfolio_record(sudoku_puzzle_class_t puzzle_class, bool native_won, double seconds) {
+    if (puzzle_class >= SUDOKU_CLASS_COUNT) {
+        return;
+    }
+    pthread_mutex_lock(&portfolio_lock);
+    sudoku_portfolio_class_stats_t *stats = &portfolio_stats.classes[puzzle_class];
+    stats->races++;
+    if (native_won) {
+        stats->native_wins++;
+    } else {
+        stats->scip_wins++;
+    }
+    stats->seconds += seconds;
+    if (seconds > stats->max_seconds) {
+        stats->max_seconds = seconds;
+    }
+    pthread_mutex_unlock(&portfolio_lock);
+}
+
+void sudoku_portfolio_get_stats(sudoku_portfolio_stats_t *stats) {
+    pthread_mutex_lock(&portfolio_lock);
+    *stats = portfolio_stats;
+    pthread_mutex_unlock(&portfolio_lock);
+}
+
+void sudoku_portfolio_reset_stats(void) {
+    pthread_mutex_lock(&portfolio_lock);
+    memset(&portfolio_stats, 0, sizeof(portfolio_stats));
+    pthread_mutex_unlock(&portfolio_lock);
+}
+
+// SCIP is not thread-safe, so the other engine only raises the flag and
+// the interrupt is issued here, on the thread running SCIPsolve()
+static SCIP_DECL_EVENTEXEC(cancel_exec) {
+    (void)event;
+    (void)eventdata;
+    SCIP_EVENTHDLRDATA* data = SCIPeventhdlrGetData(eventhdlr);
+    if (atomic_load_explicit(data->cancel, memory_order_relaxed) && !SCIPisStopped(scip)) {
+        SCIP_CALL(SCIPinterruptSolve(scip));
+    }
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTINITSOL(cancel_initsol) {
+    SCIP_CALL(SCIPcatchEvent(scip, EVENTHDLR_EVENTS, eventhdlr, NULL, NULL));
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXITSOL(cancel_exitsol) {
+    SCIP_CALL(SCIPdropEvent(scip, EVENTHDLR_EVENTS, eventhdlr, NULL, -1));
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTFREE(cancel_free) {
+    SCIP_EVENTHDLRDATA* data = SCIPeventhdlrGetData(eventhdlr);
+    SCIPfreeBlockMemory(scip, &data);
+    SCIPeventhdlrSetData(eventhdlr, NULL);
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE sudoku_include_cancel_eventhdlr(SCIP *scip, atomic_bool *cancel) {
+    SCIP_EVENTHDLRDATA* data = NULL;
+    SCIP_CALL(SCIPallocBlockMemory(scip, &data));
+    data->cancel = cancel;
+
+    SCIP_EVENTHDLR* eventhdlr = NULL;
+    SCIP_CALL(SCIPincludeEventhdlrBasic(scip, &eventhdlr, EVENTHDLR_NAME, EVENTHDLR_DESC, cancel_exec, data));
+    SCIP_CALL(SCIPsetEventhdlrInitsol(scip, eventhdlr, cancel_initsol));
+    SCIP_CALL(SCIPsetEventhdlrExitsol(scip, eventhdlr, cancel_exitsol));
+    SCIP_CALL(SCIPsetEventhdlrFree(scip, eventhdlr, cancel_free));
+    return SCIP_OKAY;
+}
@@ -0,0 +1,502 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "problems/sudoku/sudoku_propagation.h"
+#include "sudoku_budget.h"
+
+#define ALL_DIGITS 0x1FFu
+
+// Search state, copied on every branch (~110 bytes)
+typedef struct {
+    uint8_t cells[81];
+    uint16_t row_used[9];
+    uint16_t col_used[9];
+    uint16_t box_used[9];
+    int empty;
+} native_state_t;
+
+typedef struct {
+    sudoku_budget_t budget;
+    sudoku_native_stats_t stats;
+    const int (*guide)[9];  // Digit tried first per cell, NULL for plain order
+
+    // Counting mode: solutions is shared by all workers of one count
+    int cap;
+    atomic_int *solutions;
+    uint8_t first[81];
+    bool has_first;
+} native_search_t;
+
+static inline int box_of(int row, int col) {
+    return (row / 3) * 3 + col / 3;
+}
+
+static inline int unit_cell(int unit, int k) {
+    // Units 0-8 are rows, 9-17 columns, 18-26 boxes
+    if (unit < 9) {
+        return unit * 9 + k;
+    }
+    if (unit < 18) {
+        return k * 9 + (unit - 9);
+    }
+    int box = unit - 18;
+    return ((box / 3) * 3 + k / 3) * 9 + (box % 3) * 3 + k % 3;
+}
+
+static inline uint16_t candidates(const native_state_t *state, int cell) {
+    int row = cell / 9;
+    int col = cell % 9;
+    return (uint16_t)(~(state->row_used[row] | state->col_used[col] | state->box_used[box_of(row, col)]) & ALL_DIGITS);
+}
+
+static inline int digit_of(uint16_t mask) {
+    return __builtin_ctz(mask) + 1;
+}
+
+static bool place(native_state_t *state, int cell, int digit) {
+    int row = cell / 9;
+    int col = cell % 9;
+    int box = box_of(row, col);
+    uint16_t bit = (uint16_t)(1u << (digit - 1));
+
+    if ((state->row_used[row] | state->col_used[col] | state->box_used[box]) & bit) {
+        return false;
+    }
+    state->cells[cell] = (uint8_t)digit;
+    state->row_used[row] |= bit;
+    state->col_used[col] |= bit;
+    state->box_used[box] |= bit;
+    state->empty--;
+    return true;
+}
+
+// Applies naked and hidden singles until a fixpoint. Returns false on a
+// contradiction (a cell without candidates or a digit without a place).
+static bool propagate(native_state_t *state, native_search_t *search) {
+    bool changed = true;
+
+    while (changed && state->empty > 0) {
+        changed = false;
+
+        // Naked singles: cells with exactly one candidate
+        for (int cell = 0; cell < 81; cell++) {
+            if (state->cells[cell]) {
+                continue;
+            }
+            uint16_t mask = candidates(state, cell);
+            if (mask == 0) {
+                return false;
+            }
+            if ((mask & (mask - 1)) == 0) {
+                place(state, cell, digit_of(mask));
+                search->stats.placements++;
+                changed = true;
+            }
+        }
+
+        // Hidden singles: digits with exactly one possible cell in a unit
+        for (int unit = 0; unit < 27; unit++) {
+            uint16_t seen_once = 0;
+            uint16_t seen_twice = 0;
+            uint16_t placed = 0;
+
+            for (int k = 0; k < 9; k++) {
+                int cell = unit_cell(unit, k);
+                if (state->cells[cell]) {
+                    placed |= (uint16_t)(1u << (state->cells[cell] - 1));
+                    continue;
+                }
+                uint16_t mask = candidates(state, cell);
+                seen_twice |= seen_once & mask;
+                seen_once |= mask;
+            }
+
+            if ((seen_once | placed) != ALL_DIGITS) {
+                return false;
+            }
+
+            uint16_t hidden = seen_once & (uint16_t)~seen_twice;
+            while (hidden) {
+                uint16_t bit = hidden & (uint16_t)-hidden;
+                hidden &= (uint16_t)(hidden - 1);
+                for (int k = 0; k < 9; k++) {
+                    int cell = unit_cell(unit, k);
+                    if (!state->cells[cell] && (candidates(state, cell) & bit)) {
+                        if (!place(state, cell, digit_of(bit))) {
+                            return false;
+                        }
+                        search->stats.placements++;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// The empty cell with the fewest candidates (state must not be solved)
+static int branch_cell(const native_state_t *state) {
+    int best_cell = -1;
+    int best_count = 10;
+    for (int cell = 0; cell < 81 && best_count > 2; cell++) {
+        if (state->cells[cell]) {
+            continue;
+        }
+        int count = __builtin_popcount(candidates(state, cell));
+        if (count < best_count) {
+            best_count = count;
+            best_cell = cell;
+        }
+    }
+    return best_cell;
+}
+
+static bool search_state(native_state_t *state, native_search_t *search) {
+    if (!propagate(state, search)) {
+        return false;
+    }
+    if (state->empty == 0) {
+        return true;
+    }
+
+    int best_cell = branch_cell(state);
+    uint16_t mask = candidates(state, best_cell);
+    // The guide digit first, when it is still a candidate
+    int preferred = search->guide ? search->guide[best_cell / 9][best_cell % 9] : 0;
+    uint16_t first = preferred > 0 && preferred <= 9 ? mask & (uint16_t)(1u << (preferred - 1)) : 0;
+    while (mask) {
+        uint16_t bit = first ? first : mask & (uint16_t)-mask;
+        mask &= (uint16_t)~bit;
+        first = 0;
+
+        if (sudoku_budget_exhausted(&search->budget, search->stats.nodes)) {
+            return false;
+        }
+        search->stats.nodes++;
+
+        native_state_t child = *state;
+        place(&child, best_cell, digit_of(bit));
+        if (search_state(&child, search)) {
+            *state = child;
+            return true;
+        }
+        if (search->budget.limit_reached) {
+            return false;
+        }
+    }
+    return false;
+}
+
+static void init_search(native_search_t *search, const sudoku_native_limits_t *limits) {
+    memset(search, 0, sizeof(*search));
+    sudoku_budget_init(&search->budget, limits);
+}
+
+// Places the givens. Returns false for out-of-range or clashing values.
+static bool load_grid(native_state_t *state, const int grid[9][9]) {
+    memset(state, 0, sizeof(*state));
+    state->empty = 81;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int value = grid[i][j];
+            if (value < 0 || value > 9) {
+                return false;
+            }
+            // A given that clashes with an earlier one makes the puzzle infeasible
+            if (value > 0 && !place(state, i * 9 + j, value)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void store_grid(const uint8_t cells[81], int grid[9][9]) {
+    for (int cell = 0; cell < 81; cell++) {
+        grid[cell / 9][cell % 9] = cells[cell];
+    }
+}
+
+sudoku_native_status_t sudoku_native_solve(int grid[9][9], const sudoku_native_limits_t *limits,
+                                           sudoku_native_stats_t *stats) {
+    return sudoku_native_solve_guided(grid, NULL, limits, stats);
+}
+
+sudoku_native_status_t sudoku_native_solve_guided(int grid[9][9], const int guide[9][9],
+                                                  const sudoku_native_limits_t *limits,
+                                                  sudoku_native_stats_t *stats) {
+    native_state_t state;
+    native_search_t search;
+    init_search(&search, limits);
+    search.guide = guide;
+
+    sudoku_native_status_t status = SUDOKU_NATIVE_SOLVED;
+    if (!load_grid(&state, (const int (*)[9])grid)) {
+        status = SUDOKU_NATIVE_INFEASIBLE;
+    } else if (!search_state(&state, &search)) {
+        status = search.budget.limit_reached ? SUDOKU_NATIVE_LIMIT_REACHED : SUDOKU_NATIVE_INFEASIBLE;
+    }
+
+    if (status == SUDOKU_NATIVE_SOLVED) {
+        store_grid(state.cells, grid);
+    }
+    if (stats) {
+        *stats = search.stats;
+    }
+    return status;
+}
+
+static bool cap_reached(const native_search_t *search) {
+    return atomic_load_explicit(search->solutions, memory_order_relaxed) >= search->cap;
+}
+
+static void record_solution(const native_state_t *state, native_search_t *search) {
+    atomic_fetch_add_explicit(search->solutions, 1, memory_order_relaxed);
+    if (!search->has_first) {
+        memcpy(search->first, state->cells, sizeof(search->first));
+        search->has_first = true;
+    }
+}
+
+// Like search_state(), but keeps going after a solution until the cap
+static void count_state(native_state_t *state, native_search_t *search) {
+    if (!propagate(state, search)) {
+        return;
+    }
+    if (state->empty == 0) {
+        record_solution(state, search);
+        return;
+    }
+
+    int best_cell = branch_cell(state);
+    uint16_t mask = candidates(state, best_cell);
+    while (mask) {
+        uint16_t bit = mask & (uint16_t)-mask;
+        mask &= (uint16_t)(mask - 1);
+
+        if (cap_reached(search) || sudoku_budget_exhausted(&search->budget, search->stats.nodes)) {
+            return;
+        }
+        search->stats.nodes++;
+
+        native_state_t child = *state;
+        place(&child, best_cell, digit_of(bit));
+        count_state(&child, search);
+        if (search->budget.limit_reached) {
+            return;
+        }
+    }
+}
+
+static sudoku_native_status_t count_status(int found, int cap, bool limit_reached, int *count) {
+    *count = found < cap ? found : cap;
+    if (found >= cap) {
+        return SUDOKU_NATIVE_SOLVED;
+    }
+    if (limit_reached) {
+        return SUDOKU_NATIVE_LIMIT_REACHED;
+    }
+    return found > 0 ? SUDOKU_NATIVE_SOLVED : SUDOKU_NATIVE_INFEASIBLE;
+}
+
+sudoku_native_status_t sudoku_native_count(int grid[9][9], int cap, const sudoku_native_limits_t *limits,
+                                           sudoku_native_stats_t *stats, int *count) {
+    native_state_t state;
+    native_search_t search;
+    atomic_int solutions;
+    atomic_init(&solutions, 0);
+    init_search(&search, limits);
+    search.cap = cap > 0 ? cap : 1;
+    search.solutions = &solutions;
+
+    if (load_grid(&state, (const int (*)[9])grid)) {
+        count_state(&state, &search);
+    }
+
+    sudoku_native_status_t status = count_status(atomic_load(&solutions), search.cap, search.budget.limit_reached,
+                                                 count);
+    if (search.has_first) {
+        store_grid(search.first, grid);
+    }
+    if (stats) {
+        *stats = search.stats;
+    }
+    return status;
+}
+
+// Parallel count: the top of the tree is expanded breadth-first into
+// independent subtrees, which workers then count from a shared cursor
+
+#define SUBTREES_PER_WORKER 8
+
+typedef struct {
+    native_state_t *subtrees;
+    int count;
+    atomic_int next;
+    atomic_int solutions;
+} count_job_t;
+
+typedef struct {
+    pthread_t thread;
+    count_job_t *job;
+    native_search_t search;
+} count_worker_t;
+
+static void *count_worker(void *arg) {
+    count_worker_t *worker = arg;
+    count_job_t *job = worker->job;
+
+    for (;;) {
+        int index = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (index >= job->count || cap_reached(&worker->search) || worker->search.budget.limit_reached) {
+            break;
+        }
+        count_state(&job->subtrees[index], &worker->search);
+    }
+    return NULL;
+}
+
+// Expands the frontier until it holds at least target open subtrees.
+// Solved children are recorded right away and dead ones dropped.
+static int expand_frontier(count_job_t *job, int capacity, int target, native_search_t *search) {
+    int head = 0;
+    int tail = job->count;
+
+    while (tail - head > 0 && tail - head < target && !cap_reached(search)) {
+        native_state_t state = job->subtrees[head++];
+        int best_cell = branch_cell(&state);
+        uint16_t mask = candidates(&state, best_cell);
+        if (tail + __builtin_popcount(mask) > capacity) {
+            head--;
+            break;
+        }
+        while (mask) {
+            uint16_t bit = mask & (uint16_t)-mask;
+            mask &= (uint16_t)(mask - 1);
+            search->stats.nodes++;
+
+            native_state_t child = state;
+            place(&child, best_cell, digit_of(bit));
+            if (!propagate(&child, search)) {
+                continue;
+            }
+            if (child.empty == 0) {
+                record_solution(&child, search);
+                continue;
+            }
+            job->subtrees[tail++] = child;
+        }
+    }
+
+    memmove(job->subtrees, job->subtrees + head, (size_t)(tail - head) * sizeof(*job->subtrees));
+    return tail - head;
+}
+
+sudoku_native_status_t sudoku_native_count_parallel(int grid[9][9], int cap, int threads,
+                                                    const sudoku_native_limits_t *limits,
+                                                    sudoku_native_stats_t *stats, int *count) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads == 1) {
+        return sudoku_native_count(grid, cap, limits, stats, count);
+    }
+
+    int capacity = threads * SUBTREES_PER_WORKER + 9;
+    count_job_t job;
+    job.subtrees = malloc((size_t)capacity * sizeof(*job.subtrees));
+    if (!job.subtrees) {
+        return sudoku_native_count(grid, cap, limits, stats, count);
+    }
+    job.count = 0;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.solutions, 0);
+
+    native_search_t root;
+    init_search(&root, limits);
+    root.cap = cap > 0 ? cap : 1;
+    root.solutions = &job.solutions;
+
+    native_state_t *state = &job.subtrees[0];
+    if (load_grid(state, (const int (*)[9])grid) && propagate(state, &root)) {
+        if (state->empty == 0) {
+            record_solution(state, &root);
+        } else {
+            job.count = 1;
+            job.count = expand_frontier(&job, capacity, threads * SUBTREES_PER_WORKER, &root);
+        }
+    }
+
+    // Workers share the deadline of the root and split its node budget
+    sudoku_native_stats_t totals = root.stats;
+    bool limit_reached = false;
+    bool has_first = root.has_first;
+    uint8_t first[81];
+    memcpy(first, root.first, sizeof(first));
+
+    if (job.count > 0) {
+        if (threads > job.count) {
+            threads = job.count;
+        }
+        count_worker_t *workers = calloc((size_t)threads, sizeof(*workers));
+        int started = 0;
+        for (; workers && started < threads; started++) {
+            count_worker_t *worker = &workers[started];
+            worker->job = &job;
+            worker->search = root;
+            memset(&worker->search.stats, 0, sizeof(worker->search.stats));
+            worker->search.has_first = false;
+            if (root.budget.node_limit > 0) {
+                long share = root.budget.node_limit / threads;
+                worker->search.budget.node_limit = share > 0 ? share : 1;
+            }
+            if (pthread_create(&worker->thread, NULL, count_worker, worker) != 0) {
+                break;
+            }
+        }
+        if (started == 0) {
+            // No threads available, count the subtrees on this one
+            count_worker_t worker = {.job = &job, .search = root};
+            count_worker(&worker);
+            totals.nodes += worker.search.stats.nodes;
+            totals.placements += worker.search.stats.placements;
+            limit_reached = worker.search.budget.limit_reached;
+            if (!has_first && worker.search.has_first) {
+                memcpy(first, worker.search.first, sizeof(first));
+                has_first = true;
+            }
+        }
+        for (int t = 0; t < started; t++) {
+            pthread_join(workers[t].thread, NULL);
+            native_search_t *search = &workers[t].search;
+            totals.nodes += search->stats.nodes;
+            totals.placements += search->stats.placements;
+            limit_reached = limit_reached || search->budget.limit_reached;
+            if (!has_first && search->has_first) {
+                memcpy(first, search->first, sizeof(first));
+                has_first = true;
+            }
+        }
+        free(workers);
+    }
+
+    // Subtrees never handed out because of a budget stop leave the count open
+    bool unfinished = limit_reached || atomic_load(&job.next) < job.count;
+    sudoku_native_status_t status = count_status(atomic_load(&job.solutions), root.cap, unfinished, count);
+    if (has_first) {
+        store_grid(first, grid);
+    }
+    if (stats) {
+        *stats = totals;
+    }
+    free(job.subtrees);
+    return status;
+}
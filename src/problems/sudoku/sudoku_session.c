@@ -0,0 +1,106 @@
+#include <string.h>
+#include "problems/sudoku/sudoku_session.h"
+
+// Whether digit at (row, col) repeats a given of its row, column or box
+static bool clashes(const int givens[9][9], int row, int col, int digit) {
+    int top = (row / 3) * 3;
+    int left = (col / 3) * 3;
+    for (int k = 0; k < 9; k++) {
+        if ((k != col && givens[row][k] == digit) || (k != row && givens[k][col] == digit)) {
+            return true;
+        }
+        int r = top + k / 3;
+        int c = left + k % 3;
+        if ((r != row || c != col) && givens[r][c] == digit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static sudoku_session_status_t resolve(sudoku_session_t *session) {
+    sudoku_ctx_t *ctx = &session->ctx;
+    sudoku_grid_from_rows(&ctx->puzzle, (const int (*)[9])session->givens);
+    // Any earlier solution is a good guide, even one from before a clash
+    ctx->use_guide = session->guide_valid;
+    if (ctx->use_guide) {
+        sudoku_grid_from_rows(&ctx->guide, (const int (*)[9])session->solution);
+    }
+
+    SCIP_RETCODE retcode = solve_puzzle(ctx);
+    ctx->use_guide = false;
+    session->stats.resolved++;
+
+    if (retcode != SCIP_OKAY) {
+        session->status = SUDOKU_SESSION_ERROR;
+    } else if (ctx->has_solution) {
+        memcpy(session->solution, sudoku_grid_rows(&ctx->puzzle), sizeof(session->solution));
+        session->guide_valid = true;
+        session->status = SUDOKU_SESSION_SOLVED;
+    } else {
+        session->status = ctx->limit_reached ? SUDOKU_SESSION_ERROR : SUDOKU_SESSION_INFEASIBLE;
+    }
+    return session->status;
+}
+
+void sudoku_session_init(sudoku_session_t *session, const sudoku_options_t *options) {
+    memset(session, 0, sizeof(*session));
+    sudoku_ctx_init(&session->ctx);
+    if (options) {
+        session->ctx.options = *options;
+    }
+    session->ctx.options.solution_cap = 0;
+    session->status = SUDOKU_SESSION_ERROR;  // Nothing solved yet
+}
+
+SCIP_RETCODE sudoku_session_free(sudoku_session_t *session) {
+    SCIP_RETCODE retcode = sudoku_ctx_free(&session->ctx);
+    session->guide_valid = false;
+    session->status = SUDOKU_SESSION_ERROR;
+    return retcode;
+}
+
+sudoku_session_status_t sudoku_session_load(sudoku_session_t *session, const int puzzle[9][9]) {
+    // The whole grid is checked before any of it replaces the givens
+    for (int cell = 0; cell < 81; cell++) {
+        int digit = puzzle[cell / 9][cell % 9];
+        if (digit < 0 || digit > 9) {
+            return SUDOKU_SESSION_ERROR;
+        }
+    }
+    session->guide_valid = false;
+    memcpy(session->givens, puzzle, sizeof(session->givens));
+    for (int cell = 0; cell < 81; cell++) {
+        int digit = session->givens[cell / 9][cell % 9];
+        if (digit > 0 && clashes((const int (*)[9])session->givens, cell / 9, cell % 9, digit)) {
+            session->status = SUDOKU_SESSION_INFEASIBLE;
+            return session->status;
+        }
+    }
+    return resolve(session);
+}
+
+sudoku_session_status_t sudoku_session_set_cell(sudoku_session_t *session, int row, int col, int digit) {
+    if (row < 0 || row > 8 || col < 0 || col > 8 || digit < 0 || digit > 9) {
+        return SUDOKU_SESSION_ERROR;
+    }
+    session->stats.edits++;
+    int previous = session->givens[row][col];
+    session->givens[row][col] = digit;
+
+    // Cases the last answer still settles
+    bool unchanged = digit == previous && session->status != SUDOKU_SESSION_ERROR;
+    bool still_solved = session->status == SUDOKU_SESSION_SOLVED
+        && (digit == 0 || session->solution[row][col] == digit);
+    bool still_infeasible = session->status == SUDOKU_SESSION_INFEASIBLE && previous == 0;
+    if (unchanged || still_solved || still_infeasible) {
+        session->stats.revalidated++;
+        return session->status;
+    }
+    if (digit != 0 && clashes((const int (*)[9])session->givens, row, col, digit)) {
+        session->stats.revalidated++;
+        session->status = SUDOKU_SESSION_INFEASIBLE;
+        return session->status;
+    }
+    return resolve(session);
+}
@@ -1,39 +1,88 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <scip/scip.h>
 #include <scip/scipdefplugins.h>
 #include "problems/sudoku/sudoku_solver.h"
+#include "problems/sudoku/sudoku_cache.h"
+#include "problems/sudoku/sudoku_canonical.h"
+#include "problems/sudoku/sudoku_conshdlr.h"
+#include "problems/sudoku/sudoku_portfolio.h"
+#include "sudoku_budget.h"
 
-// Global variable definitions
-SCIP* scip = NULL;
-int puzzle[9][9];
-SCIP_VAR* vars[9][9][9] = {0};
-SCIP_CONS* row_constrs[9][9] = {0};
-SCIP_CONS* col_constrs[9][9] = {0};
-SCIP_CONS* subgrid_constrs[9][3][3] = {0};
-SCIP_CONS* fillgrid_constrs[9][9] = {0};
-SCIP_Bool infeasible = FALSE;
-SCIP_Bool fixed = FALSE;
+// Fits every model name up to SUDOKU_MAX_SIZE, "subgrid_35_5_5" the longest
+#define NAME_LEN 24
 
-bool validate_sudoku_data(const char *data, char **error_msg) {
-    // For now, we don't use the input data or error_msg as the puzzle is hardcoded
-    // This is a placeholder for future implementation where puzzle can be loaded from data
-    (void)data;     // Mark as unused
-    (void)error_msg; // Mark as unused
-    
-    // Always return true for now since we're using a hardcoded puzzle
+static bool load_sudoku_data(const char *data, sudoku_grid_t *grid, char **error_msg) {
+    // Rejects malformed input and duplicate givens before any model is built
+    sudoku_parse_status_t status = sudoku_parse_grid(data, grid);
+    if (status != SUDOKU_PARSE_OK) {
+        if (error_msg) {
+            *error_msg = strdup(sudoku_parse_error(status));
+        }
+        return false;
+    }
     return true;
 }
 
-int solve_sudoku(const char *data, char **error_msg) {
-    // Validate input data
-    if (!validate_sudoku_data(data, error_msg)) {
+bool validate_sudoku_data(const char *data, char **error_msg) {
+    sudoku_grid_t grid;
+    return load_sudoku_data(data, &grid, error_msg);
+}
+
+// Each thread keeps its own context so the model template survives between
+// calls to solve_sudoku() without being shared across threads
+static _Thread_local sudoku_ctx_t thread_ctx;
+static _Thread_local bool thread_ctx_ready = false;
+
+void sudoku_default_options(sudoku_options_t *options) {
+    options->engine = SUDOKU_ENGINE_AUTO;
+    options->formulation = SUDOKU_DEFAULT_FORMULATION;
+    options->reduced_model = false;
+    options->native_node_limit = SUDOKU_DEFAULT_NATIVE_NODE_LIMIT;
+    options->native_time_limit = SUDOKU_DEFAULT_NATIVE_TIME_LIMIT;
+    options->solution_cap = 0;
+    options->count_threads = 1;
+    options->use_cache = true;
+    options->time_limit = 0.0;
+    options->node_limit = 0;
+    options->memory_limit = 0.0;
+}
+
+void sudoku_ctx_init(sudoku_ctx_t *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+    sudoku_grid_init(&ctx->puzzle, 3);
+    sudoku_default_options(&ctx->options);
+}
+
+SCIP_RETCODE sudoku_ctx_free(sudoku_ctx_t *ctx) {
+    SCIP_RETCODE retcode = release_model(ctx);
+    sudoku_options_t options = ctx->options;
+    sudoku_ctx_init(ctx);
+    ctx->options = options;
+    return retcode;
+}
+
+// Counting and the native engines work on 9x9 grids only
+static bool needs_9x9(const sudoku_options_t *options) {
+    return options->solution_cap > 0 || options->engine == SUDOKU_ENGINE_NATIVE
+        || options->engine == SUDOKU_ENGINE_DLX;
+}
+
+// Solves the puzzle already loaded into ctx->puzzle
+static int solve_loaded_puzzle(sudoku_ctx_t *ctx, char **error_msg) {
+    if (ctx->puzzle.order != 3 && needs_9x9(&ctx->options)) {
+        if (error_msg) {
+            *error_msg = strdup("Solution counting and the native engines are only available for 9x9 puzzles");
+        }
         return EXIT_FAILURE;
     }
-    
-    // Call the existing SCIP-based solver
-    SCIP_RETCODE retcode = manage_sudoku_problem();
+
+    SCIP_RETCODE retcode = manage_sudoku_problem(ctx);
     
     if (retcode != SCIP_OKAY) {
         if (error_msg) {
@@ -41,11 +90,179 @@ int solve_sudoku(const char *data, char **error_msg) {
         }
         return EXIT_FAILURE;
     }
+
+    if (!ctx->has_solution) {
+        if (ctx->limit_reached) {
+            if (error_msg) {
+                *error_msg = strdup("Solver limit reached before a solution was found");
+            }
+            return SUDOKU_LIMIT_REACHED;
+        }
+        if (error_msg) {
+            *error_msg = strdup("Sudoku puzzle has no solution");
+        }
+        return EXIT_FAILURE;
+    }
     
     return EXIT_SUCCESS;
 }
 
-void create_puzzle() {
+int solve_sudoku_ctx(sudoku_ctx_t *ctx, const char *data, char **error_msg) {
+    // Validate and load input data
+    if (!load_sudoku_data(data, &ctx->puzzle, error_msg)) {
+        return EXIT_FAILURE;
+    }
+    ctx->from_cache = false;
+    return solve_loaded_puzzle(ctx, error_msg);
+}
+
+// solve_loaded_puzzle() on a 9x9 puzzle behind the shared solution cache,
+// keyed by canonical form: a hit maps the cached canonical solution back
+// onto the request
+static int solve_cached(sudoku_ctx_t *ctx, char **error_msg) {
+    int (*puzzle)[9] = sudoku_grid_rows(&ctx->puzzle);
+    int givens = 0;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            givens += puzzle[i][j] != 0;
+        }
+    }
+    sudoku_cache_t *cache = sudoku_solution_cache();
+    if (!cache || givens < SUDOKU_CACHE_MIN_GIVENS || givens > SUDOKU_CACHE_MAX_GIVENS) {
+        return solve_loaded_puzzle(ctx, error_msg);
+    }
+
+    int canonical[9][9];
+    sudoku_transform_t transform;
+    char key[SUDOKU_PUZZLE_LEN];
+    char cached[SUDOKU_PUZZLE_LEN];
+    sudoku_canonicalize((const int (*)[9])puzzle, canonical, &transform);
+    sudoku_format_line((const int (*)[9])canonical, key);
+
+    if (sudoku_cache_lookup(cache, key, cached)) {
+        printf("Initial puzzle:\n");
+        print_puzzle(ctx);
+        for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+            canonical[cell / 9][cell % 9] = cached[cell] - '0';
+        }
+        sudoku_transform_invert(&transform, (const int (*)[9])canonical, puzzle);
+        ctx->has_solution = true;
+        ctx->from_cache = true;
+        ctx->solved_natively = true;
+        memset(&ctx->native_stats, 0, sizeof(ctx->native_stats));
+        print_solution(ctx);
+        return EXIT_SUCCESS;
+    }
+
+    int retcode = solve_loaded_puzzle(ctx, error_msg);
+    if (retcode == EXIT_SUCCESS) {
+        sudoku_transform_apply(&transform, (const int (*)[9])puzzle, canonical);
+        sudoku_format_line((const int (*)[9])canonical, cached);
+        sudoku_cache_insert(cache, key, cached);
+    }
+    return retcode;
+}
+
+// Solves puzzle on the calling thread's context, leaving the result in
+// thread_ctx.puzzle
+static int solve_on_thread_ctx(const sudoku_grid_t *puzzle, const sudoku_options_t *options,
+                               sudoku_solve_info_t *info, char **error_msg) {
+    if (!thread_ctx_ready) {
+        sudoku_ctx_init(&thread_ctx);
+        thread_ctx_ready = true;
+    }
+    if (options) {
+        thread_ctx.options = *options;
+    } else {
+        sudoku_default_options(&thread_ctx.options);
+    }
+    sudoku_grid_copy(&thread_ctx.puzzle, puzzle);
+    thread_ctx.from_cache = false;
+    thread_ctx.limit_reached = false;  // A cache hit does not solve
+    thread_ctx.gap = 0.0;
+    thread_ctx.solution_count = 0;
+    // Counting has to see every solution, so it never takes the cache
+    bool cached = thread_ctx.options.use_cache && thread_ctx.options.solution_cap <= 0 && puzzle->order == 3;
+    int retcode = cached ? solve_cached(&thread_ctx, error_msg) : solve_loaded_puzzle(&thread_ctx, error_msg);
+    if (info) {
+        info->limit_reached = thread_ctx.limit_reached;
+        info->gap = thread_ctx.gap;
+        info->solution_count = thread_ctx.solution_count;
+    }
+    return retcode;
+}
+
+int solve_sudoku_grid(const sudoku_grid_t *puzzle, const sudoku_options_t *options, char **solution,
+                      sudoku_solve_info_t *info, char **error_msg) {
+    int retcode = solve_on_thread_ctx(puzzle, options, info, error_msg);
+    if ((retcode == EXIT_SUCCESS || retcode == SUDOKU_LIMIT_REACHED) && solution) {
+        size_t len = sudoku_format_grid(&thread_ctx.puzzle, NULL, 0);
+        *solution = malloc(len + 1);
+        if (*solution) {
+            sudoku_format_grid(&thread_ctx.puzzle, *solution, len + 1);
+        } else {
+            retcode = EXIT_FAILURE;
+        }
+    }
+    return retcode;
+}
+
+int solve_sudoku_with_options(const char *data, const sudoku_options_t *options, char *solution, char **error_msg) {
+    return solve_sudoku_with_info(data, options, solution, NULL, error_msg);
+}
+
+int solve_sudoku_with_info(const char *data, const sudoku_options_t *options, char *solution,
+                           sudoku_solve_info_t *info, char **error_msg) {
+    sudoku_grid_t puzzle;
+    if (!load_sudoku_data(data, &puzzle, error_msg)) {
+        return EXIT_FAILURE;
+    }
+    if (solution && puzzle.order != 3) {
+        if (error_msg) {
+            *error_msg = strdup("Line-format solutions need a 9x9 puzzle");
+        }
+        return EXIT_FAILURE;
+    }
+    int retcode = solve_on_thread_ctx(&puzzle, options, info, error_msg);
+    if ((retcode == EXIT_SUCCESS || retcode == SUDOKU_LIMIT_REACHED) && solution) {
+        sudoku_format_line((const int (*)[9])sudoku_grid_rows(&thread_ctx.puzzle), solution);
+        solution[SUDOKU_PUZZLE_LEN] = '\0';
+    }
+    return retcode;
+}
+
+int solve_sudoku_count(const char *data, const sudoku_options_t *options, char *solution, int *solution_count,
+                       char **error_msg) {
+    sudoku_options_t count_options;
+    if (options) {
+        count_options = *options;
+    } else {
+        sudoku_default_options(&count_options);
+    }
+    if (count_options.solution_cap <= 0) {
+        count_options.solution_cap = 2;
+    }
+
+    sudoku_solve_info_t info = {false, 0.0, 0};
+    int retcode = solve_sudoku_with_info(data, &count_options, solution, &info, error_msg);
+    if (solution_count) {
+        *solution_count = info.solution_count;
+    }
+    return retcode == EXIT_SUCCESS && info.limit_reached ? SUDOKU_LIMIT_REACHED : retcode;
+}
+
+int solve_sudoku(const char *data, char **error_msg) {
+    return solve_sudoku_with_options(data, NULL, NULL, error_msg);
+}
+
+void sudoku_thread_cleanup(void) {
+    if (thread_ctx_ready) {
+        sudoku_ctx_free(&thread_ctx);
+        thread_ctx_ready = false;
+    }
+}
+
+void create_puzzle(sudoku_ctx_t *ctx) {
     int initial[9][9] = {
         {5, 3, 0, 0, 7, 0, 0, 0, 0},
         {6, 0, 0, 1, 9, 5, 0, 0, 0},
@@ -58,51 +275,100 @@ void create_puzzle() {
         {0, 0, 0, 0, 8, 0, 0, 7, 9}
     };
     
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            puzzle[i][j] = initial[i][j];
-        }
-    }
+    sudoku_grid_from_rows(&ctx->puzzle, (const int (*)[9])initial);
 }
 
-void print_puzzle() {
-    for (int i = 0; i < 9; i++) {
-        if (i > 0 && i % 3 == 0) {
-            printf("------+-------+------\n");
+void print_puzzle(sudoku_ctx_t *ctx) {
+    const sudoku_grid_t *grid = &ctx->puzzle;
+    int width = grid->size < 10 ? 1 : 2;
+    for (int i = 0; i < grid->size; i++) {
+        if (i > 0 && i % grid->order == 0) {
+            // "------+-------+------" for 9x9, '+' under every '|'
+            for (int b = 0; b < grid->order; b++) {
+                int dashes = grid->order * (width + 1) + (b > 0 && b < grid->order - 1);
+                printf("%s%.*s", b > 0 ? "+" : "", dashes, "--------------------------------");
+            }
+            printf("\n");
         }
-        for (int j = 0; j < 9; j++) {
-            if (j > 0 && j % 3 == 0) {
+        for (int j = 0; j < grid->size; j++) {
+            if (j > 0 && j % grid->order == 0) {
                 printf("| ");
             }
-            printf("%d ", puzzle[i][j]);
+            printf("%*d ", width, grid->cells[i * grid->size + j]);
         }
         printf("\n");
     }
 }
 
-void print_solution() {
+void print_solution(sudoku_ctx_t *ctx) {
     printf("\nSolution:\n");
-    print_puzzle();
+    print_puzzle(ctx);
+}
+
+// Variables of one cell, one per digit
+static inline SCIP_VAR** cell_vars(sudoku_ctx_t *ctx, int row, int col) {
+    return &ctx->vars[(row * ctx->model_size + col) * ctx->model_size];
 }
 
-SCIP_RETCODE init_model() {    
-    SCIP_CALL(SCIPcreate(&scip));
-    SCIP_CALL(SCIPincludeDefaultPlugins(scip));
-    SCIP_CALL(SCIPcreateProbBasic(scip, "test"));
-    SCIP_CALL(SCIPsetObjsense(scip, SCIP_OBJSENSE_MAXIMIZE));
-    SCIP_CALL(SCIPsetIntParam(scip, "display/verblevel", 0));
+// Grid cell (row * size + col) of the k-th cell of unit u: rows, columns,
+// then boxes row-major
+static int unit_cell(int order, int u, int k) {
+    int size = order * order;
+    int a = u % size;
+    switch (u / size) {
+        case 0:
+            return a * size + k;
+        case 1:
+            return k * size + a;
+        default:
+            return (order * (a / order) + k / order) * size + order * (a % order) + k % order;
+    }
+}
+
+// The all-different handler is 9x9 only, other orders use setppc for it
+static sudoku_formulation_t formulation_for(const sudoku_ctx_t *ctx) {
+    if (ctx->options.formulation == SUDOKU_FORMULATION_ALLDIFF && ctx->puzzle.order != 3) {
+        return SUDOKU_FORMULATION_SETPPC;
+    }
+    return ctx->options.formulation;
+}
+
+SCIP_RETCODE init_model(sudoku_ctx_t *ctx) {    
+    int size = ctx->puzzle.size;
+    size_t units = (size_t)(size * size);
+    ctx->model_order = ctx->puzzle.order;
+    ctx->model_size = size;
+    ctx->vars = calloc(units * (size_t)size, sizeof(*ctx->vars));
+    ctx->row_constrs = calloc(units, sizeof(*ctx->row_constrs));
+    ctx->col_constrs = calloc(units, sizeof(*ctx->col_constrs));
+    ctx->subgrid_constrs = calloc(units, sizeof(*ctx->subgrid_constrs));
+    ctx->fillgrid_constrs = calloc(units, sizeof(*ctx->fillgrid_constrs));
+    ctx->alldiff_constrs = calloc(3 * (size_t)size, sizeof(*ctx->alldiff_constrs));
+    ctx->applied_givens = calloc(units, sizeof(*ctx->applied_givens));
+    if (!ctx->vars || !ctx->row_constrs || !ctx->col_constrs || !ctx->subgrid_constrs ||
+        !ctx->fillgrid_constrs || !ctx->alldiff_constrs || !ctx->applied_givens) {
+        return SCIP_NOMEMORY;
+    }
+
+    SCIP_CALL(SCIPcreate(&ctx->scip));
+    SCIP_CALL(SCIPincludeDefaultPlugins(ctx->scip));
+    SCIP_CALL(sudoku_include_alldiff_conshdlr(ctx->scip));
+    SCIP_CALL(sudoku_include_cancel_eventhdlr(ctx->scip, &ctx->scip_cancel));
+    SCIP_CALL(SCIPcreateProbBasic(ctx->scip, "test"));
+    SCIP_CALL(SCIPsetObjsense(ctx->scip, SCIP_OBJSENSE_MAXIMIZE));
+    SCIP_CALL(SCIPsetIntParam(ctx->scip, "display/verblevel", 0));
     
     return SCIP_OKAY;
 }
 
-SCIP_RETCODE add_variables() {
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            for(int k = 0; k < 9; k++) {
+SCIP_RETCODE add_variables(sudoku_ctx_t *ctx) {
+    int size = ctx->model_size;
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            for(int k = 0; k < size; k++) {
                 SCIP_VAR* var = NULL;
                 
-                // buffer sized for "9-9-9\0"
-                char name[6];
+                char name[NAME_LEN];
                 int needed = snprintf(NULL, 0, "%d-%d-%d", i, j, k);
                 if (needed >= (int)sizeof(name)) {
                     fprintf(stderr, "Error: name buffer too small for i=%d, j=%d, k=%d\n", i, j, k);
@@ -110,9 +376,10 @@ SCIP_RETCODE add_variables() {
                 }
 
                 snprintf(name, sizeof(name), "%d-%d-%d", i, j, k);
-                SCIP_CALL(SCIPcreateVarBasic(scip, &var, name, 0.0, 1.0, 0.0, SCIP_VARTYPE_BINARY));
-                SCIP_CALL(SCIPaddVar(scip, var));
-                vars[i][j][k] = var;
+                SCIP_CALL(SCIPcreateVarBasic(ctx->scip, &var, name, 0.0, 1.0, 0.0, SCIP_VARTYPE_BINARY));
+                SCIP_CALL(SCIPaddVar(ctx->scip, var));
+                cell_vars(ctx, i, j)[k] = var;
+                ctx->model_vars++;
                 #ifdef DEBUG
                     printf("Variable %s added\n", name);
                 #endif
@@ -122,16 +389,98 @@ SCIP_RETCODE add_variables() {
     return SCIP_OKAY;
 }
 
-SCIP_RETCODE create_constraints() {
+// Creates "exactly one of these binaries" (at most size) in the configured
+// formulation. Both variants pass the whole variable array at creation time.
+// The all-different formulation keeps setppc for what is left per cell.
+static SCIP_RETCODE create_unit_constraint(sudoku_ctx_t *ctx, SCIP_CONS** cons, const char* name, SCIP_VAR** unit, int nvars) {
+    if (ctx->model_formulation != SUDOKU_FORMULATION_LINEAR) {
+        SCIP_CALL(SCIPcreateConsBasicSetpart(ctx->scip, cons, name, nvars, unit));
+    } else {
+        SCIP_Real ones[SUDOKU_MAX_SIZE];
+        for(int n = 0; n < nvars; n++) {
+            ones[n] = 1.0;
+        }
+        SCIP_CALL(SCIPcreateConsBasicLinear(ctx->scip, cons, name, nvars, unit, ones, 1.0, 1.0));
+    }
+    ctx->model_conss++;
+    return SCIP_OKAY;
+}
+
+// One all-different constraint per row, column and box (9x9 only). With
+// givens_only set (reduced model) given cells have no variables and are
+// passed as givens, and units made up of givens only are left out.
+static SCIP_RETCODE create_alldiff_constraints(sudoku_ctx_t *ctx, SCIP_Bool givens_only) {
+    static const char* kinds[3] = {"row", "col", "box"};
+
+    for(int u = 0; u < 27; u++) {
+        int a = u % 9;
+        SCIP_VAR* unit[9][9];
+        int givens[9];
+        int open = 0;
+        for(int n = 0; n < 9; n++) {
+            int cell = unit_cell(3, u, n);
+            memcpy(unit[n], cell_vars(ctx, cell / 9, cell % 9), sizeof(unit[n]));
+            givens[n] = givens_only ? ctx->puzzle.cells[cell] : 0;
+            open += givens[n] == 0;
+        }
+        if(open == 0) {
+            continue;
+        }
 
-    // Add row constraints - each number 1-9 appears exactly once per row
+        char name[NAME_LEN];  // "alldiff_row_8\0"
+        snprintf(name, sizeof(name), "alldiff_%s_%d", kinds[u / 9], a);
+        SCIP_CONS* cons = NULL;
+        SCIP_CALL(sudoku_create_alldiff_cons(ctx->scip, &cons, name, unit, givens_only ? givens : NULL));
+        SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+        ctx->alldiff_constrs[u] = cons;
+        ctx->model_conss++;
+    }
+    return SCIP_OKAY;
+}
+
+// Ensure that the complete puzzle grid is filled with one number per cell
+static SCIP_RETCODE create_fillgrid_constraints(sudoku_ctx_t *ctx) {
+    int size = ctx->model_size;
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            SCIP_CONS* cons = NULL;
+            
+            // Create constraint name "fillgrid_i_j"
+            char const_name[NAME_LEN];
+            int needed = snprintf(NULL, 0, "fillgrid_%d_%d", i, j);
+            if(needed >= (int)sizeof(const_name)) {
+                fprintf(stderr, "Error: const_name buffer too small for i=%d, j=%d\n", i, j);
+                return SCIP_ERROR;
+            }
+            snprintf(const_name, sizeof(const_name), "fillgrid_%d_%d", i, j);
+            
+            // Create constraint: sum(x_ijk over all digits k) = 1 for this cell
+            SCIP_CALL(create_unit_constraint(ctx, &cons, const_name, cell_vars(ctx, i, j), size));
+            SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+            ctx->fillgrid_constrs[i * size + j] = cons;  // Store the constraint
+        }
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE create_constraints(sudoku_ctx_t *ctx) {
+    int order = ctx->model_order;
+    int size = ctx->model_size;
+
+    // Rows, columns and subgrids go to the all-different handler instead
+    if (ctx->model_formulation == SUDOKU_FORMULATION_ALLDIFF) {
+        SCIP_CALL(create_alldiff_constraints(ctx, FALSE));
+        return create_fillgrid_constraints(ctx);
+    }
+
+    // Add row constraints - each digit appears exactly once per row
     
-    for(int i = 0; i < 9; i++) {
-        for(int k = 0; k < 9; k++) {
+    for(int i = 0; i < size; i++) {
+        for(int k = 0; k < size; k++) {
             SCIP_CONS* cons = NULL;
             
             // Create constraint name "row_i_k"
-            char const_name[16];  // "row_8_8\0" is 7 chars, using 16 for safety
+            char const_name[NAME_LEN];
             int needed = snprintf(NULL, 0, "row_%d_%d", i, k);
             if (needed >= (int)sizeof(const_name)) {
                 fprintf(stderr, "Error: const_name buffer too small for i=%d, k=%d\n", i, k);
@@ -139,27 +488,27 @@ SCIP_RETCODE create_constraints() {
             }
             snprintf(const_name, sizeof(const_name), "row_%d_%d", i, k);
             
-            // Create constraint: sum(x_ijk for j=0..8) = 1
-            SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, const_name, 0, NULL, NULL, 1.0, 1.0));
-            
-            // Add all variables in this row for number k+1
-            for(int j = 0; j < 9; j++) {
-                SCIP_CALL(SCIPaddCoefLinear(scip, cons, vars[i][j][k], 1.0));
+            // Collect all variables in this row for number k+1
+            SCIP_VAR* unit[SUDOKU_MAX_SIZE];
+            for(int j = 0; j < size; j++) {
+                unit[j] = cell_vars(ctx, i, j)[k];
             }
             
-            SCIP_CALL(SCIPaddCons(scip, cons));
-            row_constrs[i][k] = cons;  // Store the constraint
+            // Create constraint: sum(x_ijk over the row) = 1
+            SCIP_CALL(create_unit_constraint(ctx, &cons, const_name, unit, size));
+            SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+            ctx->row_constrs[i * size + k] = cons;  // Store the constraint
         }
     }
 
-    // Add column constraints - each number 1-9 appears exactly once per column
+    // Add column constraints - each digit appears exactly once per column
     
-    for(int j = 0; j < 9; j++) {
-        for(int k = 0; k < 9; k++) {
+    for(int j = 0; j < size; j++) {
+        for(int k = 0; k < size; k++) {
             SCIP_CONS* cons = NULL;
             
             // Create constraint name "col_j_k"
-            char const_name[16];  // "col_8_8\0" is 7 chars, using 16 for safety
+            char const_name[NAME_LEN];
             int needed = snprintf(NULL, 0, "col_%d_%d", j, k);
             if (needed >= (int)sizeof(const_name)) {
                 fprintf(stderr, "Error: const_name buffer too small for j=%d, k=%d\n", j, k);
@@ -167,274 +516,740 @@ SCIP_RETCODE create_constraints() {
             }
             snprintf(const_name, sizeof(const_name), "col_%d_%d", j, k);
             
-            // Create constraint: sum(x_ijk for i=0..8) = 1
-            SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, const_name, 0, NULL, NULL, 1.0, 1.0));
-            
-            // Add all variables in this column for number k+1
-            for(int i = 0; i < 9; i++) {
-                SCIP_CALL(SCIPaddCoefLinear(scip, cons, vars[i][j][k], 1.0));
+            // Collect all variables in this column for number k+1
+            SCIP_VAR* unit[SUDOKU_MAX_SIZE];
+            for(int i = 0; i < size; i++) {
+                unit[i] = cell_vars(ctx, i, j)[k];
             }
             
-            SCIP_CALL(SCIPaddCons(scip, cons));
-            col_constrs[j][k] = cons;  // Store the constraint
+            // Create constraint: sum(x_ijk over the column) = 1
+            SCIP_CALL(create_unit_constraint(ctx, &cons, const_name, unit, size));
+            SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+            ctx->col_constrs[j * size + k] = cons;  // Store the constraint
         }
     }
 
-    // Add subgrid constraints - each number 1-9 appears exactly once per 3x3 subgrid
+    // Add subgrid constraints - each digit appears exactly once per box
     
-    for(int k = 0; k < 9; k++) {
-        for(int p = 0; p < 3; p++) {
-            for(int q = 0; q < 3; q++) {
+    for(int k = 0; k < size; k++) {
+        for(int p = 0; p < order; p++) {
+            for(int q = 0; q < order; q++) {
                 SCIP_CONS* cons = NULL;
                 
-                // Create constraint name "subgrid_k_p_q"
-                char const_name[24];  // "subgrid_8_2_2\0" is 13 chars, using 24 for safety
+                // Create constraint name "subgrid_k_p_q" (p = stack, q = band)
+                char const_name[NAME_LEN];
                 int needed = snprintf(NULL, 0, "subgrid_%d_%d_%d", k, p, q);
                 if(needed >= (int)sizeof(const_name)) {
                     fprintf(stderr, "Error: const_name buffer too small for k=%d, p=%d, q=%d\n", k, p, q);
-                    return 1;
+                    return SCIP_ERROR;
                 }
                 snprintf(const_name, sizeof(const_name), "subgrid_%d_%d_%d", k, p, q);
                 
-                // Create constraint: sum(x_ijk for i,j in subgrid) = 1
-                SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, const_name, 0, NULL, NULL, 1.0, 1.0));
-                
-                // Add variables in the current 3x3 subgrid for number k+1
-                for(int j = 3 * p; j < 3 * (p + 1); j++) {
-                    for(int i = 3 * q; i < 3 * (q + 1); i++) {
-                        SCIP_CALL(SCIPaddCoefLinear(scip, cons, vars[i][j][k], 1.0));
+                // Collect variables in the current box for number k+1
+                SCIP_VAR* unit[SUDOKU_MAX_SIZE];
+                int n = 0;
+                for(int j = order * p; j < order * (p + 1); j++) {
+                    for(int i = order * q; i < order * (q + 1); i++) {
+                        unit[n++] = cell_vars(ctx, i, j)[k];
                     }
                 }
                 
-                SCIP_CALL(SCIPaddCons(scip, cons));
-                subgrid_constrs[k][p][q] = cons;  // Store the constraint
+                // Create constraint: sum(x_ijk for i,j in the box) = 1
+                SCIP_CALL(create_unit_constraint(ctx, &cons, const_name, unit, size));
+                SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+                ctx->subgrid_constrs[(q * order + p) * size + k] = cons;  // Store the constraint
             }
         }
     }
 
-    // Ensure that the complete puzzle grid is filled with one number per cell
-    
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            SCIP_CONS* cons = NULL;
-            
-            // Create constraint name "fillgrid_i_j"
-            char const_name[24];  // "fillgrid_8_8\0" is 13 chars, using 24 for safety
-            int needed = snprintf(NULL, 0, "fillgrid_%d_%d", i, j);
-            if(needed >= (int)sizeof(const_name)) {
-                fprintf(stderr, "Error: const_name buffer too small for i=%d, j=%d\n", i, j);
-                return 1;
+    return create_fillgrid_constraints(ctx);
+}
+
+
+// Digits placed in each unit (rows, columns, then boxes) by the givens:
+// bit k is set if k+1 is there
+static void placed_digits(const sudoku_grid_t *grid, uint64_t placed[3 * SUDOKU_MAX_SIZE]) {
+    memset(placed, 0, 3 * SUDOKU_MAX_SIZE * sizeof(*placed));
+    for(int cell = 0; cell < grid->size * grid->size; cell++) {
+        if(grid->cells[cell] > 0) {
+            int row = cell / grid->size;
+            int col = cell % grid->size;
+            uint64_t bit = 1ull << (grid->cells[cell] - 1);
+            placed[row] |= bit;
+            placed[grid->size + col] |= bit;
+            placed[2 * grid->size + sudoku_grid_box(grid, row, col)] |= bit;
+        }
+    }
+}
+
+// Digits still open in a cell given the placed digits of its units
+static uint64_t cell_candidates(const sudoku_grid_t *grid, const uint64_t placed[3 * SUDOKU_MAX_SIZE],
+                                int row, int col) {
+    uint64_t used = placed[row] | placed[grid->size + col]
+        | placed[2 * grid->size + sudoku_grid_box(grid, row, col)];
+    return ~used & ((1ull << grid->size) - 1);
+}
+
+SCIP_RETCODE add_reduced_variables(sudoku_ctx_t *ctx) {
+    uint64_t placed[3 * SUDOKU_MAX_SIZE];
+    placed_digits(&ctx->puzzle, placed);
+    int size = ctx->model_size;
+
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            if(ctx->puzzle.cells[i * size + j] > 0) {
+                continue;  // Given cells need no variables
             }
-            snprintf(const_name, sizeof(const_name), "fillgrid_%d_%d", i, j);
-            
-            // Create constraint: sum(x_ijk for k=0..8) = 1
-            SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, const_name, 0, NULL, NULL, 1.0, 1.0));
-            
-            // Add all numbers 1-9 for this cell
-            for(int k = 0; k < 9; k++) {
-                SCIP_CALL(SCIPaddCoefLinear(scip, cons, vars[i][j][k], 1.0));
+            uint64_t candidates = cell_candidates(&ctx->puzzle, placed, i, j);
+            for(int k = 0; k < size; k++) {
+                if(!(candidates & (1ull << k))) {
+                    continue;  // Ruled out by a given peer
+                }
+                SCIP_VAR* var = NULL;
+                char name[NAME_LEN];
+                snprintf(name, sizeof(name), "%d-%d-%d", i, j, k);
+                SCIP_CALL(SCIPcreateVarBasic(ctx->scip, &var, name, 0.0, 1.0, 0.0, SCIP_VARTYPE_BINARY));
+                SCIP_CALL(SCIPaddVar(ctx->scip, var));
+                cell_vars(ctx, i, j)[k] = var;
+                ctx->model_vars++;
             }
-            
-            SCIP_CALL(SCIPaddCons(scip, cons));
-            fillgrid_constrs[i][j] = cons;  // Store the constraint
         }
     }
-    
     return SCIP_OKAY;
 }
 
+// Adds "exactly one" over the variables that exist among the first count
+// unit_vars. Units already satisfied by a given (no variables and a given
+// digit) are skipped; an empty unit that is not satisfied stays in and
+// makes the model infeasible, which SCIP detects in presolve.
+static SCIP_RETCODE add_reduced_unit(sudoku_ctx_t *ctx, SCIP_CONS** slot, const char* name,
+                                     SCIP_VAR** unit_vars, int count, SCIP_Bool satisfied) {
+    SCIP_VAR* unit[SUDOKU_MAX_SIZE];
+    int nvars = 0;
+    for(int n = 0; n < count; n++) {
+        if(unit_vars[n] != NULL) {
+            unit[nvars++] = unit_vars[n];
+        }
+    }
+    if(satisfied) {
+        return SCIP_OKAY;
+    }
+
+    SCIP_CONS* cons = NULL;
+    SCIP_CALL(create_unit_constraint(ctx, &cons, name, unit, nvars));
+    SCIP_CALL(SCIPaddCons(ctx->scip, cons));
+    *slot = cons;
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE create_reduced_constraints(sudoku_ctx_t *ctx) {
+    int order = ctx->model_order;
+    int size = ctx->model_size;
+    uint64_t placed[3 * SUDOKU_MAX_SIZE];
+    placed_digits(&ctx->puzzle, placed);
+
+    char name[NAME_LEN];
+    SCIP_VAR* unit[SUDOKU_MAX_SIZE];
+    if(ctx->model_formulation == SUDOKU_FORMULATION_ALLDIFF) {
+        SCIP_CALL(create_alldiff_constraints(ctx, TRUE));
+    }
+    for(int a = 0; a < size && ctx->model_formulation != SUDOKU_FORMULATION_ALLDIFF; a++) {
+        for(int k = 0; k < size; k++) {
+            uint64_t bit = 1ull << k;
+
+            // Row a, digit k
+            for(int n = 0; n < size; n++) {
+                unit[n] = cell_vars(ctx, a, n)[k];
+            }
+            snprintf(name, sizeof(name), "row_%d_%d", a, k);
+            SCIP_CALL(add_reduced_unit(ctx, &ctx->row_constrs[a * size + k], name, unit, size,
+                                       (placed[a] & bit) != 0));
+
+            // Column a, digit k
+            for(int n = 0; n < size; n++) {
+                unit[n] = cell_vars(ctx, n, a)[k];
+            }
+            snprintf(name, sizeof(name), "col_%d_%d", a, k);
+            SCIP_CALL(add_reduced_unit(ctx, &ctx->col_constrs[a * size + k], name, unit, size,
+                                       (placed[size + a] & bit) != 0));
+
+            // Box a (p = stack, q = band as in create_constraints()), digit k
+            for(int n = 0; n < size; n++) {
+                int cell = unit_cell(order, 2 * size + a, n);
+                unit[n] = cell_vars(ctx, cell / size, cell % size)[k];
+            }
+            snprintf(name, sizeof(name), "subgrid_%d_%d_%d", k, a % order, a / order);
+            SCIP_CALL(add_reduced_unit(ctx, &ctx->subgrid_constrs[a * size + k], name, unit, size,
+                                       (placed[2 * size + a] & bit) != 0));
+        }
+    }
+
+    // One number per empty cell
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            snprintf(name, sizeof(name), "fillgrid_%d_%d", i, j);
+            SCIP_CALL(add_reduced_unit(ctx, &ctx->fillgrid_constrs[i * size + j], name, cell_vars(ctx, i, j), size,
+                                       ctx->puzzle.cells[i * size + j] > 0));
+        }
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE build_reduced_model(sudoku_ctx_t *ctx) {
+    // Puzzle-specific, so any template is dropped and nothing is reused
+    SCIP_CALL(release_model(ctx));
+    ctx->model_formulation = formulation_for(ctx);
+
+    SCIP_CALL(init_model(ctx));
+    SCIP_CALL(add_reduced_variables(ctx));
+    SCIP_CALL(create_reduced_constraints(ctx));
+    return SCIP_OKAY;
+}
 
-SCIP_RETCODE fix_variables() { // Fix variables based on initial puzzle
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            if(puzzle[i][j] > 0) {
-                SCIP_CALL(SCIPfixVar(scip, vars[i][j][puzzle[i][j] - 1], 1.0, &infeasible, &fixed));
-                if(infeasible) {
+SCIP_RETCODE fix_variables(sudoku_ctx_t *ctx) { // Fix variables based on initial puzzle
+    int size = ctx->model_size;
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            int digit = ctx->puzzle.cells[i * size + j];
+            if(digit > 0) {
+                SCIP_CALL(SCIPfixVar(ctx->scip, cell_vars(ctx, i, j)[digit - 1], 1.0, &ctx->infeasible, &ctx->fixed));
+                if(ctx->infeasible) {
                     fprintf(stderr, "Error: Infeasible puzzle at position (%d,%d)\n", i, j);
                     return SCIP_ERROR;
                 }
+                ctx->applied_givens[i * size + j] = digit;  // Remembered so reset_model() can undo it
             }
         }
     }
     return SCIP_OKAY;
 }
 
-SCIP_RETCODE solve() {
+SCIP_RETCODE sudoku_apply_limits(SCIP *scip, const sudoku_options_t *options) {
+    if (options && options->time_limit > 0) {
+        SCIP_CALL(SCIPsetRealParam(scip, "limits/time", options->time_limit));
+    } else {
+        SCIP_CALL(SCIPresetParam(scip, "limits/time"));
+    }
+    if (options && options->node_limit > 0) {
+        SCIP_CALL(SCIPsetLongintParam(scip, "limits/nodes", options->node_limit));
+    } else {
+        SCIP_CALL(SCIPresetParam(scip, "limits/nodes"));
+    }
+    if (options && options->memory_limit > 0) {
+        SCIP_CALL(SCIPsetRealParam(scip, "limits/memory", options->memory_limit));
+    } else {
+        SCIP_CALL(SCIPresetParam(scip, "limits/memory"));
+    }
+    return SCIP_OKAY;
+}
+
+bool sudoku_status_is_limit(SCIP_STATUS status) {
+    return status == SCIP_STATUS_TIMELIMIT || status == SCIP_STATUS_NODELIMIT
+        || status == SCIP_STATUS_TOTALNODELIMIT || status == SCIP_STATUS_MEMLIMIT;
+}
+
+// Copies the assignment in sol into ctx->puzzle
+static void extract_solution(sudoku_ctx_t *ctx, SCIP_SOL *sol) {
+    int size = ctx->model_size;
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            for(int k = 0; k < size; k++) {
+                SCIP_VAR* var = cell_vars(ctx, i, j)[k];
+                if(var == NULL) {
+                    continue;  // Eliminated in a reduced model
+                }
+                if(SCIPgetSolVal(ctx->scip, sol, var) > 0.5) {
+                    ctx->puzzle.cells[i * size + j] = k + 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// After a limit without incumbent: fills in the empty cells whose digit
+// SCIP had fixed globally, leaving the rest at 0
+static SCIP_RETCODE extract_proven_cells(sudoku_ctx_t *ctx) {
+    int size = ctx->model_size;
+    for(int cell = 0; cell < size * size; cell++) {
+        for(int k = 0; k < size && ctx->puzzle.cells[cell] == 0; k++) {
+            SCIP_VAR* var = ctx->vars[cell * size + k];
+            if(var == NULL) {
+                continue;
+            }
+            SCIP_VAR* transvar = NULL;
+            SCIP_CALL(SCIPgetTransformedVar(ctx->scip, var, &transvar));
+            if(transvar != NULL && SCIPvarGetLbGlobal(transvar) > 0.5) {
+                ctx->puzzle.cells[cell] = k + 1;
+            }
+        }
+    }
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE solve(sudoku_ctx_t *ctx) {
+    ctx->has_solution = false;
+    ctx->limit_reached = false;
+    ctx->gap = 0.0;
+
+    // The template outlives the request, so every solve sets its own limits
+    SCIP_CALL(sudoku_apply_limits(ctx->scip, &ctx->options));
+
     // Solve the problem
-    SCIP_RETCODE retcode = SCIPsolve(scip);
+    SCIP_RETCODE retcode = SCIPsolve(ctx->scip);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Error in SCIPsolve: %d\n", retcode);
         return retcode;
     }
 
     // Check solution status
-    SCIP_STATUS soln_status = SCIPgetStatus(scip);
+    SCIP_STATUS soln_status = SCIPgetStatus(ctx->scip);
     
     if(soln_status == SCIP_STATUS_OPTIMAL) {  // Solution found
-        SCIP_SOL* sol = SCIPgetBestSol(scip);
+        SCIP_SOL* sol = SCIPgetBestSol(ctx->scip);
         if (sol == NULL) {
             fprintf(stderr, "Error: No solution found despite optimal status\n");
             return SCIP_ERROR;
         }
         
-        // Extract solution
-        for(int i = 0; i < 9; i++) {
-            for(int j = 0; j < 9; j++) {
-                for(int k = 0; k < 9; k++) {
-                    SCIP_Real val = SCIPgetSolVal(scip, sol, vars[i][j][k]);
-                    if(val > 0.5) {
-                        puzzle[i][j] = k + 1;
-                        break;
-                    }
-                }
-            }
+        extract_solution(ctx, sol);
+        ctx->has_solution = true;
+        return SCIP_OKAY;
+    } else if(sudoku_status_is_limit(soln_status)) {
+        // A structured stop rather than an error: report the incumbent if
+        // there is one, otherwise whatever SCIP had proven so far
+        ctx->limit_reached = true;
+        ctx->gap = SCIPgetGap(ctx->scip);
+        SCIP_SOL* sol = SCIPgetBestSol(ctx->scip);
+        if (sol != NULL) {
+            extract_solution(ctx, sol);
+            ctx->has_solution = true;
+        } else {
+            SCIP_CALL(extract_proven_cells(ctx));
         }
+        printf("Solver limit reached (status %d, gap %g)\n", soln_status, ctx->gap);
         return SCIP_OKAY;
     } else if(soln_status == SCIP_STATUS_INFEASIBLE) {
         printf("The puzzle is infeasible.\n");
         return SCIP_OKAY;  // Not an error, just no solution exists
+    } else if(soln_status == SCIP_STATUS_USERINTERRUPT && atomic_load(&ctx->scip_cancel)) {
+        return SCIP_OKAY;  // Lost a portfolio race, the native engine has the answer
     } else {
         printf("Solver stopped with status %d\n", soln_status);
         return SCIP_ERROR;
     }
 }
 
-SCIP_RETCODE free_model() {
-    SCIP_RETCODE retcode;
-    
-    // Free variables
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            for(int k = 0; k < 9; k++) {
-                if (vars[i][j][k] != NULL) {
-                    retcode = SCIPreleaseVar(scip, &vars[i][j][k]);
-                    if (retcode != SCIP_OKAY) {
-                        fprintf(stderr, "Error releasing variable at [%d][%d][%d]\n", i, j, k);
-                        return retcode;
-                    }
-                }
+// Releases the non-NULL entries of a model array and frees it
+static SCIP_RETCODE release_conss(SCIP *scip, SCIP_CONS ***conss, int count, const char *kind) {
+    for(int i = 0; *conss != NULL && i < count; i++) {
+        if ((*conss)[i] != NULL) {
+            SCIP_RETCODE retcode = SCIPreleaseCons(scip, &(*conss)[i]);
+            if (retcode != SCIP_OKAY) {
+                fprintf(stderr, "Error releasing %s constraint [%d]\n", kind, i);
+                return retcode;
             }
         }
     }
+    free(*conss);
+    *conss = NULL;
+    return SCIP_OKAY;
+}
 
-    // Free row constraints
-    for(int i = 0; i < 9; i++) {
-        for(int k = 0; k < 9; k++) {
-            if (row_constrs[i][k] != NULL) {
-                retcode = SCIPreleaseCons(scip, &row_constrs[i][k]);
-                if (retcode != SCIP_OKAY) {
-                    fprintf(stderr, "Error releasing row constraint [%d][%d]\n", i, k);
-                    return retcode;
-                }
-            }
-        }
-    }
-    
-    // Free column constraints
-    for(int j = 0; j < 9; j++) {
-        for(int k = 0; k < 9; k++) {
-            if (col_constrs[j][k] != NULL) {
-                retcode = SCIPreleaseCons(scip, &col_constrs[j][k]);
-                if (retcode != SCIP_OKAY) {
-                    fprintf(stderr, "Error releasing column constraint [%d][%d]\n", j, k);
-                    return retcode;
-                }
-            }
-        }
-    }
+SCIP_RETCODE free_model(sudoku_ctx_t *ctx) {
+    int size = ctx->model_size;
+    int units = size * size;
     
-    // Free subgrid constraints
-    for(int k = 0; k < 9; k++) {
-        for(int p = 0; p < 3; p++) {
-            for(int q = 0; q < 3; q++) {
-                if (subgrid_constrs[k][p][q] != NULL) {
-                    retcode = SCIPreleaseCons(scip, &subgrid_constrs[k][p][q]);
-                    if (retcode != SCIP_OKAY) {
-                        fprintf(stderr, "Error releasing subgrid constraint [%d][%d][%d]\n", k, p, q);
-                        return retcode;
-                    }
-                }
-            }
-        }
-    }
-    
-    // Free fillgrid constraints
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            if (fillgrid_constrs[i][j] != NULL) {
-                retcode = SCIPreleaseCons(scip, &fillgrid_constrs[i][j]);
-                if (retcode != SCIP_OKAY) {
-                    fprintf(stderr, "Error releasing fillgrid constraint [%d][%d]\n", i, j);
-                    return retcode;
-                }
+    // Free variables
+    for(int v = 0; ctx->vars != NULL && v < units * size; v++) {
+        if (ctx->vars[v] != NULL) {
+            SCIP_RETCODE retcode = SCIPreleaseVar(ctx->scip, &ctx->vars[v]);
+            if (retcode != SCIP_OKAY) {
+                fprintf(stderr, "Error releasing variable [%d]\n", v);
+                return retcode;
             }
         }
     }
+    free(ctx->vars);
+    ctx->vars = NULL;
+
+    // Free row, column, subgrid, all-different and fillgrid constraints
+    SCIP_CALL(release_conss(ctx->scip, &ctx->row_constrs, units, "row"));
+    SCIP_CALL(release_conss(ctx->scip, &ctx->col_constrs, units, "column"));
+    SCIP_CALL(release_conss(ctx->scip, &ctx->subgrid_constrs, units, "subgrid"));
+    SCIP_CALL(release_conss(ctx->scip, &ctx->alldiff_constrs, 3 * size, "all-different"));
+    SCIP_CALL(release_conss(ctx->scip, &ctx->fillgrid_constrs, units, "fillgrid"));
     
     // Free the SCIP instance
-    if (scip != NULL) {
-        retcode = SCIPfree(&scip);
+    if (ctx->scip != NULL) {
+        SCIP_RETCODE retcode = SCIPfree(&ctx->scip);
         if (retcode != SCIP_OKAY) {
             fprintf(stderr, "Error freeing SCIP instance\n");
             return retcode;
         }
     }
+
+    free(ctx->applied_givens);
+    ctx->applied_givens = NULL;
+    ctx->model_ready = FALSE;
+    ctx->model_order = 0;
+    ctx->model_size = 0;
+    ctx->model_vars = 0;
+    ctx->model_conss = 0;
     
     return SCIP_OKAY;
 }
 
+SCIP_RETCODE reset_model(sudoku_ctx_t *ctx) {
+    // Drop the transformed problem of the previous solve, the original
+    // variables and constraints stay untouched
+    if (SCIPgetStage(ctx->scip) != SCIP_STAGE_PROBLEM) {
+        SCIP_CALL(SCIPfreeTransform(ctx->scip));
+    }
 
-SCIP_RETCODE manage_sudoku_problem() {
-    SCIP_RETCODE retcode;
-    
-    #ifdef DEBUG
-        printf("Debug mode\n");
-    #endif
+    // Undo the fixings of the previous puzzle (SCIPfixVar on an original
+    // variable just tightens its bounds)
+    int size = ctx->model_size;
+    for(int cell = 0; cell < size * size; cell++) {
+        if(ctx->applied_givens[cell] > 0) {
+            SCIP_VAR* var = ctx->vars[cell * size + ctx->applied_givens[cell] - 1];
+            SCIP_CALL(SCIPchgVarLb(ctx->scip, var, 0.0));
+            SCIP_CALL(SCIPchgVarUb(ctx->scip, var, 1.0));
+            ctx->applied_givens[cell] = 0;
+        }
+    }
+    return SCIP_OKAY;
+}
 
-    create_puzzle();
-    printf("Initial puzzle:\n");
-    print_puzzle();
+SCIP_RETCODE prepare_model(sudoku_ctx_t *ctx) {
+    // Reuse the template if it has been built already, for this order and
+    // in the requested formulation
+    sudoku_formulation_t formulation = formulation_for(ctx);
+    if (ctx->model_ready && ctx->model_formulation == formulation && ctx->model_order == ctx->puzzle.order) {
+        return reset_model(ctx);
+    }
+    if (ctx->model_ready) {
+        SCIP_CALL(release_model(ctx));
+    }
+    ctx->model_formulation = formulation;
 
-    retcode = init_model();
-    if (retcode != SCIP_OKAY) {
-        fprintf(stderr, "Error initializing model: %d\n", retcode);
-        return EXIT_FAILURE;
+    SCIP_CALL(init_model(ctx));
+    SCIP_CALL(add_variables(ctx));
+    SCIP_CALL(create_constraints(ctx));
+    ctx->model_ready = TRUE;
+
+    return SCIP_OKAY;
+}
+
+SCIP_RETCODE release_model(sudoku_ctx_t *ctx) {
+    if (!ctx->model_ready && ctx->scip == NULL && ctx->vars == NULL) {
+        return SCIP_OKAY;
     }
+    return free_model(ctx);
+}
+
 
-    retcode = add_variables();
+static SCIP_RETCODE solve_with_reduced_model(sudoku_ctx_t *ctx) {
+    SCIP_RETCODE retcode = build_reduced_model(ctx);
     if (retcode != SCIP_OKAY) {
-        fprintf(stderr, "Error adding variables: %d\n", retcode);
-        free_model();
-        return EXIT_FAILURE;
+        fprintf(stderr, "Error building reduced model: %d\n", retcode);
+        free_model(ctx);
+        return retcode;
     }
 
-    retcode = create_constraints();
+    retcode = solve(ctx);
+    // The reduced model only fits this puzzle
+    SCIP_RETCODE free_retcode = free_model(ctx);
+    return retcode != SCIP_OKAY ? retcode : free_retcode;
+}
+
+// Hands the guide to SCIP as a partial start solution: every open cell
+// whose guide digit does not clash with a given. SCIP's completesol
+// heuristic extends it, so after a one-cell edit mostly the cells around
+// the edit are left to search.
+static SCIP_RETCODE add_guide_solution(sudoku_ctx_t *ctx) {
+    const sudoku_grid_t *puzzle = &ctx->puzzle;
+    uint64_t placed[3 * SUDOKU_MAX_SIZE];
+    placed_digits(puzzle, placed);
+
+    SCIP_SOL* sol = NULL;
+    SCIP_CALL(SCIPcreatePartialSol(ctx->scip, &sol, NULL));
+    for(int i = 0; i < puzzle->size; i++) {
+        for(int j = 0; j < puzzle->size; j++) {
+            int digit = ctx->guide.cells[i * puzzle->size + j];
+            if(puzzle->cells[i * puzzle->size + j] > 0 || digit < 1 || digit > puzzle->size) {
+                continue;
+            }
+            if(!(cell_candidates(puzzle, placed, i, j) & (1ull << (digit - 1)))) {
+                continue;
+            }
+            SCIP_VAR* var = cell_vars(ctx, i, j)[digit - 1];
+            if(var != NULL) {
+                SCIP_CALL(SCIPsetSolVal(ctx->scip, sol, var, 1.0));
+            }
+        }
+    }
+    SCIP_Bool stored = FALSE;
+    SCIP_CALL(SCIPaddSolFree(ctx->scip, &sol, &stored));
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE solve_with_scip(sudoku_ctx_t *ctx) {
+    SCIP_RETCODE retcode;
+
+    if (ctx->options.reduced_model) {
+        return solve_with_reduced_model(ctx);
+    }
+
+    // Build the model on first use, afterwards only the bounds are reset
+    retcode = prepare_model(ctx);
     if (retcode != SCIP_OKAY) {
-        fprintf(stderr, "Error creating constraints: %d\n", retcode);
-        free_model();
-        return EXIT_FAILURE;
+        fprintf(stderr, "Error preparing model: %d\n", retcode);
+        release_model(ctx);
+        return retcode;
     }
 
-    retcode = fix_variables();
+    retcode = fix_variables(ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Error fixing variables: %d\n", retcode);
-        free_model();
-        return EXIT_FAILURE;
+        release_model(ctx);
+        return retcode;
     }
 
-    retcode = solve();
+    if (ctx->use_guide && ctx->guide.order == ctx->puzzle.order) {
+        retcode = add_guide_solution(ctx);
+        if (retcode != SCIP_OKAY) {
+            fprintf(stderr, "Error adding start solution: %d\n", retcode);
+            release_model(ctx);
+            return retcode;
+        }
+    }
+
+    retcode = solve(ctx);
     if (retcode != SCIP_OKAY) {
-        fprintf(stderr, "Error solving the puzzle: %d\n", retcode);
-        free_model();
-        return EXIT_FAILURE;
+        release_model(ctx);
+        return retcode;
+    }
+    return SCIP_OKAY;
+}
+
+// Limits of a native search: its budget (unless budget is false), tightened
+// by the request's time and node limits, which bound every engine
+static sudoku_native_limits_t native_limits(const sudoku_options_t *options, bool budget) {
+    sudoku_native_limits_t limits = {0};
+    if (budget) {
+        limits.node_limit = options->native_node_limit;
+        limits.time_limit = options->native_time_limit;
+    }
+    if (options->node_limit > 0 && (limits.node_limit <= 0 || options->node_limit < limits.node_limit)) {
+        limits.node_limit = options->node_limit;
+    }
+    if (options->time_limit > 0 && (limits.time_limit <= 0 || options->time_limit < limits.time_limit)) {
+        limits.time_limit = options->time_limit;
+    }
+    return limits;
+}
+
+// Counting has no SCIP fallback, so the native budget bounds it for every
+// engine; a stop leaves the count as a lower bound and is reported as a limit
+static SCIP_RETCODE count_puzzle(sudoku_ctx_t *ctx) {
+    sudoku_native_limits_t limits = native_limits(&ctx->options, true);
+
+    sudoku_native_status_t status = sudoku_native_count_parallel(
+        sudoku_grid_rows(&ctx->puzzle), ctx->options.solution_cap, ctx->options.count_threads, &limits,
+        &ctx->native_stats, &ctx->solution_count);
+    ctx->solved_natively = true;
+    ctx->has_solution = ctx->solution_count > 0;
+
+    if (status == SUDOKU_NATIVE_LIMIT_REACHED) {
+        ctx->limit_reached = true;
+        #ifdef DEBUG
+            printf("Search budget exhausted after %ld nodes and %d solutions\n", ctx->native_stats.nodes,
+                   ctx->solution_count);
+        #endif
+        return SCIP_OKAY;
+    }
+    if (!ctx->has_solution) {
+        printf("The puzzle is infeasible.\n");
     }
+    return SCIP_OKAY;
+}
+
+// The guide as the native search takes it, NULL without one
+static const int (*native_guide(sudoku_ctx_t *ctx))[9] {
+    return ctx->use_guide && ctx->guide.order == 3 ? (const int (*)[9])sudoku_grid_rows(&ctx->guide) : NULL;
+}
+
+// Portfolio mode: the propagation engine searches a copy of the puzzle on
+// its own thread while SCIP runs on the calling thread, which owns ctx
+typedef struct {
+    int grid[9][9];
+    const int (*guide)[9];
+    sudoku_native_limits_t limits;
+    sudoku_native_stats_t stats;
+    sudoku_native_status_t status;
+    atomic_bool cancel;            // Set once SCIP has won
+    atomic_int *winner;            // First engine with an answer, -1 while racing
+    atomic_bool *scip_cancel;
+} native_racer_t;
+
+static bool claim_race(atomic_int *winner, sudoku_engine_t engine) {
+    int racing = -1;
+    return atomic_compare_exchange_strong(winner, &racing, (int)engine);
+}
 
-    print_solution();
+static void *race_native(void *arg) {
+    native_racer_t *racer = arg;
+    racer->status = sudoku_native_solve_guided(racer->grid, racer->guide, &racer->limits, &racer->stats);
+    // A cancelled search ends with LIMIT_REACHED and has nothing to report
+    if (racer->status != SUDOKU_NATIVE_LIMIT_REACHED && claim_race(racer->winner, SUDOKU_ENGINE_NATIVE)) {
+        atomic_store(racer->scip_cancel, true);
+    }
+    return NULL;
+}
+
+static SCIP_RETCODE solve_portfolio(sudoku_ctx_t *ctx) {
+    atomic_int winner;
+    atomic_init(&winner, -1);
+    native_racer_t racer;
+    memset(&racer, 0, sizeof(racer));
+    memcpy(racer.grid, sudoku_grid_rows(&ctx->puzzle), sizeof(racer.grid));
+    atomic_init(&racer.cancel, false);
+    // No budget: a lost race or the request limits stop it
+    racer.limits = native_limits(&ctx->options, false);
+    racer.limits.cancel = &racer.cancel;
+    racer.guide = native_guide(ctx);  // Read-only while SCIP runs
+    racer.winner = &winner;
+    racer.scip_cancel = &ctx->scip_cancel;
+    atomic_store(&ctx->scip_cancel, false);
+
+    sudoku_puzzle_class_t puzzle_class = sudoku_puzzle_class((const int (*)[9])sudoku_grid_rows(&ctx->puzzle));
+    double start = sudoku_now_seconds();
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, race_native, &racer) != 0) {
+        ctx->race_winner = SUDOKU_ENGINE_SCIP;
+        return solve_with_scip(ctx);
+    }
+
+    // SCIP can only be interrupted after the native engine has claimed the
+    // win, so a successful claim here means its answer is complete
+    SCIP_RETCODE retcode = solve_with_scip(ctx);
+    if (retcode == SCIP_OKAY && !ctx->limit_reached && claim_race(&winner, SUDOKU_ENGINE_SCIP)) {
+        atomic_store(&racer.cancel, true);
+    }
+    // Unless the request has limits the native search always ends with an
+    // answer or is cancelled, so after the join one engine has won
+    pthread_join(thread, NULL);
+    atomic_store(&ctx->scip_cancel, false);
+
+    if (atomic_load(&winner) < 0) {
+        // Both engines hit a limit; SCIP's partial result stands
+        ctx->race_winner = SUDOKU_ENGINE_SCIP;
+        ctx->native_stats = racer.stats;
+        return retcode;
+    }
+    ctx->limit_reached = false;
+    ctx->race_winner = (sudoku_engine_t)atomic_load(&winner);
+    ctx->native_stats = racer.stats;
+    if (ctx->race_winner == SUDOKU_ENGINE_NATIVE) {
+        ctx->solved_natively = true;
+        ctx->has_solution = racer.status == SUDOKU_NATIVE_SOLVED;
+        if (ctx->has_solution) {
+            memcpy(sudoku_grid_rows(&ctx->puzzle), racer.grid, sizeof(racer.grid));
+        } else {
+            printf("The puzzle is infeasible.\n");
+        }
+        retcode = SCIP_OKAY;
+    }
+    sudoku_portfolio_record(puzzle_class, ctx->race_winner == SUDOKU_ENGINE_NATIVE, sudoku_now_seconds() - start);
+    return retcode;
+}
+
+SCIP_RETCODE solve_puzzle(sudoku_ctx_t *ctx) {
+    sudoku_native_status_t status;
+    sudoku_native_limits_t limits = native_limits(&ctx->options, true);
+
+    ctx->solved_natively = false;
+    ctx->has_solution = false;
+    ctx->limit_reached = false;
+    ctx->gap = 0.0;
+    ctx->solution_count = 0;
+    if (ctx->puzzle.order != 3) {
+        // Only the SCIP model takes other orders
+        if (needs_9x9(&ctx->options)) {
+            fprintf(stderr, "Error: counting and the native engines need a 9x9 puzzle\n");
+            return SCIP_INVALIDDATA;
+        }
+        return solve_with_scip(ctx);
+    }
+    if (ctx->options.solution_cap > 0) {
+        return count_puzzle(ctx);
+    }
+    switch (ctx->options.engine) {
+        case SUDOKU_ENGINE_SCIP:
+            return solve_with_scip(ctx);
+        case SUDOKU_ENGINE_PORTFOLIO:
+            return solve_portfolio(ctx);
+        case SUDOKU_ENGINE_DLX:
+            status = sudoku_dlx_solve(sudoku_grid_rows(&ctx->puzzle), &limits, &ctx->native_stats);
+            break;
+        case SUDOKU_ENGINE_AUTO:
+        case SUDOKU_ENGINE_NATIVE:
+        default:
+            // Fast path: most puzzles fall to propagation and a little search
+            status = sudoku_native_solve_guided(sudoku_grid_rows(&ctx->puzzle), native_guide(ctx), &limits,
+                                                &ctx->native_stats);
+            break;
+    }
+
+    switch (status) {
+        case SUDOKU_NATIVE_SOLVED:
+            ctx->solved_natively = true;
+            ctx->has_solution = true;
+            return SCIP_OKAY;
+        case SUDOKU_NATIVE_INFEASIBLE:
+            ctx->solved_natively = true;
+            printf("The puzzle is infeasible.\n");
+            return SCIP_OKAY;  // Same contract as solve(): not an error
+        case SUDOKU_NATIVE_LIMIT_REACHED:
+            break;
+    }
+
+    if (ctx->options.engine != SUDOKU_ENGINE_AUTO) {
+        // Nothing beyond the givens is proven; the puzzle stays as it was
+        ctx->limit_reached = true;
+        #ifdef DEBUG
+            printf("Search budget exhausted after %ld nodes\n", ctx->native_stats.nodes);
+        #endif
+        return SCIP_OKAY;
+    }
+
+    #ifdef DEBUG
+        printf("Native budget exhausted after %ld nodes, falling back to SCIP\n", ctx->native_stats.nodes);
+    #endif
+    return solve_with_scip(ctx);
+}
+
+SCIP_RETCODE manage_sudoku_problem(sudoku_ctx_t *ctx) {
+    SCIP_RETCODE retcode;
     
-    retcode = free_model();
+    #ifdef DEBUG
+        printf("Debug mode\n");
+    #endif
+
+    printf("Initial puzzle:\n");
+    print_puzzle(ctx);
+
+    retcode = solve_puzzle(ctx);
     if (retcode != SCIP_OKAY) {
-        fprintf(stderr, "Error freeing model: %d\n", retcode);
-        return EXIT_FAILURE;
+        fprintf(stderr, "Error solving the puzzle: %d\n", retcode);
+        return SCIP_ERROR;
     }
-    return EXIT_SUCCESS;
+
+    if (ctx->has_solution) {
+        print_solution(ctx);
+    }
+    
+    // The model is kept for the next puzzle, release_model() frees it
+    return SCIP_OKAY;
 }
\ No newline at end of file
@@ -0,0 +1,371 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "problems/sudoku/sudoku_stream.h"
+#include "sudoku_budget.h"
+
+// Records per solve_sudoku_batch() call on binary input; large enough
+// that starting the workers does not show
+#define BINARY_BATCH (1u << 16)
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+    bool ready;
+    size_t counts[4];            // Indexed by sudoku_batch_status_t
+} stream_slot_t;
+
+typedef struct {
+    const char *input;
+    size_t size;
+    size_t blocks;
+    atomic_size_t next;
+
+    // Reordering window: block b lives in slots[b % window] and may only be
+    // filled once block b - window has been written
+    stream_slot_t *slots;
+    size_t window;
+    size_t written;
+    bool failed;
+    pthread_mutex_t lock;
+    pthread_cond_t slot_free;
+    pthread_cond_t slot_ready;
+} stream_job_t;
+
+typedef struct {
+    stream_job_t *job;
+    pthread_t thread;
+    sudoku_ctx_t ctx;
+} stream_worker_t;
+
+// First line start at or after pos: lines belong to the block holding
+// their first byte
+static size_t line_start(const stream_job_t *job, size_t block) {
+    if (block == 0) {
+        return 0;
+    }
+    size_t pos = block * SUDOKU_STREAM_BLOCK_SIZE;
+    if (pos >= job->size) {
+        return job->size;
+    }
+    const char *newline = memchr(job->input + pos - 1, '\n', job->size - pos + 1);
+    return newline ? (size_t)(newline - job->input) + 1 : job->size;
+}
+
+static bool solve_block(stream_job_t *job, size_t block, sudoku_ctx_t *ctx, stream_slot_t *slot) {
+    size_t begin = line_start(job, block);
+    size_t end = line_start(job, block + 1);
+
+    // Output never exceeds the input plus a newline for an unterminated last line
+    if (slot->capacity < end - begin + 1) {
+        char *data = realloc(slot->data, end - begin + 1);
+        if (!data) {
+            return false;
+        }
+        slot->data = data;
+        slot->capacity = end - begin + 1;
+    }
+    slot->len = 0;
+    memset(slot->counts, 0, sizeof(slot->counts));
+
+    const char *line = job->input + begin;
+    const char *limit = job->input + end;
+    while (line < limit) {
+        const char *newline = memchr(line, '\n', (size_t)(limit - line));
+        const char *next = newline ? newline + 1 : limit;
+        size_t len = (size_t)((newline ? newline : limit) - line);
+        if (len > 0 && line[len - 1] == '\r') {
+            len--;
+        }
+
+        if (len > 0) {
+            char *out = slot->data + slot->len;
+            sudoku_batch_status_t status = len == SUDOKU_PUZZLE_LEN
+                ? sudoku_batch_solve_record(ctx, line, out)
+                : SUDOKU_BATCH_INVALID;
+            if (status != SUDOKU_BATCH_SOLVED) {
+                memcpy(out, line, len);
+            }
+            size_t written = status == SUDOKU_BATCH_SOLVED ? SUDOKU_PUZZLE_LEN : len;
+            out[written] = '\n';
+            slot->len += written + 1;
+            slot->counts[status]++;
+        }
+        line = next;
+    }
+    return true;
+}
+
+static void *stream_worker(void *arg) {
+    stream_worker_t *worker = arg;
+    stream_job_t *job = worker->job;
+
+    for (;;) {
+        size_t block = atomic_fetch_add(&job->next, 1);
+        if (block >= job->blocks) {
+            break;
+        }
+
+        pthread_mutex_lock(&job->lock);
+        while (block >= job->written + job->window && !job->failed) {
+            pthread_cond_wait(&job->slot_free, &job->lock);
+        }
+        bool failed = job->failed;
+        pthread_mutex_unlock(&job->lock);
+        if (failed) {
+            break;
+        }
+
+        stream_slot_t *slot = &job->slots[block % job->window];
+        bool ok = solve_block(job, block, &worker->ctx, slot);
+
+        pthread_mutex_lock(&job->lock);
+        if (ok) {
+            slot->ready = true;
+        } else {
+            job->failed = true;
+            pthread_cond_broadcast(&job->slot_free);
+        }
+        pthread_cond_broadcast(&job->slot_ready);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return NULL;
+}
+
+// Writes blocks in input order as they complete
+static bool write_blocks(stream_job_t *job, FILE *output, size_t totals[4]) {
+    bool ok = true;
+
+    for (size_t block = 0; block < job->blocks && ok; block++) {
+        stream_slot_t *slot = &job->slots[block % job->window];
+
+        pthread_mutex_lock(&job->lock);
+        while (!slot->ready && !job->failed) {
+            pthread_cond_wait(&job->slot_ready, &job->lock);
+        }
+        ok = slot->ready;
+        pthread_mutex_unlock(&job->lock);
+        if (!ok) {
+            break;
+        }
+
+        ok = fwrite(slot->data, 1, slot->len, output) == slot->len;
+        for (int s = 0; s < 4; s++) {
+            totals[s] += slot->counts[s];
+        }
+
+        pthread_mutex_lock(&job->lock);
+        slot->ready = false;
+        job->written++;
+        if (!ok) {
+            job->failed = true;
+        }
+        pthread_cond_broadcast(&job->slot_free);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return ok;
+}
+
+static int run_stream(stream_job_t *job, FILE *output, const sudoku_batch_config_t *config,
+                      sudoku_batch_stats_t *totals) {
+    int threads = config->threads;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (job->blocks < (size_t)threads) {
+        threads = job->blocks > 0 ? (int)job->blocks : 1;
+    }
+
+    job->window = (size_t)threads * SUDOKU_STREAM_WINDOW_PER_THREAD;
+    job->slots = calloc(job->window, sizeof(*job->slots));
+    stream_worker_t *workers = calloc((size_t)threads, sizeof(*workers));
+    if (!job->slots || !workers) {
+        free(job->slots);
+        free(workers);
+        return EXIT_FAILURE;
+    }
+    atomic_init(&job->next, 0);
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->slot_free, NULL);
+    pthread_cond_init(&job->slot_ready, NULL);
+
+    int started = 0;
+    for (; started < threads; started++) {
+        stream_worker_t *worker = &workers[started];
+        worker->job = job;
+        sudoku_ctx_init(&worker->ctx);
+        worker->ctx.options = config->options;
+        if (pthread_create(&worker->thread, NULL, stream_worker, worker) != 0) {
+            fprintf(stderr, "Error starting stream worker %d\n", started);
+            sudoku_ctx_free(&worker->ctx);
+            break;
+        }
+    }
+
+    size_t counts[4] = {0};
+    bool ok = started > 0 && write_blocks(job, output, counts);
+    if (!ok) {
+        // Wake workers waiting for window space so they can exit
+        pthread_mutex_lock(&job->lock);
+        job->failed = true;
+        pthread_cond_broadcast(&job->slot_free);
+        pthread_mutex_unlock(&job->lock);
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+        sudoku_ctx_free(&workers[t].ctx);
+    }
+
+    totals->threads = started;
+    totals->solved = counts[SUDOKU_BATCH_SOLVED];
+    totals->infeasible = counts[SUDOKU_BATCH_INFEASIBLE];
+    totals->invalid = counts[SUDOKU_BATCH_INVALID];
+    totals->failed = counts[SUDOKU_BATCH_ERROR];
+
+    for (size_t s = 0; s < job->window; s++) {
+        free(job->slots[s].data);
+    }
+    free(job->slots);
+    free(workers);
+    pthread_cond_destroy(&job->slot_ready);
+    pthread_cond_destroy(&job->slot_free);
+    pthread_mutex_destroy(&job->lock);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int solve_sudoku_file(const char *input_path, const char *output_path,
+                      const sudoku_batch_config_t *config, sudoku_batch_stats_t *stats) {
+    sudoku_batch_config_t defaults;
+    if (!config) {
+        sudoku_batch_default_config(&defaults);
+        config = &defaults;
+    }
+
+    int fd = open(input_path, O_RDONLY);
+    if (fd < 0) {
+        perror(input_path);
+        return EXIT_FAILURE;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(input_path);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    stream_job_t job = {0};
+    job.size = (size_t)st.st_size;
+    job.blocks = (job.size + SUDOKU_STREAM_BLOCK_SIZE - 1) / SUDOKU_STREAM_BLOCK_SIZE;
+    if (job.size > 0) {
+        void *mapped = mmap(NULL, job.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            perror(input_path);
+            close(fd);
+            return EXIT_FAILURE;
+        }
+        // Read once front to back
+        posix_madvise(mapped, job.size, POSIX_MADV_SEQUENTIAL);
+        job.input = mapped;
+    }
+    close(fd);
+
+    FILE *output = fopen(output_path, "wb");
+    if (!output) {
+        perror(output_path);
+        if (job.input) {
+            munmap((void *)job.input, job.size);
+        }
+        return EXIT_FAILURE;
+    }
+
+    sudoku_batch_stats_t totals = {0};
+    double start = sudoku_now_seconds();
+    int result = run_stream(&job, output, config, &totals);
+    if (fflush(output) != 0) {
+        result = EXIT_FAILURE;
+    }
+    totals.elapsed = sudoku_now_seconds() - start;
+    size_t puzzles = totals.solved + totals.infeasible + totals.invalid + totals.failed;
+    totals.puzzles_per_second = totals.elapsed > 0.0 ? (double)puzzles / totals.elapsed : 0.0;
+    if (stats) {
+        *stats = totals;
+    }
+
+    if (fclose(output) != 0) {
+        result = EXIT_FAILURE;
+    }
+    if (job.input) {
+        munmap((void *)job.input, job.size);
+    }
+    return result;
+}
+
+int solve_sudoku_binary_file(const char *input_path, const char *output_path,
+                             const sudoku_batch_config_t *config, sudoku_batch_stats_t *stats) {
+    sudoku_binary_reader_t reader;
+    sudoku_binary_header_t header;
+    if (sudoku_binary_reader_open(&reader, input_path, &header) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if (header.order != 3) {
+        fprintf(stderr, "%s: only 9x9 puzzles can be solved\n", input_path);
+        sudoku_binary_reader_close(&reader);
+        return EXIT_FAILURE;
+    }
+    sudoku_binary_writer_t writer;
+    if (sudoku_binary_writer_open(&writer, output_path, 3, header.flags & SUDOKU_BINARY_COMPRESSED) != EXIT_SUCCESS) {
+        sudoku_binary_reader_close(&reader);
+        return EXIT_FAILURE;
+    }
+
+    char *puzzles = malloc((size_t)BINARY_BATCH * SUDOKU_PUZZLE_LEN);
+    char *solutions = malloc((size_t)BINARY_BATCH * SUDOKU_PUZZLE_LEN);
+    sudoku_batch_status_t *status = malloc(BINARY_BATCH * sizeof(*status));
+    bool ok = puzzles && solutions && status;
+
+    sudoku_batch_stats_t totals = {0};
+    double start = sudoku_now_seconds();
+    size_t count;
+    while (ok && (count = sudoku_binary_read(&reader, puzzles, BINARY_BATCH)) > 0) {
+        sudoku_batch_stats_t chunk = {0};
+        ok = solve_sudoku_batch(puzzles, count, solutions, status, config, &chunk) == EXIT_SUCCESS;
+        // Unsolved records are copied, so both files stay record-aligned
+        for (size_t n = 0; ok && n < count; n++) {
+            if (status[n] != SUDOKU_BATCH_SOLVED) {
+                memcpy(solutions + n * SUDOKU_PUZZLE_LEN, puzzles + n * SUDOKU_PUZZLE_LEN, SUDOKU_PUZZLE_LEN);
+            }
+        }
+        ok = ok && sudoku_binary_write(&writer, solutions, count) == EXIT_SUCCESS;
+        totals.solved += chunk.solved;
+        totals.infeasible += chunk.infeasible;
+        totals.invalid += chunk.invalid;
+        totals.failed += chunk.failed;
+        if (chunk.threads > totals.threads) {
+            totals.threads = chunk.threads;
+        }
+    }
+    totals.elapsed = sudoku_now_seconds() - start;
+    size_t puzzles_done = totals.solved + totals.infeasible + totals.invalid + totals.failed;
+    totals.puzzles_per_second = totals.elapsed > 0.0 ? (double)puzzles_done / totals.elapsed : 0.0;
+    if (stats) {
+        *stats = totals;
+    }
+
+    writer.failed = writer.failed || !ok;
+    ok = sudoku_binary_reader_close(&reader) == EXIT_SUCCESS && ok;
+    ok = sudoku_binary_writer_close(&writer) == EXIT_SUCCESS && ok;
+    free(puzzles);
+    free(solutions);
+    free(status);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
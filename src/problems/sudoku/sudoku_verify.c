@@ -0,0 +1,330 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "problems/sudoku/sudoku_binary.h"
+#include "problems/sudoku/sudoku_parser.h"
+#include "problems/sudoku/sudoku_verify.h"
+#include "sudoku_budget.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define ALL_DIGITS 0x3FEu          // Bits 1-9
+#define VERIFY_CHUNK (1u << 16)    // Records per step of sudoku_verify_file()
+
+static bool keeps_givens_scalar(const char *solution, const char *puzzle) {
+    for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+        char given = puzzle[cell];
+        if (given != '0' && given != '.' && given != solution[cell]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sudoku_verify_record(const char *solution, const char *puzzle) {
+    uint16_t rows[9] = {0};
+    uint16_t cols[9] = {0};
+    uint16_t boxes[9] = {0};
+
+    for (int row = 0; row < 9; row++) {
+        for (int col = 0; col < 9; col++) {
+            unsigned value = (unsigned char)solution[row * 9 + col] - (unsigned)'0';
+            // Anything but '1'-'9' leaves its units one digit short
+            uint16_t bit = value - 1 < 9 ? (uint16_t)(1u << value) : 0;
+            rows[row] |= bit;
+            cols[col] |= bit;
+            boxes[(row / 3) * 3 + col / 3] |= bit;
+        }
+    }
+    // Nine cells covering nine digits hold each digit once
+    for (int unit = 0; unit < 9; unit++) {
+        if ((rows[unit] & cols[unit] & boxes[unit]) != ALL_DIGITS) {
+            return false;
+        }
+    }
+    return !puzzle || keeps_givens_scalar(solution, puzzle);
+}
+
+bool sudoku_verify_grid(const int grid[9][9]) {
+    char record[SUDOKU_PUZZLE_LEN];
+    for (int cell = 0; cell < SUDOKU_PUZZLE_LEN; cell++) {
+        int value = grid[cell / 9][cell % 9];
+        record[cell] = value >= 1 && value <= 9 ? (char)('0' + value) : 'x';
+    }
+    return sudoku_verify_record(record, NULL);
+}
+
+#if defined(__AVX2__)
+// Transposes two 16x16 byte matrices at once, one per 128-bit half: on
+// return rows[j] holds byte j of every input row, row i in byte i of each half
+static inline void transpose16x2(__m256i rows[16]) {
+    __m256i t[16];
+    for (int i = 0; i < 8; i++) {
+        t[2 * i] = _mm256_unpacklo_epi8(rows[2 * i], rows[2 * i + 1]);
+        t[2 * i + 1] = _mm256_unpackhi_epi8(rows[2 * i], rows[2 * i + 1]);
+    }
+    for (int i = 0; i < 4; i++) {
+        rows[4 * i] = _mm256_unpacklo_epi16(t[4 * i], t[4 * i + 2]);
+        rows[4 * i + 1] = _mm256_unpackhi_epi16(t[4 * i], t[4 * i + 2]);
+        rows[4 * i + 2] = _mm256_unpacklo_epi16(t[4 * i + 1], t[4 * i + 3]);
+        rows[4 * i + 3] = _mm256_unpackhi_epi16(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 4; j++) {
+            t[8 * i + 2 * j] = _mm256_unpacklo_epi32(rows[8 * i + j], rows[8 * i + j + 4]);
+            t[8 * i + 2 * j + 1] = _mm256_unpackhi_epi32(rows[8 * i + j], rows[8 * i + j + 4]);
+        }
+    }
+    for (int j = 0; j < 8; j++) {
+        rows[2 * j] = _mm256_unpacklo_epi64(t[j], t[j + 8]);
+        rows[2 * j + 1] = _mm256_unpackhi_epi64(t[j], t[j + 8]);
+    }
+}
+
+// Characters of one cell in 32 grids to their digit bits in 16-bit lanes;
+// anything but '1'-'9' gives 0. With grid g in byte g % 16 of half g / 16,
+// masks[0] holds grids 0-7 and 16-23, masks[1] grids 8-15 and 24-31.
+static inline void cell_masks(__m256i chars, __m256i masks[2]) {
+    const __m256i low_bits = _mm256_setr_epi8(0, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i high_bits = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0,
+                                               0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0);
+    __m256i values = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    // pshufb yields 0 for indices with the top bit set
+    __m256i index = _mm256_or_si256(values, _mm256_andnot_si256(is_digit, _mm256_set1_epi8((char)0x80)));
+    __m256i low = _mm256_shuffle_epi8(low_bits, index);
+    __m256i high = _mm256_shuffle_epi8(high_bits, index);
+    masks[0] = _mm256_unpacklo_epi8(low, high);
+    masks[1] = _mm256_unpackhi_epi8(low, high);
+}
+
+// Bit g set if grid g of the 32 records at solutions is valid (units only)
+static inline uint32_t verify32(const char *solutions) {
+    __m256i masks[SUDOKU_PUZZLE_LEN][2];
+    // Five blocks of 16 cells and one overlapping block for the last cell
+    static const int offsets[] = {0, 16, 32, 48, 64, SUDOKU_PUZZLE_LEN - 16};
+    for (size_t b = 0; b < sizeof(offsets) / sizeof(offsets[0]); b++) {
+        __m256i rows[16];
+        for (int g = 0; g < 16; g++) {
+            const char *low = solutions + g * SUDOKU_PUZZLE_LEN + offsets[b];
+            const char *high = low + 16 * SUDOKU_PUZZLE_LEN;
+            rows[g] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)low)),
+                                              _mm_loadu_si128((const __m128i *)high), 1);
+        }
+        transpose16x2(rows);
+        for (int j = 0; j < 16; j++) {
+            cell_masks(rows[j], masks[offsets[b] + j]);
+        }
+    }
+
+    // As in the scalar check: the AND of a row, column and box is all
+    // digits only if each of them is
+    __m256i ok[2];
+    for (int h = 0; h < 2; h++) {
+        ok[h] = _mm256_set1_epi16(-1);
+        for (int unit = 0; unit < 9; unit++) {
+            int first = (unit / 3) * 27 + (unit % 3) * 3;
+            __m256i row = masks[unit * 9][h];
+            __m256i col = masks[unit][h];
+            __m256i box = masks[first][h];
+            for (int k = 1; k < 9; k++) {
+                row = _mm256_or_si256(row, masks[unit * 9 + k][h]);
+                col = _mm256_or_si256(col, masks[k * 9 + unit][h]);
+                box = _mm256_or_si256(box, masks[first + (k / 3) * 9 + k % 3][h]);
+            }
+            ok[h] = _mm256_and_si256(ok[h], _mm256_and_si256(row, _mm256_and_si256(col, box)));
+        }
+        ok[h] = _mm256_cmpeq_epi16(ok[h], _mm256_set1_epi16((short)ALL_DIGITS));
+    }
+    // packs works per half, which puts the grids back in order
+    return (uint32_t)_mm256_movemask_epi8(_mm256_packs_epi16(ok[0], ok[1]));
+}
+
+static inline bool keeps_givens(const char *solution, const char *puzzle) {
+    bool kept = true;
+    static const int offsets[] = {0, 32, SUDOKU_PUZZLE_LEN - 32};
+    for (size_t b = 0; b < sizeof(offsets) / sizeof(offsets[0]); b++) {
+        __m256i given = _mm256_loadu_si256((const __m256i *)(puzzle + offsets[b]));
+        __m256i value = _mm256_loadu_si256((const __m256i *)(solution + offsets[b]));
+        __m256i fine = _mm256_or_si256(_mm256_cmpeq_epi8(given, value),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(given, _mm256_set1_epi8('0')),
+                                                       _mm256_cmpeq_epi8(given, _mm256_set1_epi8('.'))));
+        kept = kept && (uint32_t)_mm256_movemask_epi8(fine) == 0xFFFFFFFFu;
+    }
+    return kept;
+}
+#endif
+
+size_t sudoku_verify_batch(const char *solutions, const char *puzzles, size_t count, bool *valid) {
+    size_t total = 0;
+    size_t done = 0;
+
+#if defined(__AVX2__)
+    for (; done + SUDOKU_VERIFY_LANES <= count; done += SUDOKU_VERIFY_LANES) {
+        const char *block = solutions + done * SUDOKU_PUZZLE_LEN;
+        uint32_t good = verify32(block);
+        for (int g = 0; g < SUDOKU_VERIFY_LANES; g++) {
+            bool ok = (good >> g) & 1u;
+            if (ok && puzzles) {
+                ok = keeps_givens(block + g * SUDOKU_PUZZLE_LEN, puzzles + (done + (size_t)g) * SUDOKU_PUZZLE_LEN);
+            }
+            if (valid) {
+                valid[done + (size_t)g] = ok;
+            }
+            total += ok;
+        }
+    }
+#endif
+    for (; done < count; done++) {
+        bool ok = sudoku_verify_record(solutions + done * SUDOKU_PUZZLE_LEN,
+                                       puzzles ? puzzles + done * SUDOKU_PUZZLE_LEN : NULL);
+        if (valid) {
+            valid[done] = ok;
+        }
+        total += ok;
+    }
+    return total;
+}
+
+// Records from a line file or a binary file
+typedef struct {
+    bool binary;
+    FILE *file;
+    sudoku_binary_reader_t reader;
+    char *line;
+    size_t capacity;
+} record_source_t;
+
+static int source_open(record_source_t *source, const char *path) {
+    memset(source, 0, sizeof(*source));
+    source->binary = sudoku_binary_file_detect(path);
+    if (source->binary) {
+        sudoku_binary_header_t header;
+        if (sudoku_binary_reader_open(&source->reader, path, &header) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        if (header.order != 3) {
+            fprintf(stderr, "%s: only 9x9 grids can be verified\n", path);
+            sudoku_binary_reader_close(&source->reader);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    source->file = fopen(path, "rb");
+    if (!source->file) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static size_t source_read(record_source_t *source, char *records, size_t max, bool *failed) {
+    if (source->binary) {
+        size_t count = sudoku_binary_read(&source->reader, records, max);
+        *failed = source->reader.failed;
+        return count;
+    }
+
+    size_t count = 0;
+    ssize_t len;
+    while (count < max && (len = getline(&source->line, &source->capacity, source->file)) >= 0) {
+        while (len > 0 && (source->line[len - 1] == '\n' || source->line[len - 1] == '\r')) {
+            len--;
+        }
+        if (len == 0) {
+            continue;
+        }
+        char *record = records + count * SUDOKU_PUZZLE_LEN;
+        if (len == SUDOKU_PUZZLE_LEN) {
+            memcpy(record, source->line, SUDOKU_PUZZLE_LEN);
+        } else {
+            memset(record, 'x', SUDOKU_PUZZLE_LEN);  // Fails as solution and as puzzle
+        }
+        count++;
+    }
+    *failed = ferror(source->file) != 0;
+    return count;
+}
+
+static int source_close(record_source_t *source) {
+    if (source->binary) {
+        return sudoku_binary_reader_close(&source->reader);
+    }
+    free(source->line);
+    return source->file && fclose(source->file) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int sudoku_verify_file(const char *solutions_path, const char *puzzles_path, sudoku_verify_stats_t *stats) {
+    sudoku_verify_stats_t totals = {0, 0, SIZE_MAX, 0.0, 0.0};
+    double start = sudoku_now_seconds();
+
+    record_source_t solutions;
+    record_source_t puzzles;
+    if (source_open(&solutions, solutions_path) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if (puzzles_path && source_open(&puzzles, puzzles_path) != EXIT_SUCCESS) {
+        source_close(&solutions);
+        return EXIT_FAILURE;
+    }
+
+    char *solution_records = malloc((size_t)VERIFY_CHUNK * SUDOKU_PUZZLE_LEN);
+    char *puzzle_records = puzzles_path ? malloc((size_t)VERIFY_CHUNK * SUDOKU_PUZZLE_LEN) : NULL;
+    bool *valid = malloc(VERIFY_CHUNK * sizeof(*valid));
+    bool ok = solution_records && valid && (!puzzles_path || puzzle_records);
+
+    while (ok) {
+        bool failed = false;
+        size_t count = source_read(&solutions, solution_records, VERIFY_CHUNK, &failed);
+        if (puzzles_path && !failed) {
+            bool puzzles_failed = false;
+            size_t given = source_read(&puzzles, puzzle_records, VERIFY_CHUNK, &puzzles_failed);
+            if (puzzles_failed || given != count) {
+                fprintf(stderr, "%s: %s\n", puzzles_path,
+                        puzzles_failed ? "read error" : "record count differs from the solutions");
+                failed = true;
+            }
+        }
+        if (failed) {
+            ok = false;
+            break;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        size_t good = sudoku_verify_batch(solution_records, puzzle_records, count, valid);
+        if (good < count && totals.first_invalid == SIZE_MAX) {
+            for (size_t n = 0; n < count; n++) {
+                if (!valid[n]) {
+                    totals.first_invalid = totals.checked + n;
+                    break;
+                }
+            }
+        }
+        totals.checked += count;
+        totals.valid += good;
+    }
+
+    totals.elapsed = sudoku_now_seconds() - start;
+    totals.grids_per_second = totals.elapsed > 0.0 ? (double)totals.checked / totals.elapsed : 0.0;
+    if (stats) {
+        *stats = totals;
+    }
+
+    ok = source_close(&solutions) == EXIT_SUCCESS && ok;
+    if (puzzles_path) {
+        ok = source_close(&puzzles) == EXIT_SUCCESS && ok;
+    }
+    free(solution_records);
+    free(puzzle_records);
+    free(valid);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
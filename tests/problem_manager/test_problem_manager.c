@@ -0,0 +1,271 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/fertilizer_mixing/fertilizer_basis_cache.h"
+#include "../include/problems/sudoku/sudoku_portfolio.h"
+#include "problem_manager/problem_manager_options.h"
+#include "problems/sudoku/sudoku_test_grids.h"
+
+static const char *easy = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+static const char *easy_answer = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+// The easy puzzle without its first row has several solutions
+static const char *open_rows = ".........6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+static const char *hard = "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+static const char *empty = ".................................................................................";
+static const char *hard_givens = "800000000003600000070090200050007000000045700000100030001000068008500010090000400";
+
+// Least-cost blend of two straight products on one hectare
+static const char *blend =
+    "{\"area\": 1,"
+    " \"nutrients\": {\"N\": {\"min\": 100}, \"K2O\": {\"min\": 60}},"
+    " \"products\": ["
+    "  {\"name\": \"Urea\", \"price\": 0.50, \"composition\": {\"N\": 0.46}},"
+    "  {\"name\": \"MOP\", \"price\": 0.40, \"composition\": {\"K2O\": 0.60}}"
+    " ]}";
+
+static solver_result_t dispatch_sudoku(const char *data, const problem_manager_options_t *options) {
+    return problem_manager_dispatch_solver_with_options(TYPE_SUDOKU, data, options);
+}
+
+Test(problem_manager, maps_sudoku_engines_and_limits) {
+    static const struct {
+        problem_manager_engine_t engine;
+        sudoku_engine_t expected;
+    } engines[] = {
+        {ENGINE_DEFAULT, SUDOKU_ENGINE_AUTO},
+        {ENGINE_SCIP, SUDOKU_ENGINE_SCIP},
+        {ENGINE_NATIVE, SUDOKU_ENGINE_NATIVE},
+        {ENGINE_DLX, SUDOKU_ENGINE_DLX},
+        {ENGINE_PORTFOLIO, SUDOKU_ENGINE_PORTFOLIO},
+        {ENGINE_LP, SUDOKU_ENGINE_AUTO}
+    };
+    sudoku_options_t mapped;
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        problem_manager_options_t options = {0};
+        options.engine = engines[e].engine;
+        problem_manager_sudoku_options(&options, &mapped);
+        cr_assert_eq(mapped.engine, engines[e].expected, "engine %d", (int)engines[e].engine);
+    }
+
+    problem_manager_sudoku_options(NULL, &mapped);
+    cr_assert_eq(mapped.engine, SUDOKU_ENGINE_AUTO);
+    cr_assert_eq(mapped.solution_cap, 0);
+
+    problem_manager_options_t options = {0};
+    options.solution_cap = 2;
+    options.time_limit = 1.5;
+    options.node_limit = 100;
+    options.memory_limit = 64.0;
+    problem_manager_sudoku_options(&options, &mapped);
+    cr_assert_eq(mapped.solution_cap, 2);
+    cr_assert_float_eq(mapped.time_limit, 1.5, 1e-12);
+    cr_assert_eq(mapped.node_limit, 100);
+    cr_assert_float_eq(mapped.memory_limit, 64.0, 1e-12);
+
+    // Zero or negative threads mean one counting thread
+    cr_assert_eq(mapped.count_threads, 1);
+    options.threads = -3;
+    problem_manager_sudoku_options(&options, &mapped);
+    cr_assert_eq(mapped.count_threads, 1);
+    options.threads = 4;
+    problem_manager_sudoku_options(&options, &mapped);
+    cr_assert_eq(mapped.count_threads, 4);
+}
+
+Test(problem_manager, maps_fertilizer_backends) {
+    static const struct {
+        problem_manager_engine_t engine;
+        fertilizer_backend_t expected;
+    } engines[] = {
+        {ENGINE_DEFAULT, FERTILIZER_BACKEND_AUTO},
+        {ENGINE_SCIP, FERTILIZER_BACKEND_SCIP},
+        {ENGINE_LP, FERTILIZER_BACKEND_LP},
+        {ENGINE_NATIVE, FERTILIZER_BACKEND_AUTO},
+        {ENGINE_PORTFOLIO, FERTILIZER_BACKEND_AUTO}
+    };
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        problem_manager_options_t options = {0};
+        options.engine = engines[e].engine;
+        cr_assert_eq(problem_manager_fertilizer_backend(&options), engines[e].expected, "engine %d",
+                     (int)engines[e].engine);
+    }
+    cr_assert_eq(problem_manager_fertilizer_backend(NULL), FERTILIZER_BACKEND_AUTO);
+}
+
+Test(problem_manager, solves_with_the_chosen_engine) {
+    static const problem_manager_engine_t engines[] = {ENGINE_DEFAULT, ENGINE_NATIVE, ENGINE_DLX};
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        problem_manager_options_t options = {0};
+        options.engine = engines[e];
+        solver_result_t result = dispatch_sudoku(easy, &options);
+        cr_assert_eq(result.status, 0, "%s", result.message);
+        cr_assert_str_eq(result.message, "Sudoku solved successfully");
+        cr_assert_str_eq(result.solution, easy_answer);
+        cr_assert_eq(result.solution_count, 0);
+
+        problem_manager_free_result(&result);
+        cr_assert_null(result.message);
+        cr_assert_null(result.solution);
+    }
+
+    // Malformed input never reaches an engine
+    solver_result_t result = problem_manager_dispatch_solver(TYPE_SUDOKU, "12x");
+    cr_assert_eq(result.status, EXIT_FAILURE);
+    cr_assert_not_null(result.message);
+    cr_assert_null(result.solution);
+    problem_manager_free_result(&result);
+
+    result = problem_manager_dispatch_solver(TYPE_INVALID, easy);
+    cr_assert_eq(result.status, -1);
+    cr_assert_str_eq(result.message, "Unknown problem type");
+    problem_manager_free_result(&result);
+
+    sudoku_thread_cleanup();
+}
+
+Test(problem_manager, races_portfolio_requests) {
+    sudoku_portfolio_reset_stats();
+    problem_manager_options_t options = {0};
+    options.engine = ENGINE_PORTFOLIO;
+    solver_result_t result = dispatch_sudoku(hard, &options);
+    cr_assert_eq(result.status, 0, "%s", result.message);
+    cr_assert(sudoku_test_is_solution_line(hard, result.solution));
+
+    sudoku_portfolio_stats_t stats;
+    sudoku_portfolio_get_stats(&stats);
+    size_t races = 0;
+    for (int c = 0; c < SUDOKU_CLASS_COUNT; c++) {
+        races += stats.classes[c].races;
+    }
+    cr_assert_eq(races, 1);
+
+    problem_manager_free_result(&result);
+    sudoku_thread_cleanup();
+}
+
+Test(problem_manager, reports_solution_counts) {
+    problem_manager_options_t options = {0};
+
+    // A cap of 1 stops at the first solution and says nothing on uniqueness
+    options.solution_cap = 1;
+    solver_result_t result = dispatch_sudoku(open_rows, &options);
+    cr_assert_eq(result.status, 0, "%s", result.message);
+    cr_assert_str_eq(result.message, "Sudoku has a solution");
+    cr_assert_eq(result.solution_count, 1);
+    cr_assert_not_null(result.solution);
+    problem_manager_free_result(&result);
+
+    options.solution_cap = 2;
+    result = dispatch_sudoku(easy, &options);
+    cr_assert_eq(result.status, 0, "%s", result.message);
+    cr_assert_str_eq(result.message, "Sudoku has a unique solution");
+    cr_assert_eq(result.solution_count, 1);
+    cr_assert_str_eq(result.solution, easy_answer);
+    problem_manager_free_result(&result);
+
+    options.threads = 2;
+    result = dispatch_sudoku(open_rows, &options);
+    cr_assert_eq(result.status, 0, "%s", result.message);
+    cr_assert_str_eq(result.message, "Sudoku has multiple solutions");
+    cr_assert_eq(result.solution_count, 2);
+    problem_manager_free_result(&result);
+
+    sudoku_thread_cleanup();
+}
+
+Test(problem_manager, reports_native_limits) {
+    problem_manager_options_t options = {0};
+    options.engine = ENGINE_NATIVE;
+    options.node_limit = 1;
+
+    // One node cannot settle the hard grid: the givens come back as the
+    // proven cells, without a gap since the native engine has no bound
+    solver_result_t result = dispatch_sudoku(hard, &options);
+    cr_assert_eq(result.status, PROBLEM_MANAGER_LIMIT_REACHED);
+    cr_assert_not_null(result.message);
+    cr_assert_str_eq(result.solution, hard_givens);
+    cr_assert_float_eq(result.gap, 0.0, 1e-12);
+    problem_manager_free_result(&result);
+
+    // The same limit bounds counting: the first of the two solutions is
+    // found, the count is only a lower bound
+    options.engine = ENGINE_DEFAULT;
+    options.solution_cap = 100;
+    result = dispatch_sudoku(open_rows, &options);
+    cr_assert_eq(result.status, PROBLEM_MANAGER_LIMIT_REACHED);
+    cr_assert_str_eq(result.message, "Search budget reached, the solution count is a lower bound");
+    cr_assert_eq(result.solution_count, 1);
+    cr_assert(sudoku_test_is_solution_line(open_rows, result.solution));
+    problem_manager_free_result(&result);
+
+    // Stopped before any solution
+    result = dispatch_sudoku(empty, &options);
+    cr_assert_eq(result.status, PROBLEM_MANAGER_LIMIT_REACHED);
+    cr_assert_str_eq(result.message, "Solver limit reached before a solution was found");
+    cr_assert_eq(result.solution_count, 0);
+    problem_manager_free_result(&result);
+
+    sudoku_thread_cleanup();
+}
+
+Test(problem_manager, reports_scip_limits) {
+    problem_manager_options_t options = {0};
+    options.engine = ENGINE_SCIP;
+    options.node_limit = 1;
+
+    // SCIP may still settle the grid at the root; a stop carries its gap
+    solver_result_t result = dispatch_sudoku(hard, &options);
+    if (result.status == PROBLEM_MANAGER_LIMIT_REACHED) {
+        cr_assert_not_null(result.solution);
+        cr_assert_gt(result.gap, 0.0);
+    } else {
+        cr_assert_eq(result.status, 0, "%s", result.message);
+        cr_assert(sudoku_test_is_solution_line(hard, result.solution));
+        cr_assert_float_eq(result.gap, 0.0, 1e-12);
+    }
+    problem_manager_free_result(&result);
+
+    sudoku_thread_cleanup();
+}
+
+Test(problem_manager, routes_fertilizer_backends) {
+    fertilizer_basis_cache_t *cache = fertilizer_basis_cache();
+    cr_assert_not_null(cache);
+    fertilizer_basis_cache_clear(cache);
+    fertilizer_basis_cache_stats_t stats;
+
+    // The default and ENGINE_LP go through the LP backend and its basis
+    // cache, and answer with sensitivity
+    static const problem_manager_engine_t lp_engines[] = {ENGINE_DEFAULT, ENGINE_LP};
+    for (size_t e = 0; e < sizeof(lp_engines) / sizeof(lp_engines[0]); e++) {
+        problem_manager_options_t options = {0};
+        options.engine = lp_engines[e];
+        solver_result_t result = problem_manager_dispatch_solver_with_options(TYPE_FERTILIZER_MIXING, blend, &options);
+        cr_assert_eq(result.status, 0, "%s", result.message);
+        cr_assert_str_eq(result.message, "Fertilizer mixing problem solved successfully");
+        cr_assert_not_null(strstr(result.solution, "\"sensitivity\""));
+        problem_manager_free_result(&result);
+
+        fertilizer_basis_cache_get_stats(cache, &stats);
+        cr_assert_eq(stats.hits + stats.misses, e + 1);
+    }
+
+    // ENGINE_SCIP bypasses both
+    problem_manager_options_t options = {0};
+    options.engine = ENGINE_SCIP;
+    solver_result_t result = problem_manager_dispatch_solver_with_options(TYPE_FERTILIZER_MIXING, blend, &options);
+    cr_assert_eq(result.status, 0, "%s", result.message);
+    cr_assert_null(strstr(result.solution, "\"sensitivity\""));
+    problem_manager_free_result(&result);
+    fertilizer_basis_cache_get_stats(cache, &stats);
+    cr_assert_eq(stats.hits + stats.misses, 2);
+
+    result = problem_manager_dispatch_solver(TYPE_FERTILIZER_MIXING, "{\"products\": []}");
+    cr_assert_eq(result.status, EXIT_FAILURE);
+    cr_assert_not_null(result.message);
+    cr_assert_null(result.solution);
+    problem_manager_free_result(&result);
+
+    fertilizer_basis_cache_clear(cache);
+    fertilizer_thread_cleanup();
+}
@@ -0,0 +1,483 @@
+#include <criterion/criterion.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/fertilizer_mixing/fertilizer_basis_cache.h"
+#include "../include/problems/fertilizer_mixing/fertilizer_lp.h"
+#include "../include/problems/fertilizer_mixing/fertilizer_mixing_parser.h"
+#include "../include/problems/fertilizer_mixing/fertilizer_mixing_solver.h"
+#include "../include/problems/fertilizer_mixing/fertilizer_sensitivity.h"
+#include "../include/problems/fertilizer_mixing/fertilizer_session.h"
+
+// Two hectares. Ammonium nitrate is the cheapest nitrogen but only 200 kg
+// are available, so urea covers the rest; the NPK blend costs more than the
+// straight products it replaces. Optimum: AN 200, urea 286.96, TSP 173.91,
+// MOP 200 kg for 379.13.
+static const char *blend =
+    "{\"area\": 2,"
+    " \"nutrients\": {\"N\": {\"min\": 100, \"max\": 150}, \"P2O5\": {\"min\": 40}, \"K2O\": {\"min\": 60},"
+    "                 \"S\": {\"max\": 50}},"
+    " \"products\": ["
+    "  {\"name\": \"Urea\", \"price\": 0.50, \"composition\": {\"N\": 0.46}},"
+    "  {\"name\": \"AN\", \"price\": 0.30, \"composition\": {\"N\": 0.34}, \"available\": 200},"
+    "  {\"name\": \"TSP\", \"price\": 0.55, \"composition\": {\"P2O5\": 0.46, \"Ca\": 0.13}},"
+    "  {\"name\": \"MOP\", \"price\": 0.40, \"composition\": {\"K2O\": 0.60}, \"available\": null},"
+    "  {\"name\": \"NPK 15-15-15\", \"price\": 0.45, \"composition\": {\"N\": 0.15, \"P2O5\": 0.15, \"K2O\": 0.15}}"
+    " ]}";
+
+Test(fertilizer_parser, reads_catalog_and_targets) {
+    fertilizer_problem_t problem;
+    char *error_msg = NULL;
+    cr_assert_eq(fertilizer_parse(blend, &problem, &error_msg), EXIT_SUCCESS, "%s", error_msg);
+
+    cr_assert_float_eq(problem.area, 2.0, 1e-12);
+    cr_assert_eq(problem.nutrient_count, 4);
+    cr_assert_str_eq(problem.nutrients[1].name, "P2O5");
+    cr_assert_float_eq(problem.nutrients[0].max, 150.0, 1e-12);
+    cr_assert(isinf(problem.nutrients[1].max));
+    cr_assert_float_eq(problem.nutrients[3].min, 0.0, 1e-12);
+
+    cr_assert_eq(problem.product_count, 5);
+    cr_assert_str_eq(problem.products[4].name, "NPK 15-15-15");
+    cr_assert_float_eq(problem.products[1].max_amount, 200.0, 1e-12);
+    cr_assert(isinf(problem.products[3].max_amount));
+    // Calcium has no target and is dropped
+    cr_assert_float_eq(problem.products[2].content[1], 0.46, 1e-12);
+    cr_assert_float_eq(problem.products[2].content[0] + problem.products[2].content[2], 0.0, 1e-12);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_parser, rejects_malformed_requests) {
+    const char *bad[] = {
+        "",
+        "[1, 2]",
+        "{\"products\": []}",
+        "{\"nutrients\": {}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 5, \"max\": 1}}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": []}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"price\": 1, \"composition\": {}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"name\": \"U\", \"composition\": {}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {\"N\": 1.5}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {\"N\": 0.6, \"K\": 0.6}}]}",
+        "{\"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {}, \"available\": -1}]}",
+        "{\"area\": 0, \"nutrients\": {\"N\": {\"min\": 1}}, \"products\": [{\"name\": \"U\", \"price\": 1, \"composition\": {}}]}"
+    };
+    for (size_t n = 0; n < sizeof(bad) / sizeof(bad[0]); n++) {
+        fertilizer_problem_t problem;
+        char *error_msg = NULL;
+        cr_assert_eq(fertilizer_parse(bad[n], &problem, &error_msg), EXIT_FAILURE, "Request %zu", n);
+        cr_assert_not_null(error_msg, "Request %zu", n);
+        cr_assert_null(problem.products);
+        free(error_msg);
+    }
+    cr_assert_not(validate_fertilizer_mixing_data(NULL, NULL));
+    cr_assert(validate_fertilizer_mixing_data(blend, NULL));
+}
+
+Test(fertilizer_parser, formats_solution_json) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    solution.status = FERTILIZER_OPTIMAL;
+    solution.cost = 12.5;
+    solution.amounts[1] = 200.0;
+    solution.product_binding[1] = FERTILIZER_BOUND_MAX;
+    solution.supplied[0] = 34.0;
+    solution.nutrient_binding[0] = FERTILIZER_BOUND_MIN;
+
+    char *text = fertilizer_format_solution(&problem, &solution);
+    cr_assert_not_null(text);
+    cr_assert_not_null(strstr(text, "\"cost\":12.5,\"area\":2,"));
+    cr_assert_not_null(strstr(text, "\"products\":[{\"name\":\"AN\",\"kg\":200,\"binding\":\"max\"}]"));
+    cr_assert_not_null(strstr(text, "{\"name\":\"N\",\"kg_per_ha\":34,\"min\":100,\"max\":150,\"binding\":\"min\"}"));
+    cr_assert_not_null(strstr(text, "{\"name\":\"S\",\"kg_per_ha\":0,\"min\":0,\"max\":50,\"binding\":null}"));
+    free(text);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_parser, reads_price_and_target_updates) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_update_t update;
+    char *error_msg = NULL;
+    const char *json = "{\"prices\": {\"AN\": 0.4, \"MOP\": 0.38},"
+                       " \"nutrients\": {\"N\": {\"max\": null}, \"S\": {\"min\": 10}}}";
+    cr_assert_eq(fertilizer_parse_update(json, &problem, &update, &error_msg), EXIT_SUCCESS, "%s", error_msg);
+
+    cr_assert_eq(update.price_count, 2);
+    cr_assert_eq(update.price_products[1], 3);
+    cr_assert_float_eq(update.prices[0], 0.4, 1e-12);
+    cr_assert_eq(update.target_count, 2);
+    // Bounds not given are kept, null reopens one
+    cr_assert_eq(update.target_nutrients[0], 0);
+    cr_assert_float_eq(update.target_min[0], 100.0, 1e-12);
+    cr_assert(isinf(update.target_max[0]));
+    cr_assert_eq(update.target_nutrients[1], 3);
+    cr_assert_float_eq(update.target_min[1], 10.0, 1e-12);
+    cr_assert_float_eq(update.target_max[1], 50.0, 1e-12);
+
+    fertilizer_problem_apply(&problem, &update);
+    cr_assert_float_eq(problem.products[1].price, 0.4, 1e-12);
+    cr_assert(isinf(problem.nutrients[0].max));
+    cr_assert_float_eq(problem.nutrients[3].min, 10.0, 1e-12);
+    fertilizer_update_free(&update);
+
+    const char *bad[] = {
+        "",
+        "[]",
+        "{\"prices\": {\"Kieserite\": 0.3}}",
+        "{\"prices\": {\"AN\": \"cheap\"}}",
+        "{\"prices\": [0.3]}",
+        "{\"nutrients\": {\"Mg\": {\"min\": 1}}}",
+        "{\"nutrients\": {\"S\": {\"min\": 60}}}",
+        "{\"nutrients\": {\"N\": {\"min\": 90}, \"N\": {\"max\": 120}}}"
+    };
+    for (size_t n = 0; n < sizeof(bad) / sizeof(bad[0]); n++) {
+        error_msg = NULL;
+        cr_assert_eq(fertilizer_parse_update(bad[n], &problem, &update, &error_msg), EXIT_FAILURE, "Update %zu", n);
+        cr_assert_not_null(error_msg, "Update %zu", n);
+        cr_assert_null(update.prices);
+        free(error_msg);
+    }
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_lp, builds_column_major_matrix) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_lp_matrix_t matrix;
+    cr_assert_eq(fertilizer_lp_matrix_build(&problem, 1e20, false, &matrix), EXIT_SUCCESS);
+
+    cr_assert_eq(matrix.ncols, 5);
+    cr_assert_eq(matrix.nrows, 4);
+    // Nothing contains sulfur, so its row is empty; NPK has three entries
+    cr_assert_eq(matrix.nnonz, 1 + 1 + 1 + 1 + 3);
+    const int beg[] = {0, 1, 2, 3, 4};
+    const int ind[] = {0, 0, 1, 2, 0, 1, 2};
+    for (int i = 0; i < 5; i++) {
+        cr_assert_eq(matrix.beg[i], beg[i]);
+    }
+    for (int n = 0; n < matrix.nnonz; n++) {
+        cr_assert_eq(matrix.ind[n], ind[n]);
+    }
+    cr_assert_float_eq(matrix.val[2], 0.46, 1e-12);
+    cr_assert_float_eq(matrix.lhs[0], 200.0, 1e-12);
+    cr_assert_float_eq(matrix.rhs[0], 300.0, 1e-12);
+    cr_assert_float_eq(matrix.rhs[1], 1e20, 1e-12);
+    cr_assert_float_eq(matrix.lhs[3], 0.0, 1e-12);
+    cr_assert_float_eq(matrix.rhs[3], 100.0, 1e-12);
+    cr_assert_float_eq(matrix.ub[1], 200.0, 1e-12);
+    cr_assert_float_eq(matrix.ub[0], 1e20, 1e-12);
+    cr_assert_float_eq(matrix.obj[3], 0.40, 1e-12);
+
+    fertilizer_lp_matrix_free(&matrix);
+    fertilizer_problem_free(&problem);
+}
+
+// Optimal basis of blend: urea, TSP, MOP and the (empty) sulfur row basic,
+// AN at its limit, NPK unused, the other rows at their minimum
+static const int blend_cols[] = {SCIP_BASESTAT_BASIC, SCIP_BASESTAT_UPPER, SCIP_BASESTAT_BASIC, SCIP_BASESTAT_BASIC,
+                                 SCIP_BASESTAT_LOWER};
+static const int blend_rows[] = {SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_BASIC};
+
+static bool cache_lookup(fertilizer_basis_cache_t *cache, const fertilizer_problem_t *problem,
+                         fertilizer_solution_t *solution, bool *warm) {
+    int cols[5];
+    int rows[4];
+    bool hit = fertilizer_basis_cache_lookup(cache, problem, solution, cols, rows, warm);
+    if (*warm) {
+        cr_assert_eq(memcmp(cols, blend_cols, sizeof(cols)), 0);
+        cr_assert_eq(memcmp(rows, blend_rows, sizeof(rows)), 0);
+    }
+    return hit;
+}
+
+Test(fertilizer_basis_cache, answers_while_basis_stays_optimal) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    fertilizer_basis_cache_t cache;
+    cr_assert_eq(fertilizer_basis_cache_init(&cache, 4), EXIT_SUCCESS);
+
+    bool warm = true;
+    cr_assert_not(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert_not(warm);
+    fertilizer_basis_cache_insert(&cache, &problem, blend_cols, blend_rows);
+
+    cr_assert(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert_eq(solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_float_eq(solution.cost, 60.0 + 132.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-6);
+    cr_assert_float_eq(solution.amounts[0], 132.0 / 0.46, 1e-6);
+    cr_assert_float_eq(solution.amounts[4], 0.0, 1e-12);
+    cr_assert_eq(solution.product_binding[1], FERTILIZER_BOUND_MAX);
+    cr_assert_eq(solution.nutrient_binding[0], FERTILIZER_BOUND_MIN);
+
+    // Dearer urea and more nitrogen keep the basis: urea makes up the rest
+    problem.products[0].price = 0.52;
+    problem.nutrients[0].min = 110.0;
+    cr_assert(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert_float_eq(solution.amounts[0], 152.0 / 0.46, 1e-6);
+    cr_assert_float_eq(solution.cost, 60.0 + 152.0 / 0.46 * 0.52 + 80.0 / 0.46 * 0.55 + 80.0, 1e-6);
+
+    // At 0.40 AN should leave its limit (dual check), and with 30 kg/ha N
+    // the limit alone oversupplies it (primal check)
+    problem.products[1].price = 0.40;
+    cr_assert_not(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert(warm);
+    problem.products[1].price = 0.30;
+    problem.nutrients[0].min = 30.0;
+    cr_assert_not(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert(warm);
+
+    // Another catalog has no bases
+    problem.products[4].content[0] = 0.16;
+    cr_assert_not(cache_lookup(&cache, &problem, &solution, &warm));
+    cr_assert_not(warm);
+
+    fertilizer_basis_cache_stats_t stats;
+    fertilizer_basis_cache_get_stats(&cache, &stats);
+    cr_assert_eq(stats.hits, 2);
+    cr_assert_eq(stats.misses, 4);
+    cr_assert_eq(stats.warm_starts, 2);
+    cr_assert_eq(stats.insertions, 1);
+    cr_assert_eq(stats.entries, 1);
+    cr_assert_float_eq(stats.hit_rate, 2.0 / 6.0, 1e-12);
+
+    // Too many basic variables is not a basis
+    const int rows[] = {SCIP_BASESTAT_BASIC, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_BASIC};
+    fertilizer_basis_cache_insert(&cache, &problem, blend_cols, rows);
+    fertilizer_basis_cache_clear(&cache);
+    fertilizer_basis_cache_get_stats(&cache, &stats);
+    cr_assert_eq(stats.insertions + stats.entries + stats.misses, 0);
+
+    fertilizer_basis_cache_free(&cache);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_sensitivity, ranges_blend_from_optimal_basis) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    const double amounts[] = {132.0 / 0.46, 200.0, 80.0 / 0.46, 200.0, 0.0};
+    memcpy(solution.amounts, amounts, sizeof(amounts));
+    solution.status = FERTILIZER_OPTIMAL;
+    fertilizer_solution_finish(&problem, &solution, 1e-9);
+    fertilizer_sensitivity_compute(&problem, blend_cols, blend_rows, &solution);
+    const fertilizer_sensitivity_t *sensitivity = &solution.sensitivity;
+    cr_assert(sensitivity->valid);
+
+    // Duals per kg of N, P2O5 and K2O are the straight products' prices
+    // per kg of nutrient; shadow prices are per kg/ha over two hectares
+    double n_dual = 0.5 / 0.46;
+    double p_dual = 0.55 / 0.46;
+    double k_dual = 0.4 / 0.6;
+    cr_assert_float_eq(sensitivity->shadow_price[0], 2.0 * n_dual, 1e-9);
+    cr_assert_float_eq(sensitivity->shadow_price[1], 2.0 * p_dual, 1e-9);
+    cr_assert_float_eq(sensitivity->shadow_price[2], 2.0 * k_dual, 1e-9);
+    cr_assert_float_eq(sensitivity->shadow_price[3], 0.0, 1e-12);
+
+    double an_reduced = 0.30 - 0.34 * n_dual;
+    double npk_reduced = 0.45 - 0.15 * (n_dual + p_dual + k_dual);
+    cr_assert_float_eq(sensitivity->reduced_cost[0], 0.0, 1e-12);
+    cr_assert_float_eq(sensitivity->reduced_cost[1], an_reduced, 1e-9);
+    cr_assert_float_eq(sensitivity->reduced_cost[4], npk_reduced, 1e-9);
+
+    // AN stays at its limit up to urea's price per kg N, NPK enters once
+    // it costs what its nutrients are worth
+    cr_assert(isinf(sensitivity->price_low[1]));
+    cr_assert_float_eq(sensitivity->price_high[1], 0.34 * n_dual, 1e-9);
+    cr_assert_float_eq(sensitivity->price_low[4], 0.45 - npk_reduced, 1e-9);
+    cr_assert(isinf(sensitivity->price_high[4]));
+    // Urea until AN is cheaper per kg N or NPK becomes worth it
+    cr_assert_float_eq(sensitivity->price_low[0], 0.30 / 0.34 * 0.46, 1e-9);
+    cr_assert_float_eq(sensitivity->price_high[0], 0.5 + npk_reduced * 0.46 / 0.15, 1e-9);
+    cr_assert_float_eq(sensitivity->price_low[2], 0.0, 1e-9);
+    cr_assert_float_eq(sensitivity->price_high[3], 0.4 + npk_reduced * 0.6 / 0.15, 1e-9);
+
+    // The N minimum may fall until AN alone covers it and rise to the maximum
+    cr_assert_float_eq(sensitivity->target_low[0], 34.0, 1e-9);
+    cr_assert_float_eq(sensitivity->target_high[0], 150.0, 1e-9);
+    cr_assert_float_eq(sensitivity->target_low[1], 0.0, 1e-9);
+    cr_assert(isinf(sensitivity->target_high[1]));
+    cr_assert(isnan(sensitivity->target_low[3]));
+
+    char *text = fertilizer_format_solution(&problem, &solution);
+    cr_assert_not_null(text);
+    cr_assert_not_null(strstr(text, "\"sensitivity\":{\"products\":[{\"name\":\"Urea\",\"reduced_cost\":0,"));
+    cr_assert_not_null(strstr(text, "\"price_range\":[null,0.3695652174]"));
+    cr_assert_not_null(strstr(text, "{\"name\":\"N\",\"shadow_price\":2.173913043,\"target_range\":[34,150]}"));
+    cr_assert_not_null(strstr(text, "{\"name\":\"S\",\"shadow_price\":0,\"target_range\":null}]}}"));
+    free(text);
+
+    // A status set that is no basis leaves it invalid
+    const int rows[] = {SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER, SCIP_BASESTAT_LOWER};
+    fertilizer_sensitivity_compute(&problem, blend_cols, rows, &solution);
+    cr_assert_not(solution.sensitivity.valid);
+
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_mixing, routes_blends_to_lp_backend) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    fertilizer_ctx_t ctx;
+    fertilizer_ctx_init(&ctx);
+
+    // AUTO solves with SoPlex alone; SCIP is only created as a fallback
+    cr_assert_eq(ctx.backend, FERTILIZER_BACKEND_AUTO);
+    cr_assert_eq(fertilizer_solve(&ctx, &problem, &solution), SCIP_OKAY);
+    cr_assert_eq(solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_not_null(ctx.lpi);
+    cr_assert_null(ctx.scip);
+
+    cr_assert_eq(fertilizer_ctx_free(&ctx), SCIP_OKAY);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_mixing, finds_least_cost_blend) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    fertilizer_ctx_t ctx;
+    fertilizer_ctx_init(&ctx);
+
+    // Both backends, each twice through the same context so the second
+    // solve reuses the SCIP instance or LP
+    const fertilizer_backend_t backends[] = {FERTILIZER_BACKEND_LP, FERTILIZER_BACKEND_LP, FERTILIZER_BACKEND_SCIP,
+                                             FERTILIZER_BACKEND_SCIP};
+    for (int pass = 0; pass < 4; pass++) {
+        ctx.backend = backends[pass];
+        cr_assert_eq(fertilizer_solve(&ctx, &problem, &solution), SCIP_OKAY);
+        cr_assert_eq(solution.status, FERTILIZER_OPTIMAL);
+        cr_assert_float_eq(solution.cost, 60.0 + 132.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-4);
+        cr_assert_float_eq(solution.amounts[0], 132.0 / 0.46, 1e-4);
+        cr_assert_float_eq(solution.amounts[1], 200.0, 1e-6);
+        cr_assert_float_eq(solution.amounts[2], 80.0 / 0.46, 1e-4);
+        cr_assert_float_eq(solution.amounts[3], 200.0, 1e-4);
+        cr_assert_float_eq(solution.amounts[4], 0.0, 1e-9);
+
+        cr_assert_eq(solution.product_binding[1], FERTILIZER_BOUND_MAX);
+        cr_assert_eq(solution.product_binding[0], FERTILIZER_BOUND_NONE);
+        cr_assert_float_eq(solution.supplied[0], 100.0, 1e-6);
+        cr_assert_eq(solution.nutrient_binding[0], FERTILIZER_BOUND_MIN);
+        cr_assert_eq(solution.nutrient_binding[1], FERTILIZER_BOUND_MIN);
+        cr_assert_eq(solution.nutrient_binding[2], FERTILIZER_BOUND_MIN);
+        cr_assert_eq(solution.nutrient_binding[3], FERTILIZER_BOUND_NONE);
+    }
+    cr_assert_eq(fertilizer_ctx_free(&ctx), SCIP_OKAY);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
+
+Test(fertilizer_mixing, reports_infeasible_targets) {
+    // Potash only from MOP, and not enough of it
+    const char *short_supply =
+        "{\"nutrients\": {\"K2O\": {\"min\": 100}},"
+        " \"products\": [{\"name\": \"MOP\", \"price\": 0.4, \"composition\": {\"K2O\": 0.6}, \"available\": 50}]}";
+    char *solution = NULL;
+    char *error_msg = NULL;
+    cr_assert_eq(solve_fertilizer_mixing(short_supply, &solution, &error_msg), EXIT_FAILURE);
+    cr_assert_null(solution);
+    cr_assert_not_null(strstr(error_msg, "No blend"));
+    free(error_msg);
+
+    error_msg = NULL;
+    cr_assert_eq(solve_fertilizer_mixing(blend, &solution, &error_msg), EXIT_SUCCESS, "%s", error_msg);
+    cr_assert_not_null(strstr(solution, "\"name\":\"AN\",\"kg\":200,\"binding\":\"max\""));
+    cr_assert_not_null(strstr(solution, "\"target_range\":[34,150]"));
+    free(solution);
+    fertilizer_thread_cleanup();
+}
+
+static void update_session(fertilizer_session_t *session, const char *json) {
+    fertilizer_update_t update;
+    char *error_msg = NULL;
+    cr_assert_eq(fertilizer_parse_update(json, &session->problem, &update, &error_msg), EXIT_SUCCESS, "%s",
+                 error_msg);
+    cr_assert_eq(fertilizer_session_update(session, &update), SCIP_OKAY);
+    fertilizer_update_free(&update);
+}
+
+Test(fertilizer_session, re_solves_from_warm_basis) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_session_t session;
+    fertilizer_session_init(&session);
+    cr_assert_eq(fertilizer_session_load(&session, &problem), SCIP_OKAY);
+    cr_assert_null(problem.products);
+    cr_assert_eq(session.solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_float_eq(session.solution.cost, 60.0 + 132.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-4);
+
+    // At 0.40 AN costs more per kg N than urea, which now covers all of it
+    update_session(&session, "{\"prices\": {\"AN\": 0.40}}");
+    cr_assert_eq(session.solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_float_eq(session.solution.amounts[1], 0.0, 1e-6);
+    cr_assert_float_eq(session.solution.amounts[0], 200.0 / 0.46, 1e-4);
+    cr_assert_float_eq(session.solution.cost, 200.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-4);
+
+    // A target on a nutrient without a row at load time
+    update_session(&session, "{\"nutrients\": {\"N\": {\"min\": 120}, \"S\": {\"max\": 0}}}");
+    cr_assert_eq(session.solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_float_eq(session.solution.amounts[0], 240.0 / 0.46, 1e-4);
+    cr_assert_float_eq(session.solution.supplied[0], 120.0, 1e-6);
+
+    // Free phosphate is unbounded; the next price goes back to the last
+    // optimal basis
+    update_session(&session, "{\"prices\": {\"TSP\": -0.1}}");
+    cr_assert_eq(session.solution.status, FERTILIZER_UNBOUNDED);
+    update_session(&session, "{\"prices\": {\"TSP\": 0.55}}");
+    cr_assert_eq(session.solution.status, FERTILIZER_OPTIMAL);
+    cr_assert_float_eq(session.solution.cost, 240.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-4);
+
+    cr_assert_eq(session.stats.updates, 4);
+    cr_assert_eq(session.stats.cold, 1);
+    cr_assert_eq(session.stats.warm, 4);
+    cr_assert_eq(fertilizer_session_free(&session), SCIP_OKAY);
+}
+
+Test(fertilizer_mixing, answers_repeat_quotes_from_basis_cache) {
+    fertilizer_problem_t problem;
+    cr_assert_eq(fertilizer_parse(blend, &problem, NULL), EXIT_SUCCESS);
+    fertilizer_solution_t solution;
+    cr_assert_eq(fertilizer_solution_init(&solution, &problem), EXIT_SUCCESS);
+    fertilizer_basis_cache_t cache;
+    cr_assert_eq(fertilizer_basis_cache_init(&cache, 4), EXIT_SUCCESS);
+    fertilizer_ctx_t ctx;
+    fertilizer_ctx_init(&ctx);
+    ctx.cache = &cache;
+
+    // Solved, answered from the cache, then solved again from the cached
+    // basis once AN is too dear to stay at its limit
+    const double an_prices[] = {0.30, 0.31, 0.40};
+    const bool cached[] = {false, true, false};
+    for (int pass = 0; pass < 3; pass++) {
+        problem.products[1].price = an_prices[pass];
+        cr_assert_eq(fertilizer_solve(&ctx, &problem, &solution), SCIP_OKAY);
+        cr_assert_eq(solution.status, FERTILIZER_OPTIMAL);
+        cr_assert_eq(ctx.from_cache, cached[pass]);
+    }
+    cr_assert_float_eq(solution.amounts[1], 0.0, 1e-6);
+    cr_assert_float_eq(solution.cost, 200.0 / 0.46 * 0.5 + 80.0 / 0.46 * 0.55 + 80.0, 1e-4);
+
+    fertilizer_basis_cache_stats_t stats;
+    fertilizer_basis_cache_get_stats(&cache, &stats);
+    cr_assert_eq(stats.hits, 1);
+    cr_assert_eq(stats.warm_starts, 1);
+    cr_assert_eq(stats.insertions, 2);
+
+    cr_assert_eq(fertilizer_ctx_free(&ctx), SCIP_OKAY);
+    fertilizer_basis_cache_free(&cache);
+    fertilizer_solution_free(&solution);
+    fertilizer_problem_free(&problem);
+}
@@ -0,0 +1,62 @@
+#include "sudoku_test_grids.h"
+
+const int sudoku_test_easy[9][9] = {
+    {5, 3, 0, 0, 7, 0, 0, 0, 0},
+    {6, 0, 0, 1, 9, 5, 0, 0, 0},
+    {0, 9, 8, 0, 0, 0, 0, 6, 0},
+    {8, 0, 0, 0, 6, 0, 0, 0, 3},
+    {4, 0, 0, 8, 0, 3, 0, 0, 1},
+    {7, 0, 0, 0, 2, 0, 0, 0, 6},
+    {0, 6, 0, 0, 0, 0, 2, 8, 0},
+    {0, 0, 0, 4, 1, 9, 0, 0, 5},
+    {0, 0, 0, 0, 8, 0, 0, 7, 9}
+};
+
+const int sudoku_test_hard[9][9] = {
+    {8, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 3, 6, 0, 0, 0, 0, 0},
+    {0, 7, 0, 0, 9, 0, 2, 0, 0},
+    {0, 5, 0, 0, 0, 7, 0, 0, 0},
+    {0, 0, 0, 0, 4, 5, 7, 0, 0},
+    {0, 0, 0, 1, 0, 0, 0, 3, 0},
+    {0, 0, 1, 0, 0, 0, 0, 6, 8},
+    {0, 0, 8, 5, 0, 0, 0, 1, 0},
+    {0, 9, 0, 0, 0, 0, 4, 0, 0}
+};
+
+bool sudoku_test_is_solution(const int givens[9][9], const int grid[9][9]) {
+    for (int unit = 0; unit < 27; unit++) {
+        int seen = 0;
+        for (int k = 0; k < 9; k++) {
+            int row = unit < 9 ? unit : unit < 18 ? k : ((unit - 18) / 3) * 3 + k / 3;
+            int col = unit < 9 ? k : unit < 18 ? unit - 9 : ((unit - 18) % 3) * 3 + k % 3;
+            int value = grid[row][col];
+            if (value < 1 || value > 9 || (seen & (1 << value))) {
+                return false;
+            }
+            if (givens[row][col] && givens[row][col] != value) {
+                return false;
+            }
+            seen |= 1 << value;
+        }
+    }
+    return true;
+}
+
+bool sudoku_test_is_solution_line(const char *puzzle, const char *solution) {
+    int givens[9][9];
+    int grid[9][9];
+    for (int cell = 0; cell < 81; cell++) {
+        givens[cell / 9][cell % 9] = puzzle[cell] >= '1' && puzzle[cell] <= '9' ? puzzle[cell] - '0' : 0;
+        grid[cell / 9][cell % 9] = solution[cell] >= '1' && solution[cell] <= '9' ? solution[cell] - '0' : 0;
+    }
+    return sudoku_test_is_solution((const int (*)[9])givens, (const int (*)[9])grid);
+}
+
+void sudoku_test_copy_grid(int dst[9][9], const int src[9][9]) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            dst[i][j] = src[i][j];
+        }
+    }
+}
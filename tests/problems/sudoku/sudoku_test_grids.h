@@ -0,0 +1,20 @@
+#ifndef SUDOKU_TEST_GRIDS_H
+#define SUDOKU_TEST_GRIDS_H
+
+#include <stdbool.h>
+
+// Puzzles and checks shared by the Sudoku tests
+
+// Solved by naked and hidden singles alone
+extern const int sudoku_test_easy[9][9];
+// Needs search, singles alone do not solve it
+extern const int sudoku_test_hard[9][9];
+
+// Whether grid is a complete solution that keeps every given
+bool sudoku_test_is_solution(const int givens[9][9], const int grid[9][9]);
+// Same for 81-character lines; givens are the digits 1-9 of puzzle
+bool sudoku_test_is_solution_line(const char *puzzle, const char *solution);
+
+void sudoku_test_copy_grid(int dst[9][9], const int src[9][9]);
+
+#endif
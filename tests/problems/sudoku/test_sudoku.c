@@ -1,5 +1,11 @@
 #include <criterion/criterion.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
 #include "../include/problems/sudoku/sudoku_solver.h"
+#include "../include/problems/sudoku/sudoku_cache.h"
+#include "../include/problems/sudoku/sudoku_portfolio.h"
+#include "../include/problems/sudoku/sudoku_verify.h"
 
 Test(sudoku, test_puzzle_creation) {
     int expected[9][9] = {
@@ -14,28 +20,32 @@ Test(sudoku, test_puzzle_creation) {
         {0, 0, 0, 0, 8, 0, 0, 7, 9}
     };
     
-    create_puzzle();
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    create_puzzle(&ctx);
     
     // Verify puzzle initialization
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
-            cr_assert_eq(puzzle[i][j], expected[i][j], 
+            cr_assert_eq(ctx.puzzle.cells[i * 9 + j], expected[i][j], 
                         "Mismatch at [%d][%d]: expected %d, got %d", 
-                        i, j, expected[i][j], puzzle[i][j]);
+                        i, j, expected[i][j], ctx.puzzle.cells[i * 9 + j]);
         }
     }
 }
 
 Test(sudoku, test_solution) {
     SCIP_RETCODE retcode;
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
     
     // Initialize puzzle
     printf("Creating puzzle...\n");
-    create_puzzle();
+    create_puzzle(&ctx);
     
     // Initialize model with error checking
     printf("Initializing model...\n");
-    retcode = init_model();
+    retcode = init_model(&ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Failed to initialize model: %d\n", retcode);
         cr_assert_fail("Failed to initialize model");
@@ -43,37 +53,37 @@ Test(sudoku, test_solution) {
 
     // Add variables to the model
     printf("Adding variables to model...\n");
-    retcode = add_variables();
+    retcode = add_variables(&ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Failed to add variables: %d\n", retcode);
-        free_model();
+        free_model(&ctx);
         cr_assert_fail("Failed to add variables");
     }
     
     // Create constraints
     printf("Creating constraints...\n");
-    retcode = create_constraints();
+    retcode = create_constraints(&ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Failed to create constraints: %d\n", retcode);
-        free_model();
+        free_model(&ctx);
         cr_assert_fail("Failed to create constraints");
     }
     
     // Fix variables based on the puzzle
     printf("Fixing variables...\n");
-    retcode = fix_variables();
+    retcode = fix_variables(&ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Failed to fix variables: %d\n", retcode);
-        free_model();
+        free_model(&ctx);
         cr_assert_fail("Failed to fix variables");
     }
     
     // Solve the puzzle with error checking
     printf("Solving puzzle...\n");
-    retcode = solve();
+    retcode = solve(&ctx);
     if (retcode != SCIP_OKAY) {
         fprintf(stderr, "Failed to solve puzzle: %d\n", retcode);
-        free_model();
+        free_model(&ctx);
         cr_assert_fail("Failed to solve puzzle");
     }
     
@@ -82,14 +92,14 @@ Test(sudoku, test_solution) {
     
     // Print the solution for debugging
     printf("Solution found:\n");
-    print_solution();
+    print_solution(&ctx);
     
     // Check that the solution is valid
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
-            if (puzzle[i][j] < 1 || puzzle[i][j] > 9) {
-                fprintf(stderr, "Invalid value at [%d][%d]: %d\n", i, j, puzzle[i][j]);
-                free_model();
+            if (ctx.puzzle.cells[i * 9 + j] < 1 || ctx.puzzle.cells[i * 9 + j] > 9) {
+                fprintf(stderr, "Invalid value at [%d][%d]: %d\n", i, j, ctx.puzzle.cells[i * 9 + j]);
+                free_model(&ctx);
                 cr_assert_fail("Invalid solution found");
             }
         }
@@ -97,6 +107,413 @@ Test(sudoku, test_solution) {
     
     // Clean up
     printf("Cleaning up...\n");
-    free_model();
+    free_model(&ctx);
     printf("Test completed successfully\n");
-}
\ No newline at end of file
+}
+
+static void *solve_in_thread(void *arg) {
+    // Drives the SCIP model directly so the native fast path is bypassed
+    sudoku_ctx_t *ctx = arg;
+    create_puzzle(ctx);
+    SCIP_RETCODE retcode = prepare_model(ctx);
+    if (retcode == SCIP_OKAY) {
+        retcode = fix_variables(ctx);
+    }
+    if (retcode == SCIP_OKAY) {
+        retcode = solve(ctx);
+    }
+    return (void *)(intptr_t)retcode;
+}
+
+Test(sudoku, test_independent_contexts) {
+    // Two contexts solved concurrently must not interfere with each other
+    sudoku_ctx_t ctx[2];
+    pthread_t threads[2];
+
+    for (int t = 0; t < 2; t++) {
+        sudoku_ctx_init(&ctx[t]);
+        cr_assert_eq(pthread_create(&threads[t], NULL, solve_in_thread, &ctx[t]), 0);
+    }
+    for (int t = 0; t < 2; t++) {
+        void *retcode = NULL;
+        pthread_join(threads[t], &retcode);
+        cr_assert_eq((intptr_t)retcode, SCIP_OKAY, "Context %d failed to solve", t);
+    }
+
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            cr_assert_eq(ctx[0].puzzle.cells[i * 9 + j], ctx[1].puzzle.cells[i * 9 + j]);
+        }
+    }
+    cr_assert(sudoku_verify_grid((const int (*)[9])sudoku_grid_rows(&ctx[0].puzzle)), "Every row, column and box must hold 1-9 once");
+
+    sudoku_ctx_free(&ctx[0]);
+    sudoku_ctx_free(&ctx[1]);
+}
+
+Test(sudoku, test_native_fast_path) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    create_puzzle(&ctx);
+
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert(ctx.solved_natively, "Easy puzzle should not need SCIP");
+    cr_assert_null(ctx.scip, "SCIP model should not have been built");
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+    sudoku_ctx_free(&ctx);
+}
+
+Test(sudoku, test_solve_from_input) {
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+
+    int retcode = solve_sudoku_with_options(
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+        NULL, solution, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+    cr_assert_str_eq(solution, "534678912672195348198342567859761423426853791713924856961537284287419635345286179");
+
+    // Duplicate givens are rejected before solving
+    retcode = solve_sudoku("55..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79", &error_msg);
+    cr_assert_eq(retcode, EXIT_FAILURE);
+    cr_assert_not_null(error_msg);
+    free(error_msg);
+
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_solution_cache) {
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+    sudoku_cache_t *cache = sudoku_solution_cache();
+    cr_assert_not_null(cache);
+    sudoku_cache_clear(cache);
+
+    int retcode = solve_sudoku_with_options(
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+        NULL, solution, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+
+    // Relabeled, permuted and transposed copy of the same puzzle
+    retcode = solve_sudoku_with_options(
+        ".....6......85.126.8..94....3.......5.4...789.62..8...1..7..6..4..5..9..7.642..38",
+        NULL, solution, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+    cr_assert_str_eq(solution, "275316894349857126681294375837945261514632789962178453153789642428563917796421538");
+
+    sudoku_cache_stats_t stats;
+    sudoku_cache_get_stats(cache, &stats);
+    cr_assert_eq(stats.misses, 1);
+    cr_assert_eq(stats.hits, 1);
+    cr_assert_eq(stats.entries, 1);
+
+    sudoku_cache_clear(cache);
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_complete_grid_skips_cache) {
+    const char *complete = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+    sudoku_cache_t *cache = sudoku_solution_cache();
+    cr_assert_not_null(cache);
+    sudoku_cache_clear(cache);
+
+    cr_assert_eq(solve_sudoku_with_options(complete, NULL, solution, &error_msg), EXIT_SUCCESS);
+    cr_assert_str_eq(solution, complete);
+
+    // One blank short of complete takes the same path
+    char nearly[SUDOKU_PUZZLE_LEN + 1];
+    memcpy(nearly, complete, sizeof(nearly));
+    nearly[40] = '.';
+    cr_assert_eq(solve_sudoku_with_options(nearly, NULL, solution, &error_msg), EXIT_SUCCESS);
+    cr_assert_str_eq(solution, complete);
+
+    sudoku_cache_stats_t stats;
+    sudoku_cache_get_stats(cache, &stats);
+    cr_assert_eq(stats.hits, 0);
+    cr_assert_eq(stats.misses, 0);
+    cr_assert_eq(stats.entries, 0);
+
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_setppc_formulation) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    ctx.options.formulation = SUDOKU_FORMULATION_SETPPC;
+    create_puzzle(&ctx);
+
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert(ctx.has_solution);
+    cr_assert_eq(ctx.model_formulation, SUDOKU_FORMULATION_SETPPC);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+    sudoku_ctx_free(&ctx);
+}
+
+Test(sudoku, test_alldiff_formulation) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    ctx.options.formulation = SUDOKU_FORMULATION_ALLDIFF;
+    create_puzzle(&ctx);
+
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert(ctx.has_solution);
+    cr_assert_eq(ctx.model_formulation, SUDOKU_FORMULATION_ALLDIFF);
+    cr_assert_eq(ctx.model_conss, 27 + 81, "One constraint per unit and per cell");
+    cr_assert_null(ctx.row_constrs[0]);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+    // Reduced model: given cells reach the handler as givens
+    ctx.options.reduced_model = true;
+    create_puzzle(&ctx);
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert(ctx.has_solution);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+    sudoku_ctx_free(&ctx);
+}
+
+Test(sudoku, test_portfolio_race) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    ctx.options.engine = SUDOKU_ENGINE_PORTFOLIO;
+    sudoku_portfolio_reset_stats();
+
+    for (int round = 0; round < 3; round++) {
+        create_puzzle(&ctx);
+        cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+        cr_assert(ctx.has_solution);
+        cr_assert(ctx.race_winner == SUDOKU_ENGINE_NATIVE || ctx.race_winner == SUDOKU_ENGINE_SCIP);
+        cr_assert_eq(ctx.solved_natively, ctx.race_winner == SUDOKU_ENGINE_NATIVE);
+        cr_assert_eq(ctx.puzzle.cells[2], 4);
+        cr_assert_not(atomic_load(&ctx.scip_cancel), "A lost race must not leak into the next solve");
+    }
+
+    // The sample puzzle has 30 givens
+    sudoku_portfolio_stats_t stats;
+    sudoku_portfolio_get_stats(&stats);
+    const sudoku_portfolio_class_stats_t *typical = &stats.classes[SUDOKU_CLASS_TYPICAL];
+    cr_assert_eq(typical->races, 3);
+    cr_assert_eq(typical->native_wins + typical->scip_wins, 3);
+    cr_assert_eq(stats.classes[SUDOKU_CLASS_SPARSE].races, 0);
+
+    // The model template survives a lost race
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    create_puzzle(&ctx);
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+    sudoku_ctx_free(&ctx);
+}
+
+Test(sudoku, test_native_limits) {
+    static const char *hard = "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+    static const char *givens = "800000000003600000070090200050007000000045700000100030001000068008500010090000400";
+    static const sudoku_engine_t engines[] = {SUDOKU_ENGINE_NATIVE, SUDOKU_ENGINE_DLX};
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+
+    // The request node limit caps the native budget: one node cannot settle
+    // this grid, so the answer is the limit with the givens as proven cells
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        sudoku_options_t options;
+        sudoku_default_options(&options);
+        options.engine = engines[e];
+        options.use_cache = false;
+        options.node_limit = 1;
+
+        sudoku_solve_info_t info;
+        int retcode = solve_sudoku_with_info(hard, &options, solution, &info, &error_msg);
+        cr_assert_eq(retcode, SUDOKU_LIMIT_REACHED);
+        cr_assert(info.limit_reached);
+        cr_assert_str_eq(solution, givens);
+        cr_assert_not_null(error_msg);
+        free(error_msg);
+        error_msg = NULL;
+    }
+
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_scip_limits) {
+    static const char *hard = "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+    static const char *answer = "812753649943682175675491283154237896369845721287169534521974368438526917796318452";
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.engine = SUDOKU_ENGINE_SCIP;
+    options.use_cache = false;
+    options.node_limit = 1;
+
+    // Stopping leaves the model template in SCIP's stopped stage
+    sudoku_solve_info_t info;
+    solve_sudoku_with_info(hard, &options, solution, &info, &error_msg);
+    free(error_msg);
+    error_msg = NULL;
+
+    // The limits are reset on the kept model template
+    options.node_limit = 0;
+    int retcode = solve_sudoku_with_info(hard, &options, solution, &info, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+    cr_assert_not(info.limit_reached);
+    cr_assert_str_eq(solution, answer);
+
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_reduced_model) {
+    sudoku_ctx_t ctx;
+    sudoku_ctx_init(&ctx);
+    create_puzzle(&ctx);
+
+    SCIP_Bool solved[9][9];
+    cr_assert_eq(build_reduced_model(&ctx), SCIP_OKAY);
+    cr_assert_gt(ctx.model_vars, 0);
+    cr_assert_lt(ctx.model_vars, 729 / 2, "Givens should eliminate most variables");
+    cr_assert_lt(ctx.model_conss, 4 * 81);
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            solved[i][j] = ctx.puzzle.cells[i * 9 + j] > 0;
+            for (int k = 0; k < 9; k++) {
+                if (solved[i][j]) {
+                    cr_assert_null(ctx.vars[(i * 9 + j) * 9 + k], "Given cells need no variables");
+                }
+            }
+        }
+    }
+
+    cr_assert_eq(solve(&ctx), SCIP_OKAY);
+    cr_assert(ctx.has_solution);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+    cr_assert_eq(free_model(&ctx), SCIP_OKAY);
+
+    // Same answer through solve_puzzle()
+    ctx.options.engine = SUDOKU_ENGINE_SCIP;
+    ctx.options.reduced_model = true;
+    create_puzzle(&ctx);
+    cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+    cr_assert_eq(ctx.puzzle.cells[2], 4);
+    cr_assert_null(ctx.scip, "Reduced model should not be kept");
+
+    sudoku_ctx_free(&ctx);
+}
+
+Test(sudoku, test_solution_count) {
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+    int count = -1;
+
+    int retcode = solve_sudoku_count(
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+        NULL, solution, &count, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+    cr_assert_eq(count, 1);
+    cr_assert_str_eq(solution, "534678912672195348198342567859761423426853791713924856961537284287419635345286179");
+
+    // Without its first row the puzzle is no longer unique
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.solution_cap = 2;
+    options.count_threads = 4;
+    retcode = solve_sudoku_count(
+        ".........6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+        &options, solution, &count, &error_msg);
+    cr_assert_eq(retcode, EXIT_SUCCESS);
+    cr_assert_eq(count, 2);
+
+    sudoku_thread_cleanup();
+}
+
+Test(sudoku, test_count_budget) {
+    char solution[SUDOKU_PUZZLE_LEN + 1];
+    char *error_msg = NULL;
+    int count = -1;
+
+    // The native budget bounds counting under every engine, AUTO included
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.solution_cap = 2;
+    options.native_node_limit = 1;
+    options.native_time_limit = 0.0;
+    options.use_cache = false;
+    int retcode = solve_sudoku_count(
+        ".................................................................................",
+        &options, solution, &count, &error_msg);
+    cr_assert_eq(retcode, SUDOKU_LIMIT_REACHED);
+    cr_assert_lt(count, 2);
+    free(error_msg);
+
+    sudoku_thread_cleanup();
+}
+
+// Valid solved grid of the given order: shifted rows, one band per box row
+static int pattern(int order, int row, int col) {
+    int size = order * order;
+    return ((row % order) * order + row / order + col) % size + 1;
+}
+
+Test(sudoku, test_larger_orders) {
+    for (int order = 4; order <= 5; order++) {
+        sudoku_ctx_t ctx;
+        sudoku_ctx_init(&ctx);
+        cr_assert(sudoku_grid_init(&ctx.puzzle, order));
+        int size = ctx.puzzle.size;
+        for (int cell = 0; cell < size * size; cell++) {
+            ctx.puzzle.cells[cell] = cell % 2 == 0 ? 0 : pattern(order, cell / size, cell % size);
+        }
+
+        // Goes straight to the SCIP model, sized for the order
+        cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+        cr_assert(ctx.has_solution);
+        cr_assert_not(ctx.solved_natively);
+        cr_assert_eq(ctx.model_size, size);
+        cr_assert(sudoku_grid_consistent(&ctx.puzzle));
+        for (int cell = 0; cell < size * size; cell++) {
+            cr_assert_neq(ctx.puzzle.cells[cell], 0);
+        }
+
+        // A 9x9 puzzle afterwards rebuilds the template
+        create_puzzle(&ctx);
+        ctx.options.engine = SUDOKU_ENGINE_SCIP;
+        cr_assert_eq(solve_puzzle(&ctx), SCIP_OKAY);
+        cr_assert_eq(ctx.model_size, 9);
+        cr_assert_eq(ctx.puzzle.cells[2], 4);
+
+        sudoku_ctx_free(&ctx);
+    }
+}
+
+Test(sudoku, test_solve_grid) {
+    sudoku_grid_t puzzle;
+    char *solution = NULL;
+    char *error_msg = NULL;
+
+    cr_assert_eq(sudoku_parse_grid("12....3...4.....", &puzzle), SUDOKU_PARSE_OK);
+    cr_assert_eq(solve_sudoku_grid(&puzzle, NULL, &solution, NULL, &error_msg), EXIT_FAILURE);
+    cr_assert_not_null(error_msg);
+    free(error_msg);
+    error_msg = NULL;
+
+    cr_assert_eq(sudoku_parse_grid("1.34.412214.4.21", &puzzle), SUDOKU_PARSE_OK);
+    cr_assert_eq(solve_sudoku_grid(&puzzle, NULL, &solution, NULL, &error_msg), EXIT_SUCCESS);
+    cr_assert_str_eq(solution, "1234341221434321");
+    free(solution);
+    solution = NULL;
+
+    // Counting needs the 9x9 engines
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.solution_cap = 2;
+    cr_assert_eq(solve_sudoku_grid(&puzzle, &options, &solution, NULL, &error_msg), EXIT_FAILURE);
+    cr_assert_null(solution);
+    cr_assert_not_null(error_msg);
+    free(error_msg);
+
+    sudoku_thread_cleanup();
+}
@@ -0,0 +1,63 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_batch.h"
+#include "sudoku_test_grids.h"
+
+static const char *records[] = {
+    "530070000600195000098000060800060003400803001700020006060000280000419005000080079",
+    "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+    "53x070000600195000098000060800060003400803001700020006060000280000419005000080079",
+    "535070000600195000098000060800060003400803001700020006060000280000419005000080079"
+};
+static const sudoku_batch_status_t expected[] = {
+    SUDOKU_BATCH_SOLVED,
+    SUDOKU_BATCH_SOLVED,
+    SUDOKU_BATCH_INVALID,
+    SUDOKU_BATCH_INFEASIBLE
+};
+
+Test(sudoku_batch, solves_mixed_batch) {
+    const size_t count = 1000;
+    char *puzzles = malloc(count * SUDOKU_PUZZLE_LEN);
+    char *solutions = malloc(count * SUDOKU_PUZZLE_LEN);
+    sudoku_batch_status_t *status = malloc(count * sizeof(*status));
+    cr_assert(puzzles && solutions && status);
+
+    for (size_t n = 0; n < count; n++) {
+        memcpy(puzzles + n * SUDOKU_PUZZLE_LEN, records[n % 4], SUDOKU_PUZZLE_LEN);
+    }
+
+    sudoku_batch_config_t config;
+    sudoku_batch_default_config(&config);
+    config.threads = 4;
+    sudoku_batch_stats_t stats;
+
+    cr_assert_eq(solve_sudoku_batch(puzzles, count, solutions, status, &config, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.solved, count / 2);
+    cr_assert_eq(stats.invalid, count / 4);
+    cr_assert_eq(stats.infeasible, count / 4);
+    cr_assert_eq(stats.failed, 0);
+    cr_assert_gt(stats.puzzles_per_second, 0.0);
+
+    for (size_t n = 0; n < count; n++) {
+        const char *puzzle = puzzles + n * SUDOKU_PUZZLE_LEN;
+        const char *solution = solutions + n * SUDOKU_PUZZLE_LEN;
+        cr_assert_eq(status[n], expected[n % 4], "Unexpected status for puzzle %zu", n);
+        if (status[n] == SUDOKU_BATCH_SOLVED) {
+            cr_assert(sudoku_test_is_solution_line(puzzle, solution), "Invalid solution for puzzle %zu", n);
+        } else {
+            cr_assert_eq(memcmp(puzzle, solution, SUDOKU_PUZZLE_LEN), 0);
+        }
+    }
+
+    free(puzzles);
+    free(solutions);
+    free(status);
+}
+
+Test(sudoku_batch, empty_batch) {
+    sudoku_batch_stats_t stats;
+    cr_assert_eq(solve_sudoku_batch(NULL, 0, NULL, NULL, NULL, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.solved, 0);
+}
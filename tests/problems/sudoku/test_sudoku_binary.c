@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/problems/sudoku/sudoku_binary.h"
+
+static const char *puzzle = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+static const char *dotted = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+static void temp_path(char *path, size_t len, const char *name) {
+    snprintf(path, len, "/tmp/test_sudoku_binary_%ld_%s", (long)getpid(), name);
+}
+
+// count copies of puzzle with a few cells varied per record
+static char *make_records(size_t count) {
+    char *records = malloc(count * 81);
+    cr_assert_not_null(records);
+    for (size_t n = 0; n < count; n++) {
+        memcpy(records + n * 81, puzzle, 81);
+        records[n * 81 + n % 81] = (char)('0' + n % 10);
+    }
+    return records;
+}
+
+Test(sudoku_binary, packs_two_cells_per_byte) {
+    uint8_t packed[SUDOKU_PACKED_LEN];
+    cr_assert(sudoku_pack_cells(puzzle, 81, packed));
+    cr_assert_eq(packed[0], 0x35);
+    cr_assert_eq(packed[40], 0x09, "The odd last cell takes a low nibble");
+
+    uint8_t dots[SUDOKU_PACKED_LEN];
+    cr_assert(sudoku_pack_cells(dotted, 81, dots));
+    cr_assert_eq(memcmp(packed, dots, sizeof(packed)), 0, "'.' and '0' are both empty");
+
+    char text[82] = {0};
+    sudoku_unpack_cells(packed, 81, text);
+    cr_assert_str_eq(text, puzzle);
+
+    char bad[82];
+    memcpy(bad, puzzle, sizeof(bad));
+    for (int cell = 0; cell < 81; cell += 13) {
+        bad[cell] = 'x';
+        cr_assert_not(sudoku_pack_cells(bad, 81, packed), "Cell %d", cell);
+        bad[cell] = puzzle[cell];
+    }
+}
+
+Test(sudoku_binary, encodes_and_decodes_buffers) {
+    enum { COUNT = 1000 };
+    char *records = make_records(COUNT);
+
+    for (int compress = 0; compress < 2; compress++) {
+        uint8_t *data;
+        size_t len;
+        cr_assert_eq(sudoku_binary_encode(records, COUNT, 3, compress, &data, &len), EXIT_SUCCESS);
+        if (!compress) {
+            cr_assert_eq(len, SUDOKU_BINARY_HEADER_SIZE + COUNT * SUDOKU_PACKED_LEN);
+        } else {
+            cr_assert_lt(len, SUDOKU_BINARY_HEADER_SIZE + COUNT * SUDOKU_PACKED_LEN / 4);
+        }
+
+        sudoku_binary_header_t header;
+        cr_assert(sudoku_binary_decode_header(data, &header));
+        cr_assert_eq(header.order, 3);
+        cr_assert_eq(header.count, COUNT);
+        cr_assert_eq(header.record_bytes, SUDOKU_PACKED_LEN);
+        cr_assert_eq(header.flags, compress ? SUDOKU_BINARY_COMPRESSED : 0);
+
+        char *decoded;
+        size_t count;
+        int order;
+        cr_assert_eq(sudoku_binary_decode(data, len, &decoded, &count, &order), EXIT_SUCCESS);
+        cr_assert_eq(count, COUNT);
+        cr_assert_eq(order, 3);
+        cr_assert_eq(memcmp(decoded, records, COUNT * 81), 0);
+        free(decoded);
+
+        // A flipped payload bit fails the checksum or the inflate
+        data[len - 5] ^= 0x10;
+        cr_assert_eq(sudoku_binary_decode(data, len, &decoded, &count, &order), EXIT_FAILURE);
+        cr_assert_null(decoded);
+        cr_assert_eq(sudoku_binary_decode(data, len - 1, &decoded, &count, &order), EXIT_FAILURE);
+        free(data);
+    }
+
+    uint8_t *data;
+    size_t len;
+    cr_assert_eq(sudoku_binary_encode(records, COUNT, 4, false, &data, &len), EXIT_FAILURE,
+                 "16x16 digits do not fit in 4 bits");
+    free(records);
+}
+
+Test(sudoku_binary, streams_files_in_chunks) {
+    char path[128];
+    temp_path(path, sizeof(path), "records.sdkb");
+    // Several chunks with a partial last one
+    size_t total = 2 * SUDOKU_BINARY_CHUNK + 123;
+    char *records = make_records(total);
+
+    for (int compress = 0; compress < 2; compress++) {
+        sudoku_binary_writer_t writer;
+        cr_assert_eq(sudoku_binary_writer_open(&writer, path, 3, compress), EXIT_SUCCESS);
+        cr_assert_eq(sudoku_binary_write(&writer, records, 1000), EXIT_SUCCESS);
+        cr_assert_eq(sudoku_binary_write(&writer, records + 1000 * 81, total - 1000), EXIT_SUCCESS);
+        cr_assert_eq(sudoku_binary_writer_close(&writer), EXIT_SUCCESS);
+        cr_assert(sudoku_binary_file_detect(path));
+
+        sudoku_binary_reader_t reader;
+        sudoku_binary_header_t header;
+        cr_assert_eq(sudoku_binary_reader_open(&reader, path, &header), EXIT_SUCCESS);
+        cr_assert_eq(header.count, total);
+
+        char *read = malloc(total * 81);
+        size_t done = 0;
+        size_t got;
+        while ((got = sudoku_binary_read(&reader, read + done * 81, 777)) > 0) {
+            done += got;
+        }
+        cr_assert_not(reader.failed);
+        cr_assert_eq(done, total);
+        cr_assert_eq(memcmp(read, records, total * 81), 0);
+        cr_assert_eq(sudoku_binary_reader_close(&reader), EXIT_SUCCESS);
+        free(read);
+    }
+
+    // Invalid characters fail the write and the file
+    sudoku_binary_writer_t writer;
+    cr_assert_eq(sudoku_binary_writer_open(&writer, path, 3, false), EXIT_SUCCESS);
+    records[5] = '?';
+    cr_assert_eq(sudoku_binary_write(&writer, records, 10), EXIT_FAILURE);
+    cr_assert_eq(sudoku_binary_writer_close(&writer), EXIT_FAILURE);
+
+    free(records);
+    unlink(path);
+}
+
+Test(sudoku_binary, converts_line_files) {
+    char text_path[128];
+    char binary_path[128];
+    char back_path[128];
+    temp_path(text_path, sizeof(text_path), "in.txt");
+    temp_path(binary_path, sizeof(binary_path), "in.sdkb");
+    temp_path(back_path, sizeof(back_path), "back.txt");
+
+    FILE *text = fopen(text_path, "wb");
+    cr_assert_not_null(text);
+    fprintf(text, "%s\r\n\n%s\n%s", puzzle, dotted, puzzle);
+    fclose(text);
+
+    size_t count;
+    cr_assert_eq(sudoku_binary_pack_file(text_path, binary_path, true, &count), EXIT_SUCCESS);
+    cr_assert_eq(count, 3);
+    cr_assert_not(sudoku_binary_file_detect(text_path));
+    cr_assert_eq(sudoku_binary_unpack_file(binary_path, back_path, &count), EXIT_SUCCESS);
+    cr_assert_eq(count, 3);
+
+    FILE *back = fopen(back_path, "rb");
+    cr_assert_not_null(back);
+    char line[128];
+    for (int n = 0; n < 3; n++) {
+        cr_assert_not_null(fgets(line, sizeof(line), back));
+        line[strcspn(line, "\n")] = '\0';
+        cr_assert_str_eq(line, puzzle, "Line %d", n);
+    }
+    cr_assert_null(fgets(line, sizeof(line), back));
+    fclose(back);
+
+    // Truncated payloads are reported
+    cr_assert_eq(truncate(binary_path, SUDOKU_BINARY_HEADER_SIZE + 10), 0);
+    cr_assert_eq(sudoku_binary_unpack_file(binary_path, back_path, &count), EXIT_FAILURE);
+
+    unlink(text_path);
+    unlink(binary_path);
+    unlink(back_path);
+}
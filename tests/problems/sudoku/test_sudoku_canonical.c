@@ -0,0 +1,113 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_cache.h"
+#include "../include/problems/sudoku/sudoku_canonical.h"
+#include "../include/problems/sudoku/sudoku_parser.h"
+
+static const char *puzzle_line = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+static const char *solution_line = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+static void parse_grid(const char *line, int grid[9][9]) {
+    for (int cell = 0; cell < 81; cell++) {
+        grid[cell / 9][cell % 9] = line[cell] - '0';
+    }
+}
+
+// Relabels digits, swaps bands, rows and columns, then transposes
+static void scramble(const int in[9][9], int out[9][9]) {
+    static const int digits[10] = {0, 7, 3, 9, 1, 5, 8, 2, 6, 4};
+    static const int rows[9] = {7, 6, 8, 1, 0, 2, 4, 5, 3};
+    static const int cols[9] = {2, 0, 1, 6, 8, 7, 3, 5, 4};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            out[j][i] = digits[in[rows[i]][cols[j]]];
+        }
+    }
+}
+
+Test(sudoku_canonical, symmetric_puzzles_share_canonical_form) {
+    int puzzle[9][9];
+    int scrambled[9][9];
+    int canonical[9][9];
+    int other[9][9];
+    parse_grid(puzzle_line, puzzle);
+    scramble((const int (*)[9])puzzle, scrambled);
+
+    sudoku_canonicalize((const int (*)[9])puzzle, canonical, NULL);
+    sudoku_canonicalize((const int (*)[9])scrambled, other, NULL);
+    cr_assert_eq(memcmp(canonical, other, sizeof(canonical)), 0);
+
+    // A different puzzle lands elsewhere
+    puzzle[0][0] = 0;
+    sudoku_canonicalize((const int (*)[9])puzzle, other, NULL);
+    cr_assert_neq(memcmp(canonical, other, sizeof(canonical)), 0);
+}
+
+Test(sudoku_canonical, transform_maps_solution_both_ways) {
+    int puzzle[9][9];
+    int solution[9][9];
+    int scrambled[9][9];
+    int scrambled_solution[9][9];
+    parse_grid(puzzle_line, puzzle);
+    parse_grid(solution_line, solution);
+    scramble((const int (*)[9])puzzle, scrambled);
+    scramble((const int (*)[9])solution, scrambled_solution);
+
+    int canonical[9][9];
+    int mapped[9][9];
+    int back[9][9];
+    sudoku_transform_t transform;
+    sudoku_canonicalize((const int (*)[9])scrambled, canonical, &transform);
+
+    // The transform reproduces the canonical grid and round-trips
+    sudoku_transform_apply(&transform, (const int (*)[9])scrambled, mapped);
+    cr_assert_eq(memcmp(mapped, canonical, sizeof(mapped)), 0);
+    sudoku_transform_invert(&transform, (const int (*)[9])canonical, back);
+    cr_assert_eq(memcmp(back, scrambled, sizeof(back)), 0);
+
+    // The solution of the original puzzle, carried through canonical form,
+    // solves the scrambled one
+    sudoku_transform_t original;
+    sudoku_canonicalize((const int (*)[9])puzzle, canonical, &original);
+    sudoku_transform_apply(&original, (const int (*)[9])solution, mapped);
+    sudoku_transform_invert(&transform, (const int (*)[9])mapped, back);
+    cr_assert_eq(memcmp(back, scrambled_solution, sizeof(back)), 0);
+}
+
+Test(sudoku_cache, evicts_least_recently_used) {
+    sudoku_cache_t cache;
+    cr_assert_eq(sudoku_cache_init(&cache, 2), EXIT_SUCCESS);
+
+    char keys[3][SUDOKU_PUZZLE_LEN];
+    char values[3][SUDOKU_PUZZLE_LEN];
+    for (int k = 0; k < 3; k++) {
+        memset(keys[k], '1' + k, SUDOKU_PUZZLE_LEN);
+        memset(values[k], 'a' + k, SUDOKU_PUZZLE_LEN);
+    }
+    char out[SUDOKU_PUZZLE_LEN];
+
+    sudoku_cache_insert(&cache, keys[0], values[0]);
+    sudoku_cache_insert(&cache, keys[1], values[1]);
+    cr_assert(sudoku_cache_lookup(&cache, keys[0], out));
+    cr_assert_eq(memcmp(out, values[0], SUDOKU_PUZZLE_LEN), 0);
+
+    // keys[1] is now the least recently used
+    sudoku_cache_insert(&cache, keys[2], values[2]);
+    cr_assert_not(sudoku_cache_lookup(&cache, keys[1], out));
+    cr_assert(sudoku_cache_lookup(&cache, keys[0], out));
+    cr_assert(sudoku_cache_lookup(&cache, keys[2], out));
+    cr_assert_eq(memcmp(out, values[2], SUDOKU_PUZZLE_LEN), 0);
+
+    sudoku_cache_stats_t stats;
+    sudoku_cache_get_stats(&cache, &stats);
+    cr_assert_eq(stats.hits, 3);
+    cr_assert_eq(stats.misses, 1);
+    cr_assert_eq(stats.insertions, 3);
+    cr_assert_eq(stats.evictions, 1);
+    cr_assert_eq(stats.entries, 2);
+
+    sudoku_cache_clear(&cache);
+    cr_assert_not(sudoku_cache_lookup(&cache, keys[0], out));
+    sudoku_cache_free(&cache);
+}
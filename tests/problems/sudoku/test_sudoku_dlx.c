@@ -0,0 +1,51 @@
+#include <criterion/criterion.h>
+#include "../include/problems/sudoku/sudoku_dlx.h"
+#include "sudoku_test_grids.h"
+
+Test(sudoku_dlx, solves_easy_puzzle) {
+    int grid[9][9];
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+
+    cr_assert_eq(sudoku_dlx_solve(grid, NULL, NULL), SUDOKU_NATIVE_SOLVED);
+    cr_assert(sudoku_test_is_solution(sudoku_test_easy, (const int (*)[9])grid));
+}
+
+Test(sudoku_dlx, solves_hard_puzzle) {
+    int grid[9][9];
+    sudoku_native_stats_t stats;
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+
+    cr_assert_eq(sudoku_dlx_solve(grid, NULL, &stats), SUDOKU_NATIVE_SOLVED);
+    cr_assert_gt(stats.nodes, 0);
+    cr_assert(sudoku_test_is_solution(sudoku_test_hard, (const int (*)[9])grid));
+}
+
+Test(sudoku_dlx, solves_empty_grid) {
+    int grid[9][9] = {{0}};
+    int givens[9][9] = {{0}};
+
+    cr_assert_eq(sudoku_dlx_solve(grid, NULL, NULL), SUDOKU_NATIVE_SOLVED);
+    cr_assert(sudoku_test_is_solution((const int (*)[9])givens, (const int (*)[9])grid));
+}
+
+Test(sudoku_dlx, detects_infeasible_puzzle) {
+    int grid[9][9];
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+    grid[0][2] = 5;  // Duplicate 5 in the first row
+    cr_assert_eq(sudoku_dlx_solve(grid, NULL, NULL), SUDOKU_NATIVE_INFEASIBLE);
+
+    // No clash between givens, but (0,0) has no candidate left
+    int empty[9][9] = {{0, 1, 2, 3, 4, 5, 6, 7, 8}};
+    empty[4][0] = 9;
+    cr_assert_eq(sudoku_dlx_solve(empty, NULL, NULL), SUDOKU_NATIVE_INFEASIBLE);
+    cr_assert_eq(empty[0][0], 0, "Grid must be left untouched");
+}
+
+Test(sudoku_dlx, stops_at_node_limit) {
+    int grid[9][9];
+    sudoku_native_limits_t limits = {.node_limit = 3, .time_limit = 0.0};
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+
+    cr_assert_eq(sudoku_dlx_solve(grid, &limits, NULL), SUDOKU_NATIVE_LIMIT_REACHED);
+    cr_assert_eq(grid[0][1], 0, "Grid must be left untouched");
+}
@@ -0,0 +1,135 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_generator.h"
+#include "../include/problems/sudoku/sudoku_parser.h"
+#include "../include/problems/sudoku/sudoku_propagation.h"
+
+static int count_clues(const int puzzle[9][9]) {
+    int clues = 0;
+    for (int cell = 0; cell < 81; cell++) {
+        clues += puzzle[cell / 9][cell % 9] != 0;
+    }
+    return clues;
+}
+
+Test(sudoku_generator, generates_unique_puzzle_with_target_clues) {
+    sudoku_generator_config_t config;
+    sudoku_generator_default_config(&config);
+    config.clues = 28;
+
+    int puzzle[9][9];
+    int solution[9][9];
+    sudoku_difficulty_t grade = SUDOKU_DIFFICULTY_ANY;
+    cr_assert_eq(sudoku_generate(7, &config, puzzle, solution, &grade, NULL), EXIT_SUCCESS);
+    cr_assert_eq(count_clues((const int (*)[9])puzzle), 28);
+    cr_assert_neq(grade, SUDOKU_DIFFICULTY_ANY);
+    cr_assert_eq(grade, sudoku_grade((const int (*)[9])puzzle));
+
+    int grid[9][9];
+    int count = 0;
+    memcpy(grid, puzzle, sizeof(grid));
+    cr_assert_eq(sudoku_native_count(grid, 2, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 1);
+    cr_assert_eq(memcmp(grid, solution, sizeof(grid)), 0);
+    for (int cell = 0; cell < 81; cell++) {
+        int value = puzzle[cell / 9][cell % 9];
+        cr_assert(value == 0 || value == solution[cell / 9][cell % 9]);
+    }
+}
+
+Test(sudoku_generator, meets_difficulty_target) {
+    sudoku_generator_config_t config;
+    sudoku_generator_default_config(&config);
+    config.clues = 35;
+    config.difficulty = SUDOKU_DIFFICULTY_EASY;
+
+    int puzzle[9][9];
+    sudoku_difficulty_t grade = SUDOKU_DIFFICULTY_ANY;
+    cr_assert_eq(sudoku_generate(11, &config, puzzle, NULL, &grade, NULL), EXIT_SUCCESS);
+    cr_assert_eq(grade, SUDOKU_DIFFICULTY_EASY);
+
+    config.clues = 28;
+    config.difficulty = SUDOKU_DIFFICULTY_MEDIUM;
+    cr_assert_eq(sudoku_generate(11, &config, puzzle, NULL, &grade, NULL), EXIT_SUCCESS);
+    cr_assert_eq(grade, SUDOKU_DIFFICULTY_MEDIUM);
+
+    // A single attempt at an unreachable clue count fails cleanly
+    config.clues = SUDOKU_MIN_CLUES;
+    config.difficulty = SUDOKU_DIFFICULTY_ANY;
+    config.max_attempts = 1;
+    int attempts = 0;
+    cr_assert_eq(sudoku_generate(11, &config, puzzle, NULL, NULL, &attempts), EXIT_FAILURE);
+    cr_assert_eq(attempts, 1);
+}
+
+Test(sudoku_generator, batch_is_deterministic_across_thread_counts) {
+    enum { COUNT = 100 };
+    sudoku_generator_config_t config;
+    sudoku_generator_default_config(&config);
+    config.seed = 42;
+
+    char *serial = malloc(COUNT * SUDOKU_PUZZLE_LEN);
+    char *parallel = malloc(COUNT * SUDOKU_PUZZLE_LEN);
+    sudoku_difficulty_t grades[COUNT];
+    sudoku_generator_stats_t stats;
+    cr_assert_not_null(serial);
+    cr_assert_not_null(parallel);
+
+    config.threads = 1;
+    cr_assert_eq(sudoku_generate_batch(COUNT, serial, NULL, NULL, &config, NULL), EXIT_SUCCESS);
+    config.threads = 4;
+    cr_assert_eq(sudoku_generate_batch(COUNT, parallel, NULL, grades, &config, &stats), EXIT_SUCCESS);
+
+    cr_assert_eq(memcmp(serial, parallel, COUNT * SUDOKU_PUZZLE_LEN), 0);
+    cr_assert_eq(stats.generated, COUNT);
+    cr_assert_eq(stats.failed, 0);
+    cr_assert_geq(stats.attempts, COUNT);
+
+    // Different puzzles within a batch
+    cr_assert_neq(memcmp(parallel, parallel + SUDOKU_PUZZLE_LEN, SUDOKU_PUZZLE_LEN), 0);
+    int grid[9][9];
+    for (int n = 0; n < COUNT; n++) {
+        cr_assert_eq(sudoku_parse_line(parallel + n * SUDOKU_PUZZLE_LEN, grid), SUDOKU_PARSE_OK);
+        cr_assert_eq(count_clues((const int (*)[9])grid), config.clues);
+        cr_assert_neq(grades[n], SUDOKU_DIFFICULTY_ANY);
+    }
+
+    free(serial);
+    free(parallel);
+}
+
+Test(sudoku_generator, meets_hard_target) {
+    sudoku_generator_config_t config;
+    sudoku_generator_default_config(&config);
+    config.clues = 26;
+    config.difficulty = SUDOKU_DIFFICULTY_HARD;
+
+    int puzzle[9][9];
+    int solution[9][9];
+    sudoku_difficulty_t grade = SUDOKU_DIFFICULTY_ANY;
+    cr_assert_eq(sudoku_generate(5, &config, puzzle, solution, &grade, NULL), EXIT_SUCCESS);
+    cr_assert_eq(grade, SUDOKU_DIFFICULTY_HARD);
+    cr_assert_eq(sudoku_grade((const int (*)[9])puzzle), SUDOKU_DIFFICULTY_HARD);
+    cr_assert_eq(count_clues((const int (*)[9])puzzle), 26);
+
+    int grid[9][9];
+    int count = 0;
+    memcpy(grid, puzzle, sizeof(grid));
+    cr_assert_eq(sudoku_native_count(grid, 2, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 1);
+    cr_assert_eq(memcmp(grid, solution, sizeof(grid)), 0);
+
+    // No silent all-zero records for the hard tier
+    enum { COUNT = 16 };
+    char puzzles[COUNT * SUDOKU_PUZZLE_LEN];
+    sudoku_difficulty_t grades[COUNT];
+    sudoku_generator_stats_t stats;
+    config.threads = 2;
+    cr_assert_eq(sudoku_generate_batch(COUNT, puzzles, NULL, grades, &config, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.generated, COUNT);
+    cr_assert_eq(stats.failed, 0);
+    for (int n = 0; n < COUNT; n++) {
+        cr_assert_eq(grades[n], SUDOKU_DIFFICULTY_HARD);
+    }
+}
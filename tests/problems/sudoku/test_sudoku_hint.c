@@ -0,0 +1,98 @@
+#include <criterion/criterion.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_hint.h"
+#include "sudoku_test_grids.h"
+
+static const char *easy_solution =
+    "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+Test(sudoku_hint, naked_single_names_cell_and_digit) {
+    int grid[9][9] = {{1, 2, 3, 4, 5, 6, 7, 8, 0}};
+    sudoku_hint_t hint;
+
+    cr_assert_eq(sudoku_next_hint((const int (*)[9])grid, NULL, &hint), SUDOKU_HINT_NAKED_SINGLE);
+    cr_assert_eq(hint.placement_cell, 8);
+    cr_assert_eq(hint.placement_digit, 9);
+    cr_assert_str_eq(sudoku_hint_technique_name(hint.technique), "naked single");
+}
+
+Test(sudoku_hint, singles_walk_an_easy_puzzle) {
+    int grid[9][9];
+    memcpy(grid, sudoku_test_easy, sizeof(grid));
+    sudoku_hint_t hint;
+
+    int steps = 0;
+    while (sudoku_next_hint((const int (*)[9])grid, NULL, &hint) != SUDOKU_HINT_NONE) {
+        cr_assert(hint.technique == SUDOKU_HINT_NAKED_SINGLE || hint.technique == SUDOKU_HINT_HIDDEN_SINGLE);
+        sudoku_hint_apply(&hint, grid, NULL);
+        cr_assert_lt(++steps, 81);
+    }
+    for (int cell = 0; cell < 81; cell++) {
+        cr_assert_eq(grid[cell / 9][cell % 9], easy_solution[cell] - '0');
+    }
+}
+
+Test(sudoku_hint, reports_clashes_and_erased_candidates) {
+    int grid[9][9] = {{4, 0, 0, 0, 0, 0, 0, 0, 4}};
+    sudoku_hint_t hint;
+
+    cr_assert_eq(sudoku_next_hint((const int (*)[9])grid, NULL, &hint), SUDOKU_HINT_CONTRADICTION);
+    cr_assert_eq(hint.unit, 0);
+    cr_assert_eq(hint.cell_count, 2);
+    cr_assert_eq(hint.cells[1], 8);
+
+    // The player erased every place of digit 5 in column 3
+    memset(grid, 0, sizeof(grid));
+    uint16_t marks[81] = {0};
+    for (int row = 0; row < 9; row++) {
+        marks[row * 9 + 3] = 0x1FF & ~(1u << 4);
+    }
+    cr_assert_eq(sudoku_next_hint((const int (*)[9])grid, marks, &hint), SUDOKU_HINT_CONTRADICTION);
+    cr_assert_eq(hint.unit, 9 + 3);
+    cr_assert_eq(hint.digits, 1u << 4);
+}
+
+Test(sudoku_hint, pointing_clears_the_rest_of_the_row) {
+    int grid[9][9] = {{0}};
+    uint16_t marks[81] = {0};
+    // Digit 1 only in the top row of box 0
+    for (int row = 1; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            marks[row * 9 + col] = 0x1FF & ~1u;
+        }
+    }
+    sudoku_hint_t hint;
+
+    cr_assert_eq(sudoku_next_hint((const int (*)[9])grid, marks, &hint), SUDOKU_HINT_POINTING);
+    cr_assert_eq(hint.unit, 18);
+    cr_assert_eq(hint.digits, 1u);
+    cr_assert_eq(hint.cell_count, 3);
+    cr_assert_eq(hint.elimination_count, 6);
+    for (int col = 3; col < 9; col++) {
+        cr_assert_eq(hint.eliminations[col], 1u);
+    }
+
+    sudoku_hint_apply(&hint, grid, marks);
+    cr_assert_eq(marks[5], 0x1FF & ~1u);
+    cr_assert_neq(sudoku_next_hint((const int (*)[9])grid, marks, &hint), SUDOKU_HINT_POINTING);
+}
+
+Test(sudoku_hint, x_wing_on_two_rows) {
+    int grid[9][9] = {{0}};
+    uint16_t marks[81] = {0};
+    // Digit 1 only in columns 2 and 6 of rows 0 and 4
+    for (int col = 0; col < 9; col++) {
+        if (col != 2 && col != 6) {
+            marks[col] = 0x1FF & ~1u;
+            marks[4 * 9 + col] = 0x1FF & ~1u;
+        }
+    }
+    sudoku_hint_t hint;
+
+    cr_assert_eq(sudoku_next_hint((const int (*)[9])grid, marks, &hint), SUDOKU_HINT_X_WING);
+    cr_assert_eq(hint.digits, 1u);
+    cr_assert_eq(hint.cell_count, 4);
+    cr_assert_eq(hint.elimination_count, 14);
+    cr_assert_eq(hint.eliminations[1 * 9 + 2], 1u);
+    cr_assert_eq(hint.eliminations[4 * 9 + 2], 0);
+}
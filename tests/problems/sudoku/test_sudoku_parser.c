@@ -0,0 +1,195 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_parser.h"
+
+static const char *sample = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+
+Test(sudoku_parser, parses_line_format) {
+    int grid[9][9];
+
+    cr_assert_eq(sudoku_parse(sample, grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(grid[0][0], 5);
+    cr_assert_eq(grid[0][2], 0);
+    cr_assert_eq(grid[8][8], 9);
+
+    // Dots for blanks and surrounding whitespace
+    char dotted[96];
+    snprintf(dotted, sizeof(dotted), "  %s\r\n", sample);
+    for (char *p = dotted; *p; p++) {
+        if (*p == '0') {
+            *p = '.';
+        }
+    }
+    int dotted_grid[9][9];
+    cr_assert_eq(sudoku_parse(dotted, dotted_grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(memcmp(grid, dotted_grid, sizeof(grid)), 0);
+}
+
+Test(sudoku_parser, rejects_malformed_lines) {
+    int grid[9][9];
+    char line[SUDOKU_PUZZLE_LEN + 1];
+
+    cr_assert_eq(sudoku_parse(NULL, grid), SUDOKU_PARSE_EMPTY);
+    cr_assert_eq(sudoku_parse(" \n", grid), SUDOKU_PARSE_EMPTY);
+    cr_assert_eq(sudoku_parse("53007", grid), SUDOKU_PARSE_BAD_LENGTH);
+
+    // A bad character in every SIMD block and in the scalar tail
+    for (int pos = 0; pos < SUDOKU_PUZZLE_LEN; pos += 8) {
+        memcpy(line, sample, sizeof(line));
+        line[pos] = 'x';
+        cr_assert_eq(sudoku_parse(line, grid), SUDOKU_PARSE_BAD_CHAR, "Bad char at %d accepted", pos);
+    }
+    memcpy(line, sample, sizeof(line));
+    line[80] = '/';
+    cr_assert_eq(sudoku_parse(line, grid), SUDOKU_PARSE_BAD_CHAR);
+}
+
+Test(sudoku_parser, rejects_duplicate_givens) {
+    int grid[9][9];
+    char line[SUDOKU_PUZZLE_LEN + 1];
+
+    memcpy(line, sample, sizeof(line));
+    line[2] = '3';  // Row 0 already has a 3
+    cr_assert_eq(sudoku_parse(line, grid), SUDOKU_PARSE_DUPLICATE);
+
+    memcpy(line, sample, sizeof(line));
+    line[9 * 8] = '5';  // Column 0 already has a 5
+    cr_assert_eq(sudoku_parse(line, grid), SUDOKU_PARSE_DUPLICATE);
+
+    memcpy(line, sample, sizeof(line));
+    line[9 * 2] = '3';  // Top-left box already has a 3
+    cr_assert_eq(sudoku_parse(line, grid), SUDOKU_PARSE_DUPLICATE);
+}
+
+Test(sudoku_parser, parses_json_grid) {
+    const char *json =
+        "{\"grid\": [[5,3,0,0,7,0,0,0,0],[6,0,0,1,9,5,0,0,0],[0,9,8,0,0,0,0,6,0],"
+        "[8,0,0,0,6,0,0,0,3],[4,0,0,8,0,3,0,0,1],[7,0,0,0,2,0,0,0,6],"
+        "[0,6,0,0,0,0,2,8,0],[0,0,0,4,1,9,0,0,5],[0,0,0,0,8,0,null,7,9]]}";
+    int expected[9][9];
+    int grid[9][9];
+
+    cr_assert_eq(sudoku_parse(sample, expected), SUDOKU_PARSE_OK);
+    cr_assert_eq(sudoku_parse(json, grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(memcmp(grid, expected, sizeof(grid)), 0);
+
+    // Top-level array
+    char top_level[512];
+    snprintf(top_level, sizeof(top_level), "%.*s", (int)(strlen(json) - 10), json + 9);
+    cr_assert_eq(sudoku_parse(top_level, grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(memcmp(grid, expected, sizeof(grid)), 0);
+
+    // Line format inside JSON
+    char wrapped[128];
+    snprintf(wrapped, sizeof(wrapped), "{\"grid\": \"%s\"}", sample);
+    cr_assert_eq(sudoku_parse(wrapped, grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(memcmp(grid, expected, sizeof(grid)), 0);
+}
+
+Test(sudoku_parser, rejects_malformed_json) {
+    int grid[9][9];
+
+    cr_assert_eq(sudoku_parse("{\"puzzle\": []}", grid), SUDOKU_PARSE_BAD_JSON);
+    cr_assert_eq(sudoku_parse("{\"grid\": [[1,2,3]]}", grid), SUDOKU_PARSE_BAD_LENGTH);
+    cr_assert_eq(sudoku_parse("{\"grid\": [[1,2,3,4,5,6,7,8,10]]}", grid), SUDOKU_PARSE_BAD_CHAR);
+    cr_assert_eq(sudoku_parse("{\"grid\": \"123\"}", grid), SUDOKU_PARSE_BAD_LENGTH);
+    cr_assert_eq(sudoku_parse("[[1,1,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0],"
+                              "[0,0,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0],"
+                              "[0,0,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0],[0,0,0,0,0,0,0,0,0]]", grid),
+                 SUDOKU_PARSE_DUPLICATE);
+}
+
+Test(sudoku_parser, formats_line) {
+    int grid[9][9];
+    char line[SUDOKU_PUZZLE_LEN + 1] = {0};
+
+    cr_assert_eq(sudoku_parse(sample, grid), SUDOKU_PARSE_OK);
+    sudoku_format_line((const int (*)[9])grid, line);
+    cr_assert_str_eq(line, sample);
+}
+
+// Valid solved grid of the given order: shifted rows, one band per box row
+static void make_grid(sudoku_grid_t *grid, int order, int blank_every) {
+    cr_assert(sudoku_grid_init(grid, order));
+    for (int cell = 0; cell < grid->size * grid->size; cell++) {
+        int row = cell / grid->size;
+        int col = cell % grid->size;
+        int value = ((row % order) * order + row / order + col) % grid->size + 1;
+        grid->cells[cell] = cell % blank_every == 0 ? 0 : value;
+    }
+}
+
+Test(sudoku_parser, parses_16x16_symbols) {
+    sudoku_grid_t grid;
+    make_grid(&grid, 4, 3);
+    char text[300];
+    cr_assert_eq(sudoku_format_grid(&grid, text, sizeof(text)), 256);
+
+    sudoku_grid_t parsed;
+    cr_assert_eq(sudoku_parse_grid(text, &parsed), SUDOKU_PARSE_OK);
+    cr_assert_eq(parsed.order, 4);
+    cr_assert_eq(parsed.size, 16);
+    cr_assert_eq(memcmp(parsed.cells, grid.cells, 256 * sizeof(int)), 0);
+
+    // Lowercase symbols are accepted too
+    for (char *p = text; *p; p++) {
+        *p = (char)(*p >= 'A' && *p <= 'Z' ? *p - 'A' + 'a' : *p);
+    }
+    cr_assert_eq(sudoku_parse_grid(text, &parsed), SUDOKU_PARSE_OK);
+    cr_assert_eq(memcmp(parsed.cells, grid.cells, 256 * sizeof(int)), 0);
+
+    // Not a 9x9 puzzle
+    int rows[9][9];
+    cr_assert_eq(sudoku_parse(text, rows), SUDOKU_PARSE_BAD_LENGTH);
+}
+
+Test(sudoku_parser, parses_tokens_and_json_of_any_order) {
+    sudoku_grid_t grid;
+    cr_assert_eq(sudoku_parse_grid("1 0 3 4, 3 4 1 2\n2 1 4 0 4 3 2 1", &grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(grid.order, 2);
+    cr_assert_eq(grid.cells[1], 0);
+    cr_assert_eq(grid.cells[3], 4);
+
+    cr_assert_eq(sudoku_parse_grid("{\"grid\": [[1,null,3,4],[3,4,1,2],[2,1,4,0],[4,3,2,1]]}", &grid),
+                 SUDOKU_PARSE_OK);
+    cr_assert_eq(grid.order, 2);
+    cr_assert_eq(grid.cells[1], 0);
+    cr_assert_eq(grid.cells[15], 1);
+
+    cr_assert_eq(sudoku_parse_grid("{\"grid\": \"1034341221404321\"}", &grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(grid.cells[0], 1);
+
+    cr_assert_eq(sudoku_parse_grid(sample, &grid), SUDOKU_PARSE_OK);
+    cr_assert_eq(grid.order, 3);
+    cr_assert_eq(sudoku_grid_rows(&grid)[8][8], 9);
+}
+
+Test(sudoku_parser, rejects_malformed_grids) {
+    sudoku_grid_t grid;
+    cr_assert_eq(sudoku_parse_grid("", &grid), SUDOKU_PARSE_EMPTY);
+    cr_assert_eq(sudoku_parse_grid("12345", &grid), SUDOKU_PARSE_BAD_LENGTH);
+    cr_assert_eq(sudoku_parse_grid("1 2 3", &grid), SUDOKU_PARSE_BAD_LENGTH);
+    // 5 is not a digit of a 4x4 puzzle
+    cr_assert_eq(sudoku_parse_grid("5034341221404321", &grid), SUDOKU_PARSE_BAD_CHAR);
+    cr_assert_eq(sudoku_parse_grid("1 0 3 4 3 4 1 2 2 1 4 0 4 3 2 x", &grid), SUDOKU_PARSE_BAD_CHAR);
+    cr_assert_eq(sudoku_parse_grid("1134341221404321", &grid), SUDOKU_PARSE_DUPLICATE);
+    cr_assert_eq(sudoku_parse_grid("[[1,2],[3,4]]", &grid), SUDOKU_PARSE_BAD_LENGTH);
+}
+
+Test(sudoku_parser, formats_tokens_above_35) {
+    sudoku_grid_t grid;
+    make_grid(&grid, 6, 1);
+
+    size_t len = sudoku_format_grid(&grid, NULL, 0);
+    char *text = malloc(len + 1);
+    cr_assert_not_null(text);
+    cr_assert_eq(sudoku_format_grid(&grid, text, len + 1), len);
+    cr_assert_eq(text[len], '\0');
+
+    sudoku_grid_t parsed;
+    cr_assert_eq(sudoku_parse_grid(text, &parsed), SUDOKU_PARSE_OK);
+    cr_assert_eq(parsed.order, 6);
+    cr_assert_eq(memcmp(parsed.cells, grid.cells, 36 * 36 * sizeof(int)), 0);
+    free(text);
+}
@@ -0,0 +1,119 @@
+#include <criterion/criterion.h>
+#include "../include/problems/sudoku/sudoku_propagation.h"
+#include "sudoku_test_grids.h"
+
+Test(sudoku_propagation, solves_with_singles_only) {
+    int grid[9][9];
+    sudoku_native_stats_t stats;
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+
+    cr_assert_eq(sudoku_native_solve(grid, NULL, &stats), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(stats.nodes, 0, "Expected no branching, got %ld nodes", stats.nodes);
+    cr_assert(sudoku_test_is_solution(sudoku_test_easy, (const int (*)[9])grid));
+}
+
+Test(sudoku_propagation, solves_with_search) {
+    int grid[9][9];
+    sudoku_native_stats_t stats;
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+
+    cr_assert_eq(sudoku_native_solve(grid, NULL, &stats), SUDOKU_NATIVE_SOLVED);
+    cr_assert_gt(stats.nodes, 0);
+    cr_assert(sudoku_test_is_solution(sudoku_test_hard, (const int (*)[9])grid));
+}
+
+Test(sudoku_propagation, detects_infeasible_puzzle) {
+    int grid[9][9];
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+    grid[0][2] = 5;  // Duplicate 5 in the first row
+
+    cr_assert_eq(sudoku_native_solve(grid, NULL, NULL), SUDOKU_NATIVE_INFEASIBLE);
+    cr_assert_eq(grid[0][3], 0, "Grid must be left untouched");
+
+    // No clash between givens, but (0,0) has no candidate left
+    int empty[9][9] = {{0, 1, 2, 3, 4, 5, 6, 7, 8}};
+    empty[4][0] = 9;
+    sudoku_test_copy_grid(grid, (const int (*)[9])empty);
+    cr_assert_eq(sudoku_native_solve(grid, NULL, NULL), SUDOKU_NATIVE_INFEASIBLE);
+}
+
+Test(sudoku_propagation, stops_at_node_limit) {
+    int grid[9][9];
+    sudoku_native_limits_t limits = {.node_limit = 1, .time_limit = 0.0};
+    sudoku_native_stats_t stats;
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+
+    cr_assert_eq(sudoku_native_solve(grid, &limits, &stats), SUDOKU_NATIVE_LIMIT_REACHED);
+    cr_assert_leq(stats.nodes, 1);
+    cr_assert_eq(grid[0][1], 0, "Grid must be left untouched");
+}
+
+Test(sudoku_propagation, stops_when_cancelled) {
+    int grid[9][9];
+    atomic_bool cancel;
+    atomic_init(&cancel, true);
+    sudoku_native_limits_t limits = {.node_limit = 0, .time_limit = 0.0, .cancel = &cancel};
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+
+    cr_assert_eq(sudoku_native_solve(grid, &limits, NULL), SUDOKU_NATIVE_LIMIT_REACHED);
+    cr_assert_eq(grid[0][1], 0, "Grid must be left untouched");
+
+    atomic_store(&cancel, false);
+    cr_assert_eq(sudoku_native_solve(grid, &limits, NULL), SUDOKU_NATIVE_SOLVED);
+}
+
+Test(sudoku_propagation, counts_solutions_up_to_cap) {
+    int grid[9][9];
+    int count = -1;
+
+    // Unique puzzles need a full search to prove it
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+    cr_assert_eq(sudoku_native_count(grid, 2, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 1);
+    cr_assert(sudoku_test_is_solution(sudoku_test_hard, (const int (*)[9])grid));
+
+    // The empty grid stops at the cap
+    int empty[9][9] = {{0}};
+    sudoku_test_copy_grid(grid, (const int (*)[9])empty);
+    cr_assert_eq(sudoku_native_count(grid, 2, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 2);
+    cr_assert(sudoku_test_is_solution((const int (*)[9])empty, (const int (*)[9])grid));
+
+    sudoku_test_copy_grid(grid, (const int (*)[9])empty);
+    cr_assert_eq(sudoku_native_count(grid, 50, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 50);
+
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+    grid[0][2] = 5;
+    cr_assert_eq(sudoku_native_count(grid, 2, NULL, NULL, &count), SUDOKU_NATIVE_INFEASIBLE);
+    cr_assert_eq(count, 0);
+}
+
+Test(sudoku_propagation, counts_in_parallel) {
+    int grid[9][9];
+    int count = -1;
+    sudoku_native_stats_t stats;
+
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+    cr_assert_eq(sudoku_native_count_parallel(grid, 2, 4, NULL, &stats, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 1);
+    cr_assert_gt(stats.nodes, 0);
+    cr_assert(sudoku_test_is_solution(sudoku_test_hard, (const int (*)[9])grid));
+
+    // Removing givens from a unique puzzle opens it up
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+    grid[0][0] = 0;
+    grid[1][2] = 0;
+    grid[2][1] = 0;
+    cr_assert_eq(sudoku_native_count_parallel(grid, 2, 4, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 2);
+
+    sudoku_test_copy_grid(grid, sudoku_test_easy);
+    cr_assert_eq(sudoku_native_count_parallel(grid, 2, 0, NULL, NULL, &count), SUDOKU_NATIVE_SOLVED);
+    cr_assert_eq(count, 1);
+    cr_assert(sudoku_test_is_solution(sudoku_test_easy, (const int (*)[9])grid));
+
+    sudoku_native_limits_t limits = {.node_limit = 4, .time_limit = 0.0};
+    sudoku_test_copy_grid(grid, sudoku_test_hard);
+    cr_assert_eq(sudoku_native_count_parallel(grid, 2, 2, &limits, NULL, &count), SUDOKU_NATIVE_LIMIT_REACHED);
+}
@@ -0,0 +1,98 @@
+#include <criterion/criterion.h>
+#include <string.h>
+#include "../include/problems/sudoku/sudoku_session.h"
+#include "sudoku_test_grids.h"
+
+static void init_native(sudoku_session_t *session) {
+    sudoku_options_t options;
+    sudoku_default_options(&options);
+    options.engine = SUDOKU_ENGINE_NATIVE;
+    sudoku_session_init(session, &options);
+}
+
+Test(sudoku_session, revalidates_edits_the_solution_covers) {
+    sudoku_session_t session;
+    init_native(&session);
+
+    cr_assert_eq(sudoku_session_load(&session, sudoku_test_easy), SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(session.stats.resolved, 1);
+    cr_assert(sudoku_test_is_solution(sudoku_test_easy, (const int (*)[9])session.solution));
+
+    // Entering the solution's own digit and clearing a given keep the answer
+    cr_assert_eq(sudoku_session_set_cell(&session, 0, 2, session.solution[0][2]), SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(sudoku_session_set_cell(&session, 0, 0, 0), SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(session.stats.revalidated, 2);
+    cr_assert_eq(session.stats.resolved, 1);
+
+    // A clash is seen without solving, and stays infeasible as givens are added
+    cr_assert_eq(sudoku_session_set_cell(&session, 0, 3, 3), SUDOKU_SESSION_INFEASIBLE);
+    cr_assert_eq(sudoku_session_set_cell(&session, 8, 0, session.solution[8][0]), SUDOKU_SESSION_INFEASIBLE);
+    cr_assert_eq(session.stats.resolved, 1);
+
+    // Undoing the clash needs a (guided) solve
+    cr_assert_eq(sudoku_session_set_cell(&session, 0, 3, 0), SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(session.stats.resolved, 2);
+    cr_assert(sudoku_test_is_solution((const int (*)[9])session.givens, (const int (*)[9])session.solution));
+    cr_assert_eq(session.stats.edits, 5);
+
+    cr_assert_eq(sudoku_session_set_cell(&session, 9, 0, 1), SUDOKU_SESSION_ERROR);
+    cr_assert_eq(session.status, SUDOKU_SESSION_SOLVED, "Rejected edits leave the session unchanged");
+
+    sudoku_session_free(&session);
+}
+
+Test(sudoku_session, rejected_load_keeps_the_previous_grid) {
+    sudoku_session_t session;
+    init_native(&session);
+    cr_assert_eq(sudoku_session_load(&session, sudoku_test_easy), SUDOKU_SESSION_SOLVED);
+
+    // The bad digit comes after cells that differ from the loaded grid
+    int bad[9][9];
+    memcpy(bad, sudoku_test_hard, sizeof(bad));
+    bad[8][8] = 10;
+    cr_assert_eq(sudoku_session_load(&session, bad), SUDOKU_SESSION_ERROR);
+    cr_assert_eq(memcmp(session.givens, sudoku_test_easy, sizeof(session.givens)), 0);
+    cr_assert_eq(session.status, SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(session.stats.resolved, 1);
+
+    // Edits still apply to the previous grid and its answer
+    cr_assert_eq(sudoku_session_set_cell(&session, 0, 0, 0), SUDOKU_SESSION_SOLVED);
+    cr_assert_eq(session.stats.resolved, 1);
+    cr_assert(sudoku_test_is_solution(sudoku_test_easy, (const int (*)[9])session.solution));
+
+    sudoku_session_free(&session);
+}
+
+Test(sudoku_session, resolves_edits_that_break_the_solution) {
+    sudoku_session_t session;
+    init_native(&session);
+
+    // Without its first row the puzzle has several solutions
+    int open[9][9];
+    memcpy(open, sudoku_test_easy, sizeof(open));
+    memset(open[0], 0, sizeof(open[0]));
+    cr_assert_eq(sudoku_session_load(&session, open), SUDOKU_SESSION_SOLVED);
+
+    int first[9][9];
+    memcpy(first, session.solution, sizeof(first));
+    bool moved = false;
+    for (int col = 0; col < 9 && !moved; col++) {
+        for (int digit = 1; digit <= 9 && !moved; digit++) {
+            if (digit == first[0][col]) {
+                continue;
+            }
+            sudoku_session_status_t status = sudoku_session_set_cell(&session, 0, col, digit);
+            if (status == SUDOKU_SESSION_SOLVED) {
+                cr_assert_eq(session.solution[0][col], digit);
+                cr_assert(sudoku_test_is_solution((const int (*)[9])session.givens, (const int (*)[9])session.solution));
+                moved = true;
+            } else {
+                cr_assert_eq(status, SUDOKU_SESSION_INFEASIBLE);
+            }
+            cr_assert_eq(sudoku_session_set_cell(&session, 0, col, 0), SUDOKU_SESSION_SOLVED);
+        }
+    }
+    cr_assert(moved, "Another solution should be reachable by one edit");
+
+    sudoku_session_free(&session);
+}
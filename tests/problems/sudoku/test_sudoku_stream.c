@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/problems/sudoku/sudoku_stream.h"
+
+static const char *puzzle = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+static const char *solution = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+static const char *duplicate = "550070000600195000098000060800060003400803001700020006060000280000419005000080079";
+
+static void temp_path(char *path, size_t len, const char *name) {
+    snprintf(path, len, "/tmp/test_sudoku_stream_%ld_%s", (long)getpid(), name);
+}
+
+Test(sudoku_stream, solves_file_in_input_order) {
+    char input_path[128];
+    char output_path[128];
+    temp_path(input_path, sizeof(input_path), "in.txt");
+    temp_path(output_path, sizeof(output_path), "out.txt");
+
+    // Enough lines for several blocks, with odd lines mixed in
+    enum { LINES = 40000 };
+    FILE *input = fopen(input_path, "wb");
+    cr_assert_not_null(input);
+    for (int n = 0; n < LINES; n++) {
+        if (n % 1000 == 1) {
+            fprintf(input, "%s\r\n", duplicate);
+        } else if (n % 1000 == 2) {
+            fprintf(input, "too short\n\n");
+        } else {
+            fprintf(input, "%s\n", puzzle);
+        }
+    }
+    fprintf(input, "%s", puzzle);  // Unterminated last line
+    fclose(input);
+
+    sudoku_batch_config_t config;
+    sudoku_batch_default_config(&config);
+    config.threads = 4;
+    config.options.engine = SUDOKU_ENGINE_NATIVE;
+    sudoku_batch_stats_t stats;
+    cr_assert_eq(solve_sudoku_file(input_path, output_path, &config, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.solved, LINES + 1 - 80);
+    cr_assert_eq(stats.infeasible, 40);
+    cr_assert_eq(stats.invalid, 40);
+    cr_assert_eq(stats.failed, 0);
+
+    FILE *output = fopen(output_path, "rb");
+    cr_assert_not_null(output);
+    char line[128];
+    int n = 0;
+    while (fgets(line, sizeof(line), output)) {
+        line[strcspn(line, "\n")] = '\0';
+        const char *expected = n % 1000 == 1 ? duplicate : n % 1000 == 2 ? "too short" : solution;
+        cr_assert_str_eq(line, expected);
+        n++;
+    }
+    cr_assert_eq(n, LINES + 1);
+    fclose(output);
+
+    remove(input_path);
+    remove(output_path);
+}
+
+Test(sudoku_stream, handles_empty_and_missing_files) {
+    char input_path[128];
+    char output_path[128];
+    temp_path(input_path, sizeof(input_path), "empty.txt");
+    temp_path(output_path, sizeof(output_path), "empty_out.txt");
+
+    FILE *input = fopen(input_path, "wb");
+    cr_assert_not_null(input);
+    fclose(input);
+    sudoku_batch_stats_t stats;
+    cr_assert_eq(solve_sudoku_file(input_path, output_path, NULL, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.solved, 0);
+
+    remove(input_path);
+    cr_assert_eq(solve_sudoku_file(input_path, output_path, NULL, NULL), EXIT_FAILURE);
+    remove(output_path);
+}
+
+Test(sudoku_stream, solves_binary_files) {
+    char input_path[128];
+    char output_path[128];
+    temp_path(input_path, sizeof(input_path), "in.sdkb");
+    temp_path(output_path, sizeof(output_path), "out.sdkb");
+
+    enum { RECORDS = 300 };
+    char *records = malloc(RECORDS * 81);
+    cr_assert_not_null(records);
+    for (int n = 0; n < RECORDS; n++) {
+        memcpy(records + n * 81, n % 100 == 7 ? duplicate : puzzle, 81);
+    }
+    sudoku_binary_writer_t writer;
+    cr_assert_eq(sudoku_binary_writer_open(&writer, input_path, 3, true), EXIT_SUCCESS);
+    cr_assert_eq(sudoku_binary_write(&writer, records, RECORDS), EXIT_SUCCESS);
+    cr_assert_eq(sudoku_binary_writer_close(&writer), EXIT_SUCCESS);
+
+    sudoku_batch_config_t config;
+    sudoku_batch_default_config(&config);
+    config.threads = 2;
+    config.options.engine = SUDOKU_ENGINE_NATIVE;
+    sudoku_batch_stats_t stats;
+    cr_assert_eq(solve_sudoku_binary_file(input_path, output_path, &config, &stats), EXIT_SUCCESS);
+    cr_assert_eq(stats.solved, RECORDS - 3);
+    cr_assert_eq(stats.infeasible, 3);
+
+    sudoku_binary_reader_t reader;
+    sudoku_binary_header_t header;
+    cr_assert_eq(sudoku_binary_reader_open(&reader, output_path, &header), EXIT_SUCCESS);
+    cr_assert_eq(header.flags, SUDOKU_BINARY_COMPRESSED, "Output keeps the input's compression");
+    cr_assert_eq(sudoku_binary_read(&reader, records, RECORDS), RECORDS);
+    cr_assert_eq(sudoku_binary_reader_close(&reader), EXIT_SUCCESS);
+    for (int n = 0; n < RECORDS; n++) {
+        cr_assert_eq(memcmp(records + n * 81, n % 100 == 7 ? duplicate : solution, 81), 0, "Record %d", n);
+    }
+
+    free(records);
+    remove(input_path);
+    remove(output_path);
+}
@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/problems/sudoku/sudoku_binary.h"
+#include "../include/problems/sudoku/sudoku_verify.h"
+
+static const char *puzzle = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+static const char *solution = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+static void temp_path(char *path, size_t len, const char *name) {
+    snprintf(path, len, "/tmp/test_sudoku_verify_%ld_%s", (long)getpid(), name);
+}
+
+// Every fourth grid is broken in its own way; the rest are valid relabelings
+// of solution (with puzzle relabeled alike)
+static void make_grids(char *solutions, char *puzzles, size_t count, bool *expected) {
+    for (size_t n = 0; n < count; n++) {
+        char *grid = solutions + n * 81;
+        char *givens = puzzles + n * 81;
+        int shift = (int)(n % 9);
+        for (int cell = 0; cell < 81; cell++) {
+            grid[cell] = (char)('1' + (solution[cell] - '1' + shift) % 9);
+            givens[cell] = puzzle[cell] == '0' ? '.' : grid[cell];
+        }
+        expected[n] = n % 4 != 3;
+        if (expected[n]) {
+            continue;
+        }
+        switch ((n / 4) % 4) {
+        case 0:  // A digit repeated in a row
+            grid[(n % 9) * 9 + 2] = grid[(n % 9) * 9 + 3];
+            break;
+        case 1:
+            grid[n % 81] = '0';
+            break;
+        case 2: {  // Two cells of a row swapped keep the rows but break columns
+            char swap = grid[0];
+            grid[0] = grid[1];
+            grid[1] = swap;
+            break;
+        }
+        default:  // Valid grid that drops a given
+            givens[0] = grid[0] == '9' ? '1' : (char)(grid[0] + 1);
+            break;
+        }
+    }
+}
+
+Test(sudoku_verify, checks_units_and_givens) {
+    cr_assert(sudoku_verify_record(solution, NULL));
+    cr_assert(sudoku_verify_record(solution, puzzle));
+
+    char grid[82];
+    memcpy(grid, solution, sizeof(grid));
+    grid[40] = '.';
+    cr_assert_not(sudoku_verify_record(grid, NULL));
+
+    // Swapping two rows of a band keeps every unit but not the givens
+    memcpy(grid, solution, sizeof(grid));
+    memcpy(grid, solution + 9, 9);
+    memcpy(grid + 9, solution, 9);
+    cr_assert(sudoku_verify_record(grid, NULL));
+    cr_assert_not(sudoku_verify_record(grid, puzzle));
+
+    int values[9][9];
+    for (int cell = 0; cell < 81; cell++) {
+        values[cell / 9][cell % 9] = solution[cell] - '0';
+    }
+    cr_assert(sudoku_verify_grid((const int (*)[9])values));
+    // In range everywhere, but column 0 repeats
+    values[0][0] = values[1][0];
+    values[0][8] = 5;
+    cr_assert_not(sudoku_verify_grid((const int (*)[9])values));
+}
+
+Test(sudoku_verify, batch_matches_single_checks) {
+    // Not a multiple of SUDOKU_VERIFY_LANES, so the scalar tail runs too
+    enum { COUNT = 16 * 40 + 7 };
+    char *solutions = malloc(COUNT * 81);
+    char *puzzles = malloc(COUNT * 81);
+    bool expected[COUNT];
+    bool valid[COUNT];
+    make_grids(solutions, puzzles, COUNT, expected);
+
+    size_t good = sudoku_verify_batch(solutions, puzzles, COUNT, valid);
+    size_t want = 0;
+    for (size_t n = 0; n < COUNT; n++) {
+        cr_assert_eq(valid[n], expected[n], "Grid %zu", n);
+        cr_assert_eq(valid[n], sudoku_verify_record(solutions + n * 81, puzzles + n * 81));
+        want += expected[n];
+    }
+    cr_assert_eq(good, want);
+
+    // Without puzzles the grids that only drop a given are valid too
+    size_t units_only = 0;
+    for (size_t n = 0; n < COUNT; n++) {
+        units_only += expected[n] || n % 16 == 15;
+    }
+    cr_assert_eq(sudoku_verify_batch(solutions, NULL, COUNT, NULL), units_only);
+
+    free(solutions);
+    free(puzzles);
+}
+
+Test(sudoku_verify, verifies_text_and_binary_files) {
+    char text_path[128];
+    char binary_path[128];
+    char puzzles_path[128];
+    temp_path(text_path, sizeof(text_path), "solutions.txt");
+    temp_path(binary_path, sizeof(binary_path), "solutions.sdkb");
+    temp_path(puzzles_path, sizeof(puzzles_path), "puzzles.txt");
+
+    enum { COUNT = 100 };
+    char *solutions = malloc(COUNT * 81);
+    char *puzzles = malloc(COUNT * 81);
+    for (size_t n = 0; n < COUNT; n++) {
+        memcpy(solutions + n * 81, solution, 81);
+        memcpy(puzzles + n * 81, puzzle, 81);
+    }
+    memcpy(solutions + 42 * 81, solutions + 42 * 81 + 9, 9);  // Row 0 repeats row 1
+
+    FILE *text = fopen(text_path, "wb");
+    FILE *givens = fopen(puzzles_path, "wb");
+    cr_assert(text && givens);
+    for (size_t n = 0; n < COUNT; n++) {
+        fprintf(text, "%.81s\n%s", solutions + n * 81, n == 10 ? "\r\n" : "");
+        fprintf(givens, "%.81s\n", puzzles + n * 81);
+    }
+    fclose(text);
+    fclose(givens);
+
+    sudoku_binary_writer_t writer;
+    cr_assert_eq(sudoku_binary_writer_open(&writer, binary_path, 3, true), EXIT_SUCCESS);
+    cr_assert_eq(sudoku_binary_write(&writer, solutions, COUNT), EXIT_SUCCESS);
+    cr_assert_eq(sudoku_binary_writer_close(&writer), EXIT_SUCCESS);
+
+    const char *paths[] = {text_path, binary_path};
+    for (int p = 0; p < 2; p++) {
+        sudoku_verify_stats_t stats;
+        cr_assert_eq(sudoku_verify_file(paths[p], puzzles_path, &stats), EXIT_SUCCESS);
+        cr_assert_eq(stats.checked, COUNT);
+        cr_assert_eq(stats.valid, COUNT - 1);
+        cr_assert_eq(stats.first_invalid, 42);
+    }
+
+    // A puzzles file of another length is an error, not a verdict
+    givens = fopen(puzzles_path, "ab");
+    fprintf(givens, "%s\n", puzzle);
+    fclose(givens);
+    cr_assert_eq(sudoku_verify_file(text_path, puzzles_path, NULL), EXIT_FAILURE);
+    cr_assert_eq(sudoku_verify_file("/nonexistent/solutions.txt", NULL, NULL), EXIT_FAILURE);
+
+    free(solutions);
+    free(puzzles);
+    unlink(text_path);
+    unlink(binary_path);
+    unlink(puzzles_path);
+}